@@ -1,11 +1,42 @@
 #include <benchmark/benchmark.h>
 #include "keyword_matcher.h"
 #include "log_monitor.h"
+#include "simd_search.h"
+#include "parallel_scanner.h"
+#include "multi_log_monitor.h"
+#include "line_index.h"
+#include "field_filter.h"
+#include "static_keyword_matcher.h"
+#include "latency_histogram.h"
+#include "file_watcher.h"
+#include "compressed_input.h"
+#include "compressed_sink.h"
+#include "placement.h"
 #include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cctype>
 #include <random>
 #include <filesystem>
 #include <thread>
 #include <chrono>
+#include <memory>
+#include <cstdio>
+#include <atomic>
+#include <charconv>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+#if LOG_MONITOR_GZIP
+#include <zlib.h>
+#endif
+#if LOG_MONITOR_ZSTD
+#include <zstd.h>
+#endif
 
 namespace fs = std::filesystem;
 
@@ -23,9 +54,21 @@ static void BM_KeywordMatcher_SingleKeyword(benchmark::State& state) {
 BENCHMARK(BM_KeywordMatcher_SingleKeyword);
 
 //multiple keywords in line
+//arg0 = keyword count (watchlist size), arg1 = 0 linear / 1 automaton
 static void BM_KeywordMatcher_MultipleKeywords(benchmark::State& state) {
-    KeywordMatcher matcher({"key1", "key2", "EXECUTION", "REJECT", "FILL", 
-                            "CANCEL", "ERROR", "WARNING", "INFO", "DEBUG"});
+    std::vector<std::string> keywords = {"key1", "key2", "REJECT", "FILL", "CANCEL",
+                                         "ERROR", "WARNING", "INFO", "DEBUG"};
+    // pad with watchlist-style ids that never hit, real hit is last
+    const size_t count = static_cast<size_t>(state.range(0));
+    keywords.resize(std::min(keywords.size(), count - 1));
+    while (keywords.size() < count - 1) {
+        keywords.push_back("ORD" + std::to_string(1000000 + keywords.size()));
+    }
+    keywords.push_back("EXECUTION");
+    
+    auto engine = state.range(1) ? KeywordMatcher::Engine::Automaton
+                                 : KeywordMatcher::Engine::Linear;
+    KeywordMatcher matcher(keywords, engine);
     std::string line = "2024-10-15 12:34:56.789123 EXECUTION OrderID=123456 Symbol=AAPL Side=BUY";
     
     for (auto _ : state) {
@@ -34,7 +77,9 @@ static void BM_KeywordMatcher_MultipleKeywords(benchmark::State& state) {
     
     state.SetItemsProcessed(state.iterations());
 }
-BENCHMARK(BM_KeywordMatcher_MultipleKeywords);
+BENCHMARK(BM_KeywordMatcher_MultipleKeywords)
+    ->ArgNames({"keywords", "automaton"})
+    ->ArgsProduct({{4, 10, 100, 1000}, {0, 1}});
 
 //check false positives
 static void BM_KeywordMatcher_NoMatch(benchmark::State& state) {
@@ -49,6 +94,89 @@ static void BM_KeywordMatcher_NoMatch(benchmark::State& state) {
 }
 BENCHMARK(BM_KeywordMatcher_NoMatch);
 
+//no match on a generator-style line, linear find() vs simd prefilter
+//(arg = 0 linear / 1 simd). unlike the line above this one is full of the
+//keywords' first bytes, so memchr keeps stopping on false candidates
+static void BM_KeywordMatcher_NoMatchEngine(benchmark::State& state) {
+    auto engine = state.range(0) ? KeywordMatcher::Engine::Simd : KeywordMatcher::Engine::Linear;
+    KeywordMatcher matcher({"REJECT", "ERROR", "FILL"}, engine);
+    std::string line = "[2024-10-15 12:34:56.789123] EXECUTION OrderID=482913 Symbol=GOOGL "
+                       "Side=SELL Type=LIMIT Price=321.45 Qty=4200 Venue=NYSE Latency=231us";
+    
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(matcher.matches(line));
+    }
+    
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_KeywordMatcher_NoMatchEngine)->ArgName("simd")->DenseRange(0, 1);
+
+static constexpr char BENCH_REJECT[] = "REJECT";
+static constexpr char BENCH_ERROR[] = "ERROR";
+static constexpr char BENCH_FILL[] = "FILL";
+
+//same no-match line, keyword set fixed at compile time
+//arg0 = 0 runtime simd matcher / 1 StaticKeywordMatcher / 2 static behind KeywordMatcher
+//arg1 = 0 no match / 1 hit at the end of the line
+static void BM_StaticKeywordMatcher(benchmark::State& state) {
+    using Matcher = StaticKeywordMatcher<BENCH_REJECT, BENCH_ERROR, BENCH_FILL>;
+    KeywordMatcher runtime(Matcher::keywords(), KeywordMatcher::Engine::Simd);
+    KeywordMatcher wrapped(Matcher::keywords(), &Matcher::matches);
+    std::string line = "[2024-10-15 12:34:56.789123] EXECUTION OrderID=482913 Symbol=GOOGL "
+                       "Side=SELL Type=LIMIT Price=321.45 Qty=4200 Venue=NYSE Latency=231us";
+    if (state.range(1)) line += " FILL";
+    
+    const int64_t mode = state.range(0);
+    for (auto _ : state) {
+        if (mode == 0) {
+            benchmark::DoNotOptimize(runtime.matches(line));
+        } else if (mode == 1) {
+            benchmark::DoNotOptimize(Matcher::matches(line));
+        } else {
+            benchmark::DoNotOptimize(wrapped.matches(line));
+        }
+    }
+    
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_StaticKeywordMatcher)
+    ->ArgNames({"mode", "hit"})
+    ->ArgsProduct({{0, 1, 2}, {0, 1}});
+
+//match modes on the no-match generator line
+//arg0 = 0 case-sensitive / 1 ignore case (folded in the kernel) /
+//       2 ignore case by lower casing a copy of each line / 3 whole word
+//arg1 = 0 simd / 1 automaton
+static void BM_KeywordMatcherModes(benchmark::State& state) {
+    const int64_t mode = state.range(0);
+    KeywordMatcher::Options options;
+    options.engine = state.range(1) ? KeywordMatcher::Engine::Automaton : KeywordMatcher::Engine::Simd;
+    options.ignoreCase = mode == 1;
+    options.wholeWord = mode == 3;
+    KeywordMatcher matcher(mode == 2 ? std::vector<std::string>{"reject", "error", "fill"}
+                                     : std::vector<std::string>{"REJECT", "ERROR", "FILL"},
+                           {}, options);
+    std::string line = "[2024-10-15 12:34:56.789123] EXECUTION OrderID=482913 Symbol=GOOGL "
+                       "Side=SELL Type=LIMIT Price=321.45 Qty=4200 Venue=NYSE Latency=231us";
+    
+    std::string lowered;
+    for (auto _ : state) {
+        if (mode == 2) {
+            lowered.assign(line);
+            std::transform(lowered.begin(), lowered.end(), lowered.begin(),
+                           [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            benchmark::DoNotOptimize(matcher.matches(lowered));
+        } else {
+            benchmark::DoNotOptimize(matcher.matches(line));
+        }
+    }
+    
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_KeywordMatcherModes)
+    ->ArgNames({"mode", "automaton"})
+    ->ArgsProduct({{0, 1, 2, 3}, {0, 1}});
+
 //check for long lines truncation
 static void BM_KeywordMatcher_LongLine(benchmark::State& state) {
     KeywordMatcher matcher({"EXECUTION"});
@@ -65,6 +193,155 @@ static void BM_KeywordMatcher_LongLine(benchmark::State& state) {
 }
 BENCHMARK(BM_KeywordMatcher_LongLine);
 
+//same 10KB line, each search kernel on its own (arg = simd::Kernel)
+//scalar is the std::string_view::find path used by Engine::Linear
+static void BM_KeywordMatcher_LongLineKernel(benchmark::State& state) {
+    auto kernel = static_cast<simd::Kernel>(state.range(0));
+    if (!simd::isSupported(kernel)) {
+        state.SkipWithError("kernel not supported on this CPU");
+        return;
+    }
+    auto search = simd::searchFunction(kernel);
+    std::string line(5000, 'X');
+    line += "EXECUTION";
+    line += std::string(5000, 'Y');
+    
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(search(line.data(), line.size(), "EXECUTION", 9));
+    }
+    
+    state.SetLabel(simd::kernelName(kernel));
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * line.size());
+}
+BENCHMARK(BM_KeywordMatcher_LongLineKernel)->DenseRange(0, 3);
+
+// routing a line to 4 outputs (alerts, fills, cancels, watchlist)
+//arg0 = 0 one matcher per output (a pass each), 1 one grouped matcher (matchGroups)
+static void BM_RoutedMatch(benchmark::State& state) {
+    std::vector<std::vector<std::string>> routes = {
+        {"REJECT", "ERROR"}, {"FILL", "EXECUTION"}, {"CANCEL"}, {"NVDA", "GOOGL", "META"}};
+    std::vector<std::string> lines = {
+        "2024-10-15 12:34:56.789123 EXECUTION OrderID=123456 Symbol=AAPL Side=BUY",
+        "2024-10-15 12:34:56.789124 NEW OrderID=123457 Symbol=MSFT Side=SELL",
+        "2024-10-15 12:34:56.789125 REJECT OrderID=123458 Symbol=NVDA Reason=RISK",
+        "2024-10-15 12:34:56.789126 CANCEL OrderID=123459 Symbol=TSLA"};
+    
+    std::vector<std::unique_ptr<KeywordMatcher>> perOutput;
+    std::vector<std::string> all;
+    std::vector<KeywordMatcher::GroupMask> groups;
+    for (size_t r = 0; r < routes.size(); ++r) {
+        perOutput.push_back(std::make_unique<KeywordMatcher>(routes[r]));
+        for (const auto& keyword : routes[r]) {
+            all.push_back(keyword);
+            groups.push_back(KeywordMatcher::GroupMask(1) << r);
+        }
+    }
+    KeywordMatcher grouped(all, groups);
+    
+    size_t i = 0;
+    for (auto _ : state) {
+        const std::string& line = lines[i++ % lines.size()];
+        KeywordMatcher::GroupMask hit = 0;
+        if (state.range(0)) {
+            hit = grouped.matchGroups(line);
+        } else {
+            for (size_t r = 0; r < perOutput.size(); ++r) {
+                if (perOutput[r]->matches(line)) hit |= KeywordMatcher::GroupMask(1) << r;
+            }
+        }
+        benchmark::DoNotOptimize(hit);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RoutedMatch)->ArgName("grouped")->DenseRange(0, 1);
+
+
+// "Latency>300 AND Symbol=NVDA" over generator-style lines, 1 in 8 is NVDA
+//arg0 = 0 tokenize every line (evaluate), 1 substring prefilter first (matches)
+static void BM_FieldFilter(benchmark::State& state) {
+    const char* symbols[] = {"AAPL", "MSFT", "GOOGL", "AMZN", "NVDA", "META", "TSLA", "JPM"};
+    std::vector<std::string> lines;
+    for (int i = 0; i < 64; ++i) {
+        lines.push_back("[2024-10-15 12:34:56.789123] EXECUTION OrderID=" + std::to_string(100000 + i) +
+                        " Symbol=" + symbols[i % 8] + " Side=BUY Type=LIMIT Price=123.45 Qty=" +
+                        std::to_string(100 + i) + " Venue=NYSE Latency=" + std::to_string(i * 7 % 500) + "us");
+    }
+    FieldFilter filter("Latency>300 AND Symbol=NVDA");  // numeric side first: tokenized on every line without the prefilter
+    
+    size_t i = 0;
+    for (auto _ : state) {
+        const std::string& line = lines[i++ % lines.size()];
+        benchmark::DoNotOptimize(state.range(0) ? filter.matches(line) : filter.evaluate(line));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FieldFilter)->ArgName("prefilter")->DenseRange(0, 1);
+
+
+//matched line output cost per flush policy (arg = OutputWriter::FlushPolicy)
+static void BM_OutputWriter_FlushPolicy(benchmark::State& state) {
+    const std::string outputFile = "writer_bench.log";
+    OutputWriter::Options options;
+    options.policy = static_cast<OutputWriter::FlushPolicy>(state.range(0));
+    
+    // a read buffer full of matched lines, handed over the way LogMonitor does
+    std::string buffer;
+    while (buffer.size() < 64 * 1024 - 128) {
+        buffer += "2024-10-15 12:34:56.789123 EXECUTION OrderID=123456 Symbol=AAPL Side=BUY\n";
+    }
+    
+    fs::remove(outputFile);
+    {
+        OutputWriter writer(outputFile, options);
+        for (auto _ : state) {
+            for (size_t pos = 0, nl; (nl = buffer.find('\n', pos)) != std::string::npos; pos = nl + 1) {
+                writer.writeLine(std::string_view(buffer).substr(pos, nl - pos), true);
+            }
+            writer.endOfBuffer();
+        }
+        state.counters["flushes_per_buffer"] = benchmark::Counter(
+            static_cast<double>(writer.flushCount()), benchmark::Counter::kAvgIterations);
+    }
+    fs::remove(outputFile);
+    
+    state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+BENCHMARK(BM_OutputWriter_FlushPolicy)->ArgName("policy")->DenseRange(0, 3);
+
+// parallel filtering of an in-memory backlog region (~64MB)
+//arg0 = threads (caller included)
+static void BM_ParallelScan(benchmark::State& state) {
+    static const std::string region = [] {
+        std::string text;
+        for (int i = 0; text.size() < 64 * 1024 * 1024; ++i) {
+            text += "2024-10-15 12:34:56.789123 EXECUTION OrderID=" + std::to_string(i) +
+                    (i % 100 == 0 ? " REJECT\n" : " Symbol=AAPL Side=BUY\n");
+        }
+        return text;
+    }();
+    
+    KeywordMatcher matcher({"REJECT"});
+    ParallelScanner scanner(matcher, static_cast<size_t>(state.range(0)),
+                            LogMonitor::MAX_LINE_LENGTH);
+    uint64_t matched = 0;
+    
+    for (auto _ : state) {
+        auto result = scanner.scan(region.data(), region.size(),
+                                   [&matched](std::string_view) { matched++; });
+        benchmark::DoNotOptimize(result);
+    }
+    
+    state.SetBytesProcessed(state.iterations() * region.size());
+    benchmark::DoNotOptimize(matched);
+}
+BENCHMARK(BM_ParallelScan)
+    ->ArgName("threads")
+    ->RangeMultiplier(2)
+    ->Range(1, 32)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
 // bench line processing throughput
 class BenchmarkFixture : public benchmark::Fixture {
 public:
@@ -84,11 +361,14 @@ public:
     std::string outputFile_;
 };
 
-BENCHMARK_F(BenchmarkFixture, BM_ProcessShortLines)(benchmark::State& state) {
-    // create test file with 10000 short lines
+//arg0 = scan mode (0 per-line, 1 whole-buffer)
+//arg1 = match rate (0 = no line matches, 1 = every line matches)
+BENCHMARK_DEFINE_F(BenchmarkFixture, BM_ProcessShortLines)(benchmark::State& state) {
+    // create test file with 100000 short lines
+    constexpr int lineCount = 100000;
     {
         std::ofstream ofs(testFile_);
-        for (int i = 0; i < 10000; ++i) {
+        for (int i = 0; i < lineCount; ++i) {
             ofs << "2024-10-15 12:34:56.789123 EXECUTION OrderID=" << i 
                 << " Symbol=AAPL Side=BUY Price=150.25 Qty=100\n";
         }
@@ -100,25 +380,65 @@ BENCHMARK_F(BenchmarkFixture, BM_ProcessShortLines)(benchmark::State& state) {
         LogMonitor::Config config;
         config.inputFile = testFile_;
         config.outputFile = outputFile_;
-        config.keywords = {"EXECUTION"};
+        config.keywords = {state.range(1) ? "EXECUTION" : "REJECT"};
         config.pollIntervalMs = 0;
+        config.scanMode = state.range(0) ? LogMonitor::ScanMode::WholeBuffer
+                                         : LogMonitor::ScanMode::PerLine;
         
         LogMonitor monitor(config);
         state.ResumeTiming();
-        //THREAD STARTS HERE 
-        std::thread t([&monitor]() {
-            monitor.start();
-        });
         
-        std::this_thread::sleep_for(std::chrono::milliseconds(100)); //need time to process here for cpu
-        monitor.stop();
-        t.join(); //join back thread
+        auto stats = monitor.runUntilEof();
+        state.SetItemsProcessed(state.items_processed() + stats.linesProcessed);
+        state.SetBytesProcessed(state.bytes_processed() + stats.bytesRead);
+    }
+}
+BENCHMARK_REGISTER_F(BenchmarkFixture, BM_ProcessShortLines)
+    ->ArgNames({"whole_buffer", "match_all"})
+    ->ArgsProduct({{0, 1}, {0, 1}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// single-threaded vs pipelined with a slow (per-line flush) writer, every
+// line matches so output is the bottleneck stage
+//arg0 = 0 single thread, 1 pipelined (1 matcher)
+BENCHMARK_DEFINE_F(BenchmarkFixture, BM_Pipelined)(benchmark::State& state) {
+    constexpr int lineCount = 100000;
+    {
+        std::ofstream ofs(testFile_);
+        for (int i = 0; i < lineCount; ++i) {
+            ofs << "2024-10-15 12:34:56.789123 EXECUTION OrderID=" << i
+                << " Symbol=AAPL Side=BUY Price=150.25 Qty=100\n";
+        }
+    }
+    
+    LogMonitor::Statistics last;
+    for (auto _ : state) {
+        state.PauseTiming();
+        fs::remove(outputFile_);
+        LogMonitor::Config config;
+        config.inputFile = testFile_;
+        config.outputFile = outputFile_;
+        config.keywords = {"EXECUTION"};
+        config.mmapWindowSize = 0;
+        config.pipelined = state.range(0) != 0;
+        
+        LogMonitor monitor(config);
+        state.ResumeTiming();
         
-        auto stats = monitor.getStatistics();
-        state.SetItemsProcessed(stats.linesProcessed);
-        state.SetBytesProcessed(stats.bytesRead);
+        last = monitor.runUntilEof();
     }
+    
+    state.SetItemsProcessed(state.iterations() * lineCount);
+    state.counters["reader_stalls"] = static_cast<double>(last.readerStalls);
+    state.counters["matcher_stalls"] = static_cast<double>(last.matcherStalls);
+    state.counters["writer_stalls"] = static_cast<double>(last.writerStalls);
 }
+BENCHMARK_REGISTER_F(BenchmarkFixture, BM_Pipelined)
+    ->ArgName("pipelined")
+    ->DenseRange(0, 1)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
 
 //bench mixed lines
 //mix of matching + nonmatching lines
@@ -149,27 +469,23 @@ BENCHMARK_F(BenchmarkFixture, BM_ProcessMixedLines)(benchmark::State& state) {
         LogMonitor monitor(config);
         state.ResumeTiming();
         
-        std::thread t([&monitor]() {
-            monitor.start(); //similar as above
-        });
-        
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        monitor.stop();
-        t.join();
-        
-        auto stats = monitor.getStatistics();
-        state.SetItemsProcessed(stats.linesProcessed);
-        state.SetBytesProcessed(stats.bytesRead);
+        auto stats = monitor.runUntilEof();
+        state.SetItemsProcessed(state.items_processed() + stats.linesProcessed);
+        state.SetBytesProcessed(state.bytes_processed() + stats.bytesRead);
     }
 }
 
-//process long lines
-BENCHMARK_F(BenchmarkFixture, BM_ProcessLongLines)(benchmark::State& state) {
-    // Create test file with very long lines
+//process long lines, 64MB of them whatever the length
+//arg0 = line length in bytes (6000 just over the limit, 1MB mostly discarded)
+//arg1 = backlog path (0 read() buffers, 1 mmap catch-up)
+BENCHMARK_DEFINE_F(BenchmarkFixture, BM_ProcessLongLines)(benchmark::State& state) {
+    const size_t lineLength = static_cast<size_t>(state.range(0));
+    const int lineCount = static_cast<int>((64 * 1024 * 1024) / lineLength);
     {
         std::ofstream ofs(testFile_);
-        for (int i = 0; i < 1000; ++i) {
-            ofs << "EXECUTION " << std::string(6000, 'X') << "\n";
+        const std::string filler(lineLength - 11, 'X');
+        for (int i = 0; i < lineCount; ++i) {
+            ofs << "EXECUTION " << filler << "\n";
         }
     }
     
@@ -181,25 +497,24 @@ BENCHMARK_F(BenchmarkFixture, BM_ProcessLongLines)(benchmark::State& state) {
         config.outputFile = outputFile_;
         config.keywords = {"EXECUTION"};
         config.pollIntervalMs = 0;
+        config.mmapWindowSize = state.range(1) ? LogMonitor::DEFAULT_MMAP_WINDOW : 0;
         
         LogMonitor monitor(config);
         state.ResumeTiming();
         
-        std::thread t([&monitor]() {
-            monitor.start(); //similar as above
-        });
-        
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        monitor.stop();
-        t.join();
-        
-        auto stats = monitor.getStatistics();
-        state.SetItemsProcessed(stats.linesProcessed);
-        state.SetBytesProcessed(stats.bytesRead);
+        auto stats = monitor.runUntilEof();
+        state.SetItemsProcessed(state.items_processed() + stats.linesProcessed);
+        state.SetBytesProcessed(state.bytes_processed() + stats.bytesRead);
     }
 }
+BENCHMARK_REGISTER_F(BenchmarkFixture, BM_ProcessLongLines)
+    ->ArgNames({"line", "mmap"})
+    ->ArgsProduct({{6000, 1024 * 1024}, {0, 1}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
 
 // Benchmark different buffer sizeson throughput
+//arg0 = buffer size, arg1 = input backend (0 ifstream, 1 pread)
 static void BM_BufferSize(benchmark::State& state) {
     std::string testFile = "buffer_bench.log";
     std::string outputFile = "buffer_out.log";
@@ -224,26 +539,765 @@ static void BM_BufferSize(benchmark::State& state) {
         config.keywords = {"EXECUTION"};
         config.bufferSize = bufferSize;
         config.pollIntervalMs = 0;
+        config.inputBackend = state.range(1) ? LogMonitor::InputBackend::Posix
+                                             : LogMonitor::InputBackend::Stream;
+        config.flushPolicy = LogMonitor::FlushPolicy::PerBuffer;  // keep output writes from masking the read path
+        
+        LogMonitor monitor(config);
+        state.ResumeTiming();
+        
+        auto stats = monitor.runUntilEof();
+        state.SetItemsProcessed(state.items_processed() + stats.linesProcessed);
+        state.SetBytesProcessed(state.bytes_processed() + stats.bytesRead);
+    }
+    
+    fs::remove(testFile);
+    fs::remove(outputFile);
+}
+BENCHMARK(BM_BufferSize)
+    ->ArgNames({"buffer", "pread"})
+    ->ArgsProduct({benchmark::CreateRange(4096, 256 * 1024, 2), {0, 1}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// cold start against an existing backlog (~60MB, 1M lines)
+//arg0 = 0 read loop only, 1 mmap catch-up then tail
+static void BM_ColdStartBacklog(benchmark::State& state) {
+    std::string testFile = "backlog_bench.log";
+    std::string outputFile = "backlog_out.log";
+    constexpr int lineCount = 1000000;
+    {
+        std::ofstream ofs(testFile);
+        for (int i = 0; i < lineCount; ++i) {
+            ofs << "2024-10-15 12:34:56.789123 EXECUTION OrderID=" << i << " Symbol=AAPL\n";
+        }
+    }
+    
+    for (auto _ : state) {
+        state.PauseTiming();
+        fs::remove(outputFile);
+        
+        LogMonitor::Config config;
+        config.inputFile = testFile;
+        config.outputFile = outputFile;
+        config.keywords = {"REJECT"};
+        config.mmapWindowSize = state.range(0) ? LogMonitor::DEFAULT_MMAP_WINDOW : 0;
         
         LogMonitor monitor(config);
         state.ResumeTiming();
         
-        std::thread t([&monitor]() {
-            monitor.start();
+        auto stats = monitor.runUntilEof();
+        state.SetBytesProcessed(state.bytes_processed() + stats.bytesRead);
+    }
+    
+    fs::remove(testFile);
+    fs::remove(outputFile);
+}
+BENCHMARK(BM_ColdStartBacklog)
+    ->ArgName("mmap")
+    ->DenseRange(0, 1)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// full pipeline over 1M generator-style lines (~130MB, 1 in 8 matches):
+// read/map, split, match, write, final flush; reports GB/s and lines/s
+//arg0 = path (0 read() buffers, 1 mmap catch-up, 2 mmap + 4 scan threads, 3 pipelined)
+static void BM_EndToEndThroughput(benchmark::State& state) {
+    std::string testFile = "e2e_bench.log";
+    std::string outputFile = "e2e_out.log";
+    const char* statuses[] = {"EXECUTION", "NEW", "ACK", "PENDING", "NEW", "ACK", "REPLACE", "NEW"};
+    const char* symbols[] = {"AAPL", "MSFT", "GOOGL", "AMZN", "NVDA", "META", "TSLA", "JPM"};
+    constexpr int lineCount = 1000000;
+    {
+        std::ofstream ofs(testFile);
+        for (int i = 0; i < lineCount; ++i) {
+            ofs << "[2024-10-15 12:34:56." << (100000 + i % 900000) << "] " << statuses[i % 8]
+                << " OrderID=" << (100000 + i) << " Symbol=" << symbols[(i / 8) % 8]
+                << " Side=BUY Type=LIMIT Price=123.45 Qty=" << (100 + i % 9900)
+                << " Venue=NYSE Latency=" << (i * 7 % 500) << "us\n";
+        }
+    }
+    
+    for (auto _ : state) {
+        state.PauseTiming();
+        fs::remove(outputFile);
+        LogMonitor::Config config;
+        config.inputFile = testFile;
+        config.outputFile = outputFile;
+        config.keywords = {"EXECUTION"};
+        config.flushPolicy = LogMonitor::FlushPolicy::PerBuffer;
+        config.mmapWindowSize = state.range(0) == 1 || state.range(0) == 2 ? LogMonitor::DEFAULT_MMAP_WINDOW : 0;
+        config.scanThreads = state.range(0) == 2 ? 4 : 1;
+        config.pipelined = state.range(0) == 3;
+        
+        LogMonitor monitor(config);
+        state.ResumeTiming();
+        
+        auto stats = monitor.runUntilEof();
+        state.SetItemsProcessed(state.items_processed() + stats.linesProcessed);
+        state.SetBytesProcessed(state.bytes_processed() + stats.bytesRead);
+    }
+    
+    fs::remove(testFile);
+    fs::remove(outputFile);
+}
+BENCHMARK(BM_EndToEndThroughput)
+    ->ArgName("path")
+    ->DenseRange(0, 3)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// BM_EndToEndThroughput's workload per buffer placement; "backing" is the
+// Arena::Backing the monitor got (0 heap, 1 THP, 2 hugetlb) and "node" the
+// NUMA node the monitor thread ran on. Pinning uses the first allowed CPUs
+// (monitor, matcher, writer), and the thread's affinity is restored after
+//arg0 = placement (0 default, 1 huge pages, 2 pinned, 3 pinned + huge pages)
+//arg1 = path (0 read() buffers, 1 pipelined)
+static void BM_Placement(benchmark::State& state) {
+    const bool huge = state.range(0) == 1 || state.range(0) == 3;
+    const bool pinned = state.range(0) >= 2;
+    std::string testFile = "placement_bench.log";
+    std::string outputFile = "placement_out.log";
+    {
+        const char* statuses[] = {"EXECUTION", "NEW", "ACK", "PENDING", "NEW", "ACK", "REPLACE", "NEW"};
+        std::ofstream ofs(testFile);
+        for (int i = 0; i < 1000000; ++i) {
+            ofs << "[2024-10-15 12:34:56." << (100000 + i % 900000) << "] " << statuses[i % 8]
+                << " OrderID=" << (100000 + i) << " Symbol=AAPL Side=BUY Type=LIMIT Price=123.45 Qty="
+                << (100 + i % 9900) << " Venue=NYSE Latency=" << (i * 7 % 500) << "us\n";
+        }
+    }
+    std::vector<int> cpus;
+    for (int cpu = 0; cpu < 1024 && cpus.size() < 3; ++cpu) {
+        if (cpuAllowed(cpu)) cpus.push_back(cpu);
+    }
+    if (pinned && cpus.empty()) {
+        state.SkipWithError("CPU pinning unavailable");
+        return;
+    }
+#if defined(__linux__)
+    cpu_set_t saved;
+    sched_getaffinity(0, sizeof(saved), &saved);
+#endif
+    
+    int backing = 0;
+    int node = -1;
+    for (auto _ : state) {
+        state.PauseTiming();
+        fs::remove(outputFile);
+        LogMonitor::Config config;
+        config.inputFile = testFile;
+        config.outputFile = outputFile;
+        config.keywords = {"EXECUTION"};
+        config.flushPolicy = LogMonitor::FlushPolicy::PerBuffer;
+        config.mmapWindowSize = 0;
+        config.pipelined = state.range(1) == 1;
+        config.hugePages = huge;
+        if (pinned) {
+            config.monitorCpu = cpus[0];
+            config.pipelineCpus = {cpus[1 % cpus.size()], cpus[2 % cpus.size()]};
+        }
+        LogMonitor monitor(config);
+        state.ResumeTiming();
+        
+        auto stats = monitor.runUntilEof();
+        state.SetBytesProcessed(state.bytes_processed() + stats.bytesRead);
+        backing = static_cast<int>(monitor.arena().backing());
+        node = currentNumaNode();
+    }
+    state.counters["backing"] = backing;
+    state.counters["node"] = node;
+    
+#if defined(__linux__)
+    sched_setaffinity(0, sizeof(saved), &saved);
+#endif
+    fs::remove(testFile);
+    fs::remove(outputFile);
+}
+BENCHMARK(BM_Placement)
+    ->ArgNames({"placement", "path"})
+    ->ArgsProduct({{0, 1, 2, 3}, {0, 1}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// filtering a rotated, compressed log: 500k generator-style lines (~65MB raw)
+// decompressed into the read buffer, against the old way of decompressing
+// to disk first; GB/s is of decompressed text
+//arg0 = input (0 plain, 1 gzip streamed, 2 gzip to disk then scanned, 3 zstd 1MB frames streamed)
+//arg1 = decompress threads (zstd only)
+static void BM_CompressedInput(benchmark::State& state) {
+    const int input = static_cast<int>(state.range(0));
+    const size_t threads = static_cast<size_t>(state.range(1));
+    std::string rawFile = "compressed_bench.log";
+    std::string compressedFile = input == 3 ? "compressed_bench.log.zst" : "compressed_bench.log.gz";
+    std::string outputFile = "compressed_bench_out.log";
+    
+    std::string raw;
+    {
+        std::vector<std::string> statuses = {"NEW", "ACK", "PENDING", "REPLACE", "NEW", "ACK", "PENDING", "EXECUTION"};
+        std::ostringstream out;
+        for (int i = 0; i < 500000; ++i) {
+            out << "[2024-10-15 12:34:56." << (100000 + i % 900000) << "] " << statuses[i % 8]
+                << " OrderID=" << (100000 + i) << " Symbol=AAPL Side=BUY Type=LIMIT Price=123.45 Qty="
+                << (100 + i % 9900) << " Venue=NYSE Latency=" << (i * 7 % 500) << "us\n";
+        }
+        raw = out.str();
+    }
+    std::string packed;
+    if (input == 1 || input == 2) {
+#if LOG_MONITOR_GZIP
+        z_stream zs{};
+        deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+        packed.resize(deflateBound(&zs, raw.size()));
+        zs.next_in = reinterpret_cast<Bytef*>(&raw[0]);
+        zs.avail_in = static_cast<uInt>(raw.size());
+        zs.next_out = reinterpret_cast<Bytef*>(&packed[0]);
+        zs.avail_out = static_cast<uInt>(packed.size());
+        deflate(&zs, Z_FINISH);
+        packed.resize(zs.total_out);
+        deflateEnd(&zs);
+#else
+        state.SkipWithError("built without zlib");
+        return;
+#endif
+    } else if (input == 3) {
+#if LOG_MONITOR_ZSTD
+        // one frame per MB, as pzstd writes, so frames can go to threads
+        for (size_t pos = 0; pos < raw.size(); pos += 1024 * 1024) {
+            const size_t len = std::min<size_t>(1024 * 1024, raw.size() - pos);
+            std::string frame(ZSTD_compressBound(len), '\0');
+            frame.resize(ZSTD_compress(&frame[0], frame.size(), raw.data() + pos, len, 3));
+            packed += frame;
+        }
+#else
+        state.SkipWithError("built without zstd");
+        return;
+#endif
+    }
+    std::ofstream(input == 0 ? rawFile : compressedFile, std::ios::binary) << (input == 0 ? raw : packed);
+    
+    for (auto _ : state) {
+        state.PauseTiming();
+        fs::remove(outputFile);
+        fs::remove(input == 2 ? rawFile : outputFile);
+        state.ResumeTiming();
+        
+        LogMonitor::Config config;
+        config.inputFile = input == 0 || input == 2 ? rawFile : compressedFile;
+        config.outputFile = outputFile;
+        config.keywords = {"EXECUTION"};
+        config.flushPolicy = LogMonitor::FlushPolicy::PerBuffer;
+        config.mmapWindowSize = 0;
+        if (input == 1 || input == 3) {
+            config.inputBackend = LogMonitor::InputBackend::Compressed;
+            config.decompressThreads = threads;
+        }
+        if (input == 2) {
+            // gunzip > file, then scan: pays a raw-sized write and read
+            CompressedInputSource source;
+            source.open(compressedFile);
+            std::ofstream out(rawFile, std::ios::binary);
+            std::vector<char> buffer(1024 * 1024);
+            uint64_t offset = 0;
+            ssize_t n;
+            while ((n = source.read(buffer.data(), buffer.size(), offset)) > 0) {
+                out.write(buffer.data(), n);
+                offset += static_cast<uint64_t>(n);
+            }
+        }
+        
+        LogMonitor monitor(config);
+        auto stats = monitor.runUntilEof();
+        state.SetBytesProcessed(state.bytes_processed() + stats.bytesRead);
+    }
+    state.counters["ratio"] = packed.empty() ? 1.0 : static_cast<double>(raw.size()) / packed.size();
+    
+    fs::remove(rawFile);
+    fs::remove(compressedFile);
+    fs::remove(outputFile);
+}
+BENCHMARK(BM_CompressedInput)
+    ->ArgNames({"input", "threads"})
+    ->Args({0, 1})
+    ->Args({1, 1})
+    ->Args({2, 1})
+    ->Args({3, 1})
+    ->Args({3, 4})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// matched-output heavy run: 500k generator-style lines (~65MB), every one
+// matches, so the output is as large as the input; bytes/s is of matched
+// text and "disk" is the output file size
+//arg0 = output (0 plain, 1 gzip, 2 zstd)
+static void BM_CompressedOutput(benchmark::State& state) {
+    const auto compression = static_cast<LogMonitor::Compression>(state.range(0));
+    if (!CompressedSink::supported(compression)) {
+        state.SkipWithError("compression not compiled in");
+        return;
+    }
+    std::string testFile = "compressed_out_bench.log";
+    std::string outputFile = "compressed_out_bench_out.log";
+    {
+        std::vector<std::string> statuses = {"NEW", "ACK", "PENDING", "REPLACE", "NEW", "ACK", "PENDING", "EXECUTION"};
+        std::ofstream out(testFile);
+        for (int i = 0; i < 500000; ++i) {
+            out << "[2024-10-15 12:34:56." << (100000 + i % 900000) << "] " << statuses[i % 8]
+                << " OrderID=" << (100000 + i) << " Symbol=AAPL Side=BUY Type=LIMIT Price=123.45 Qty="
+                << (100 + i % 9900) << " Venue=NYSE Latency=" << (i * 7 % 500) << "us\n";
+        }
+    }
+    
+    uint64_t diskBytes = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        fs::remove(outputFile);
+        state.ResumeTiming();
+        
+        LogMonitor::Config config;
+        config.inputFile = testFile;
+        config.outputFile = outputFile;
+        config.keywords = {"Venue=NYSE"};
+        config.flushPolicy = LogMonitor::FlushPolicy::PerBuffer;
+        config.mmapWindowSize = 0;
+        config.outputCompression = compression;
+        {
+            LogMonitor monitor(config);  // destructor waits for the last frame
+            monitor.runUntilEof();
+        }
+        diskBytes = fs::file_size(outputFile);
+        state.SetBytesProcessed(state.bytes_processed() + fs::file_size(testFile));
+    }
+    state.counters["disk_mb"] = static_cast<double>(diskBytes) / (1024 * 1024);
+    
+    fs::remove(testFile);
+    fs::remove(outputFile);
+}
+BENCHMARK(BM_CompressedOutput)
+    ->ArgName("output")
+    ->DenseRange(0, 2)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// cost of --trace on the per-line path: 1M short lines, 1 in 8 matches
+//arg0 = 0 tracing off, 1 tracing on
+static void BM_TraceOverhead(benchmark::State& state) {
+    std::string testFile = "trace_bench.log";
+    std::string outputFile = "trace_out.log";
+    constexpr int lineCount = 1000000;
+    {
+        std::ofstream ofs(testFile);
+        for (int i = 0; i < lineCount; ++i) {
+            ofs << "2024-10-15 12:34:56.789123 " << (i % 8 ? "NEW" : "EXECUTION")
+                << " OrderID=" << i << " Symbol=AAPL\n";
+        }
+    }
+    
+    for (auto _ : state) {
+        state.PauseTiming();
+        fs::remove(outputFile);
+        LogMonitor::Config config;
+        config.inputFile = testFile;
+        config.outputFile = outputFile;
+        config.keywords = {"EXECUTION"};
+        config.flushPolicy = LogMonitor::FlushPolicy::PerBuffer;
+        config.mmapWindowSize = 0;
+        config.trace = state.range(0) != 0;
+        LogMonitor monitor(config);
+        state.ResumeTiming();
+        
+        auto stats = monitor.runUntilEof();
+        state.SetItemsProcessed(state.items_processed() + stats.linesProcessed);
+    }
+    
+    fs::remove(testFile);
+    fs::remove(outputFile);
+}
+BENCHMARK(BM_TraceOverhead)
+    ->ArgName("trace")
+    ->DenseRange(0, 1)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// write-to-output latency under a steady load: a generator thread appends
+// one batch every 100us at the target rate, each line stamped with the
+// steady_clock time of its write(); this thread waits for output changes
+// and records arrival - stamp per line into a histogram
+//arg0 = lines/s, arg1 = flush policy (0 per line, 1 per buffer)
+static void BM_WriteToOutputLatency(benchmark::State& state) {
+    std::string testFile = "load_bench.log";
+    std::string outputFile = "load_out.log";
+    const uint64_t rate = static_cast<uint64_t>(state.range(0));
+    constexpr auto duration = std::chrono::seconds(1);
+    const uint64_t total = rate * static_cast<uint64_t>(duration.count());
+    
+    auto nowNs = []() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    };
+    
+    LatencyHistogram histogram;
+    for (auto _ : state) {
+        fs::remove(testFile);
+        fs::remove(outputFile);
+        std::ofstream(testFile).close();
+        std::ofstream(outputFile).close();
+        
+        LogMonitor::Config config;
+        config.inputFile = testFile;
+        config.outputFile = outputFile;
+        config.keywords = {"EXECUTION"};
+        config.flushPolicy = state.range(1) ? LogMonitor::FlushPolicy::PerBuffer
+                                            : LogMonitor::FlushPolicy::PerLine;
+        LogMonitor monitor(config);
+        FileWatcher outputWatch(outputFile);
+        std::thread t([&monitor]() { monitor.start(); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));  // let it go idle
+        
+        std::thread generator([&]() {
+            int fd = ::open(testFile.c_str(), O_WRONLY | O_APPEND);
+            std::string batch;
+            char stamp[24];
+            uint64_t sent = 0;
+            auto start = std::chrono::steady_clock::now();
+            for (auto tick = start; sent < total; tick += std::chrono::microseconds(100)) {
+                std::this_thread::sleep_until(tick);
+                uint64_t due = std::min<uint64_t>(total,
+                    static_cast<uint64_t>(std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - start).count() * rate) + 1);
+                batch.clear();
+                char* end = std::to_chars(stamp, stamp + sizeof(stamp), nowNs()).ptr;
+                for (; sent < due; ++sent) {
+                    batch += "[2024-10-15 12:34:56.789123] EXECUTION OrderID=123456 Symbol=AAPL Sent=";
+                    batch.append(stamp, end);
+                    batch += '\n';
+                }
+                (void)!::write(fd, batch.data(), batch.size());
+            }
+            ::close(fd);
         });
         
-        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        // read the output as it grows; stop once every line arrived
+        int fd = ::open(outputFile.c_str(), O_RDONLY);
+        std::vector<char> chunk(1024 * 1024);
+        std::string carry;
+        uint64_t offset = 0, received = 0;
+        auto deadline = std::chrono::steady_clock::now() + duration + std::chrono::seconds(10);
+        while (received < total && std::chrono::steady_clock::now() < deadline) {
+            ssize_t n = ::pread(fd, chunk.data(), chunk.size(), static_cast<off_t>(offset));
+            if (n <= 0) {
+                outputWatch.wait(10);
+                continue;
+            }
+            const uint64_t arrived = nowNs();
+            offset += static_cast<uint64_t>(n);
+            carry.append(chunk.data(), static_cast<size_t>(n));
+            size_t pos = 0, eol;
+            while ((eol = carry.find('\n', pos)) != std::string::npos) {
+                const char* sent = std::strstr(carry.c_str() + pos, "Sent=");
+                uint64_t stamp = 0;
+                if (sent && sent < carry.c_str() + eol) {
+                    std::from_chars(sent + 5, carry.c_str() + eol, stamp);
+                    histogram.record(arrived - stamp);
+                }
+                ++received;
+                pos = eol + 1;
+            }
+            carry.erase(0, pos);
+        }
+        ::close(fd);
+        
+        generator.join();
         monitor.stop();
         t.join();
+        if (received < total) {
+            state.SkipWithError("monitor did not write every line in time");
+        }
+    }
+    
+    state.counters["p50_us"] = histogram.percentile(50) / 1e3;
+    state.counters["p99_us"] = histogram.percentile(99) / 1e3;
+    state.counters["p999_us"] = histogram.percentile(99.9) / 1e3;
+    state.counters["max_us"] = histogram.max() / 1e3;
+    state.SetItemsProcessed(static_cast<int64_t>(histogram.count()));
+    
+    fs::remove(testFile);
+    fs::remove(outputFile);
+}
+BENCHMARK(BM_WriteToOutputLatency)
+    ->ArgNames({"rate", "buffered"})
+    ->ArgsProduct({{10000, 100000, 1000000}, {0, 1}})
+    ->Iterations(1)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// write-to-output latency of a single line on an idle monitor
+// the benchmark thread plays the log generator: append one matching line,
+// then spin until the monitor has written it to the output file
+//arg0 = 0 poll 10ms (old default), 1 busy poll (0ms), 2 inotify/kqueue event
+static void BM_TailLatency(benchmark::State& state) {
+    std::string testFile = "latency_bench.log";
+    std::string outputFile = "latency_out.log";
+    fs::remove(testFile);
+    fs::remove(outputFile);
+    std::ofstream(testFile).close();
+    
+    LogMonitor::Config config;
+    config.inputFile = testFile;
+    config.outputFile = outputFile;
+    config.keywords = {"EXECUTION"};
+    config.waitMode = state.range(0) == 2 ? LogMonitor::WaitMode::Event
+                                          : LogMonitor::WaitMode::Poll;
+    config.pollIntervalMs = state.range(0) == 0 ? 10 : 0;
+    
+    std::unique_ptr<LogMonitor> monitor;
+    try {
+        monitor = std::make_unique<LogMonitor>(config);
+    } catch (const std::exception& e) {
+        state.SkipWithError(e.what());
+        return;
+    }
+    std::thread t([&monitor]() { monitor->start(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));  // let it go idle
+    
+    std::ofstream generator(testFile, std::ios::app);
+    const std::string line = "2024-10-15 12:34:56.789123 EXECUTION OrderID=1 Symbol=AAPL\n";
+    uintmax_t outputSize = 0;
+    
+    for (auto _ : state) {
+        auto begin = std::chrono::steady_clock::now();
+        generator << line;
+        generator.flush();
+        
+        outputSize += line.size();
+        std::error_code ec;
+        while (fs::file_size(outputFile, ec) < outputSize) {
+            std::this_thread::yield();
+        }
+        auto end = std::chrono::steady_clock::now();
+        state.SetIterationTime(std::chrono::duration<double>(end - begin).count());
+        
+        // idle gap so every sample starts from a waiting monitor
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    
+    monitor->stop();
+    t.join();
+    state.SetItemsProcessed(state.iterations());
+    
+    fs::remove(testFile);
+    fs::remove(outputFile);
+}
+BENCHMARK(BM_TailLatency)
+    ->ArgName("wait")
+    ->DenseRange(0, 2)
+    ->UseManualTime()
+    ->Iterations(200)
+    ->Unit(benchmark::kMicrosecond);
+
+// one-minute time-range query over ~60MB covering about 3 hours
+//arg0 = 0 without index (one entry at 0: reads from the start), 1 with 1MB index
+static void BM_TimeRangeQuery(benchmark::State& state) {
+    std::string testFile = "query_bench.log";
+    std::string indexFile = "query_bench.idx";
+    constexpr int lineCount = 1000000;
+    {
+        std::ofstream ofs(testFile);
+        char stamp[64];
+        for (int i = 0; i < lineCount; ++i) {
+            int ms = i * 10;  // 100 lines per second
+            std::snprintf(stamp, sizeof(stamp), "[2024-10-15 %02d:%02d:%02d.%06d] ",
+                          9 + ms / 3600000, ms / 60000 % 60, ms / 1000 % 60, ms % 1000 * 1000);
+            ofs << stamp << "EXECUTION OrderID=" << i << " Symbol=AAPL\n";
+        }
+    }
+    {
+        std::ifstream in(testFile, std::ios::binary);
+        LineIndexWriter writer(indexFile, state.range(0) ? LineIndexWriter::DEFAULT_INTERVAL : UINT64_MAX);
+        writer.reset();
+        std::vector<char> chunk(LogMonitor::DEFAULT_BUFFER_SIZE);
+        while (in.read(chunk.data(), chunk.size()) || in.gcount() > 0) {
+            writer.consume(chunk.data(), static_cast<size_t>(in.gcount()));
+        }
+    }
+    
+    LineIndex index(indexFile);
+    auto input = InputSource::create(InputSource::Backend::Posix);
+    input->open(testFile);
+    int64_t from, to;
+    parseTimestamp("2024-10-15 11:40:00", from);  // near the end of the file
+    parseTimestamp("2024-10-15 11:41:00", to);
+    KeywordMatcher filter({"EXECUTION"});
+    
+    uint64_t scanned = 0;
+    for (auto _ : state) {
+        auto result = index.query(*input, from, to, &filter, [](std::string_view line) {
+            benchmark::DoNotOptimize(line.data());
+        });
+        scanned = result.bytesScanned;
+    }
+    state.counters["MB_scanned"] = static_cast<double>(scanned) / (1024 * 1024);
+    
+    input->close();
+    fs::remove(testFile);
+    fs::remove(indexFile);
+}
+BENCHMARK(BM_TimeRangeQuery)
+    ->ArgName("indexed")
+    ->DenseRange(0, 1)
+    ->Unit(benchmark::kMillisecond);
+
+// tail latency with many idle files in one MultiLogMonitor
+// same write-then-spin loop as BM_TailLatency, on a random one of N sources
+// that all share one output; idle sources should cost nothing per write
+//arg0 = source count
+static void BM_MultiSourceTail(benchmark::State& state) {
+    const size_t sources = static_cast<size_t>(state.range(0));
+    fs::path dir = "multi_bench";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    std::string outputFile = (dir / "out.log").string();
+    
+    MultiLogMonitor::Config config;
+    config.outputFile = outputFile;
+    config.keywords = {"EXECUTION"};
+    for (size_t i = 0; i < sources; ++i) {
+        std::string input = (dir / ("strategy_" + std::to_string(i) + ".log")).string();
+        std::ofstream(input).close();
+        config.sources.push_back({input, "", {}});
+    }
+    
+    MultiLogMonitor monitor(config);
+    std::thread t([&monitor]() { monitor.start(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));  // initial pass, then idle
+    
+    std::mt19937 rng(42);
+    const std::string line = "2024-10-15 12:34:56.789123 EXECUTION OrderID=1 Symbol=AAPL\n";
+    uintmax_t outputSize = 0;
+    
+    for (auto _ : state) {
+        std::ofstream generator(config.sources[rng() % sources].inputFile, std::ios::app);
+        auto begin = std::chrono::steady_clock::now();
+        generator << line;
+        generator.flush();
         
-        auto stats = monitor.getStatistics();
-        state.SetItemsProcessed(stats.linesProcessed);
-        state.SetBytesProcessed(stats.bytesRead);
+        outputSize += line.size();
+        std::error_code ec;
+        while (fs::file_size(outputFile, ec) < outputSize) {
+            std::this_thread::yield();
+        }
+        auto end = std::chrono::steady_clock::now();
+        state.SetIterationTime(std::chrono::duration<double>(end - begin).count());
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    
+    monitor.stop();
+    t.join();
+    state.counters["wakeups_per_line"] = static_cast<double>(monitor.wakeupCount()) / state.iterations();
+    state.SetItemsProcessed(state.iterations());
+    
+    fs::remove_all(dir);
+}
+BENCHMARK(BM_MultiSourceTail)
+    ->ArgName("sources")
+    ->Arg(1)
+    ->Arg(64)
+    ->Arg(512)
+    ->UseManualTime()
+    ->Iterations(200)
+    ->Unit(benchmark::kMicrosecond);
+
+// context lines on the per-line path: 1M short lines, 1 in 64 matches,
+// 4KB reads so most kept lines meet a refill before their match
+//arg0 = lines of context before and after (0 = off)
+static void BM_ContextLines(benchmark::State& state) {
+    std::string testFile = "context_bench.log";
+    std::string outputFile = "context_out.log";
+    constexpr int lineCount = 1000000;
+    {
+        std::ofstream ofs(testFile);
+        for (int i = 0; i < lineCount; ++i) {
+            ofs << "2024-10-15 12:34:56.789123 " << (i % 64 ? "NEW" : "EXECUTION")
+                << " OrderID=" << i << " Symbol=AAPL\n";
+        }
+    }
+    
+    uint64_t outputBytes = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        fs::remove(outputFile);
+        state.ResumeTiming();
+        
+        LogMonitor::Config config;
+        config.inputFile = testFile;
+        config.outputFile = outputFile;
+        config.keywords = {"EXECUTION"};
+        config.bufferSize = 4096;
+        config.flushPolicy = LogMonitor::FlushPolicy::PerBuffer;
+        config.mmapWindowSize = 0;
+        config.contextBefore = static_cast<size_t>(state.range(0));
+        config.contextAfter = static_cast<size_t>(state.range(0));
+        {
+            LogMonitor monitor(config);
+            monitor.runUntilEof();
+        }
+        outputBytes = fs::file_size(outputFile);
+    }
+    state.SetItemsProcessed(state.iterations() * lineCount);
+    state.counters["output_mb"] = static_cast<double>(outputBytes) / (1024 * 1024);
+    
+    fs::remove(testFile);
+    fs::remove(outputFile);
+}
+BENCHMARK(BM_ContextLines)
+    ->ArgName("context")
+    ->Arg(0)
+    ->Arg(2)
+    ->Arg(16)
+    ->Unit(benchmark::kMillisecond);
+
+// incident flood: 1M lines, a REJECT template on every other line with the
+// timestamp, OrderID and Price varying; PerLine flush, so every written
+// line is a write()
+//arg0 = repeat limit per 1s window (0 = off)
+static void BM_RepeatSuppression(benchmark::State& state) {
+    std::string testFile = "repeat_bench.log";
+    std::string outputFile = "repeat_out.log";
+    constexpr int lineCount = 1000000;
+    {
+        std::ofstream ofs(testFile);
+        for (int i = 0; i < lineCount; ++i) {
+            ofs << "2024-10-15 12:34:56." << (100000 + i % 900000) << (i % 2 ? " NEW" : " REJECT")
+                << " OrderID=" << (100000 + i) << " Symbol=AAPL Price=" << (100 + i % 50) << ".25\n";
+        }
+    }
+    
+    uint64_t suppressed = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        fs::remove(outputFile);
+        state.ResumeTiming();
+        
+        LogMonitor::Config config;
+        config.inputFile = testFile;
+        config.outputFile = outputFile;
+        config.keywords = {"REJECT"};
+        config.mmapWindowSize = 0;
+        config.repeatLimit = static_cast<size_t>(state.range(0));
+        LogMonitor monitor(config);
+        suppressed = monitor.runUntilEof().linesSuppressed;
     }
+    state.SetItemsProcessed(state.iterations() * lineCount);
+    state.counters["suppressed"] = static_cast<double>(suppressed);
     
     fs::remove(testFile);
     fs::remove(outputFile);
 }
-BENCHMARK(BM_BufferSize)->RangeMultiplier(2)->Range(4096, 256*1024);
+BENCHMARK(BM_RepeatSuppression)
+    ->ArgName("limit")
+    ->Arg(0)
+    ->Arg(10)
+    ->Arg(1000)
+    ->Unit(benchmark::kMillisecond);
 
 BENCHMARK_MAIN();
\ No newline at end of file
@@ -0,0 +1,143 @@
+/**
+ * @file aho_corasick.h
+ * @brief Compiled multi-pattern automaton for single-pass keyword search
+ * @author Nicholas Loo
+ * @date 14/10/26
+ *
+ * Aho-Corasick automaton flattened into a dense DFA. Used by KeywordMatcher
+ * for large keyword sets (watchlists of hundreds of symbols / order IDs)
+ * where running one find() per keyword would rescan every line many times.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class AhoCorasick
+ * @brief Dense DFA built from a set of patterns, searched in one pass
+ *
+ * Construction builds the keyword trie, computes failure links and then
+ * resolves every missing edge so that searching is a single table lookup
+ * per input byte with no failure-link chasing.
+ *
+ * Transition table layout (cache-friendly):
+ * - Bytes are mapped to equivalence classes. Every byte that appears in some
+ *   pattern gets its own class, all other bytes share class 0. A watchlist of
+ *   uppercase symbols typically needs < 40 classes instead of 256 columns.
+ * - Rows are stored contiguously as uint32_t, one row per state.
+ * - Each entry holds the target row offset (state * classes) so the hot loop
+ *   never multiplies, and the top bit flags accepting states.
+ *
+ * Case-insensitive search folds the table, not the text: patterns are
+ * lower cased and every upper case byte maps to the class of its lower
+ * case letter, so the hot loop is unchanged. Whole-word search checks the
+ * bytes around each hit on accepting transitions only.
+ *
+ * @note Immutable after construction, so const methods are thread-safe
+ */
+class AhoCorasick {
+public:
+    /**
+     * @brief Builds the automaton for the given patterns
+     * @param patterns Patterns to search for (case-sensitive bytes)
+     * @param masks Optional per-pattern bit mask reported by collect();
+     *              empty = every pattern reports bit 0
+     * @param ignoreCase ASCII case-insensitive matching
+     * @param wholeWord Hits must not be part of a longer word, see isWordByte()
+     *
+     * Time complexity: O(total pattern length * classes)
+     */
+    explicit AhoCorasick(const std::vector<std::string>& patterns,
+                         const std::vector<uint64_t>& masks = {},
+                         bool ignoreCase = false, bool wholeWord = false);
+
+    /**
+     * @brief Checks if text contains at least one pattern
+     * @param text Text to search
+     * @return true on the first accepting state reached
+     *
+     * Time complexity: O(m) where m = text length, independent of pattern count
+     */
+    bool contains(std::string_view text) const;
+
+    /**
+     * @brief Finds where the earliest-ending match ends
+     * @param text Text to search
+     * @return Offset of the last byte of the first match, or npos.
+     *         For an empty pattern the result is 0.
+     *
+     * Used for whole-buffer scanning, where any byte of the match is enough
+     * to locate the surrounding line.
+     */
+    size_t findEnd(std::string_view text) const;
+
+    /**
+     * @brief ORs the masks of every pattern that occurs in text
+     * @param text Text to search
+     * @param all Mask of all bits in use; the walk stops once it is reached
+     * @return Union of the masks of the patterns found, 0 if none
+     *
+     * Same single DFA walk as contains(), but it keeps going after the
+     * first hit so one pass reports every group present.
+     */
+    uint64_t collect(std::string_view text, uint64_t all) const;
+
+    /**
+     * @brief Number of DFA states (trie nodes), mostly for diagnostics
+     */
+    size_t stateCount() const { return accepting_.size(); }
+
+    /**
+     * @brief Number of byte equivalence classes (row width of the table)
+     */
+    size_t classCount() const { return numClasses_; }
+
+    /**
+     * @brief Word byte for whole-word matching: [A-Za-z0-9_]
+     *
+     * A whole-word hit whose first byte is a word byte must not follow one,
+     * and one whose last byte is a word byte must not precede one. Edges
+     * that are punctuation ("Symbol=") need no boundary. KeywordMatcher
+     * uses the same rule for its other engines.
+     */
+    static bool isWordByte(unsigned char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+    }
+
+private:
+    static constexpr uint32_t ACCEPT_BIT = 0x80000000u;  ///< Flag in table entries
+
+    /**
+     * @struct Output
+     * @brief A pattern ending in some state (whole-word mode only)
+     */
+    struct Output {
+        uint32_t length;   ///< Pattern length
+        bool wordStart;    ///< First byte is a word byte, needs a boundary before
+        bool wordEnd;      ///< Last byte is a word byte, needs a boundary after
+        uint64_t mask;     ///< Pattern mask
+    };
+
+    /**
+     * @brief Whole-word check of the patterns ending at text[end] in state
+     * @param mask ORed with the masks of the patterns that pass
+     * @return true if at least one pattern passes
+     */
+    bool wordHit(uint32_t state, std::string_view text, size_t end, uint64_t& mask) const;
+
+    std::array<uint8_t, 256> byteClass_{};  ///< Byte -> column in transition table
+    uint32_t numClasses_ = 1;               ///< Columns per row
+    std::vector<uint32_t> table_;           ///< Row offsets of targets | ACCEPT_BIT
+    std::vector<uint8_t> accepting_;        ///< Accepting flag per state
+    std::vector<uint64_t> stateMask_;       ///< Masks of the patterns ending in each state
+    uint64_t emptyMask_ = 0;                ///< Masks of empty patterns (match everywhere)
+    bool matchesEmpty_ = false;             ///< An empty pattern matches everything
+    bool wholeWord_ = false;                ///< Accepting transitions need wordHit()
+    std::vector<uint32_t> outputBegin_;     ///< Per state first index into outputs_ (size states + 1)
+    std::vector<Output> outputs_;           ///< Patterns ending per state, suffixes included
+};
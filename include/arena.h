@@ -0,0 +1,124 @@
+/**
+ * @file arena.h
+ * @brief Fixed-capacity arena for the per-byte buffers of a monitor
+ * @author Nicholas Loo
+ * @date 14/10/26
+ *
+ * Read buffers, partial-line carries, output staging and pipeline blocks
+ * used to be separate heap allocations, sized independently and multiplied
+ * by every route, worker and source. An Arena is one page-aligned block
+ * sized from the config up front; each buffer is carved out of it at
+ * construction and lives as long as its owner. The total is known before
+ * anything runs (LogMonitor::arenaBytes()), is capped by a limit, and the
+ * steady state never touches the allocator.
+ *
+ * Optionally the block is 2MB huge pages, so a 64KB read buffer and the
+ * pipeline blocks next to it share one TLB entry instead of dozens. Pages
+ * are not touched here: each lands on the NUMA node of the thread that
+ * first writes it (see placement.h).
+ */
+
+#pragma once
+
+#include "input_source.h"
+
+#include <cstddef>
+#include <string_view>
+
+/**
+ * @class Arena
+ * @brief Bump allocator over one fixed block, nothing is freed individually
+ *
+ * @note allocate() is not thread-safe; owners carve their buffers while
+ *       being constructed, before any thread uses them
+ */
+class Arena {
+public:
+    /// Default alignment of allocations, one cache line
+    static constexpr size_t ALIGNMENT = 64;
+
+    /// Huge page size on x86-64 and most arm64 kernels
+    static constexpr size_t HUGE_PAGE = 2 * 1024 * 1024;
+
+    /**
+     * @brief What the block ended up backed by
+     */
+    enum class Backing {
+        Heap,             ///< posix_memalign, regular pages
+        TransparentHuge,  ///< 2MB aligned mmap + MADV_HUGEPAGE (THP, best effort)
+        HugeTlb           ///< MAP_HUGETLB, preallocated huge pages (vm.nr_hugepages)
+    };
+
+    /**
+     * @brief Allocates the block
+     * @param capacity Bytes available to allocate(), see footprint()
+     * @param hugePages Try MAP_HUGETLB, then THP, then fall back to Heap;
+     *                  rounds the block up to whole huge pages
+     * @throw std::bad_alloc on failure
+     */
+    explicit Arena(size_t capacity, bool hugePages = false);
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * @brief Carves size bytes out of the block
+     * @param alignment Power of two, at least ALIGNMENT is used
+     * @throw std::runtime_error if the block is full
+     */
+    char* allocate(size_t size, size_t alignment = ALIGNMENT);
+
+    /// Total bytes of the block
+    size_t capacity() const { return capacity_; }
+
+    /// Bytes handed out so far, padding included
+    size_t used() const { return used_; }
+
+    /// How the block is backed
+    Backing backing() const { return backing_; }
+
+    /**
+     * @brief Capacity to reserve for one allocate(size, alignment), whatever
+     *        was allocated before it; sum these to size an Arena
+     */
+    static size_t footprint(size_t size, size_t alignment = ALIGNMENT);
+
+private:
+    AlignedBuffer heap_;      ///< Backing::Heap
+    char* base_ = nullptr;    ///< Start of the block, either backing
+    size_t mapped_ = 0;       ///< mmap length, 0 for Heap
+    size_t capacity_;
+    size_t used_ = 0;
+    Backing backing_ = Backing::Heap;
+};
+
+/**
+ * @class FixedBuffer
+ * @brief Append-only bytes in caller-provided memory (e.g. from an Arena)
+ *
+ * The string-like subset the line carries use, without ever reallocating:
+ * callers keep appends within capacity() themselves.
+ */
+class FixedBuffer {
+public:
+    FixedBuffer() = default;
+    FixedBuffer(char* data, size_t capacity) : data_(data), capacity_(capacity) {}
+
+    void append(const char* data, size_t len);
+    void push_back(char c) { data_[size_++] = c; }
+    void clear() { size_ = 0; }
+
+    bool empty() const { return size_ == 0; }
+    size_t size() const { return size_; }
+    size_t length() const { return size_; }
+    size_t capacity() const { return capacity_; }
+    const char* data() const { return data_; }
+
+    operator std::string_view() const { return std::string_view(data_, size_); }
+
+private:
+    char* data_ = nullptr;
+    size_t capacity_ = 0;
+    size_t size_ = 0;
+};
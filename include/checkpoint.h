@@ -0,0 +1,65 @@
+/**
+ * @file checkpoint.h
+ * @brief Persistent resume point (input offset + output offset) for restarts
+ * @author Nicholas Loo
+ * @date 14/10/26
+ *
+ * A checkpoint ties a position in the input file to the size the output
+ * file had once every match before that position was written. Resuming
+ * from it means: verify it's still the same input, truncate the output
+ * back to its size, and continue reading at the offset. Lines after the
+ * checkpoint are reprocessed exactly once, nothing before it is rescanned.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @struct Checkpoint
+ * @brief One resume point, stored as a small key=value text file
+ *
+ * Identity is checked three ways: device + inode catch a rotation while
+ * the monitor was down, and a hash of the bytes just before inputOffset
+ * catches a file rewritten in place (same inode, different content).
+ */
+struct Checkpoint {
+    /**
+     * @brief Bytes before inputOffset covered by tailHash
+     */
+    static constexpr size_t TAIL_BYTES = 64;
+
+    uint64_t device = 0;        ///< st_dev of the input
+    uint64_t inode = 0;         ///< st_ino of the input
+    uint64_t inputOffset = 0;   ///< Start of the first line not yet fully processed
+    uint64_t tailLength = 0;    ///< min(TAIL_BYTES, inputOffset)
+    uint64_t tailHash = 0;      ///< hashTail() of those bytes
+    uint64_t outputOffset = 0;  ///< Output size with every earlier match written
+    std::vector<uint64_t> routeOffsets;  ///< Same for each route output after outputFile, in first-use order
+
+    /**
+     * @brief Writes path atomically (temp file + rename)
+     * @param path Checkpoint file
+     * @return false on any I/O error; the previous checkpoint is kept
+     *
+     * Survives a crash of the process at any point. There is no fsync, to
+     * match OutputWriter, which doesn't fsync the output either.
+     */
+    bool save(const std::string& path) const;
+
+    /**
+     * @brief Reads path
+     * @param path Checkpoint file
+     * @param checkpoint Filled on success
+     * @return false if missing or malformed
+     */
+    static bool load(const std::string& path, Checkpoint& checkpoint);
+
+    /**
+     * @brief 64-bit FNV-1a of the trailing bytes
+     */
+    static uint64_t hashTail(const char* data, size_t len);
+};
@@ -0,0 +1,141 @@
+/**
+ * @file compressed_sink.h
+ * @brief Background zstd / gzip compression for OutputWriter
+ * @author Nicholas Loo
+ * @date 14/10/26
+ *
+ * Matched output is mostly repeated prefixes (timestamps, field names,
+ * venues), so it compresses 10x or more. The sink takes OutputWriter's
+ * write batches, copies them into a block and returns; a background
+ * thread compresses each block into one complete frame (zstd) or member
+ * (gzip) and appends it. The monitor thread does a memcpy per batch
+ * instead of a write(), and the disk sees a fraction of the bytes.
+ *
+ * Frames end on batch boundaries, i.e. whole lines, and a frame is cut
+ * at least every frameIntervalMs while lines arrive, so the file is a
+ * valid concatenation of frames at any time: zstdcat / zcat read it live
+ * and CompressedInputSource can tail it. zstd frames carry their content
+ * size, so they decode in parallel. A crash loses the block in memory
+ * and at most a torn last frame, which readers report as truncated.
+ */
+
+#pragma once
+
+#include "output_writer.h"
+#include "stat_counter.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/uio.h>
+
+/**
+ * @class CompressedSink
+ * @brief Block pool plus one compressor / writer thread
+ *
+ * @note append / tick / sync come from the owning writer's thread only
+ */
+class CompressedSink {
+public:
+    /// Blocks in flight; the producer waits (and counts a stall) when all are queued
+    static constexpr size_t BLOCKS = 4;
+
+    /**
+     * @brief Starts the compressor thread
+     * @param fd O_APPEND output descriptor, owned by the caller
+     * @param path For error messages
+     * @param options Compression, level, frameBytes, frameIntervalMs
+     * @throw std::runtime_error if the format isn't compiled in
+     */
+    CompressedSink(int fd, const std::string& path, const OutputWriter::Options& options);
+
+    /**
+     * @brief Compresses and writes what is left, then joins
+     */
+    ~CompressedSink();
+
+    CompressedSink(const CompressedSink&) = delete;
+    CompressedSink& operator=(const CompressedSink&) = delete;
+
+    /**
+     * @brief Copies a batch of whole lines into the current block
+     * @throw std::runtime_error if the compressor thread failed to write
+     *
+     * Cuts the frame after the batch once the block holds frameBytes or
+     * is frameIntervalMs old.
+     */
+    void append(const iovec* iov, size_t count);
+
+    /**
+     * @brief Cuts an aged block while no lines arrive
+     */
+    void tick();
+
+    /**
+     * @brief Cuts the current block and waits until every frame is written
+     * @throw std::runtime_error if a write failed
+     */
+    void sync();
+
+    /// Frames (gzip members) written, any thread
+    uint64_t frames() const { return frames_.load(); }
+
+    /// Uncompressed bytes taken in, any thread
+    uint64_t bytesIn() const { return bytesIn_.load(); }
+
+    /// Compressed bytes written, any thread
+    uint64_t bytesOut() const { return bytesOut_.load(); }
+
+    /// Times append waited for a free block, any thread
+    uint64_t stalls() const { return stalls_.load(); }
+
+    /**
+     * @brief Whether this build can write a compression format (None always)
+     */
+    static bool supported(OutputWriter::Compression compression);
+
+private:
+    struct Encoder;
+
+    /// Hands the current block to the compressor thread
+    void cut();
+
+    /// Throws the compressor thread's error, if any (mutex_ held)
+    void rethrowLocked();
+
+    /// Compressor thread body
+    void run();
+
+    /// Compresses one block into out and write()s it
+    void writeFrame(const std::vector<char>& block, std::vector<char>& out);
+
+    int fd_;
+    std::string path_;
+    OutputWriter::Options options_;
+    std::unique_ptr<Encoder> encoder_;  ///< zstd / zlib state, compressor thread only
+
+    std::vector<char> current_;  ///< Block being filled (producer)
+    std::chrono::steady_clock::time_point currentStart_;  ///< First append into current_
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::vector<char>> queued_;  ///< Cut blocks, oldest first
+    std::vector<std::vector<char>> free_;   ///< Emptied blocks, capacity kept
+    size_t busy_ = 0;                       ///< Blocks taken off queued_ and not returned
+    bool stopping_ = false;
+    std::exception_ptr error_;              ///< First failure on the compressor thread
+
+    StatCounter frames_;    ///< Written by the compressor thread
+    StatCounter bytesIn_;   ///< Written by the producer
+    StatCounter bytesOut_;  ///< Written by the compressor thread
+    StatCounter stalls_;    ///< Written by the producer
+    std::thread thread_;
+};
@@ -0,0 +1,102 @@
+/**
+ * @file context_ring.h
+ * @brief grep -B/-A style context lines around matches
+ * @author Nicholas Loo
+ * @date 14/10/26
+ *
+ * The lines before a match are only known to be wanted once the match is
+ * seen, so the last N non-matching lines are kept in a ring. Most of them
+ * are still in the read buffer and are kept as views; a line is copied
+ * only when its memory is about to go (partialLine_ is reused by the next
+ * carry, the read buffer is refilled or a catch-up window unmapped). Lines
+ * after a match need no buffering at all: they are written as they arrive.
+ */
+
+#pragma once
+
+#include "arena.h"
+#include "output_writer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class ContextRing
+ * @brief Writes matches with up to `before` / `after` surrounding lines
+ *
+ * Every line of the input is passed in order, to match() or other().
+ * Groups of lines that are not adjacent in the input are separated by a
+ * "--" line, like grep; a line is never written twice.
+ *
+ * @note Single-threaded, owned by the monitor thread
+ */
+class ContextRing {
+public:
+    /**
+     * @param before Lines kept for before-context
+     * @param after Lines written after each match
+     * @param maxLineLength Longest line passed in (already truncated)
+     * @param arena Backs the copies, see arenaBytes()
+     */
+    ContextRing(size_t before, size_t after, size_t maxLineLength, Arena& arena);
+
+    /**
+     * @brief A matched line: writes the kept lines before it, then the line
+     * @param stable Same contract as OutputWriter::writeLine(); stable lines
+     *               are kept as views until endOfBuffer()
+     */
+    void match(std::string_view line, bool stable, OutputWriter& out);
+
+    /**
+     * @brief A line that didn't match: written if it is trailing context,
+     *        otherwise kept for the next match
+     */
+    void other(std::string_view line, bool stable, OutputWriter& out);
+
+    /**
+     * @brief A line that is neither written nor kept (e.g. a suppressed
+     *        repeat); it still counts against before/after distances
+     */
+    void skip();
+
+    /**
+     * @brief Copies kept lines that still view the buffer about to be reused
+     */
+    void endOfBuffer();
+
+    /**
+     * @brief Forgets kept lines and trailing context (input rotated)
+     */
+    void reset();
+
+    /// Lines copied into the ring's storage so far
+    uint64_t copies() const { return copies_; }
+
+    /**
+     * @brief Arena capacity the constructor carves for before lines
+     */
+    static size_t arenaBytes(size_t before, size_t maxLineLength);
+
+private:
+    struct Slot {
+        std::string_view line;    ///< Into the caller's buffer, or storage once copied
+        char* storage;            ///< maxLineLength bytes in the arena
+        bool copied = false;
+        uint64_t number = 0;      ///< Input line number
+    };
+
+    void keep(std::string_view line, bool stable);
+    void copy(Slot& slot, std::string_view line);
+    void emit(std::string_view line, bool stable, uint64_t number, OutputWriter& out);
+
+    std::vector<Slot> slots_;     ///< Ring of `before` slots
+    size_t head_ = 0;             ///< Oldest kept slot
+    size_t count_ = 0;            ///< Slots in use
+    size_t after_;
+    size_t afterLeft_ = 0;        ///< Trailing lines still to write
+    uint64_t lineNumber_ = 0;     ///< Lines seen, numbered from 1
+    uint64_t lastEmitted_ = 0;    ///< Number of the last line written, 0 = none yet
+    uint64_t copies_ = 0;
+};
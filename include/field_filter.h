@@ -0,0 +1,121 @@
+/**
+ * @file field_filter.h
+ * @brief Filter expressions over key=value fields, e.g. "Symbol=NVDA AND Latency>300"
+ * @author Nicholas Loo
+ * @date 14/10/26
+ *
+ * Generator lines are key=value records (OrderID=, Symbol=, Side=, Type=,
+ * Price=, Qty=, Latency=...us). Substring keywords can't say "the Symbol
+ * field is META" or "Latency above 300", so FieldFilter evaluates a small
+ * boolean expression against the fields, reading them lazily as
+ * string_views into the line. A substring prefilter derived from the
+ * expression runs first, so only candidate lines are tokenized.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "keyword_matcher.h"
+
+/**
+ * @class FieldFilter
+ * @brief Compiled filter expression with a derived keyword prefilter
+ *
+ * Grammar (operators upper case, terms separated by spaces):
+ * @code
+ *   expr   := term (OR term)*
+ *   term   := factor (AND factor)*
+ *   factor := NOT factor | ( expr ) | Key<op>Value | word
+ *   op     := = | != | < | <= | > | >=
+ * @endcode
+ *
+ * - `Key=Value` / `Key!=Value` compare the field's text exactly.
+ * - `<`, `<=`, `>`, `>=` compare numbers: the leading number of the field,
+ *   so Latency=250us is 250, against Value (units after it are ignored).
+ * - A comparison on a field the line doesn't have is false, `!=` too.
+ * - A bare word is a substring keyword, as in KeywordMatcher.
+ *
+ * A field is "Key=" at the start of the line or after a space, up to the
+ * next space.
+ *
+ * @note Immutable after construction, so const methods are thread-safe
+ */
+class FieldFilter {
+public:
+    /**
+     * @brief Parses the expression and builds the prefilter
+     * @param expression Filter text, see the grammar above
+     * @throw std::runtime_error on a syntax error
+     */
+    explicit FieldFilter(const std::string& expression);
+
+    ~FieldFilter();
+
+    FieldFilter(const FieldFilter&) = delete;
+    FieldFilter& operator=(const FieldFilter&) = delete;
+
+    /**
+     * @brief Prefilter, then the expression
+     * @param line Line without '\n'
+     */
+    bool matches(std::string_view line) const;
+
+    /**
+     * @brief Expression only, for lines that already passed the prefilter
+     * @param line Line without '\n'
+     */
+    bool evaluate(std::string_view line) const;
+
+    /**
+     * @brief Substrings a matching line contains at least one of
+     *
+     * Derived from the expression: an AND keeps its most selective side
+     * (longest literals), an OR the union of both. When nothing can be
+     * derived (a NOT at the top, an OR with a NOT side) this is {""},
+     * which every line contains. Meant to be handed to a KeywordMatcher.
+     */
+    const std::vector<std::string>& prefilterKeywords() const { return prefilter_; }
+
+    /**
+     * @brief Finds the value of field key in line
+     * @param line Line to search
+     * @param key Field name, without '='
+     * @param value View into line, up to the next space
+     * @return false if the line has no such field
+     */
+    static bool findField(std::string_view line, std::string_view key, std::string_view& value);
+
+private:
+    /// Comparison operators
+    enum class Op { Eq, Ne, Lt, Le, Gt, Ge };
+
+    /**
+     * @struct Node
+     * @brief Expression tree node, children by index into nodes_
+     */
+    struct Node {
+        enum class Kind { And, Or, Not, Word, Compare } kind;
+        int left = -1;        ///< And/Or/Not operand
+        int right = -1;       ///< And/Or second operand
+        Op op = Op::Eq;       ///< Compare only
+        std::string key;      ///< Compare: field name
+        std::string text;     ///< Word, or Compare value
+        double number = 0;    ///< Compare value as a number (<, <=, >, >=)
+    };
+
+    class Parser;
+
+    /// Recursive evaluation with short-circuit AND / OR
+    bool eval(int node, std::string_view line) const;
+
+    /// Literal set for node, false if none can be derived
+    bool derivePrefilter(int node, std::vector<std::string>& literals) const;
+
+    std::vector<Node> nodes_;
+    int root_ = -1;
+    std::vector<std::string> prefilter_;
+    std::unique_ptr<KeywordMatcher> prefilterMatcher_;
+};
@@ -0,0 +1,87 @@
+/**
+ * @file file_watcher.h
+ * @brief Event-driven wait for changes to a single file (inotify / kqueue)
+ * @author Nicholas Loo
+ * @date 14/10/26
+ *
+ * Lets the monitor block until the input file is written to, instead of
+ * sleeping a fixed poll interval. Wakes within microseconds of a write and
+ * uses no CPU while the file is idle.
+ */
+
+#pragma once
+
+#include <string>
+
+/**
+ * @class FileWatcher
+ * @brief Blocks until a file is modified, created, renamed or removed
+ *
+ * Backends:
+ * - Linux: inotify watch on the parent directory, filtered by file name.
+ *   Watching the directory (not the inode) also reports creation of a file
+ *   that doesn't exist yet and renames during log rotation.
+ * - macOS/BSD: kqueue EVFILT_VNODE on the directory and on the file.
+ * - Elsewhere: valid() is false and callers fall back to polling.
+ *
+ * The watch is registered in the constructor, so a write that lands between
+ * the caller's last read and its call to wait() is still reported.
+ *
+ * @note wait() is for a single thread; wakeup() may be called from any
+ *       thread or from a signal handler
+ */
+class FileWatcher {
+public:
+    /**
+     * @brief Starts watching path
+     * @param path File to watch (may not exist yet, its directory must)
+     *
+     * Never throws; check valid() to see if events are available.
+     */
+    explicit FileWatcher(const std::string& path);
+
+    /**
+     * @brief Closes the watch descriptors
+     */
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    /**
+     * @brief Whether an event backend is active on this platform/path
+     */
+    bool valid() const { return valid_; }
+
+    /**
+     * @brief Blocks until the file changes, wakeup() is called or the timeout expires
+     * @param timeoutMs Maximum wait in milliseconds (-1 = no timeout)
+     * @return true if woken by a file event or wakeup(), false on timeout
+     */
+    bool wait(int timeoutMs);
+
+    /**
+     * @brief Interrupts a concurrent or the next wait()
+     *
+     * @note Async-signal-safe (a single write/kevent syscall)
+     */
+    void wakeup();
+
+    /**
+     * @brief Name of the active backend ("inotify", "kqueue" or "none")
+     */
+    const char* backendName() const;
+
+private:
+    /// (Re)registers the vnode watch on the file itself (kqueue only)
+    void watchFile();
+
+    std::string path_;       ///< Watched file
+    std::string dir_;        ///< Parent directory
+    std::string name_;       ///< File name inside dir_
+    bool valid_ = false;     ///< Backend initialised
+    int eventFd_ = -1;       ///< inotify or kqueue descriptor
+    int wakeFd_ = -1;        ///< eventfd (Linux) used by wakeup()
+    int dirFd_ = -1;         ///< Directory descriptor (kqueue)
+    int fileFd_ = -1;        ///< File descriptor (kqueue)
+};
@@ -6,14 +6,21 @@
  * 
  * This module provides fast, case-sensitive keyword matching for log filtering.
  * Uses std::string_view for zero-copy operations to minimize overhead.
+ * Small keyword sets use a linear scan (SIMD accelerated, see simd_search.h),
+ * large ones a compiled Aho-Corasick automaton (see aho_corasick.h).
  */
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <string_view>
 #include <algorithm>
+#include <array>
+#include <optional>
+#include "aho_corasick.h"
+#include "simd_search.h"
 
 /**
  * @class KeywordMatcher
@@ -22,21 +29,127 @@
  * Performs case-sensitive substring matching against a list of keywords.
  * Optimized for minimal memory allocation and CPU overhead.
  * 
- * @note Keywords are matched using substring search, not whole-word matching.
- * @note Matching is case-sensitive: "ERROR" will not match "error"
+ * Four search engines are available:
+ * - Linear: one std::string_view::find per keyword. Cheapest for a handful
+ *   of keywords since find() is memchr-accelerated.
+ * - Simd: linear scan, but each keyword is searched with a vectorized
+ *   first/last byte prefilter (SSE2/AVX2/NEON picked at runtime).
+ * - Automaton: Aho-Corasick DFA built once in the constructor, finds every
+ *   keyword in a single pass over the line regardless of keyword count.
+ * - Static: matches() calls a StaticKeywordMatcher compiled for exactly
+ *   these keywords (see static_keyword_matcher.h).
+ *
+ * Optional modes (see Options), handled inside every engine so no line is
+ * ever copied or lower cased:
+ * - ignoreCase: ASCII case-insensitive. The Simd/Linear kernels fold the
+ *   haystack within the compare, the automaton folds its byte class map.
+ * - wholeWord: a hit must not be part of a longer word ("key" no longer
+ *   matches "monkey"), see AhoCorasick::isWordByte().
+ *
+ * @note By default keywords are matched using substring search, not
+ *       whole-word matching, and case-sensitive: "ERROR" will not match "error"
  * 
  * @endcode
  */
 class KeywordMatcher {
 public:
+    /**
+     * @brief Search engine selection
+     */
+    enum class Engine {
+        Auto,       ///< Simd (or Linear) up to AUTOMATON_THRESHOLD keywords, automaton above
+        Linear,     ///< One std::string_view::find() per keyword
+        Simd,       ///< One vectorized prefilter search per keyword
+        Automaton,  ///< Aho-Corasick single pass
+        Static      ///< Compile-time matcher for matches(), Simd for the rest
+    };
+
+    /**
+     * @brief Keyword count above which Auto switches to the automaton
+     *
+     * Picked from BM_KeywordMatcher_MultipleKeywords: each find() costs ~9ns on
+     * a typical log line while the automaton is a flat ~60ns, so the
+     * crossover sits around 6 keywords.
+     */
+    static constexpr size_t AUTOMATON_THRESHOLD = 6;
+
+    /**
+     * @brief Same crossover for a matcher with more than one group
+     *
+     * matchGroups() can't stop at the first hit, so the automaton walks
+     * the whole line (~170ns on a 75 byte line) while the per-keyword scan
+     * skips keywords of groups already hit. Measured crossover ~20.
+     */
+    static constexpr size_t GROUPED_AUTOMATON_THRESHOLD = 20;
+
+    /**
+     * @brief Set of keyword groups, bit i = group i (e.g. one per output)
+     */
+    using GroupMask = uint64_t;
+
+    /**
+     * @brief Most groups a matcher can report
+     */
+    static constexpr size_t MAX_GROUPS = 64;
+
+    /**
+     * @brief A matches() compiled for a fixed keyword set, e.g.
+     *        &StaticKeywordMatcher<REJECT, FILL>::matches
+     */
+    using StaticMatchFn = bool (*)(std::string_view text);
+
+    /**
+     * @struct Options
+     * @brief Engine and match mode
+     */
+    struct Options {
+        Engine engine = Engine::Auto;  ///< Search engine, Static is not selectable here
+        bool ignoreCase = false;       ///< ASCII case-insensitive matching
+        bool wholeWord = false;        ///< Hits must not be part of a longer word
+    };
+
     /**
      * @brief Constructs a keyword matcher with the given keywords
      * @param keywords Vector of keywords to match against
+     * @param engine Search engine to use (default: pick by keyword count)
      * 
      * Uses move semantics to avoid copying the keyword vector.
      * Keywords are stored internally for the lifetime of the matcher.
+     * The automaton, if selected, is built here once.
+     */
+    explicit KeywordMatcher(std::vector<std::string> keywords,
+                            Engine engine = Engine::Auto);
+
+    /**
+     * @brief Constructs a matcher whose keywords belong to groups
+     * @param keywords Keywords to match against
+     * @param groups Group mask per keyword (same size as keywords); a
+     *               keyword may belong to several groups
+     * @param engine Search engine to use (default: pick by keyword count)
+     *
+     * matches() is unchanged; matchGroups() reports which groups hit.
+     */
+    KeywordMatcher(std::vector<std::string> keywords, std::vector<GroupMask> groups,
+                   Engine engine = Engine::Auto);
+
+    /**
+     * @brief Constructs a grouped matcher with a match mode
+     * @param keywords Keywords to match against
+     * @param groups Group mask per keyword, empty = all group 0
+     * @param options Engine, case and word boundary handling
+     */
+    KeywordMatcher(std::vector<std::string> keywords, std::vector<GroupMask> groups,
+                   const Options& options);
+
+    /**
+     * @brief Constructs a matcher whose matches() is a compile-time matcher
+     * @param keywords The keywords staticMatch was compiled for
+     * @param staticMatch Called by matches(); must find exactly keywords
+     *
+     * The engine is Engine::Static. Scanner and matchGroups() have no
+     * static counterpart and use the Simd scan over keywords.
      */
-    explicit KeywordMatcher(std::vector<std::string> keywords);
+    KeywordMatcher(std::vector<std::string> keywords, StaticMatchFn staticMatch);
     
     /**
      * @brief Checks if the given text contains any of the configured keywords
@@ -47,11 +160,74 @@ public:
      * it will match "keyboard", "monkey", etc.
      * 
      * Time complexity: O(n*m) where n = number of keywords, m = text length
+     * for the linear engine, O(m) for the automaton
      * 
      * @note This is a const method and thread-safe for reading
      */
     bool matches(std::string_view text) const;
+
+    /**
+     * @brief Finds every group with a keyword in text, in one pass
+     * @param text Text to search
+     * @return Union of the groups of the keywords found, 0 for no match
+     *
+     * Automaton: a single DFA walk that stops once every group has hit.
+     * Linear/Simd: keywords whose groups have all hit already are skipped.
+     * Without explicit groups every keyword is group 0, so this is
+     * matches() as a mask.
+     *
+     * @note This is a const method and thread-safe for reading
+     */
+    GroupMask matchGroups(std::string_view text) const;
+
+    /**
+     * @brief Union of all keyword groups
+     */
+    GroupMask allGroups() const { return allGroups_; }
     
+    /**
+     * @class Scanner
+     * @brief Iterates keyword hits across a large text such as a whole read buffer
+     *
+     * Where matches() answers yes/no for one line, Scanner finds successive
+     * hits in a multi-line buffer so the caller can locate the surrounding
+     * lines itself.
+     *
+     * - Automaton: one DFA walk from @p from, restarted at the root.
+     * - Linear/Simd: the next occurrence of every keyword is cached, and a
+     *   keyword is only searched again once the caller has moved past its
+     *   cached hit. Each keyword therefore scans the buffer at most once,
+     *   instead of once per hit.
+     *
+     * @note Holds a reference to the matcher and a view of the text; both
+     *       must outlive the scanner. Not thread-safe (per-call cache state).
+     */
+    class Scanner {
+    public:
+        /**
+         * @brief Prepares a scan over text
+         * @param matcher Matcher providing keywords and engine
+         * @param text Text to scan (typically a run of complete lines)
+         */
+        Scanner(const KeywordMatcher& matcher, std::string_view text);
+
+        /**
+         * @brief Finds the next hit at or after from
+         * @param from Offset to resume from (typically the start of a line)
+         * @return Offset of a byte inside an occurrence that starts at or
+         *         after from, or std::string_view::npos
+         */
+        size_t next(size_t from);
+
+    private:
+        static constexpr size_t MAX_CACHED = 16;  ///< Keywords with a cached position
+
+        const KeywordMatcher& matcher_;           ///< Source of keywords / engine
+        std::string_view text_;                   ///< Text being scanned
+        std::array<size_t, MAX_CACHED> nextHit_;  ///< Cached next occurrence per keyword
+        bool primed_ = false;                     ///< nextHit_ filled in
+    };
+
     /**
      * @brief Returns the list of keywords being matched
      * @return Const reference to the internal keyword vector
@@ -59,7 +235,32 @@ public:
      * Useful for debugging and logging which keywords are active.
      */
     const std::vector<std::string>& getKeywords() const { return keywords_; }
+
+    /**
+     * @brief Returns the engine actually in use (never Engine::Auto)
+     */
+    Engine getEngine() const { return engine_; }
+
+    /**
+     * @brief Returns the match mode in use (engine resolved)
+     */
+    Options getOptions() const { return {engine_, ignoreCase_, wholeWord_}; }
     
 private:
-    std::vector<std::string> keywords_;  ///< List of keywords to match against
+    /**
+     * @brief First valid occurrence of keyword i at or after from (Linear/Simd/Static)
+     * @return Start offset, or npos
+     */
+    size_t find(std::string_view text, size_t i, size_t from) const;
+
+    std::vector<std::string> keywords_;      ///< List of keywords to match against
+    std::vector<std::string> needles_;       ///< keywords_, lower cased when ignoreCase_
+    bool ignoreCase_ = false;                ///< Options::ignoreCase
+    bool wholeWord_ = false;                 ///< Options::wholeWord
+    std::vector<GroupMask> groups_;          ///< Group mask per keyword
+    GroupMask allGroups_ = 0;                ///< Union of groups_
+    Engine engine_;                          ///< Resolved engine (never Auto)
+    std::optional<AhoCorasick> automaton_;   ///< Compiled automaton (automaton engine only)
+    simd::SearchFn search_ = nullptr;        ///< Per-keyword search kernel (linear/simd/static engines)
+    StaticMatchFn staticMatch_ = nullptr;    ///< matches() of the static engine
 };
@@ -0,0 +1,72 @@
+/**
+ * @file latency_histogram.h
+ * @brief Fixed-size log-linear latency histogram with percentile queries
+ * @author Nicholas Loo
+ * @date 14/10/26
+ *
+ * Each power of two is split into 32 linear sub-buckets, so any recorded
+ * value is reported within ~3% whether it is 200ns or 20ms, in a fixed
+ * ~15KB table with no allocation per sample. Used by the latency
+ * benchmarks for p50/p99/p999 of write-to-output times.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class LatencyHistogram
+ * @brief Counts nanosecond samples into log-linear buckets
+ *
+ * record() is a clz, a shift and an increment. percentile() walks the
+ * buckets and returns the upper edge of the one holding the requested
+ * rank (clamped to the largest sample), so it never underreports.
+ *
+ * @note Not thread-safe; one recording thread, or merge() per-thread copies
+ */
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 5;                        ///< 32 sub-buckets per power of two
+    static constexpr size_t SUB_BUCKETS = size_t(1) << SUB_BUCKET_BITS;
+    static constexpr size_t BUCKETS = SUB_BUCKETS * (64 - SUB_BUCKET_BITS + 1);
+
+    /**
+     * @brief Adds one sample
+     * @param ns Latency in nanoseconds
+     */
+    void record(uint64_t ns);
+
+    /**
+     * @brief Value at or below which q percent of the samples fall
+     * @param q Percentile in [0, 100], e.g. 99.9
+     * @return Bucket upper edge in ns, 0 with no samples
+     */
+    uint64_t percentile(double q) const;
+
+    /**
+     * @brief Adds another histogram's samples to this one
+     */
+    void merge(const LatencyHistogram& other);
+
+    /**
+     * @brief Drops all samples
+     */
+    void reset();
+
+    uint64_t count() const { return count_; }  ///< Samples recorded
+    uint64_t min() const { return count_ ? min_ : 0; }  ///< Smallest sample, exact
+    uint64_t max() const { return max_; }  ///< Largest sample, exact
+    double mean() const { return count_ ? static_cast<double>(sum_) / count_ : 0; }  ///< Exact mean
+
+private:
+    static size_t bucketOf(uint64_t ns);
+    static uint64_t upperEdge(size_t bucket);
+
+    std::array<uint64_t, BUCKETS> counts_{};
+    uint64_t count_ = 0;
+    uint64_t sum_ = 0;
+    uint64_t min_ = UINT64_MAX;
+    uint64_t max_ = 0;
+};
@@ -0,0 +1,206 @@
+/**
+ * @file line_index.h
+ * @brief Sparse sidecar index (offset, line number, timestamp) for time-range queries
+ * @author Nicholas Loo
+ * @date 14/10/26
+ *
+ * While the monitor reads, LineIndexWriter records one entry roughly every
+ * interval bytes: the offset of the first line starting there, its line
+ * number, and the timestamp from the "[YYYY-MM-DD HH:MM:SS.ffffff]" prefix
+ * HFTLogGenerator writes. A query for a time range binary-searches the
+ * entries and reads only the chunks that can contain it, instead of a
+ * full filter pass over hundreds of GB.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "input_source.h"
+#include "keyword_matcher.h"
+
+/**
+ * @brief Entry timestamp before the first parseable line
+ */
+constexpr int64_t NO_TIMESTAMP = std::numeric_limits<int64_t>::min();
+
+/**
+ * @brief Parses a "YYYY-MM-DD HH:MM:SS[.f{1,6}]" prefix, optionally in '[' ']'
+ * @param text Line (or query bound), only the prefix is looked at
+ * @param micros Microseconds since 1970-01-01 of the wall-clock time as
+ *               written (no time zone conversion, only used for ordering)
+ * @return false if text doesn't start with a timestamp
+ */
+bool parseTimestamp(std::string_view text, int64_t& micros);
+
+/**
+ * @struct IndexEntry
+ * @brief One sparse index point, stored as three host-order 64-bit words
+ */
+struct IndexEntry {
+    uint64_t offset = 0;           ///< Byte offset of a line start
+    uint64_t line = 0;             ///< '\n' count before offset (0-based line number)
+    int64_t timestamp = NO_TIMESTAMP;  ///< That line's timestamp, else the previous entry's
+};
+
+/**
+ * @class LineIndexWriter
+ * @brief Appends index entries as input bytes stream past
+ *
+ * consume() is fed every byte of the input in file order (each read
+ * buffer or mmap window). Buffers that don't reach the next entry
+ * boundary cost one newline count; entries are appended to the file as
+ * they are made, so the index is usable while the monitor runs.
+ *
+ * @note Not thread-safe; driven by the monitor's reading thread
+ */
+class LineIndexWriter {
+public:
+    /**
+     * @brief Default distance between entries (1MB)
+     */
+    static constexpr uint64_t DEFAULT_INTERVAL = 1024 * 1024;
+
+    /**
+     * @brief Opens (or creates) the index file
+     * @param path Index file
+     * @param interval Minimum bytes between entries
+     * @throw std::runtime_error if the file cannot be opened
+     *
+     * Call reset() or resume() before the first consume().
+     */
+    LineIndexWriter(const std::string& path, uint64_t interval = DEFAULT_INTERVAL);
+
+    ~LineIndexWriter();
+
+    LineIndexWriter(const LineIndexWriter&) = delete;
+    LineIndexWriter& operator=(const LineIndexWriter&) = delete;
+
+    /**
+     * @brief Empties the index, the input is read from offset 0 again
+     * @throw std::runtime_error on write failure
+     */
+    void reset();
+
+    /**
+     * @brief Continues an existing index at offset (checkpoint restart)
+     * @param inputFile Input being indexed
+     * @param offset Line start the monitor resumes at
+     * @throw std::runtime_error on write failure
+     *
+     * Entries past offset are dropped. The line number at offset is counted
+     * from the last kept entry, which is at most about one interval away
+     * when the index was written alongside the checkpoint. Falls back to
+     * reset() if the file is not a valid index.
+     */
+    void resume(const std::string& inputFile, uint64_t offset);
+
+    /**
+     * @brief Feeds the next bytes of the input
+     * @param data Bytes at the current offset
+     * @param len Byte count
+     * @throw std::runtime_error on write failure
+     */
+    void consume(const char* data, size_t len);
+
+    /**
+     * @brief Entries written since reset() / resume()
+     */
+    uint64_t entryCount() const { return entries_; }
+
+private:
+    /// Appends one entry to the file
+    void append(const IndexEntry& entry);
+
+    /// Parses the gathered prefix and appends the pending entry
+    void finishPending();
+
+    int fd_ = -1;
+    std::string path_;
+    uint64_t interval_;
+
+    uint64_t offset_ = 0;          ///< File offset of the next consume()
+    uint64_t line_ = 0;            ///< '\n's before offset_
+    uint64_t nextEntryAt_ = 0;     ///< First offset an entry may start at
+    bool atLineStart_ = true;      ///< offset_ is the start of a line
+    bool pending_ = false;         ///< Gathering the prefix of an entry's line
+    IndexEntry pendingEntry_;
+    std::string prefix_;           ///< Start of the pending line, <= PREFIX_BYTES
+    int64_t lastTimestamp_ = NO_TIMESTAMP;
+    uint64_t entries_ = 0;
+};
+
+/**
+ * @class LineIndex
+ * @brief Loaded index plus time-range queries over the input file
+ */
+class LineIndex {
+public:
+    /**
+     * @struct Range
+     * @brief Byte range that holds every line of a time range
+     */
+    struct Range {
+        uint64_t begin = 0;                                  ///< Line start to read from
+        uint64_t end = std::numeric_limits<uint64_t>::max();  ///< Stop offset (max = EOF)
+        uint64_t firstLine = 0;                              ///< Line number at begin
+    };
+
+    /**
+     * @struct QueryResult
+     * @brief Counters for one query()
+     */
+    struct QueryResult {
+        uint64_t bytesScanned = 0;  ///< Bytes read from the input
+        uint64_t linesScanned = 0;  ///< Lines looked at
+        uint64_t linesEmitted = 0;  ///< Lines passed to the callback
+    };
+
+    /**
+     * @brief Called for each line in the range, without '\n'
+     */
+    using LineFn = std::function<void(std::string_view line)>;
+
+    /**
+     * @brief Loads all entries
+     * @param path Index file written by LineIndexWriter
+     * @throw std::runtime_error if missing or not an index
+     */
+    explicit LineIndex(const std::string& path);
+
+    /**
+     * @brief Index entries in file order
+     */
+    const std::vector<IndexEntry>& entries() const { return entries_; }
+
+    /**
+     * @brief Binary search for the chunks that can hold [from, to]
+     *
+     * Assumes timestamps don't go backwards between entries, which holds
+     * for a log written in time order.
+     */
+    Range find(int64_t from, int64_t to) const;
+
+    /**
+     * @brief Emits lines with from <= timestamp <= to (and matching filter)
+     * @param input Open input file
+     * @param from Range start, inclusive (see parseTimestamp)
+     * @param to Range end, inclusive
+     * @param filter Optional keyword filter, nullptr = every line
+     * @param onLine Receives each line, truncated to maxLineLength
+     * @param maxLineLength Truncation limit, as LogMonitor::MAX_LINE_LENGTH
+     *
+     * Lines without a timestamp belong to the last timestamped line before
+     * them (stack traces, wrapped messages). Stops at the first line past
+     * `to`.
+     */
+    QueryResult query(InputSource& input, int64_t from, int64_t to, const KeywordMatcher* filter,
+                      const LineFn& onLine, size_t maxLineLength = 5000) const;
+
+private:
+    std::vector<IndexEntry> entries_;
+};
@@ -12,11 +12,32 @@
 #pragma once
 
 #include <string>
-#include <fstream>
 #include <vector>
 #include <atomic>
 #include <memory>
+#include <mutex>
+#include <chrono>
 #include "keyword_matcher.h"
+#include "output_writer.h"
+#include "file_watcher.h"
+#include "input_source.h"
+#include "arena.h"
+#include "parallel_scanner.h"
+#include "pipeline.h"
+#include "rate_tracker.h"
+#include "stat_counter.h"
+#include "checkpoint.h"
+#include "line_index.h"
+#include "field_filter.h"
+#include "stage_tracer.h"
+#include "context_ring.h"
+#include "repeat_suppressor.h"
+
+// hot-path tracing compiled in (CMake option LOG_MONITOR_TRACE); still off
+// at runtime unless Config::trace is set. 0 removes it entirely
+#ifndef LOG_MONITOR_TRACE
+#define LOG_MONITOR_TRACE 1
+#endif
 
 /**
  * @class LogMonitor
@@ -32,6 +53,11 @@
  * - Automatic line truncation at 5000 characters
  * - Thread-safe shutdown via atomic flag
  * - Comprehensive statistics tracking
+ * - Log rotation (rename + create, copytruncate) detected by inode and size
+ * - Optional checkpoint file for restarts without rescanning or duplicates
+ * - Optional sparse offset/line/timestamp index for time-range queries
+ * - Keyword routing: one matcher pass, each line copied to the outputs it hits
+ * - Field filters ("Symbol=NVDA AND Latency>300") behind a substring prefilter
  * 
  * Memory usage: ~50MB constant (buffer + overhead), independent of file size
  * 
@@ -47,13 +73,71 @@ public:
     static constexpr size_t DEFAULT_BUFFER_SIZE = 64 * 1024;
     
     /**
-     * @brief Maximum line length before truncation (5000 characters)
+     * @brief Default maximum line length before truncation (5000 characters)
      * 
      * Lines exceeding this length are truncated to prevent memory exhaustion
      * from malformed or extremely long log entries. The remainder is discarded.
+     * Config::maxLineLength overrides it.
      */
     static constexpr size_t MAX_LINE_LENGTH = 5000;
     
+    /**
+     * @brief When matched lines are written to the output file
+     * @see OutputWriter::FlushPolicy
+     */
+    using FlushPolicy = OutputWriter::FlushPolicy;
+    
+    /**
+     * @brief On-disk format of output files
+     * @see OutputWriter::Compression
+     */
+    using Compression = OutputWriter::Compression;
+    
+    /**
+     * @brief How processBuffer finds matching lines
+     */
+    enum class ScanMode {
+        PerLine,     ///< Split buffer into lines, run the matcher on each line
+        WholeBuffer  ///< Run the matcher once over the buffer, find lines around hits
+    };
+    
+    /**
+     * @brief How the input file is read
+     * @see InputSource::Backend
+     */
+    using InputBackend = InputSource::Backend;
+    
+    /**
+     * @brief How the monitor waits when the input has no new data
+     */
+    enum class WaitMode {
+        Auto,   ///< Event if the platform supports it, otherwise Poll
+        Poll,   ///< Sleep pollIntervalMs between reads (old behaviour)
+        Event   ///< Block on inotify/kqueue until the file changes
+    };
+    
+    /**
+     * @brief Upper bound on a single event wait in ms
+     * 
+     * Safety net for filesystems that don't deliver change events (NFS,
+     * some FUSE mounts): the file is re-read at least this often.
+     */
+    static constexpr int EVENT_RECHECK_MS = 1000;
+    
+    /**
+     * @brief Default mmap window for the catch-up pass (256MB)
+     */
+    static constexpr size_t DEFAULT_MMAP_WINDOW = 256 * 1024 * 1024;
+    
+    /**
+     * @struct Route
+     * @brief Extra output for the lines containing any of a keyword group
+     */
+    struct Route {
+        std::vector<std::string> keywords;  ///< Lines with any of these keywords...
+        std::string outputFile;             ///< ...are appended to this file
+    };
+    
     /**
      * @struct Config
      * @brief Configuration parameters for log monitoring
@@ -62,17 +146,82 @@ public:
         std::string inputFile;                      ///< Path to log file to monitor
         std::string outputFile;                     ///< Path to output file for filtered logs
         std::vector<std::string> keywords;          ///< Keywords to filter on
+        KeywordMatcher::StaticMatchFn staticMatch = nullptr;  ///< Compiled matcher for exactly keywords (no routes / filter)
+        bool ignoreCase = false;                    ///< ASCII case-insensitive keywords and routes
+        bool wholeWord = false;                     ///< Keywords and routes only hit whole words
         size_t bufferSize = DEFAULT_BUFFER_SIZE;    ///< Read buffer size in bytes
-        int pollIntervalMs = 10;                    ///< Poll interval in milliseconds (10ms = low latency)
+        size_t maxLineLength = MAX_LINE_LENGTH;     ///< Longer lines are truncated, the rest skipped
+        int pollIntervalMs = 10;                    ///< Poll interval in milliseconds (WaitMode::Poll only)
+        WaitMode waitMode = WaitMode::Auto;         ///< Idle strategy, event-driven where available
+        InputBackend inputBackend = InputBackend::Posix;  ///< pread(), std::ifstream or decompressing reads
+        size_t decompressThreads = 1;               ///< Compressed backend: zstd frames decoded in parallel
+        size_t mmapWindowSize = DEFAULT_MMAP_WINDOW;  ///< Catch-up mmap window, 0 disables catch-up
+        uint64_t mmapCatchUpThreshold = 16 * 1024 * 1024;  ///< Min unread backlog that triggers catch-up
+        size_t scanThreads = 1;                     ///< Threads for backlog regions (1 = single-threaded)
+        size_t scanChunkSize = ParallelScanner::DEFAULT_CHUNK_SIZE;  ///< Per-thread chunk of a backlog region
+        bool pipelined = false;                     ///< Separate reader / matcher / writer threads
+        size_t matcherThreads = 1;                  ///< Matcher stage threads (pipelined only)
+        size_t pipelineBlocks = 16;                 ///< Pre-allocated blocks of bufferSize (pipelined only)
+        int rateWindowMs = 10000;                   ///< Sliding window for getRates()
+        std::vector<Route> routes;                  ///< Keyword group -> output, next to keywords -> outputFile
+        std::string filter;                         ///< FieldFilter expression for outputFile, replaces keywords
+        size_t contextBefore = 0;                   ///< Non-matching lines written before each outputFile match (grep -B)
+        size_t contextAfter = 0;                    ///< Non-matching lines written after each outputFile match (grep -A)
+        size_t repeatLimit = 0;                     ///< Lines of one template written to outputFile per window, 0 = all
+        uint64_t repeatWindowMs = 1000;             ///< Window of repeatLimit, repeats are summed up when it ends
+        size_t repeatSlots = 1024;                  ///< Templates tracked at once (RepeatSuppressor)
+        std::string checkpointFile;                 ///< Resume point file, empty disables checkpoints
+        int checkpointIntervalMs = 1000;            ///< Min time between checkpoints while reading
+        std::string indexFile;                      ///< Sparse line index file, empty disables indexing
+        uint64_t indexInterval = LineIndexWriter::DEFAULT_INTERVAL;  ///< Bytes between index entries
+        ScanMode scanMode = ScanMode::PerLine;      ///< Per-line or whole-buffer matching
+        FlushPolicy flushPolicy = FlushPolicy::PerLine;  ///< Durability vs throughput of output
+        size_t flushBytes = 64 * 1024;              ///< Pending bytes that trigger a flush (FlushPolicy::Bytes)
+        uint64_t flushIntervalUs = 1000;            ///< Max age of pending output in us (FlushPolicy::Interval)
+        Compression outputCompression = Compression::None;  ///< Background zstd / gzip frames for every output
+        int compressionLevel = 0;                   ///< 0 = the format's fastest level
+        uint64_t frameIntervalMs = 1000;            ///< Max age of a compressed frame before it is cut
+        bool trace = false;                         ///< Per-stage tick histograms (needs TRACE_COMPILED)
+        size_t arenaLimit = 50 * 1024 * 1024;       ///< Max arenaBytes() the config may need, 0 = no limit
+        bool hugePages = false;                     ///< Back the arena with 2MB pages (hugetlb, else THP)
+        int monitorCpu = -1;                        ///< Pin the monitor (reader) thread, -1 = unpinned
+        std::vector<int> pipelineCpus;              ///< Pipelined: matcher CPUs, then the writer's (Pipeline::Options::cpus)
     };
     
+    /**
+     * @brief Whether tracing is compiled in; without it Config::trace is ignored
+     */
+    static constexpr bool TRACE_COMPILED = LOG_MONITOR_TRACE != 0;
+    
     /**
      * @brief Constructs a log monitor with the given configuration
      * @param config Configuration parameters (see Config struct)
-     * @throw std::runtime_error if output file cannot be opened
+     * @throw std::runtime_error if output file cannot be opened, or
+     *        WaitMode::Event was requested and no event backend is available
      * 
      * Opens the output file in append mode. If the file exists, new entries
      * are appended. The input file is opened when start() is called.
+     * 
+     * With a checkpointFile that still matches the input (same inode,
+     * same bytes before the offset), reading resumes at the checkpoint
+     * and the output is cut back to its checkpointed size, so the lines
+     * in between are written exactly once. Otherwise it starts at 0.
+     * An indexFile is continued from the same offset, or rebuilt from 0.
+     * 
+     * Routes are merged into one matcher with a group per distinct output
+     * file (outputFile is group 0), so every line is scanned once and
+     * written once to each output it matches.
+     * @throw std::runtime_error for more than KeywordMatcher::MAX_GROUPS outputs,
+     *        or a filter expression that doesn't parse
+     * 
+     * Context lines need every line in order, so they scan per line on the
+     * monitor thread (no whole-buffer or parallel scans).
+     * @throw std::runtime_error for context lines with pipelined
+     * 
+     * With a repeatLimit, matched lines that differ from an earlier one only
+     * in their digits are rate-limited on the way to outputFile (routes get
+     * every line); each window's repeats become one summary line.
+     * @throw std::runtime_error for repeatLimit with pipelined
      */
     explicit LogMonitor(const Config& config);
     
@@ -94,7 +243,7 @@ public:
      * 2. Reads available data in chunks
      * 3. Processes complete lines, filters by keywords
      * 4. Writes matches to output file
-     * 5. Sleeps for pollIntervalMs if no data available
+     * 5. Waits for a file event (or sleeps pollIntervalMs) if no data available
      * 6. Repeats until stop() is called
      * 
      * @note This is a blocking call - run in a separate thread for async operation
@@ -108,35 +257,254 @@ public:
      * Thread-safe method to signal the monitor to stop. Can be called from
      * signal handlers (e.g., SIGINT) or other threads.
      * 
-     * The monitor will complete processing the current buffer before stopping.
+     * The monitor will complete processing the current buffer before stopping,
+     * then flushes pending output on its own thread as start() returns.
      * 
      * @note Thread-safe via atomic flag
      */
     void stop();
     
+    /**
+     * @brief Replaces the keywords while the monitor runs
+     * @param keywords New keyword list for outputFile; routes keep theirs
+     * @throw std::runtime_error with a filter (its expression owns the
+     *        keywords) or an empty list
+     * 
+     * The new matcher (automaton included) is built on the calling thread
+     * and published through an atomic pointer; the monitor thread swaps
+     * it in before its next read, between buffers, where it is the only
+     * user of the matcher. The hot loop pays one relaxed load per read and
+     * never locks. Pipelined, the stages are drained and restarted around
+     * the swap. Lines already read are matched with the old keywords; a
+     * newer reload not yet picked up replaces the pending one. Compiled-in
+     * keyword sets (Config::staticMatch) give way to the runtime matcher.
+     * 
+     * @note Thread-safe; not async-signal-safe (it allocates), so signal
+     *       handlers should defer to a thread (see main's SIGHUP)
+     */
+    void reloadKeywords(const std::vector<std::string>& keywords);
+    
     /**
      * @struct Statistics
-     * @brief Runtime statistics for monitoring operations
+     * @brief Snapshot of the runtime statistics for monitoring operations
+     * 
+     * Plain values copied out of the live counters by getStatistics().
+     * Each field is read atomically; fields are not one consistent cut
+     * (e.g. bytesRead may already include a buffer whose lines aren't
+     * counted yet).
      */
     struct Statistics {
         uint64_t linesProcessed = 0;      ///< Total lines read and processed
         uint64_t linesMatched = 0;        ///< Lines containing keywords (written to output)
         uint64_t bytesRead = 0;           ///< Total bytes read from input file
-        uint64_t longLinesDiscarded = 0;  ///< Count of lines truncated due to length >5000
+        uint64_t longLinesDiscarded = 0;  ///< Count of lines truncated due to length > maxLineLength
+        uint64_t outputFlushes = 0;       ///< Write batches issued to the output file
+        uint64_t outputRawBytes = 0;      ///< Compressed outputs: bytes handed to the compressor
+        uint64_t outputCompressedBytes = 0;  ///< Compressed outputs: frame bytes written to disk
+        uint64_t bytesMapped = 0;         ///< Part of bytesRead consumed via mmap catch-up
+        uint64_t rotations = 0;           ///< Input replaced or truncated and reread from 0
+        uint64_t resumedOffset = 0;       ///< Input offset restored from the checkpoint (0 = none)
+        uint64_t checkpointsSaved = 0;    ///< Checkpoint files written
+        uint64_t indexEntries = 0;        ///< Line index entries written since start / last rotation
+        uint64_t readOffset = 0;          ///< Input offset read up to (pipelined: handed to the matchers)
+        uint64_t readerStalls = 0;        ///< Pipelined: reader waited for a free block
+        uint64_t matcherStalls = 0;       ///< Pipelined: matchers waited for input
+        uint64_t writerStalls = 0;        ///< Pipelined: writer waited for matched blocks
+        uint64_t matchQueueDepth = 0;     ///< Pipelined: blocks read but not matched yet
+        uint64_t writeQueueDepth = 0;     ///< Pipelined: blocks matched but not written yet
+        uint64_t keywordReloads = 0;      ///< reloadKeywords() matchers swapped in
+        uint64_t linesSuppressed = 0;     ///< Repeats kept out of outputFile by repeatLimit
     };
     
     /**
      * @brief Retrieves current monitoring statistics
      * @return Copy of current statistics
      * 
-     * Safe to call while monitoring is running. Returns a snapshot of
-     * current statistics without blocking the monitor.
+     * Safe to call from any thread while monitoring is running: every
+     * counter is a relaxed atomic with a single writer, so polling never
+     * locks or slows the monitor thread.
      * 
      * Useful for displaying progress or debugging performance issues.
      */
     Statistics getStatistics() const;
     
+    /**
+     * @brief Processes the input from the current position to EOF, then returns
+     * @return Statistics after the final flush
+     * @throw std::runtime_error if the input file cannot be opened
+     * 
+     * Synchronous alternative to start() for batch jobs and benchmarks:
+     * same catch-up, read, match and output path, but no startup banner,
+     * no waiting and no rotation checks. Output is flushed (and the
+     * checkpoint saved) before it returns, so the output file is complete.
+     * An unterminated last line stays carried, as while tailing; calling
+     * it again, or start(), continues from where it stopped.
+     */
+    Statistics runUntilEof();
+    
+    /**
+     * @brief How far the monitor lags the writer: input size minus readOffset
+     * @return Unread bytes, 0 if the input doesn't exist
+     * 
+     * Costs a stat() on the calling thread; the monitor thread is not
+     * involved. Meant for metrics pollers and lag alerts.
+     */
+    uint64_t bytesBehind() const;
+    
+    /**
+     * @brief Arena capacity a monitor with this config reserves
+     * 
+     * Read buffer, partial-line carry, one staging buffer per output and
+     * the pipeline's block pool; everything the read / match / write path
+     * touches per byte lives there. Fixed for the monitor's lifetime.
+     */
+    static size_t arenaBytes(const Config& config);
+    
+    /**
+     * @brief Pins the calling thread to Config::monitorCpu, if set
+     * 
+     * start() and runUntilEof() call this, so the thread that runs the
+     * monitor stays on that CPU. The constructor only pins for its own
+     * duration (ScopedPin): the matcher's tables and the buffers it first
+     * touches land on that CPU's NUMA node, and the constructing thread's
+     * affinity is restored before it returns.
+     */
+    void pinMonitorThread() const;
+    
+    /**
+     * @brief The monitor's buffer arena (see arenaBytes())
+     */
+    const Arena& arena() const { return arena_; }
+    
+    /**
+     * @brief Throughput over the last Config::rateWindowMs
+     * @see RateTracker::Rates
+     */
+    using Rates = RateTracker::Rates;
+    
+    /**
+     * @brief Samples the counters and returns sliding-window rates
+     * @return lines/s, bytes/s, matches/s
+     * 
+     * Intended to be polled periodically (e.g. once a second) by a
+     * dashboard thread. Rates are computed from successive polls, so the
+     * hot path does no timing work. Thread-safe; concurrent pollers share
+     * one window.
+     */
+    Rates getRates() const;
+    
+    /**
+     * @brief Asks the monitor thread to print the trace report to stderr
+     * 
+     * The report is printed on the next loop iteration (the wait is cut
+     * short). No-op without Config::trace.
+     * 
+     * @note Async-signal-safe (atomic store + watcher wakeup), for SIGUSR1
+     */
+    void requestTraceDump();
+    
+    /**
+     * @brief Stage histograms, null unless tracing
+     * 
+     * Written by the thread running start() / runUntilEof(); read it from
+     * another thread only after that has returned (use requestTraceDump
+     * while running).
+     */
+    const StageTracer* getTracer() const { return tracer_.get(); }
+    
+    /**
+     * @brief Wait mode actually in use (Auto resolved to Poll or Event)
+     */
+    WaitMode getWaitMode() const { return watcher_ ? WaitMode::Event : WaitMode::Poll; }
+    
+    /**
+     * @brief Scan mode actually in use (Config::scanMode unless the keywords
+     *        or context lines need per-line scans)
+     */
+    ScanMode getScanMode() const { return scanMode_; }
+    
 private:
+    /**
+     * @brief Idles until new input may be available
+     * 
+     * Event mode blocks on the watcher, capped at EVENT_RECHECK_MS, or at
+     * the flush interval while FlushPolicy::Interval output is pending.
+     * Poll mode sleeps pollIntervalMs.
+     */
+    void waitForData();
+    
+    /**
+     * @brief Reads and processes input until caught up
+     * @param followRotation Tailing: stop at a short read and switch to a
+     *        rotated file at EOF; batch run: read on to EOF only
+     * @return true if any data was read
+     */
+    bool readAvailable(bool followRotation);
+    
+    /**
+     * @brief Drains the pipeline, flushes every output and saves the checkpoint
+     */
+    void finishOutput();
+    
+    /**
+     * @brief Prints input, output, keywords and wait mode when start() begins
+     */
+    void printStartup() const;
+    
+    /**
+     * @brief Match and output of one line with both stages timed
+     * 
+     * Taken by processLine for 1 in StageTracer::SAMPLE_EVERY lines.
+     */
+    void processLineTraced(std::string_view line);
+    
+    /**
+     * @brief True with a tracer; constant false when tracing isn't compiled in
+     */
+    bool tracing() const { return TRACE_COMPILED && tracer_ != nullptr; }
+    
+    /**
+     * @brief Switches to the new file after logrotate, at EOF of the old one
+     * @return true if the input was replaced or truncated
+     * 
+     * Uses InputSource::checkRotation (device + inode, size vs offset).
+     * The old file has been read to EOF by then, so nothing is lost; its
+     * unterminated last line is processed as a line of its own instead of
+     * being glued to the head of the new file. Replaced closes the input
+     * so the loop reopens it (and catches up) at offset 0; Truncated just
+     * rewinds to 0.
+     */
+    bool handleRotation();
+    
+    /**
+     * @brief Resumes from Config::checkpointFile if it matches the input
+     * 
+     * Constructor only. A checkpoint for another inode (rotated while we
+     * were down), a shorter file or a different tail hash is ignored.
+     */
+    void restoreCheckpoint();
+    
+    /**
+     * @brief Records the current resume point in Config::checkpointFile
+     * 
+     * The offset is the start of the carried partial line, which is
+     * reread after a restart. Flushes the output first so outputOffset
+     * covers every match before that offset. Pipelined mode only calls
+     * this after finish(), since the writer thread owns the output.
+     */
+    void saveCheckpoint();
+    
+    /**
+     * @brief Processes the unread backlog through mmap windows
+     * 
+     * Runs when the input is (re)opened with at least mmapCatchUpThreshold
+     * bytes beyond lastPosition_ (not in pipelined mode, where the writer
+     * thread owns the output, nor for compressed input). Each window goes through processBuffer()
+     * in place, so there is no copy into buffer_. Returns at EOF (as seen
+     * by fstat) or on stop(), and the normal read loop takes over.
+     */
+    void catchUp();
+    
     /**
      * @brief Processes a buffer of data read from the input file
      * @param buffer Pointer to buffer containing data
@@ -146,31 +514,159 @@ private:
      * them to processLine(). Handles partial lines across buffer boundaries
      * by accumulating them in partialLine_.
      * 
-     * If a line exceeds MAX_LINE_LENGTH, it's truncated immediately to
-     * prevent memory exhaustion.
+     * A line over maxLineLength keeps only maxLineLength + 1 bytes in
+     * partialLine_; the rest of it is skipped with one memchr per buffer
+     * (discardingLine_), never copied or walked byte by byte.
+     * 
+     * In ScanMode::WholeBuffer the complete lines in the middle of the
+     * buffer are handed to processRegion() instead of processLine().
      */
     void processBuffer(const char* buffer, size_t bytesRead);
     
+    /**
+     * @brief Whole-buffer matching over a run of complete lines
+     * @param data Start of the first line
+     * @param len Bytes up to and including the last '\n'
+     * 
+     * Runs the keyword search once over the whole region. For every hit the
+     * enclosing line is located by scanning back/forward to the nearest '\n'.
+     * Line statistics come from a vectorized newline count instead of a
+     * per-line call, so non-matching lines are only touched by the two
+     * vector scans.
+     */
+    void processRegion(const char* data, size_t len);
+    
+    /**
+     * @brief Multi-threaded version of the complete-lines step
+     * @param data Start of the first line
+     * @param len Bytes up to and including the last '\n'
+     * 
+     * Used for regions of at least two chunks (mmap catch-up windows) when
+     * scanThreads > 1. Output order and statistics match processRegion().
+     */
+    void processRegionParallel(const char* data, size_t len);
+    
+    /**
+     * @brief Stores the trailing fragment of a buffer in partialLine_
+     * @param data Start of the fragment (no '\n' inside)
+     * @param len Fragment length
+     * 
+     * Keeps at most maxLineLength + 1 bytes, enough to know the line is too
+     * long and what its truncated form is, and switches to discardingLine_
+     * beyond that. The line is processed (and counted once) at its '\n'.
+     */
+    void carryPartialLine(const char* data, size_t len);
+    
+    /**
+     * @brief Adds the last segment of the carried line and processes it
+     * @param data Segment before the '\n'
+     * @param len Segment length
+     */
+    void completePartialLine(const char* data, size_t len);
+    
+    /**
+     * @brief Drops partialLine_ and any discard in progress
+     */
+    void clearPartialLine();
+    
     /**
      * @brief Processes a single complete line
      * @param line Line to process (string_view for zero-copy)
      * 
-     * 1. Truncates if line exceeds MAX_LINE_LENGTH
+     * 1. Truncates if line exceeds maxLineLength
      * 2. Checks if line contains any keyword
-     * 3. If match found, writes to output file with flush
+     * 3. If match found, hands it to the output writer (flush per policy)
      * 4. Updates statistics
      * 
      * @note Uses string_view to avoid copying when line is within buffer
      */
     void processLine(std::string_view line);
     
+    /**
+     * @brief Writes a matched (already truncated) line to its outputs
+     * @param line Line to write, without trailing newline
+     * @param groups Outputs to write to (bit i = outputs_[i])
+     */
+    void emitMatch(std::string_view line, KeywordMatcher::GroupMask groups);
+    
+    /**
+     * @brief Outputs a line found by a yes/no search belongs to
+     * 
+     * Unrouted that is outputs_[0]; routed, only matched lines pay for
+     * the matchGroups() pass.
+     */
+    KeywordMatcher::GroupMask groupsOf(std::string_view line) const;
+    
+    /**
+     * @brief OutputWriter::endOfBuffer() on every output
+     */
+    void endOfBuffer();
+    
+    /**
+     * @brief Matcher for primary keywords plus the routes' keywords
+     * @param primaryKeywords Keywords (or filter literals) for outputFile
+     * 
+     * Group 0 is outputFile, route i goes to group routeGroups_[i].
+     */
+    std::unique_ptr<KeywordMatcher> buildMatcher(std::vector<std::string> primaryKeywords) const;
+    
+    /**
+     * @brief Swaps in a matcher published by reloadKeywords (monitor thread)
+     */
+    void applyPendingMatcher();
+    
+    /**
+     * @brief Whole-buffer scans assume no keyword spans lines
+     */
+    void checkScanMode();
+    
     Config config_;                              ///< Configuration parameters
+    ScanMode scanMode_ = ScanMode::PerLine;      ///< Effective Config::scanMode, see checkScanMode()
+    Arena arena_;                                ///< Backs every buffer below, outlives their owners
     std::unique_ptr<KeywordMatcher> matcher_;    ///< Keyword matcher instance
-    std::ifstream inStream_;                     ///< Input file stream
-    std::ofstream outStream_;                    ///< Output file stream (append mode)
-    std::streampos lastPosition_;                ///< Last read position in input file
-    std::string partialLine_;                    ///< Accumulator for lines split across buffers
+    std::unique_ptr<FieldFilter> filter_;        ///< Config::filter, null without one
+    std::unique_ptr<ParallelScanner> parallel_;  ///< Backlog thread pool, null if scanThreads <= 1
+    std::unique_ptr<Pipeline> pipeline_;         ///< Matcher/writer stages, null unless pipelined
+    std::unique_ptr<LineIndexWriter> index_;     ///< Sparse line index, null without indexFile
+    std::unique_ptr<InputSource> input_;         ///< Input file reader (see Config::inputBackend)
+    std::unique_ptr<OutputWriter> writer_;       ///< Batched output (append mode)
+    std::vector<std::unique_ptr<OutputWriter>> routeWriters_;  ///< Route outputs other than outputFile
+    std::vector<OutputWriter*> outputs_;         ///< Matcher group i -> output, [0] = writer_
+    std::vector<size_t> routeGroups_;            ///< Config::routes[i] -> matcher group / outputs_ index
+    std::atomic<KeywordMatcher*> pendingMatcher_{nullptr};  ///< Owned, published by reloadKeywords()
+    std::unique_ptr<FileWatcher> watcher_;       ///< Change notifications, null in poll mode
+    std::unique_ptr<StageTracer> tracer_;        ///< Stage histograms, null unless Config::trace
+    std::unique_ptr<ContextRing> context_;       ///< outputFile context lines, null without contextBefore/After
+    std::unique_ptr<RepeatSuppressor> repeats_;  ///< outputFile rate limit, null without repeatLimit
+    std::atomic<bool> traceDumpRequested_{false};  ///< Set by requestTraceDump()
+    uint64_t lastPosition_;                      ///< Offset of the next read in the input file
+    FixedBuffer partialLine_;                    ///< Accumulator for lines split across buffers (arena)
+    bool discardingLine_ = false;                ///< Skipping the rest of an over-long partialLine_
+    uint64_t discardedBytes_ = 0;                ///< Bytes of that line not kept in partialLine_
     std::atomic<bool> running_;                  ///< Atomic flag for thread-safe shutdown
-    Statistics stats_;                           ///< Runtime statistics
-    std::unique_ptr<char[]> buffer_;             ///< Read buffer (size = config.bufferSize)
+    /**
+     * @struct Counters
+     * @brief Live counters, each written by the monitor thread only
+     */
+    struct Counters {
+        StatCounter linesProcessed;
+        StatCounter linesMatched;
+        StatCounter bytesRead;
+        StatCounter longLinesDiscarded;
+        StatCounter bytesMapped;
+        StatCounter rotations;
+        StatCounter resumedOffset;
+        StatCounter checkpointsSaved;
+        StatCounter indexEntries;
+        StatCounter readOffset;    ///< lastPosition_, for pollers
+        StatCounter keywordReloads;
+        StatCounter linesSuppressed;
+    };
+    
+    Counters stats_;                             ///< Runtime statistics (see getStatistics)
+    mutable std::mutex ratesMutex_;              ///< Serialises getRates() callers
+    mutable RateTracker rates_;                  ///< Sliding window over polled counters
+    std::chrono::steady_clock::time_point lastCheckpoint_;  ///< Last saveCheckpoint()
+    bool checkpointDirty_ = false;               ///< Input consumed since the last checkpoint
+    char* buffer_;                               ///< Page-aligned read buffer in arena_ (size = config.bufferSize)
 };
@@ -0,0 +1,70 @@
+/**
+ * @file mapped_file.h
+ * @brief Read-only sliding-window memory mapping of a large file
+ * @author Nicholas Loo
+ * @date 14/10/26
+ *
+ * Used for the cold-start catch-up pass: instead of copying a multi-GB
+ * backlog through the read buffer 64KB at a time, map a big window of it
+ * and run the line processing straight over the page cache.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @class MappedFile
+ * @brief One active mmap window over a file opened read-only
+ *
+ * map() replaces any previous window. Window starts are rounded down to a
+ * page boundary internally, so any byte offset can be requested.
+ *
+ * @warning If the file is truncated while a window is mapped, touching the
+ *          cut-off pages raises SIGBUS. Rename-based rotation is safe,
+ *          copytruncate is not; callers only map the backlog that
+ *          existed when they checked size().
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Opens path read-only
+     * @param path File to map
+     * @throw std::runtime_error if the file cannot be opened
+     */
+    explicit MappedFile(const std::string& path);
+
+    /**
+     * @brief Unmaps the window and closes the file
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Current file size (fstat)
+     */
+    uint64_t size() const;
+
+    /**
+     * @brief Maps [offset, offset + len) with MADV_SEQUENTIAL
+     * @param offset File offset of the first byte
+     * @param len Bytes to map, must not extend past size()
+     * @return Pointer to the byte at offset, valid until the next map()/unmap(),
+     *         or nullptr if mmap fails (caller falls back to read())
+     */
+    const char* map(uint64_t offset, size_t len);
+
+    /**
+     * @brief Drops the current window, no-op if none
+     */
+    void unmap();
+
+private:
+    int fd_ = -1;              ///< Read-only descriptor
+    void* base_ = nullptr;     ///< Page-aligned start of the mapping
+    size_t mappedLen_ = 0;     ///< Length passed to mmap
+};
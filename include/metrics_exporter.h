@@ -0,0 +1,126 @@
+/**
+ * @file metrics_exporter.h
+ * @brief Prometheus text endpoint serving the monitor's live counters
+ * @author Nicholas Loo
+ * @date 14/10/26
+ *
+ * A long-lived monitor needs continuous visibility, not a summary at
+ * shutdown: how far it is behind the writer, match and flush rates. The
+ * exporter runs its own thread with a minimal HTTP/1.0 server; each
+ * scrape of /metrics renders the counters from the relaxed atomics the
+ * monitor already keeps (getStatistics) plus a stat() for the lag, so the
+ * hot loop is never locked, signalled or slowed. Rates are left to
+ * Prometheus (rate() over the _total counters).
+ *
+ * @code
+ *   MetricsExporter exporter("127.0.0.1", 9102, [&] { return renderMetrics(monitor); });
+ *   // curl http://127.0.0.1:9102/metrics
+ * @endcode
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+
+class LogMonitor;
+class MultiLogMonitor;
+
+/**
+ * @class MetricsText
+ * @brief Builds Prometheus text exposition format (version 0.0.4)
+ */
+class MetricsText {
+public:
+    /**
+     * @brief Starts a metric family: # HELP and # TYPE lines
+     * @param name Metric name, e.g. "log_monitor_lines_processed_total"
+     * @param type "counter" or "gauge"
+     * @param help One line description
+     */
+    void family(const std::string& name, const char* type, const char* help);
+
+    /**
+     * @brief One sample of the current family
+     * @param name Metric name (as passed to family)
+     * @param value Sample value
+     * @param label Optional label name, e.g. "source"; labelValue is escaped
+     */
+    void sample(const std::string& name, uint64_t value,
+                const char* label = nullptr, const std::string& labelValue = "");
+
+    /// family() + sample() for an unlabeled metric
+    void metric(const std::string& name, const char* type, const char* help, uint64_t value);
+
+    const std::string& str() const { return out_; }
+
+private:
+    std::string out_;
+};
+
+/**
+ * @brief /metrics body for a single-file monitor
+ *
+ * Counters (lines, matches, bytes, long lines, flushes, rotations,
+ * checkpoints, pipeline stalls) and gauges for the read offset, bytes
+ * behind the writer and the pipeline queue depths (0 unless pipelined).
+ */
+std::string renderMetrics(const LogMonitor& monitor);
+
+/**
+ * @brief /metrics body for a multi-file monitor, one sample per source
+ *
+ * Same counters with a source="path" label, plus bytes behind per source
+ * and the summed output flushes.
+ */
+std::string renderMetrics(const MultiLogMonitor& monitor);
+
+/**
+ * @class MetricsExporter
+ * @brief Serves GET /metrics on a background thread
+ *
+ * One connection at a time, Connection: close; a scrape takes
+ * microseconds, so that is plenty for Prometheus and curl. Anything but
+ * GET /metrics gets 404.
+ */
+class MetricsExporter {
+public:
+    using Render = std::function<std::string()>;
+
+    /**
+     * @brief Binds, listens and starts the server thread
+     * @param host IPv4 address to bind, e.g. "127.0.0.1" or "0.0.0.0"
+     * @param port TCP port, 0 picks a free one (see port())
+     * @param render Builds the response body; called on the server thread
+     * @throw std::runtime_error if the address is invalid or can't be bound
+     */
+    MetricsExporter(const std::string& host, uint16_t port, Render render);
+
+    /**
+     * @brief Stops and joins the server thread, closes the socket
+     */
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    /// Bound port (the chosen one when constructed with 0)
+    uint16_t port() const { return port_; }
+
+    /// Scrapes answered so far
+    uint64_t scrapes() const { return scrapes_.load(std::memory_order_relaxed); }
+
+private:
+    void serve();
+    void handle(int client);
+
+    Render render_;
+    int listenFd_ = -1;
+    int wakePipe_[2] = {-1, -1};  ///< Written by the destructor to end poll()
+    uint16_t port_ = 0;
+    std::atomic<uint64_t> scrapes_{0};
+    std::thread thread_;
+};
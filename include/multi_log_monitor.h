@@ -0,0 +1,336 @@
+/**
+ * @file multi_log_monitor.h
+ * @brief One process tailing many log files from a small worker pool
+ * @author Nicholas Loo
+ * @date 14/10/26
+ *
+ * LogMonitor is one input, one output and one thread blocked in start().
+ * Tailing hundreds of per-strategy logs that way costs a thread, a read
+ * buffer and a watcher per file. MultiLogMonitor keeps only small
+ * per-source state (offset, partial line, counters) and shares everything
+ * else: one event loop, a fixed worker pool with one read buffer per
+ * worker, and one writer per distinct output path.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "keyword_matcher.h"
+#include "output_writer.h"
+#include "input_source.h"
+#include "arena.h"
+#include "stat_counter.h"
+
+/**
+ * @class MultiLogMonitor
+ * @brief Event loop + worker pool over many (input, output, keywords) sources
+ *
+ * Event loop (the thread in start()):
+ * - Linux: epoll over one inotify descriptor, with one watch per distinct
+ *   parent directory, plus an eventfd for stop(). An event naming a
+ *   source's file schedules that source.
+ * - Elsewhere: every source is scheduled each pollIntervalMs.
+ * - Every recheckMs all sources are scheduled anyway, as in
+ *   LogMonitor::EVENT_RECHECK_MS, for filesystems without events.
+ *
+ * Workers pop scheduled sources from a ready queue. A source is only ever
+ * handled by one worker at a time, so its lines stay in file order. Events
+ * that arrive while it is being read mark it to be queued again. A worker
+ * does at most readsPerTurn reads before requeueing a source, so one busy
+ * file can't starve the rest.
+ *
+ * Line rules match LogMonitor::processLine (empty lines skipped, truncation
+ * at Config::maxLineLength, the rest of the line skipped). Matches of one read are collected in the
+ * worker's staging buffer and then written under the output's lock, so
+ * sources sharing an output only serialise on the write, not on matching.
+ *
+ * Idle cost is per event, not per file: nothing runs for a source until
+ * its file changes (or the recheck fires). Memory is
+ * workerThreads * bufferSize plus a few hundred bytes per source; a
+ * partial line only takes memory while a source actually has one.
+ */
+class MultiLogMonitor {
+public:
+    /**
+     * @brief When matched lines are written to an output file
+     * @see OutputWriter::FlushPolicy
+     */
+    using FlushPolicy = OutputWriter::FlushPolicy;
+
+    /**
+     * @brief On-disk format of output files
+     * @see OutputWriter::Compression
+     */
+    using Compression = OutputWriter::Compression;
+
+    /**
+     * @brief How input files are read
+     * @see InputSource::Backend
+     */
+    using InputBackend = InputSource::Backend;
+
+    /**
+     * @struct Source
+     * @brief One tailed file and where its matches go
+     */
+    struct Source {
+        std::string inputFile;              ///< Log file to tail (may not exist yet)
+        std::string outputFile;             ///< Empty = Config::outputFile (shared)
+        std::vector<std::string> keywords;  ///< Empty = Config::keywords
+    };
+
+    /**
+     * @struct Config
+     * @brief Sources plus shared defaults and pool sizing
+     */
+    struct Config {
+        std::vector<Source> sources;                ///< Files to tail
+        std::string outputFile;                     ///< Default output for sources without one
+        std::vector<std::string> keywords;          ///< Default keywords for sources without any
+        bool ignoreCase = false;                    ///< ASCII case-insensitive keywords
+        bool wholeWord = false;                     ///< Keywords only hit whole words
+        size_t workerThreads = 2;                   ///< Reader/matcher threads shared by all sources
+        size_t bufferSize = 64 * 1024;              ///< Read buffer per worker, not per source
+        size_t maxLineLength = 5000;                ///< Longer lines are truncated, the rest skipped (LogMonitor default)
+        size_t readsPerTurn = 16;                   ///< Reads before a busy source goes to the back
+        int recheckMs = 1000;                       ///< Safety-net rescan of all sources, 0 = never
+        int pollIntervalMs = 10;                    ///< Rescan interval without inotify
+        InputBackend inputBackend = InputBackend::Posix;  ///< pread() or std::ifstream reads
+        FlushPolicy flushPolicy = FlushPolicy::PerLine;   ///< Durability vs throughput of output
+        size_t flushBytes = 64 * 1024;              ///< Pending bytes that trigger a flush (FlushPolicy::Bytes)
+        uint64_t flushIntervalUs = 1000;            ///< Max age of pending output in us (FlushPolicy::Interval)
+        Compression outputCompression = Compression::None;  ///< Background zstd / gzip frames for every output
+        int compressionLevel = 0;                   ///< 0 = the format's fastest level
+        uint64_t frameIntervalMs = 1000;            ///< Max age of a compressed frame before it is cut
+        size_t arenaLimit = 50 * 1024 * 1024;       ///< Max arenaBytes() the config may need, 0 = no limit
+        bool hugePages = false;                     ///< Back the arena with 2MB pages (hugetlb, else THP)
+    };
+
+    /**
+     * @struct Statistics
+     * @brief Snapshot of one source's counters, or the sum over all sources
+     */
+    struct Statistics {
+        uint64_t linesProcessed = 0;      ///< Non-empty lines matched against
+        uint64_t linesMatched = 0;        ///< Lines written to the output
+        uint64_t bytesRead = 0;           ///< Bytes read from the input
+        uint64_t longLinesDiscarded = 0;  ///< Lines truncated to Config::maxLineLength
+        uint64_t turns = 0;               ///< Times a worker picked the source up
+        uint64_t rotations = 0;           ///< Input replaced or truncated and reread from 0
+        uint64_t readOffset = 0;          ///< Input offset read up to (per source only, 0 in sums)
+    };
+
+    /**
+     * @brief Opens every distinct output and builds the matchers
+     * @param config Sources and defaults
+     * @throw std::runtime_error if there are no sources, an output cannot
+     *        be opened, a source has neither its own nor a default output,
+     *        or the buffers would exceed Config::arenaLimit
+     *
+     * Inputs are opened lazily by the workers, so missing files are fine.
+     */
+    explicit MultiLogMonitor(const Config& config);
+
+    /**
+     * @brief Stops, joins the workers and flushes every output
+     */
+    ~MultiLogMonitor();
+
+    MultiLogMonitor(const MultiLogMonitor&) = delete;
+    MultiLogMonitor& operator=(const MultiLogMonitor&) = delete;
+
+    /**
+     * @brief Runs the event loop and worker pool until stop() (blocking)
+     *
+     * Every source is read once on entry, so existing content is processed
+     * before waiting for events. Outputs are flushed before returning.
+     */
+    void start();
+
+    /**
+     * @brief Stops the event loop; safe from other threads and signal handlers
+     */
+    void stop();
+
+    /**
+     * @brief Number of configured sources
+     */
+    size_t sourceCount() const { return sources_.size(); }
+
+    /**
+     * @brief Counters for source index (order of Config::sources), any thread
+     */
+    Statistics getSourceStatistics(size_t index) const;
+
+    /**
+     * @brief Input size minus readOffset for source index (a stat(), any thread)
+     */
+    uint64_t bytesBehind(size_t index) const;
+
+    /**
+     * @brief Input path of source index
+     */
+    const std::string& sourcePath(size_t index) const { return sources_.at(index)->inputFile; }
+
+    /**
+     * @brief Counters summed over all sources, any thread
+     */
+    Statistics getStatistics() const;
+
+    /**
+     * @brief Event loop wakeups so far (events, rechecks and timeouts)
+     */
+    uint64_t wakeupCount() const { return wakeups_.load(); }
+
+    /**
+     * @brief Write batches issued over all outputs
+     */
+    uint64_t outputFlushes() const;
+
+    /**
+     * @brief Arena capacity a monitor with this config reserves
+     *
+     * Per worker a read buffer and a matches buffer, per source a
+     * partial-line carry, per distinct output a staging buffer; one arena
+     * shared by all of them, fixed for the monitor's lifetime.
+     */
+    static size_t arenaBytes(const Config& config);
+
+    /**
+     * @brief The shared buffer arena (see arenaBytes())
+     */
+    const Arena& arena() const { return arena_; }
+
+private:
+    /**
+     * @struct Output
+     * @brief One writer shared by every source routed to its path
+     */
+    struct Output {
+        std::string path;
+        std::mutex mutex;                      ///< Workers write whole batches under it
+        std::unique_ptr<OutputWriter> writer;
+    };
+
+    /// Scheduling state of a source, guarded by queueMutex_
+    enum class State {
+        Idle,        ///< Waiting for an event
+        Queued,      ///< In ready_
+        Active,      ///< A worker is reading it
+        ActiveDirty  ///< Being read and changed again meanwhile: requeue after
+    };
+
+    /**
+     * @struct SourceState
+     * @brief Everything kept per tailed file
+     */
+    struct SourceState {
+        std::string inputFile;
+        std::string name;                      ///< File name within its directory (event filter)
+        const KeywordMatcher* matcher;
+        Output* output;
+        std::unique_ptr<InputSource> input;
+        uint64_t offset = 0;                   ///< Next read position
+        FixedBuffer partialLine;               ///< Unterminated tail (arena), empty most of the time
+        bool discardingLine = false;           ///< Skipping the rest of an over-long partialLine
+        State state = State::Idle;
+
+        // written only by the worker currently holding the source
+        StatCounter linesProcessed;
+        StatCounter linesMatched;
+        StatCounter bytesRead;
+        StatCounter longLinesDiscarded;
+        StatCounter turns;
+        StatCounter rotations;
+        StatCounter readOffset;                ///< offset, for pollers
+    };
+
+    /**
+     * @struct Worker
+     * @brief Per-thread buffers, reused for every source
+     */
+    struct Worker {
+        char* buffer = nullptr;                ///< Read buffer (Config::bufferSize, arena)
+        FixedBuffer matches;                   ///< Matched lines of one read, '\n' terminated (arena)
+    };
+
+    /**
+     * @struct WatchedDir
+     * @brief One inotify watch and the sources living in that directory
+     */
+    struct WatchedDir {
+        std::string path;
+        int wd = -1;
+        std::unordered_map<std::string, std::vector<size_t>> byName;  ///< File name -> source indices
+    };
+
+    /// Queues source index unless it's already queued; marks an active one dirty
+    void scheduleLocked(size_t index);
+
+    /// Queues every source (start, recheck, inotify overflow)
+    void scheduleAll();
+
+    /// Worker thread body
+    void workerLoop(Worker& worker);
+
+    /**
+     * @brief Reads up to readsPerTurn buffers of one source
+     * @return true if the source still had data when the budget ran out
+     */
+    bool drain(SourceState& source, Worker& worker);
+
+    /// LogMonitor::handleRotation for one source, true if it was rotated
+    bool handleRotation(SourceState& source, Worker& worker);
+
+    /// Splits a read into lines, collects matches into worker.matches
+    void processBuffer(SourceState& source, Worker& worker, const char* data, size_t len);
+
+    /// Carries an unterminated tail, as LogMonitor::carryPartialLine
+    void carryPartialLine(SourceState& source, const char* data, size_t len);
+
+    /// Applies the line rules, appends a match to worker.matches
+    void processLine(SourceState& source, Worker& worker, std::string_view line);
+
+    /// Writes worker.matches to the source's output under its lock
+    void writeMatches(SourceState& source, Worker& worker);
+
+    /// Sets up the inotify/epoll descriptors (constructor), false where unsupported
+    bool setupEvents();
+
+    /// Blocks for events up to timeoutMs and schedules affected sources
+    void waitForEvents(int timeoutMs);
+
+    /// Runs tick() on every output (FlushPolicy::Interval while idle)
+    void tickOutputs();
+
+    Config config_;
+    Arena arena_;                              ///< Backs every buffer, outlives outputs_ and sources_
+    std::vector<Worker> workerState_;          ///< One per worker thread, carved at construction
+    std::vector<std::unique_ptr<KeywordMatcher>> matchers_;  ///< [0] = default keywords
+    std::vector<std::unique_ptr<Output>> outputs_;           ///< One per distinct path
+    std::vector<std::unique_ptr<SourceState>> sources_;
+    std::vector<WatchedDir> dirs_;
+
+    std::mutex queueMutex_;
+    std::condition_variable queueCv_;
+    std::deque<size_t> ready_;                 ///< Scheduled source indices
+
+    std::vector<std::thread> workers_;
+    std::atomic<bool> running_{false};
+    StatCounter wakeups_;                      ///< Event loop thread only
+
+    bool events_ = false;                      ///< inotify active (else poll every pollIntervalMs)
+    int inotifyFd_ = -1;
+    int epollFd_ = -1;
+    int wakeFd_ = -1;                          ///< eventfd poked by stop()
+};
@@ -0,0 +1,201 @@
+/**
+ * @file output_writer.h
+ * @brief Batched output writer for matched lines with configurable flushing
+ * @author Nicholas Loo
+ * @date 14/10/26
+ *
+ * Replaces the per-line std::ofstream::flush() in LogMonitor. Matched lines
+ * are gathered into iovec batches and written with writev(), and the flush
+ * policy decides when a batch goes to the kernel. That trades durability
+ * (how much can be lost if the process dies) against syscalls per match.
+ *
+ * With Options::compression set, batches go to a CompressedSink instead
+ * and reach the file as zstd frames / gzip members from its thread.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <sys/uio.h>
+#include "stat_counter.h"
+
+class Arena;
+class CompressedSink;
+
+/**
+ * @class OutputWriter
+ * @brief Append-only writer with per-line / byte / time / buffer flush policies
+ *
+ * Pending output is a list of iovecs:
+ * - Copied lines live in a fixed staging buffer allocated once up front
+ *   (from the owner's Arena if given), so the steady state never allocates.
+ * - With FlushPolicy::PerBuffer, lines handed in via writeLine(line, true)
+ *   are referenced in place (zero-copy). The caller must keep that memory
+ *   alive until endOfBuffer(), which writes the whole batch with writev().
+ *
+ * "Flush" here means handing the data to the kernel with write(2), after
+ * which it survives a process crash. It does not fsync.
+ *
+ * @note Not thread-safe; owned and driven by a single monitor thread
+ */
+class OutputWriter {
+public:
+    /**
+     * @brief When pending output is written to the file
+     */
+    enum class FlushPolicy {
+        PerLine,    ///< One writev per matched line (most durable, old behaviour)
+        Bytes,      ///< When at least flushBytes are pending
+        Interval,   ///< When the oldest pending line is flushIntervalUs old
+        PerBuffer   ///< Once per input buffer, lines referenced zero-copy
+    };
+
+    /**
+     * @brief On-disk format of the output file
+     */
+    enum class Compression {
+        None,  ///< Plain text, written on the calling thread
+        Gzip,  ///< One gzip member per frame (needs zlib)
+        Zstd   ///< One zstd frame per frame, content size in the header (needs zstd)
+    };
+
+    /**
+     * @struct Options
+     * @brief Flush tuning
+     */
+    struct Options {
+        FlushPolicy policy = FlushPolicy::PerLine;  ///< Flush trigger
+        size_t flushBytes = 64 * 1024;              ///< Threshold for FlushPolicy::Bytes
+        uint64_t flushIntervalUs = 1000;            ///< Max age for FlushPolicy::Interval
+        Compression compression = Compression::None;  ///< Compress in the background
+        int compressionLevel = 0;                   ///< 0 = fastest (1 for both formats)
+        size_t frameBytes = 1024 * 1024;            ///< Uncompressed bytes per frame
+        uint64_t frameIntervalMs = 1000;            ///< Max age of a frame before it is cut
+    };
+
+    /**
+     * @brief Opens path for appending
+     * @param path Output file path (created if missing)
+     * @param options Flush policy and thresholds
+     * @param arena Backs the staging buffer (stagingSize() bytes), null = own
+     *              heap buffer; must outlive the writer
+     * @throw std::runtime_error if the file cannot be opened or arena is full
+     */
+    OutputWriter(const std::string& path, const Options& options, Arena* arena = nullptr);
+
+    /**
+     * @brief Flushes anything pending and closes the file
+     *
+     * Write errors are swallowed here since destructors must not throw.
+     */
+    ~OutputWriter();
+
+    OutputWriter(const OutputWriter&) = delete;
+    OutputWriter& operator=(const OutputWriter&) = delete;
+
+    /**
+     * @brief Queues one line, a '\n' is appended
+     * @param line Line without trailing newline
+     * @param stable true if line's memory, plus the one byte after it, stays
+     *               valid until endOfBuffer(); only used by
+     *               FlushPolicy::PerBuffer to skip the copy. If that byte is
+     *               the line's own '\n' it is referenced too, so adjacent
+     *               matched lines collapse into one iovec.
+     * @throw std::runtime_error on write failure
+     */
+    void writeLine(std::string_view line, bool stable = false);
+
+    /**
+     * @brief Marks the end of an input buffer
+     *
+     * FlushPolicy::PerBuffer writes the batch here; all other policies
+     * never hold references, so this is a no-op for them.
+     */
+    void endOfBuffer();
+
+    /**
+     * @brief Periodic check while idle so FlushPolicy::Interval data
+     *        (and an aged compressed frame) does not wait for the next
+     *        matched line
+     */
+    void tick();
+
+    /**
+     * @brief Writes all pending data now
+     * @throw std::runtime_error on write failure
+     *
+     * Compressed: also cuts the frame and waits until the sink has
+     * written it, so fileSize() is a frame boundary afterwards.
+     */
+    void flush();
+
+    /**
+     * @brief Current size of the output file (pending data not included)
+     * @throw std::runtime_error if fstat fails
+     */
+    uint64_t fileSize() const;
+    
+    /**
+     * @brief Cuts the file back to size, dropping anything pending
+     * @param size New length, e.g. a checkpoint's output offset
+     * @throw std::runtime_error if ftruncate fails
+     *
+     * O_APPEND means later writes continue at the new end.
+     */
+    void truncate(uint64_t size);
+    
+    /**
+     * @brief Number of write batches issued so far (one syscall or more each)
+     * 
+     * Safe to read from any thread.
+     */
+    uint64_t flushCount() const { return flushes_; }
+
+    /**
+     * @brief Bytes currently queued and not yet written
+     */
+    size_t pendingBytes() const { return pendingBytes_; }
+
+    /**
+     * @brief Staging buffer size for these options, for sizing an Arena
+     */
+    static size_t stagingSize(const Options& options);
+
+    /**
+     * @brief Background compressor, null without Options::compression
+     *
+     * Its counters are safe to read from any thread.
+     */
+    const CompressedSink* sink() const { return sink_.get(); }
+
+private:
+    /// Writes the iovec batch (to the sink if compressing), no sync
+    void writePending();
+
+    /// Appends bytes to the staging buffer and the iovec list
+    void stage(const char* data, size_t len);
+
+    /// Appends an iovec, merging with the previous one when contiguous
+    void pushIov(const char* data, size_t len);
+
+    /// writev() loop over iov_, handling partial writes and EINTR; or a sink append
+    void writeAll(iovec* iov, size_t count);
+
+    std::string path_;                       ///< For error messages
+    Options options_;                        ///< Flush policy
+    int fd_ = -1;                            ///< O_APPEND file descriptor
+    std::unique_ptr<char[]> ownedStaging_;   ///< staging_ when there's no arena
+    char* staging_ = nullptr;                ///< Copies of lines not referenced in place
+    size_t stagingCapacity_ = 0;             ///< Size of staging_
+    size_t stagingUsed_ = 0;                 ///< Bytes used in staging_
+    std::vector<iovec> iov_;                 ///< Pending output, reserved to IOV_MAX
+    size_t pendingBytes_ = 0;                ///< Total bytes described by iov_
+    std::chrono::steady_clock::time_point oldestPending_;  ///< For FlushPolicy::Interval
+    StatCounter flushes_;                    ///< Write batches issued
+    std::unique_ptr<CompressedSink> sink_;   ///< Background compressor, null when plain
+};
@@ -0,0 +1,147 @@
+/**
+ * @file parallel_scanner.h
+ * @brief Multi-threaded filtering of large in-memory regions of complete lines
+ * @author Nicholas Loo
+ * @date 14/10/26
+ *
+ * Used on the backlog path (mmap catch-up windows), where a region is
+ * hundreds of MB of already-written lines. The region is cut into large
+ * newline-aligned chunks that are filtered on a small thread pool, and
+ * matches are handed back in file order through a reorder buffer.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "keyword_matcher.h"
+
+/**
+ * @class ParallelScanner
+ * @brief Thread pool that filters newline-aligned chunks in parallel
+ *
+ * Line rules are identical to LogMonitor::processLine: empty lines are
+ * skipped, lines over maxLineLength are truncated (and counted) before
+ * matching. All workers share one const KeywordMatcher.
+ *
+ * Ordering: each chunk collects its matches as string_views into the
+ * region. The calling thread emits chunk i only after chunks 0..i-1, and
+ * works on pending chunks itself while it waits, so threads = N uses N
+ * cores including the caller.
+ *
+ * @note scan() is not reentrant; one caller at a time
+ */
+class ParallelScanner {
+public:
+    /**
+     * @brief Default chunk size (4MB)
+     *
+     * Large enough that per-chunk overhead (wakeup, result vector) is noise,
+     * small enough that a 256MB window keeps 32 cores busy.
+     */
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 4 * 1024 * 1024;
+
+    /**
+     * @struct Result
+     * @brief Line counters for one scan() call
+     */
+    struct Result {
+        uint64_t lines = 0;      ///< Non-empty lines seen
+        uint64_t longLines = 0;  ///< Lines truncated to maxLineLength
+        uint64_t matched = 0;    ///< Lines passed to the match callback
+    };
+
+    /**
+     * @brief Called on the scanning thread, in file order, for every match
+     */
+    using MatchFn = std::function<void(std::string_view line)>;
+
+    /**
+     * @brief Starts threads - 1 workers (the caller is the last one)
+     * @param matcher Shared matcher, must outlive the scanner
+     * @param threads Total threads including the caller (min 1)
+     * @param maxLineLength Truncation limit, as LogMonitor::MAX_LINE_LENGTH
+     * @param chunkSize Target chunk size; chunks extend to the next '\n'
+     */
+    ParallelScanner(const KeywordMatcher& matcher, size_t threads, size_t maxLineLength,
+                    size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+    /**
+     * @brief Stops and joins the workers
+     */
+    ~ParallelScanner();
+
+    ParallelScanner(const ParallelScanner&) = delete;
+    ParallelScanner& operator=(const ParallelScanner&) = delete;
+
+    /**
+     * @brief Filters a region of complete lines
+     * @param data Region start
+     * @param len Region length; must end with '\n'
+     * @param onMatch Receives matched (truncated) lines in order; the views
+     *                point into data
+     * @return Line counters for the region
+     */
+    Result scan(const char* data, size_t len, const MatchFn& onMatch);
+
+    /**
+     * @brief Total threads used by scan(), including the caller
+     */
+    size_t threadCount() const { return workers_.size() + 1; }
+
+    /**
+     * @brief Configured chunk size
+     */
+    size_t chunkSize() const { return chunkSize_; }
+    
+    /**
+     * @brief Uses another matcher from the next scan() on
+     * @param matcher Must outlive the scanner; call between scans only
+     */
+    void setMatcher(const KeywordMatcher& matcher) { matcher_ = &matcher; }
+
+private:
+    /**
+     * @struct Chunk
+     * @brief One unit of work and its slot in the reorder buffer
+     */
+    struct Chunk {
+        const char* data = nullptr;
+        size_t len = 0;
+        std::vector<std::string_view> matches;  ///< Reused across scans
+        uint64_t lines = 0;
+        uint64_t longLines = 0;
+        bool done = false;                      ///< Guarded by mutex_
+    };
+
+    /// Worker thread body: wait for a job, drain chunks, repeat
+    void workerLoop();
+
+    /// Claims and filters chunks until none are left; false if none claimed
+    bool runChunks();
+
+    /// Filters one chunk into its result slot
+    void scanChunk(Chunk& chunk) const;
+
+    const KeywordMatcher* matcher_;
+    const size_t maxLineLength_;
+    const size_t chunkSize_;
+
+    std::vector<std::thread> workers_;
+    std::vector<Chunk> chunks_;          ///< Current job, sized per scan()
+    size_t chunkCount_ = 0;              ///< Chunks in the current job
+    std::atomic<size_t> nextChunk_{0};   ///< Work-claiming cursor
+
+    std::mutex mutex_;
+    std::condition_variable workCv_;     ///< Workers: new job or shutdown
+    std::condition_variable doneCv_;     ///< Caller: a chunk finished / worker idle
+    uint64_t jobId_ = 0;                 ///< Bumped per scan()
+    size_t activeWorkers_ = 0;           ///< Workers inside the current job
+    bool stopping_ = false;
+};
@@ -0,0 +1,227 @@
+/**
+ * @file pipeline.h
+ * @brief Reader / matcher / writer pipeline connected by SPSC rings
+ * @author Nicholas Loo
+ * @date 14/10/26
+ *
+ * Splits the monitor loop into three stages so a slow output write doesn't
+ * stall reading and a burst of reads doesn't stall matching:
+ *
+ *   reader (LogMonitor::start thread) -> matcher thread(s) -> writer thread
+ *
+ * Blocks of complete lines circulate through lock-free SPSC rings. All
+ * blocks are allocated up front, so the steady state never allocates.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <sys/types.h>
+#include "arena.h"
+#include "keyword_matcher.h"
+#include "output_writer.h"
+#include "input_source.h"
+#include "line_index.h"
+#include "field_filter.h"
+#include "spsc_ring.h"
+#include "stat_counter.h"
+
+/**
+ * @class Pipeline
+ * @brief Pre-allocated block pool plus matcher and writer threads
+ *
+ * Reader side (read(), called on the monitor thread):
+ * - reads into the current block after the carried partial line
+ * - hands everything up to the last '\n' to a matcher, round-robin
+ * - copies the unterminated tail into the next free block; a tail longer
+ *   than maxLineLength + 1 is cut there and the rest of that line is
+ *   dropped, so the carry is bounded
+ *
+ * Matcher i has its own input and output ring. It applies processLine's
+ * rules to each line and compacts the matched (truncated) lines, each with
+ * its '\n', to the front of the block in place.
+ *
+ * The writer pops the output rings in the same round-robin order, which
+ * restores file order, writes the compacted lines and returns the block
+ * to the free ring.
+ *
+ * With one matcher ring per matcher and one free ring back to the
+ * reader, every ring has exactly one producer and one consumer.
+ */
+class Pipeline {
+public:
+    /**
+     * @struct Options
+     * @brief Pipeline sizing
+     */
+    struct Options {
+        size_t matcherThreads = 1;   ///< Matcher stage threads
+        size_t blocks = 16;          ///< Blocks in the pool (min 2)
+        size_t readSize = 64 * 1024; ///< Bytes per read() call
+        size_t maxLineLength = 5000; ///< Truncation limit
+        LineIndexWriter* index = nullptr;  ///< Fed every byte read, optional
+        const FieldFilter* filter = nullptr;  ///< Evaluated on group 0 candidates, optional
+        Arena* arena = nullptr;      ///< Backs the block pool (arenaBytes()), optional
+        std::vector<int> cpus;       ///< cpus[i] pins matcher i, cpus[matcherThreads] the writer; missing or -1 = unpinned
+    };
+
+    /**
+     * @struct Stats
+     * @brief Line counters and per-stage counters
+     *
+     * A stall is one episode of a stage waiting on a ring. The stage with
+     * the fewest stalls under load is the bottleneck: the others wait on it.
+     */
+    struct Stats {
+        uint64_t lines = 0;            ///< Non-empty lines matched against
+        uint64_t longLines = 0;        ///< Lines truncated to maxLineLength
+        uint64_t matched = 0;          ///< Lines written
+        uint64_t readerStalls = 0;     ///< Reader waited for a free block
+        uint64_t matcherStalls = 0;    ///< Matchers waited for input (all threads)
+        uint64_t writerStalls = 0;     ///< Writer waited for a matched block
+        uint64_t matchQueueDepth = 0;  ///< Blocks read, not yet matched
+        uint64_t writeQueueDepth = 0;  ///< Blocks matched, not yet written
+    };
+
+    /**
+     * @brief Allocates all blocks and rings; threads start in start()
+     * @param matcher Shared matcher, must outlive the pipeline
+     * @param writer Output, only touched by the writer thread while running
+     * @param options Sizing
+     */
+    Pipeline(const KeywordMatcher& matcher, OutputWriter& writer, const Options& options);
+
+    /**
+     * @brief Routed variant: a matched line goes to writers[i] for each group i it hits
+     * @param matcher Shared matcher with one group per writer (matchGroups())
+     * @param writers Outputs, only touched by the writer thread while running
+     * @param options Sizing
+     */
+    Pipeline(const KeywordMatcher& matcher, std::vector<OutputWriter*> writers,
+             const Options& options);
+
+    /**
+     * @brief Drains and joins if still running
+     */
+    ~Pipeline();
+
+    Pipeline(const Pipeline&) = delete;
+    Pipeline& operator=(const Pipeline&) = delete;
+
+    /**
+     * @brief Arena capacity the block pool takes with Options::arena
+     */
+    static size_t arenaBytes(const Options& options);
+
+    /**
+     * @brief Starts the matcher and writer threads
+     */
+    void start();
+
+    /**
+     * @brief Processes everything read so far, then joins the threads
+     *
+     * The partial line being carried is kept for a later start().
+     */
+    void finish();
+    
+    /**
+     * @brief Uses another matcher (same groups) from the next start() on
+     * @param matcher Must outlive the pipeline; call while stopped only
+     */
+    void setMatcher(const KeywordMatcher& matcher) { matcher_ = &matcher; }
+
+    /**
+     * @brief Reader stage: one read from input at offset
+     * @param input Open input file
+     * @param offset File offset to read from
+     * @return Bytes read, 0 at EOF, -1 on error (as InputSource::read)
+     */
+    ssize_t read(InputSource& input, uint64_t offset);
+
+    /**
+     * @brief Drops the carried partial line (input reopened from scratch)
+     */
+    void discardPartial();
+    
+    /**
+     * @brief Ends the current file: the carried partial line is matched as
+     *        if it were '\n' terminated (rotation, so it can't be continued)
+     */
+    void endOfFile();
+    
+    /**
+     * @brief Bytes read but not yet handed to a matcher (reader thread)
+     *
+     * The carried partial line plus whatever of it was dropped past the
+     * carry limit, so lastOffset - carriedBytes() is where that line starts.
+     */
+    uint64_t carriedBytes() const { return used_ + dropped_; }
+
+    /**
+     * @brief Snapshot of counters and queue depths, any thread
+     */
+    Stats stats() const;
+
+private:
+    /**
+     * @struct Block
+     * @brief Unit of work: complete lines in, compacted matches out
+     */
+    struct Block {
+        char* data = nullptr;          ///< readSize + maxLineLength + 1 bytes
+        std::unique_ptr<char[]> owned; ///< data, without an arena
+        size_t len = 0;                ///< Bytes of complete lines
+        size_t outLen = 0;             ///< Bytes of compacted matches at the front
+        uint64_t lines = 0;
+        uint64_t longLines = 0;
+        uint64_t matched = 0;
+        std::vector<KeywordMatcher::GroupMask> groups;  ///< Per compacted line, routed only
+    };
+
+    /// Pops a free block, waiting (and counting a stall) if none is free
+    Block* acquireFree();
+
+    /// Matcher stage body for ring index
+    void matcherLoop(size_t index);
+
+    /// Writer stage body
+    void writerLoop();
+
+    /// Filters a block and compacts matches in place
+    void matchBlock(Block& block) const;
+
+    const KeywordMatcher* matcher_;
+    const std::vector<OutputWriter*> writers_;  ///< Group i -> output
+    const Options options_;
+
+    std::vector<Block> pool_;
+    SpscRing<Block*> freeRing_;                           ///< writer -> reader
+    std::vector<std::unique_ptr<SpscRing<Block*>>> matchRings_;  ///< reader -> matcher i
+    std::vector<std::unique_ptr<SpscRing<Block*>>> writeRings_;  ///< matcher i -> writer
+
+    // reader state (monitor thread only)
+    Block* current_ = nullptr;   ///< Block being filled
+    size_t used_ = 0;            ///< Carried bytes at the front of current_
+    bool discarding_ = false;    ///< Dropping the rest of an over-long line
+    uint64_t dropped_ = 0;       ///< Bytes of the carried line dropped so far
+    size_t nextMatcher_ = 0;     ///< Round-robin cursor
+
+    std::vector<std::thread> matchers_;
+    std::thread writerThread_;
+    std::atomic<bool> readerDone_{false};
+    std::atomic<size_t> matchersDone_{0};
+
+    // padded counters, written by one stage each (matcher stalls are
+    // shared by all matcher threads, so that one is a real fetch_add)
+    StatCounter lines_;
+    StatCounter longLines_;
+    StatCounter matched_;
+    StatCounter readerStalls_;
+    StatCounter writerStalls_;
+    alignas(64) std::atomic<uint64_t> matcherStalls_{0};
+};
@@ -0,0 +1,57 @@
+/**
+ * @file placement.h
+ * @brief CPU pinning and NUMA node lookup for the monitor's threads
+ * @author Nicholas Loo
+ * @date 14/10/26
+ *
+ * On multi-socket machines a thread that migrates away from its buffers
+ * pays remote-memory latency on every read and match. Linux places a page
+ * on the node of the thread that first touches it, so pinning a thread
+ * before it builds or first writes its buffers keeps them node-local; no
+ * libnuma needed. Elsewhere these are no-ops that report failure.
+ */
+
+#pragma once
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+/**
+ * @brief Restricts the calling thread to one CPU
+ * @return false if cpu is not allowed for this process or pinning failed
+ */
+bool pinCurrentThread(int cpu);
+
+/**
+ * @brief Whether this process may run on cpu (its affinity mask at startup)
+ */
+bool cpuAllowed(int cpu);
+
+/**
+ * @brief NUMA node the calling thread is running on, -1 if unknown
+ */
+int currentNumaNode();
+
+/**
+ * @class ScopedPin
+ * @brief Pins the calling thread for one scope, then puts its affinity back
+ *
+ * For work that should first-touch memory on a CPU's node without leaving
+ * the caller's thread pinned (e.g. building a monitor on main).
+ */
+class ScopedPin {
+public:
+    /// cpu < 0 does nothing
+    explicit ScopedPin(int cpu);
+    ~ScopedPin();
+
+    ScopedPin(const ScopedPin&) = delete;
+    ScopedPin& operator=(const ScopedPin&) = delete;
+
+private:
+    bool saved_ = false;
+#if defined(__linux__)
+    cpu_set_t mask_;  ///< Caller's affinity before the pin
+#endif
+};
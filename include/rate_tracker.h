@@ -0,0 +1,67 @@
+/**
+ * @file rate_tracker.h
+ * @brief Sliding-window throughput rates from periodic counter samples
+ * @author Nicholas Loo
+ * @date 14/10/26
+ *
+ * Rates are derived on the polling side from successive snapshots, so the
+ * monitor's hot path pays nothing for them.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+
+/**
+ * @class RateTracker
+ * @brief Lines/s, bytes/s and matches/s over the last `window`
+ *
+ * Each sample() records the cumulative counters with a timestamp and drops
+ * samples older than the window. The rate is the counter delta between the
+ * oldest kept sample and the newest one, divided by the time between them.
+ *
+ * @note Not thread-safe; one poller (LogMonitor::getRates locks around it)
+ */
+class RateTracker {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @struct Rates
+     * @brief Per-second rates over the window
+     */
+    struct Rates {
+        double linesPerSec = 0;    ///< Lines processed per second
+        double bytesPerSec = 0;    ///< Input bytes per second
+        double matchesPerSec = 0;  ///< Lines matched per second
+        double windowSec = 0;      ///< Time actually covered by the samples
+    };
+
+    /**
+     * @param window Sliding window length
+     */
+    explicit RateTracker(Clock::duration window = std::chrono::seconds(10));
+
+    /**
+     * @brief Records cumulative counters and returns the current rates
+     * @param lines Total lines processed so far
+     * @param bytes Total bytes read so far
+     * @param matches Total lines matched so far
+     * @param now Sample time
+     * @return Rates over the window (zero until two samples exist)
+     */
+    Rates sample(uint64_t lines, uint64_t bytes, uint64_t matches, Clock::time_point now = Clock::now());
+
+private:
+    struct Sample {
+        Clock::time_point time;
+        uint64_t lines;
+        uint64_t bytes;
+        uint64_t matches;
+    };
+
+    Clock::duration window_;
+    std::deque<Sample> samples_;  ///< Oldest first, bounded by poll rate * window
+};
@@ -0,0 +1,111 @@
+/**
+ * @file repeat_suppressor.h
+ * @brief Rate limit for matched lines that repeat one template
+ * @author Nicholas Loo
+ * @date 14/10/26
+ *
+ * During incidents one ERROR or REJECT line repeats thousands of times a
+ * second, differing only in timestamp, OrderID, price and so on, and the
+ * output path saturates just when the monitor most needs to keep up. A
+ * line's template is its text with every run of digits masked; the first
+ * `limit` lines of a template per window are written, the rest are only
+ * counted and summed up in one "repeated K times" line when the window
+ * ends.
+ */
+
+#pragma once
+
+#include "arena.h"
+#include "output_writer.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @class RepeatSuppressor
+ * @brief Fixed-size open-addressing table of templates, carved from an Arena
+ *
+ * One hash per matched line, a short linear probe, no allocation. Slots
+ * are never freed, a slot whose window has ended is reused in place. If
+ * every slot a template probes is busy the line is simply written.
+ *
+ * Time is only read once per buffer (tick()), so windows are as precise as
+ * the gaps between reads.
+ *
+ * @note Single-threaded, owned by the monitor thread
+ */
+class RepeatSuppressor {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// Slots probed per lookup before giving up on a template
+    static constexpr size_t MAX_PROBES = 16;
+
+    /// Prefix of a suppressed line kept for its summary
+    static constexpr size_t SAMPLE_BYTES = 120;
+
+    /**
+     * @param limit Lines of one template written per window, at least 1
+     * @param windowMs Window length
+     * @param slots Templates tracked at once, rounded up to a power of two
+     * @param arena Backs the table, see arenaBytes()
+     */
+    RepeatSuppressor(size_t limit, uint64_t windowMs, size_t slots, Arena& arena);
+
+    /**
+     * @brief Whether a matched line is written
+     *
+     * Writes the summary of the template's previous window to `out` first
+     * if that one just ended with repeats.
+     */
+    bool admit(std::string_view line, OutputWriter& out);
+
+    /**
+     * @brief Advances the clock; once a window, summarises every ended window
+     */
+    void tick(Clock::time_point now, OutputWriter& out);
+
+    /**
+     * @brief Summarises every window with repeats, ended or not (shutdown)
+     */
+    void finish(OutputWriter& out);
+
+    /// Lines not written so far
+    uint64_t suppressed() const { return suppressed_; }
+
+    /**
+     * @brief Hash of the line with each run of digits replaced by one marker
+     */
+    static uint64_t templateHash(std::string_view line);
+
+    /**
+     * @brief Arena capacity the constructor carves
+     */
+    static size_t arenaBytes(size_t slots);
+
+private:
+    struct Slot {
+        uint64_t hash;         ///< 0 = never used
+        uint64_t windowStart;  ///< ms since construction
+        uint64_t count;        ///< Lines seen in the window, 0 once summarised
+        uint32_t sampleLength; ///< Bytes kept in the slot's sample
+    };
+
+    static size_t tableSize(size_t slots);
+
+    bool expired(const Slot& slot) const { return slot.count == 0 || now_ - slot.windowStart >= windowMs_; }
+    void summarise(Slot& slot, OutputWriter& out);
+
+    Slot* slots_;                ///< tableSize() slots in the arena
+    char* samples_;              ///< SAMPLE_BYTES per slot
+    char* summary_;              ///< Summary line being formatted
+    size_t mask_;                ///< tableSize() - 1
+    uint64_t limit_;
+    uint64_t windowMs_;
+    Clock::time_point start_;
+    uint64_t now_ = 0;           ///< ms since start_, as of the last tick()
+    uint64_t lastSweep_ = 0;
+    uint64_t suppressed_ = 0;
+};
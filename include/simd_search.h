@@ -0,0 +1,119 @@
+/**
+ * @file simd_search.h
+ * @brief Vectorized substring search kernels with runtime CPU dispatch
+ * @author Nicholas Loo
+ * @date 14/10/26
+ *
+ * Implements the "first/last byte" prefilter: for a needle of length k,
+ * compare 16/32 haystack bytes at a time against needle[0] and the bytes
+ * k-1 positions further against needle[k-1]. Only positions where both
+ * agree are verified with an exact memcmp. On log lines that do not
+ * contain the keyword this almost never reaches the exact compare.
+ *
+ * Kernels are compiled side by side (SSE2, AVX2 via target attributes, NEON
+ * on ARM) and the best one for the running CPU is picked once at startup,
+ * so a single binary runs across the fleet.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace simd {
+
+/**
+ * @brief Available search kernels
+ */
+enum class Kernel {
+    Scalar,  ///< std::string_view::find (portable fallback)
+    SSE2,    ///< 16 bytes per step, baseline on x86-64
+    AVX2,    ///< 32 bytes per step, selected when the CPU supports it
+    NEON     ///< 16 bytes per step on AArch64
+};
+
+/**
+ * @brief Signature shared by all kernels
+ * @param haystack Text to search
+ * @param n Length of haystack
+ * @param needle Pattern to find
+ * @param k Length of needle
+ * @return Offset of the first occurrence, or std::string_view::npos
+ */
+using SearchFn = size_t (*)(const char* haystack, size_t n, const char* needle, size_t k);
+
+/**
+ * @struct LineCounts
+ * @brief Result of a vectorized newline scan
+ */
+struct LineCounts {
+    size_t lines = 0;      ///< Non-empty '\n'-terminated lines
+    size_t longLines = 0;  ///< Lines longer than the given limit
+};
+
+/**
+ * @brief Signature of the line counting kernels
+ * @param data Start of a line
+ * @param n Bytes to scan; bytes after the last '\n' are ignored
+ * @param maxLineLength Lines longer than this are reported in longLines
+ */
+using LineCountFn = LineCounts (*)(const char* data, size_t n, size_t maxLineLength);
+
+/**
+ * @brief Returns the fastest kernel supported by the running CPU
+ *
+ * Detection runs once (cpuid on x86) and the result is cached.
+ */
+Kernel bestKernel();
+
+/**
+ * @brief Checks whether a kernel can run on this CPU
+ */
+bool isSupported(Kernel kernel);
+
+/**
+ * @brief Returns the search function for a kernel
+ * @param kernel Kernel to resolve; must be supported (see isSupported)
+ */
+SearchFn searchFunction(Kernel kernel);
+
+/**
+ * @brief Returns the ASCII case-insensitive search function for a kernel
+ * @param kernel Kernel to resolve; must be supported (see isSupported)
+ *
+ * The needle must already be lower case. The haystack is folded inside
+ * the compare (block | 0x20 on letter positions), never copied.
+ */
+SearchFn searchFunctionIgnoreCase(Kernel kernel);
+
+/**
+ * @brief Returns the line counting function for a kernel
+ * @param kernel Kernel to resolve; must be supported (see isSupported)
+ */
+LineCountFn lineCountFunction(Kernel kernel);
+
+/**
+ * @brief Human readable kernel name for logging and benchmarks
+ */
+const char* kernelName(Kernel kernel);
+
+/**
+ * @brief Finds needle in haystack with the best available kernel
+ */
+inline size_t find(std::string_view haystack, std::string_view needle) {
+    static const SearchFn fn = searchFunction(bestKernel());
+    return fn(haystack.data(), haystack.size(), needle.data(), needle.size());
+}
+
+/**
+ * @brief Counts complete lines the same way LogMonitor::processLine does
+ *
+ * Empty lines are skipped and lines over maxLineLength are reported, so the
+ * result can stand in for calling processLine on every line.
+ */
+inline LineCounts countLines(const char* data, size_t n, size_t maxLineLength) {
+    static const LineCountFn fn = lineCountFunction(bestKernel());
+    return fn(data, n, maxLineLength);
+}
+
+} // namespace simd
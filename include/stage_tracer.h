@@ -0,0 +1,130 @@
+/**
+ * @file stage_tracer.h
+ * @brief Per-stage tick histograms for the monitor's hot path
+ * @author Nicholas Loo
+ * @date 14/10/26
+ *
+ * Answers "where did the time go" when throughput drops: read syscalls,
+ * buffer processing (newline scan + match + output), the matcher and the
+ * output writer on their own, flushes and idle waits. Ticks come from
+ * rdtsc on x86 (a few ns to read) and steady_clock elsewhere; the report
+ * converts them to ns against steady_clock over the traced period.
+ *
+ * Per-buffer stages are timed on every buffer. Per-line stages (Match,
+ * Write) are timed on 1 in SAMPLE_EVERY lines, which keeps the cost well
+ * under 1% of a ~100ns line; their totals are scaled back up in the
+ * report.
+ */
+
+#pragma once
+
+#include "latency_histogram.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/**
+ * @class StageTracer
+ * @brief Tick histograms per stage plus read sizes and loop counts
+ *
+ * @note Not thread-safe: written by the one thread running the monitor
+ *       loop. Read it from that thread (LogMonitor dumps on request) or
+ *       once the loop has returned.
+ */
+class StageTracer {
+public:
+    /**
+     * @brief Timed stages
+     */
+    enum class Stage {
+        Read,    ///< One input read() / pipeline read
+        Buffer,  ///< processBuffer: split, match and output of one read
+        Match,   ///< Matcher call for one line (sampled)
+        Write,   ///< Handing one matched line to the outputs (sampled)
+        Flush,   ///< End-of-buffer output flush
+        Idle,    ///< One wait for new input
+        Count
+    };
+
+    /// Per-line stages time 1 line in this many (power of two)
+    static constexpr uint32_t SAMPLE_EVERY = 64;
+
+    StageTracer();
+
+    /**
+     * @brief Current tick count (rdtsc, or steady_clock ns)
+     */
+    static uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    /**
+     * @brief Adds one timed occurrence of a stage
+     * @param stage Stage measured
+     * @param ticks now() after minus now() before
+     */
+    void record(Stage stage, uint64_t ticks) {
+        stages_[static_cast<size_t>(stage)].record(ticks);
+    }
+
+    /**
+     * @brief True on every SAMPLE_EVERY-th call (per-line sampling)
+     */
+    bool sampleLine() {
+        return (++lineTick_ & (SAMPLE_EVERY - 1)) == 0;
+    }
+
+    /**
+     * @brief Records the size of one read
+     */
+    void recordRead(size_t bytes) { readSizes_.record(bytes); }
+
+    /**
+     * @brief Counts a monitor loop iteration
+     * @param busy true if it read data, false if it went idle
+     */
+    void countLoop(bool busy) { ++(busy ? busyLoops_ : idleLoops_); }
+
+    /**
+     * @brief Histogram of a stage, in ticks
+     */
+    const LatencyHistogram& stage(Stage stage) const { return stages_[static_cast<size_t>(stage)]; }
+
+    const LatencyHistogram& readSizes() const { return readSizes_; }  ///< Bytes per read
+    uint64_t busyLoops() const { return busyLoops_; }  ///< Loop iterations that read data
+    uint64_t idleLoops() const { return idleLoops_; }  ///< Loop iterations that waited
+
+    /**
+     * @brief Ticks per nanosecond measured since construction (1 without rdtsc)
+     */
+    double ticksPerNs() const;
+
+    /**
+     * @brief Human readable table: count, p50/p99/max ns, total ms and share per stage
+     */
+    std::string report() const;
+
+    /// Printable stage name
+    static const char* stageName(Stage stage);
+
+private:
+    static constexpr size_t STAGES = static_cast<size_t>(Stage::Count);
+
+    LatencyHistogram stages_[STAGES];
+    LatencyHistogram readSizes_;
+    uint64_t busyLoops_ = 0;
+    uint64_t idleLoops_ = 0;
+    uint32_t lineTick_ = 0;
+    uint64_t startTicks_;                               ///< now() at construction
+    std::chrono::steady_clock::time_point startTime_;  ///< steady_clock at construction
+};
@@ -0,0 +1,61 @@
+/**
+ * @file stat_counter.h
+ * @brief Cache-line padded single-writer counter readable from any thread
+ * @author Nicholas Loo
+ * @date 14/10/26
+ *
+ * Statistics are bumped on the hot path by exactly one thread each and
+ * polled by dashboards from others. A relaxed load + store is all the
+ * writer needs (no lock-prefixed read-modify-write), and the reader still
+ * gets a torn-free value without a data race.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @class StatCounter
+ * @brief Monotonic counter with one writer thread and any number of readers
+ *
+ * Padded to a cache line so counters owned by different threads (e.g. the
+ * pipeline's reader and writer stages) never false share.
+ *
+ * @warning Only one thread may modify a given counter; concurrent writers
+ *          would lose increments. Use std::atomic::fetch_add for that.
+ */
+class alignas(64) StatCounter {
+public:
+    StatCounter() = default;
+    StatCounter(const StatCounter&) = delete;
+    StatCounter& operator=(const StatCounter&) = delete;
+
+    /// Adds n (writer thread only)
+    void add(uint64_t n) {
+        value_.store(value_.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    StatCounter& operator+=(uint64_t n) {
+        add(n);
+        return *this;
+    }
+
+    StatCounter& operator++() {
+        add(1);
+        return *this;
+    }
+
+    void operator++(int) { add(1); }
+
+    /// Overwrites the value (writer thread only), for gauges and resets
+    void set(uint64_t n) { value_.store(n, std::memory_order_relaxed); }
+
+    /// Current value, any thread
+    uint64_t load() const { return value_.load(std::memory_order_relaxed); }
+
+    operator uint64_t() const { return load(); }
+
+private:
+    std::atomic<uint64_t> value_{0};
+};
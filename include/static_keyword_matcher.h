@@ -0,0 +1,161 @@
+/**
+ * @file static_keyword_matcher.h
+ * @brief Keyword matcher generated at compile time for a fixed keyword set
+ * @author Nicholas Loo
+ * @date 14/10/26
+ *
+ * Deployments with a known keyword set such as {"REJECT", "ERROR", "FILL"}
+ * don't need the runtime machinery of KeywordMatcher (keyword vector,
+ * per-keyword kernel pointer calls, loop over keywords). Here the keywords
+ * are template arguments, so every length, first and last byte is a
+ * constant: each vector block is loaded once and checked against all
+ * keywords in an unrolled sequence, and candidate checks are fixed-size
+ * memcmps the compiler inlines.
+ *
+ * C++17 has no string literal template arguments, so keywords are named
+ * constant arrays:
+ * @code
+ *   constexpr char REJECT[] = "REJECT";
+ *   constexpr char FILL[] = "FILL";
+ *   using OrderMatcher = StaticKeywordMatcher<REJECT, FILL>;
+ *   OrderMatcher::matches(line);
+ *
+ *   // or inside LogMonitor / anything taking a KeywordMatcher
+ *   config.keywords = OrderMatcher::keywords();
+ *   config.staticMatch = &OrderMatcher::matches;
+ * @endcode
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace static_match {
+
+/// strlen usable in constant expressions
+constexpr size_t length(const char* s) {
+    size_t n = 0;
+    while (s[n] != '\0') ++n;
+    return n;
+}
+
+/// Longest of the keywords
+template <const char*... Keywords>
+constexpr size_t maxLength() {
+    size_t longest = 0;
+    ((longest = length(Keywords) > longest ? length(Keywords) : longest), ...);
+    return longest;
+}
+
+} // namespace static_match
+
+/**
+ * @class StaticKeywordMatcher
+ * @brief Substring match against a keyword set fixed at compile time
+ * @tparam Keywords Null-terminated constant arrays with linkage, non-empty
+ *
+ * Same semantics as KeywordMatcher::matches(): case-sensitive substring
+ * search, true if any keyword occurs. Everything is static, there is no
+ * state and no allocation; matches() is plain function so it converts to
+ * KeywordMatcher::StaticMatchFn.
+ *
+ * Block width follows the compile flags: 32 bytes with AVX2 (Release
+ * builds use -march=native), 16 with SSE2, scalar otherwise.
+ */
+template <const char*... Keywords>
+class StaticKeywordMatcher {
+public:
+    static_assert(sizeof...(Keywords) > 0, "at least one keyword");
+    static_assert(((static_match::length(Keywords) > 0) && ...), "keywords must not be empty");
+
+    /// Number of keywords
+    static constexpr size_t COUNT = sizeof...(Keywords);
+
+    /// Longest keyword, bytes past a block the vector loop may read
+    static constexpr size_t MAX_LENGTH = static_match::maxLength<Keywords...>();
+
+    /**
+     * @brief Checks if text contains any of the keywords
+     * @param text Text to search
+     */
+    static bool matches(std::string_view text) {
+        const char* data = text.data();
+        const size_t n = text.size();
+        size_t i = 0;
+#if defined(__AVX2__)
+        for (; i + 32 + MAX_LENGTH - 1 <= n; i += 32) {
+            if ((avx2Block<Keywords>(data + i) || ...)) return true;
+        }
+#elif defined(__SSE2__)
+        for (; i + 16 + MAX_LENGTH - 1 <= n; i += 16) {
+            if ((sse2Block<Keywords>(data + i) || ...)) return true;
+        }
+#endif
+        // short text, or less than a block plus the longest keyword left
+        const std::string_view rest = text.substr(i);
+        return ((rest.find(std::string_view(Keywords, static_match::length(Keywords))) !=
+                 std::string_view::npos) || ...);
+    }
+
+    /**
+     * @brief The keywords as strings, e.g. for KeywordMatcher or printing
+     */
+    static std::vector<std::string> keywords() {
+        return {std::string(Keywords)...};
+    }
+
+private:
+    /// Middle bytes of a candidate whose first and last byte already match
+    template <const char* K>
+    static bool verify(const char* candidate) {
+        constexpr size_t L = static_match::length(K);
+        return L <= 2 || std::memcmp(candidate + 1, K + 1, L - 2) == 0;
+    }
+
+    /// Walks the candidate bits of a block mask
+    template <const char* K>
+    static bool verifyMask(uint32_t mask, const char* block) {
+        while (mask) {
+            if (verify<K>(block + __builtin_ctz(mask))) return true;
+            mask &= mask - 1;
+        }
+        return false;
+    }
+
+#if defined(__AVX2__)
+    /// K starting at one of the 32 positions at p; reads p[0, 32 + len - 1)
+    template <const char* K>
+    static bool avx2Block(const char* p) {
+        constexpr size_t L = static_match::length(K);
+        const __m256i first = _mm256_set1_epi8(K[0]);
+        const __m256i last = _mm256_set1_epi8(K[L - 1]);
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + L - 1));
+        const uint32_t mask = static_cast<uint32_t>(
+            _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, first), _mm256_cmpeq_epi8(b, last))));
+        return mask && verifyMask<K>(mask, p);
+    }
+#elif defined(__SSE2__)
+    /// K starting at one of the 16 positions at p; reads p[0, 16 + len - 1)
+    template <const char* K>
+    static bool sse2Block(const char* p) {
+        constexpr size_t L = static_match::length(K);
+        const __m128i first = _mm_set1_epi8(K[0]);
+        const __m128i last = _mm_set1_epi8(K[L - 1]);
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + L - 1));
+        const uint32_t mask = static_cast<uint32_t>(
+            _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last))));
+        return mask && verifyMask<K>(mask, p);
+    }
+#endif
+};
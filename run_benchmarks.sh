@@ -1,27 +1,37 @@
-cat > ../run_benchmarks.sh << 'EOF'
 #!/bin/bash
+# ============================================================================
+# run_benchmarks.sh - run the benchmarks and keep a JSON result per run
+# usage: ./run_benchmarks.sh [FILTER_REGEX] (e.g. "EndToEnd|WriteToOutput")
+# ============================================================================
 
 set -e
 
 BUILD_DIR="build_Release"
+RESULTS_DIR="benchmark_results"
+FILTER="${1:-.}"
 
 if [ ! -f "$BUILD_DIR/log_monitor_benchmark" ]; then
     echo "Error: Benchmarks not built. Run ./build.sh first."
     exit 1
 fi
 
+mkdir -p "$RESULTS_DIR"
+STAMP="$(date +%Y%m%d_%H%M%S)"
+COMMIT="$(git rev-parse --short HEAD 2>/dev/null || echo nogit)"
+OUT="$(pwd)/$RESULTS_DIR/${STAMP}_${COMMIT}.json"
+
 echo "=== Running HFT Log Monitor Benchmarks ==="
 echo ""
 
+# benchmark files are created in the working directory
 cd "$BUILD_DIR"
 ./log_monitor_benchmark \
-    --benchmark_out=benchmark_results.json \
+    --benchmark_filter="$FILTER" \
+    --benchmark_out="$OUT" \
     --benchmark_out_format=json \
     --benchmark_repetitions=3 \
     --benchmark_report_aggregates_only=true
 
 echo ""
-echo "Benchmark results saved to: $BUILD_DIR/benchmark_results.json"
-EOF
-
-chmod +x ../run_benchmarks.sh
+echo "Benchmark results saved to: $OUT"
+echo "Compare two runs with google benchmark's tools/compare.py benchmarks OLD.json NEW.json"
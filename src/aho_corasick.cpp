@@ -0,0 +1,295 @@
+/**
+ * @file aho_corasick.cpp
+ * @brief Implementation of the AhoCorasick automaton
+ * @author Nicholas Loo
+ * @date 14/10/26
+ */
+
+#include "aho_corasick.h"
+#include <queue>
+
+/**
+ * @brief Builds the dense DFA for the given patterns
+ *
+ * Build steps:
+ * 1. Assign byte equivalence classes (one per distinct pattern byte)
+ * 2. Insert patterns into a trie indexed by class
+ * 3. BFS to compute failure links, filling missing edges from the
+ *    failure state so every (state, class) pair has a direct target
+ * 4. Flatten into row offsets with the accept flag folded in
+ *
+ * @param patterns Patterns to compile
+ * @param masks Per-pattern masks for collect(), empty = bit 0 each
+ * @param ignoreCase Lower case the patterns and fold the class map
+ * @param wholeWord Keep the patterns ending in each state for wordHit()
+ *
+ * Space complexity: O(states * classes) uint32_t entries. For 1000 order IDs
+ * of ~10 chars that is roughly 10k states * 40 classes = 1.6MB.
+ */
+AhoCorasick::AhoCorasick(const std::vector<std::string>& inputPatterns,
+                         const std::vector<uint64_t>& masks,
+                         bool ignoreCase, bool wholeWord)
+    : wholeWord_(wholeWord) {
+    auto maskOf = [&masks](size_t i) { return i < masks.size() ? masks[i] : 1; };
+    
+    std::vector<std::string> folded;
+    if (ignoreCase) {
+        folded = inputPatterns;
+        for (auto& pattern : folded) {
+            for (char& c : pattern) {
+                if (c >= 'A' && c <= 'Z') c = static_cast<char>(c | 0x20);
+            }
+        }
+    }
+    const std::vector<std::string>& patterns = ignoreCase ? folded : inputPatterns;
+    
+    // collect which bytes are actually used by the patterns
+    std::array<bool, 256> used{};
+    size_t distinct = 0;
+    for (size_t i = 0; i < patterns.size(); ++i) {
+        const std::string& pattern = patterns[i];
+        if (pattern.empty()) {
+            matchesEmpty_ = true;
+            emptyMask_ |= maskOf(i);
+        }
+        for (unsigned char c : pattern) {
+            if (!used[c]) {
+                used[c] = true;
+                distinct++;
+            }
+        }
+    }
+
+    // class 0 is "byte not in any pattern"; if every byte is used there are
+    // no leftovers and the classes are just the bytes themselves
+    if (distinct == 256) {
+        for (size_t b = 0; b < 256; ++b) {
+            byteClass_[b] = static_cast<uint8_t>(b);
+        }
+        numClasses_ = 256;
+    } else {
+        numClasses_ = 1;
+        for (size_t b = 0; b < 256; ++b) {
+            if (used[b]) {
+                byteClass_[b] = static_cast<uint8_t>(numClasses_++);
+            }
+        }
+    }
+
+    // upper case bytes walk the same edges as their lower case letter
+    if (ignoreCase) {
+        for (unsigned c = 'A'; c <= 'Z'; ++c) {
+            byteClass_[c] = byteClass_[c | 0x20];
+        }
+    }
+
+    const size_t classes = numClasses_;
+
+    // trie with -1 for missing edges, flattened row-major
+    std::vector<int32_t> trie(classes, -1);
+    std::vector<uint8_t> terminal(1, 0);
+    std::vector<uint64_t> mask(1, 0);
+    std::vector<std::vector<Output>> outputs(1);
+
+    for (size_t i = 0; i < patterns.size(); ++i) {
+        size_t state = 0;
+        for (unsigned char c : patterns[i]) {
+            int32_t& edge = trie[state * classes + byteClass_[c]];
+            if (edge < 0) {
+                edge = static_cast<int32_t>(terminal.size());
+                terminal.push_back(0);
+                mask.push_back(0);
+                outputs.emplace_back();
+                trie.resize(trie.size() + classes, -1);
+            }
+            // edge reference may be stale after resize, re-read via index
+            state = static_cast<size_t>(trie[state * classes + byteClass_[c]]);
+        }
+        terminal[state] = 1;
+        mask[state] |= maskOf(i);
+        if (wholeWord_ && !patterns[i].empty()) {
+            const std::string& pattern = patterns[i];
+            outputs[state].push_back({static_cast<uint32_t>(pattern.size()),
+                                      isWordByte(static_cast<unsigned char>(pattern.front())),
+                                      isWordByte(static_cast<unsigned char>(pattern.back())),
+                                      maskOf(i)});
+        }
+    }
+
+    const size_t states = terminal.size();
+    std::vector<int32_t> fail(states, 0);
+    std::queue<int32_t> bfs;
+
+    // root: missing edges loop back to root, children fail to root
+    for (size_t c = 0; c < classes; ++c) {
+        int32_t& edge = trie[c];
+        if (edge < 0) {
+            edge = 0;
+        } else {
+            fail[edge] = 0;
+            bfs.push(edge);
+        }
+    }
+
+    // BFS guarantees fail[s] is fully resolved before s is expanded
+    while (!bfs.empty()) {
+        int32_t state = bfs.front();
+        bfs.pop();
+        const size_t row = static_cast<size_t>(state) * classes;
+        const size_t failRow = static_cast<size_t>(fail[state]) * classes;
+
+        for (size_t c = 0; c < classes; ++c) {
+            int32_t child = trie[row + c];
+            if (child >= 0) {
+                fail[child] = trie[failRow + c];
+                terminal[child] |= terminal[fail[child]];
+                mask[child] |= mask[fail[child]];  // suffixes that are patterns too
+                const auto& suffixOutputs = outputs[fail[child]];
+                outputs[child].insert(outputs[child].end(), suffixOutputs.begin(), suffixOutputs.end());
+                bfs.push(child);
+            } else {
+                trie[row + c] = trie[failRow + c];
+            }
+        }
+    }
+
+    // flatten: store target row offset with accept flag in the top bit
+    accepting_ = std::move(terminal);
+    stateMask_ = std::move(mask);
+    if (wholeWord_) {
+        outputBegin_.reserve(states + 1);
+        for (const auto& list : outputs) {
+            outputBegin_.push_back(static_cast<uint32_t>(outputs_.size()));
+            outputs_.insert(outputs_.end(), list.begin(), list.end());
+        }
+        outputBegin_.push_back(static_cast<uint32_t>(outputs_.size()));
+    }
+    table_.resize(states * classes);
+    for (size_t i = 0; i < table_.size(); ++i) {
+        uint32_t target = static_cast<uint32_t>(trie[i]);
+        table_[i] = target * numClasses_ | (accepting_[target] ? ACCEPT_BIT : 0);
+    }
+}
+
+/**
+ * @brief Runs the DFA over text, stopping at the first accepting state
+ *
+ * One class lookup + one table lookup per byte, no branches other than the
+ * accept check. The 256-byte class map and the hot rows near the root
+ * stay resident in L1 for typical log lines.
+ *
+ * @param text Text to search
+ * @return true if any pattern occurs in text
+ */
+bool AhoCorasick::contains(std::string_view text) const {
+    if (matchesEmpty_) {
+        return true;
+    }
+
+    if (wholeWord_) {
+        return findEnd(text) != std::string_view::npos;
+    }
+
+    const uint32_t* table = table_.data();
+    uint32_t row = 0;
+    for (unsigned char c : text) {
+        uint32_t next = table[row + byteClass_[c]];
+        if (next & ACCEPT_BIT) {
+            return true;  // early exit on first match
+        }
+        row = next;
+    }
+    return false;
+}
+
+/**
+ * @brief Same DFA walk as contains(), returning the position of the hit
+ *
+ * @param text Text to search
+ * @return Offset of the byte that completed the first match, or npos
+ */
+size_t AhoCorasick::findEnd(std::string_view text) const {
+    if (matchesEmpty_) {
+        return 0;
+    }
+
+    const uint32_t* table = table_.data();
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(text.data());
+    uint32_t row = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        uint32_t next = table[row + byteClass_[bytes[i]]];
+        if (next & ACCEPT_BIT) {
+            next &= ~ACCEPT_BIT;
+            uint64_t mask = 0;
+            if (!wholeWord_ || wordHit(next / numClasses_, text, i, mask)) {
+                return i;
+            }
+        }
+        row = next;
+    }
+    return std::string_view::npos;
+}
+
+/**
+ * @brief DFA walk that ORs state masks on every accepting transition
+ *
+ * The state index is only recovered (one division) on accepting
+ * transitions, so lines without hits cost the same as contains().
+ *
+ * @param text Text to search
+ * @param all Early-exit mask
+ * @return Union of the masks of all patterns found
+ */
+uint64_t AhoCorasick::collect(std::string_view text, uint64_t all) const {
+    uint64_t found = emptyMask_;
+    if (found == all && found != 0) {
+        return found;
+    }
+
+    const uint32_t* table = table_.data();
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(text.data());
+    uint32_t row = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        uint32_t next = table[row + byteClass_[bytes[i]]];
+        if (next & ACCEPT_BIT) {
+            next &= ~ACCEPT_BIT;
+            if (wholeWord_) {
+                wordHit(next / numClasses_, text, i, found);
+            } else {
+                found |= stateMask_[next / numClasses_];
+            }
+            if (found == all) {
+                return found;  // nothing left to find
+            }
+        }
+        row = next;
+    }
+    return found;
+}
+
+/**
+ * @brief Checks the word boundaries of every pattern ending at end
+ *
+ * Only reached on accepting transitions, so lines without hits pay
+ * nothing for whole-word mode.
+ *
+ * @param state DFA state after the byte at end
+ * @param text Text being searched
+ * @param end Offset of the last byte of the hits
+ * @param mask Receives the masks of the patterns that are whole words
+ * @return true if one of them is
+ */
+bool AhoCorasick::wordHit(uint32_t state, std::string_view text, size_t end, uint64_t& mask) const {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(text.data());
+    const bool endOk = end + 1 == text.size() || !isWordByte(bytes[end + 1]);
+    bool hit = false;
+    for (uint32_t i = outputBegin_[state]; i < outputBegin_[state + 1]; ++i) {
+        const Output& output = outputs_[i];
+        const size_t start = end + 1 - output.length;
+        if ((!output.wordEnd || endOk) && (!output.wordStart || start == 0 || !isWordByte(bytes[start - 1]))) {
+            mask |= output.mask;
+            hit = true;
+        }
+    }
+    return hit;
+}
@@ -0,0 +1,100 @@
+/**
+ * @file arena.cpp
+ * @brief Implementation of Arena and FixedBuffer
+ * @author Nicholas Loo
+ * @date 14/10/26
+ */
+
+#include "arena.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+
+namespace {
+
+size_t roundUp(size_t n, size_t alignment) {
+    return (n + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+/**
+ * @brief One page-aligned block; untouched pages cost no memory until used
+ *
+ * THP only backs 2MB aligned ranges, so that mapping is over-allocated by
+ * a huge page and trimmed to the aligned part.
+ */
+Arena::Arena(size_t capacity, bool hugePages)
+    : capacity_(capacity) {
+    if (hugePages) {
+        const size_t length = roundUp(std::max<size_t>(capacity, 1), HUGE_PAGE);
+#ifdef MAP_HUGETLB
+        void* p = ::mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) {
+            base_ = static_cast<char*>(p);
+            mapped_ = length;
+            backing_ = Backing::HugeTlb;
+            return;
+        }
+#endif
+#ifdef MADV_HUGEPAGE
+        void* q = ::mmap(nullptr, length + HUGE_PAGE, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (q != MAP_FAILED) {
+            char* raw = static_cast<char*>(q);
+            char* aligned = reinterpret_cast<char*>(roundUp(reinterpret_cast<uintptr_t>(raw), HUGE_PAGE));
+            if (aligned > raw) ::munmap(raw, aligned - raw);
+            const size_t tail = (raw + length + HUGE_PAGE) - (aligned + length);
+            if (tail > 0) ::munmap(aligned + length, tail);
+            base_ = aligned;
+            mapped_ = length;
+            backing_ = ::madvise(base_, length, MADV_HUGEPAGE) == 0 ? Backing::TransparentHuge
+                                                                    : Backing::Heap;
+            return;
+        }
+#endif
+    }
+    heap_ = makeAlignedBuffer(std::max<size_t>(capacity, ALIGNMENT));
+    base_ = heap_.get();
+}
+
+Arena::~Arena() {
+    if (mapped_ > 0) {
+        ::munmap(base_, mapped_);
+    }
+}
+
+char* Arena::allocate(size_t size, size_t alignment) {
+    alignment = std::max(alignment, ALIGNMENT);
+    const size_t start = roundUp(used_, alignment);
+    const size_t end = start + roundUp(size, ALIGNMENT);
+    if (end > capacity_) {
+        throw std::runtime_error("Arena exhausted: " + std::to_string(size) + " bytes requested, " +
+                                 std::to_string(used_) + " of " + std::to_string(capacity_) + " used");
+    }
+    used_ = end;
+    return base_ + start;
+}
+
+/**
+ * @brief Rounded size plus the worst-case padding in front of it
+ *
+ * used_ is always a multiple of ALIGNMENT, so at most alignment - ALIGNMENT
+ * bytes are skipped to align the start.
+ */
+size_t Arena::footprint(size_t size, size_t alignment) {
+    alignment = std::max(alignment, ALIGNMENT);
+    return roundUp(size, ALIGNMENT) + (alignment - ALIGNMENT);
+}
+
+void FixedBuffer::append(const char* data, size_t len) {
+    assert(size_ + len <= capacity_);
+    std::memcpy(data_ + size_, data, len);
+    size_ += len;
+}
@@ -0,0 +1,99 @@
+/**
+ * @file checkpoint.cpp
+ * @brief Implementation of the Checkpoint file format
+ * @author Nicholas Loo
+ * @date 14/10/26
+ */
+
+#include "checkpoint.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+/// First line of the file, bumped if the format changes
+const char* const HEADER = "log_monitor checkpoint v1";
+
+} // namespace
+
+/**
+ * @brief Temp file in the same directory, then rename() over the old one
+ *
+ * rename() within a filesystem is atomic, so a reader (or a restart after
+ * a crash mid-save) sees either the old checkpoint or the new one.
+ */
+bool Checkpoint::save(const std::string& path) const {
+    const std::string temp = path + ".tmp";
+    {
+        std::ofstream out(temp, std::ios::trunc);
+        if (!out.is_open()) return false;
+        out << HEADER << "\n"
+            << "device=" << device << "\n"
+            << "inode=" << inode << "\n"
+            << "input_offset=" << inputOffset << "\n"
+            << "tail_length=" << tailLength << "\n"
+            << "tail_hash=" << tailHash << "\n"
+            << "output_offset=" << outputOffset << "\n";
+        if (!routeOffsets.empty()) {
+            out << "route_offsets=";
+            for (size_t i = 0; i < routeOffsets.size(); ++i) {
+                out << (i ? "," : "") << routeOffsets[i];
+            }
+            out << "\n";
+        }
+        out.flush();
+        if (!out) return false;
+    }
+    return std::rename(temp.c_str(), path.c_str()) == 0;
+}
+
+bool Checkpoint::load(const std::string& path, Checkpoint& checkpoint) {
+    std::ifstream in(path);
+    std::string line;
+    if (!std::getline(in, line) || line != HEADER) {
+        return false;
+    }
+
+    Checkpoint parsed;
+    int fields = 0;
+    while (std::getline(in, line)) {
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) continue;
+        std::string key = line.substr(0, eq);
+        std::istringstream value(line.substr(eq + 1));
+        if (key == "route_offsets") {
+            // optional: only written with routed outputs
+            uint64_t offset;
+            while (value >> offset) {
+                parsed.routeOffsets.push_back(offset);
+                if (value.peek() == ',') value.ignore();
+            }
+            continue;
+        }
+        uint64_t* target = key == "device"        ? &parsed.device
+                         : key == "inode"         ? &parsed.inode
+                         : key == "input_offset"  ? &parsed.inputOffset
+                         : key == "tail_length"   ? &parsed.tailLength
+                         : key == "tail_hash"     ? &parsed.tailHash
+                         : key == "output_offset" ? &parsed.outputOffset
+                         : nullptr;
+        if (target && (value >> *target)) {
+            fields++;
+        }
+    }
+    if (fields != 6 || parsed.tailLength > TAIL_BYTES || parsed.tailLength > parsed.inputOffset) {
+        return false;
+    }
+    checkpoint = parsed;
+    return true;
+}
+
+uint64_t Checkpoint::hashTail(const char* data, size_t len) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < len; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
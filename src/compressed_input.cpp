@@ -0,0 +1,413 @@
+/**
+ * @file compressed_input.cpp
+ * @brief Implementation of the gzip / zstd input backend
+ * @author Nicholas Loo
+ * @date 14/10/26
+ */
+
+#include "compressed_input.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+#if LOG_MONITOR_GZIP
+#include <zlib.h>
+#endif
+#if LOG_MONITOR_ZSTD
+#include <zstd.h>
+#include <zstd_errors.h>
+#endif
+
+namespace {
+
+/// Decompressed bytes produced per decode step
+constexpr size_t OUTPUT_CHUNK = 256 * 1024;
+
+/// Smallest prefix that holds any zstd frame header
+constexpr size_t ZSTD_HEADER_MAX = 18;
+
+} // namespace
+
+/**
+ * @struct CompressedInputSource::Codec
+ * @brief Decoder state for the open file's format
+ */
+struct CompressedInputSource::Codec {
+    bool draining = false;  ///< Last step filled the output, the decoder may hold more
+#if LOG_MONITOR_GZIP
+    z_stream zs{};
+    bool zlibReady = false;
+#endif
+#if LOG_MONITOR_ZSTD
+    ZSTD_DStream* dstream = nullptr;
+    std::vector<ZSTD_DCtx*> dctx;  ///< One per frame decoded in parallel
+    bool streamingFrame = false;   ///< Inside a frame too big or unsized for the workers
+#endif
+
+    Codec(Format format, size_t threads) {
+#if LOG_MONITOR_GZIP
+        if (format == Format::Gzip) {
+            // 16 + MAX_WBITS: gzip wrapper only
+            if (inflateInit2(&zs, 16 + MAX_WBITS) != Z_OK) {
+                throw std::runtime_error("Failed to initialise zlib");
+            }
+            zlibReady = true;
+        }
+#endif
+#if LOG_MONITOR_ZSTD
+        if (format == Format::Zstd) {
+            dstream = ZSTD_createDStream();
+            if (threads > 1) {
+                for (size_t i = 0; i < threads; ++i) dctx.push_back(ZSTD_createDCtx());
+            }
+        }
+#endif
+        (void)format;
+        (void)threads;
+    }
+
+    ~Codec() {
+#if LOG_MONITOR_GZIP
+        if (zlibReady) inflateEnd(&zs);
+#endif
+#if LOG_MONITOR_ZSTD
+        ZSTD_freeDStream(dstream);
+        for (ZSTD_DCtx* ctx : dctx) ZSTD_freeDCtx(ctx);
+#endif
+    }
+};
+
+CompressedInputSource::CompressedInputSource(size_t threads)
+    : threads_(std::max<size_t>(threads, 1)) {}
+
+CompressedInputSource::~CompressedInputSource() {
+    close();
+}
+
+CompressedInputSource::Format CompressedInputSource::detect(const char* data, size_t len) {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(data);
+    if (len >= 2 && bytes[0] == 0x1f && bytes[1] == 0x8b) {
+        return Format::Gzip;
+    }
+    if (len >= 4 && bytes[0] == 0x28 && bytes[1] == 0xb5 && bytes[2] == 0x2f && bytes[3] == 0xfd) {
+        return Format::Zstd;
+    }
+    // skippable frame (0x184d2a5?), as pzstd writes first
+    if (len >= 4 && (bytes[0] & 0xf0) == 0x50 && bytes[1] == 0x2a && bytes[2] == 0x4d && bytes[3] == 0x18) {
+        return Format::Zstd;
+    }
+    return Format::Plain;
+}
+
+bool CompressedInputSource::supported(Format format) {
+    switch (format) {
+        case Format::Gzip: return LOG_MONITOR_GZIP != 0;
+        case Format::Zstd: return LOG_MONITOR_ZSTD != 0;
+        default: return true;
+    }
+}
+
+bool CompressedInputSource::open(const std::string& path) {
+    close();
+    fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0) {
+        return false;
+    }
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    char magic[4];
+    ssize_t n = ::pread(fd_, magic, sizeof(magic), 0);
+    format_ = detect(magic, n > 0 ? static_cast<size_t>(n) : 0);
+    if (!supported(format_)) {
+        close();
+        throw std::runtime_error("Built without " + std::string(format_ == Format::Gzip ? "zlib" : "zstd") +
+                                 ", can't read " + path);
+    }
+    rewind();
+    return true;
+}
+
+void CompressedInputSource::close() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    codec_.reset();
+    format_ = Format::Plain;
+}
+
+bool CompressedInputSource::fileId(FileId& id) const {
+    struct stat st;
+    if (fd_ < 0 || ::fstat(fd_, &st) != 0) {
+        return false;
+    }
+    id.device = static_cast<uint64_t>(st.st_dev);
+    id.inode = static_cast<uint64_t>(st.st_ino);
+    id.size = static_cast<uint64_t>(st.st_size);
+    return true;
+}
+
+/**
+ * @brief As InputSource::checkRotation, truncation judged on compressed bytes
+ */
+InputSource::Rotation CompressedInputSource::checkRotation(const std::string& path, uint64_t offset) const {
+    if (format_ == Format::Plain) {
+        return InputSource::checkRotation(path, offset);
+    }
+    return InputSource::checkRotation(path, inOffset_);
+}
+
+void CompressedInputSource::rewind() {
+    codec_ = std::make_unique<Codec>(format_, threads_);
+    in_.clear();
+    inPos_ = 0;
+    inOffset_ = 0;
+    readError_ = false;
+    out_.clear();
+    outPos_ = 0;
+    position_ = 0;
+}
+
+/**
+ * @brief Serves buffer from out_, decoding more as it runs dry
+ *
+ * Fills the whole len while compressed data lasts: a short read tells
+ * the monitor it has caught up with the writer.
+ */
+ssize_t CompressedInputSource::read(char* buffer, size_t len, uint64_t offset) {
+    if (fd_ < 0) return -1;
+    if (format_ == Format::Plain) {
+        while (true) {
+            ssize_t n = ::pread(fd_, buffer, len, static_cast<off_t>(offset));
+            if (n >= 0 || errno != EINTR) return n;
+        }
+    }
+
+    if (offset < position_) {
+        rewind();  // no way back in a compressed stream but from the start
+    }
+    size_t copied = 0;
+    while (copied < len) {
+        if (outPos_ == out_.size()) {
+            out_.clear();
+            outPos_ = 0;
+            if (!decode()) break;
+            continue;
+        }
+        const size_t available = out_.size() - outPos_;
+        if (position_ < offset) {
+            // forward jump (checkpoint resume): decompress and drop
+            const size_t skip = static_cast<size_t>(std::min<uint64_t>(available, offset - position_));
+            outPos_ += skip;
+            position_ += skip;
+            continue;
+        }
+        const size_t n = std::min(available, len - copied);
+        std::memcpy(buffer + copied, out_.data() + outPos_, n);
+        outPos_ += n;
+        position_ += n;
+        copied += n;
+    }
+    if (copied == 0 && readError_) return -1;
+    return static_cast<ssize_t>(copied);
+}
+
+bool CompressedInputSource::readInput() {
+    if (inPos_ > 0) {
+        in_.erase(in_.begin(), in_.begin() + static_cast<std::ptrdiff_t>(inPos_));
+        inPos_ = 0;
+    }
+    const size_t have = in_.size();
+    in_.resize(have + INPUT_CHUNK);
+    ssize_t n;
+    do {
+        n = ::pread(fd_, in_.data() + have, INPUT_CHUNK, static_cast<off_t>(inOffset_));
+    } while (n < 0 && errno == EINTR);
+    readError_ = n < 0;
+    in_.resize(have + (n > 0 ? static_cast<size_t>(n) : 0));
+    if (n <= 0) return false;
+    inOffset_ += static_cast<uint64_t>(n);
+    return true;
+}
+
+/**
+ * @brief One decode step; true if progress was made (out_ may still be empty)
+ */
+bool CompressedInputSource::decode() {
+    if (format_ == Format::Gzip) {
+        return decodeGzip();
+    }
+#if LOG_MONITOR_ZSTD
+    if (threads_ > 1 && !codec_->streamingFrame) {
+        return decodeZstdFrames();
+    }
+#endif
+    return decodeZstdStream();
+}
+
+/**
+ * @brief inflate() into out_; members are decoded back to back
+ */
+bool CompressedInputSource::decodeGzip() {
+#if LOG_MONITOR_GZIP
+    z_stream& zs = codec_->zs;
+    out_.resize(OUTPUT_CHUNK);
+    while (true) {
+        if (inPos_ == in_.size() && !codec_->draining && !readInput()) {
+            out_.clear();
+            return false;  // EOF, or a member still being written
+        }
+        zs.next_in = reinterpret_cast<Bytef*>(in_.data() + inPos_);
+        zs.avail_in = static_cast<uInt>(in_.size() - inPos_);
+        zs.next_out = reinterpret_cast<Bytef*>(out_.data());
+        zs.avail_out = static_cast<uInt>(out_.size());
+        const int rc = inflate(&zs, Z_NO_FLUSH);
+        inPos_ = in_.size() - zs.avail_in;
+        const size_t produced = out_.size() - zs.avail_out;
+        codec_->draining = zs.avail_out == 0;
+
+        if (rc == Z_STREAM_END) {
+            inflateReset(&zs);  // concatenated members (gzip a b > c) continue as one stream
+        } else if (rc != Z_OK && rc != Z_BUF_ERROR) {
+            throw std::runtime_error("Corrupt gzip data before compressed offset " +
+                                     std::to_string(inOffset_ - (in_.size() - inPos_)));
+        }
+        if (produced > 0) {
+            out_.resize(produced);
+            return true;
+        }
+        // header or trailer only: go round for more input
+    }
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief ZSTD_decompressStream() into out_, for one thread or a frame the workers don't take
+ */
+bool CompressedInputSource::decodeZstdStream() {
+#if LOG_MONITOR_ZSTD
+    out_.resize(OUTPUT_CHUNK);
+    while (true) {
+        if (inPos_ == in_.size() && !codec_->draining && !readInput()) {
+            out_.clear();
+            return false;
+        }
+        ZSTD_inBuffer in{in_.data(), in_.size(), inPos_};
+        ZSTD_outBuffer out{out_.data(), out_.size(), 0};
+        const size_t rc = ZSTD_decompressStream(codec_->dstream, &out, &in);
+        inPos_ = in.pos;
+        if (ZSTD_isError(rc)) {
+            throw std::runtime_error(std::string("Corrupt zstd data: ") + ZSTD_getErrorName(rc));
+        }
+        codec_->draining = out.pos == out.size;
+        if (rc == 0) {
+            codec_->streamingFrame = false;  // frame done, the next may go to the workers
+        }
+        if (out.pos > 0 || rc == 0) {
+            out_.resize(out.pos);
+            return true;
+        }
+    }
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Decompresses up to threads_ complete frames at once into out_
+ *
+ * Frames are found with ZSTD_findFrameCompressedSize and need a content
+ * size in their header (zstd writes it unless streaming from a pipe);
+ * each lands at its own offset in out_, so the order is kept with no
+ * merge step. Workers are started per batch: a batch is several MB, so
+ * that costs less than keeping a pool in sync. The first frame that
+ * can't go to a worker switches to decodeZstdStream until it ends.
+ */
+bool CompressedInputSource::decodeZstdFrames() {
+#if LOG_MONITOR_ZSTD
+    struct Frame {
+        size_t pos;
+        size_t len;
+        size_t content;
+        size_t outAt;
+    };
+    std::vector<Frame> frames;
+    bool eof = false;
+    while (true) {
+        // rescanned after every readInput(), which moves in_'s contents
+        frames.clear();
+        size_t pos = inPos_;
+        size_t total = 0;
+        bool unsized = false;  // next frame can't go to a worker
+        while (frames.size() < threads_ && pos < in_.size()) {
+            const size_t avail = in_.size() - pos;
+            const unsigned long long content = ZSTD_getFrameContentSize(in_.data() + pos, avail);
+            if (content == ZSTD_CONTENTSIZE_ERROR) {
+                if (avail >= ZSTD_HEADER_MAX) {
+                    throw std::runtime_error("Corrupt zstd frame header before compressed offset " +
+                                             std::to_string(inOffset_ - avail));
+                }
+                break;  // header cut off, read more
+            }
+            if (content == ZSTD_CONTENTSIZE_UNKNOWN || content > MAX_PARALLEL_FRAME) {
+                unsized = true;
+                break;
+            }
+            const size_t len = ZSTD_findFrameCompressedSize(in_.data() + pos, avail);
+            if (ZSTD_isError(len)) {
+                if (ZSTD_getErrorCode(len) != ZSTD_error_srcSize_wrong) {
+                    throw std::runtime_error(std::string("Corrupt zstd frame: ") + ZSTD_getErrorName(len));
+                }
+                break;  // frame not complete in in_ yet
+            }
+            frames.push_back({pos, len, static_cast<size_t>(content), total});
+            total += static_cast<size_t>(content);
+            pos += len;
+        }
+
+        if (frames.empty() && unsized) {
+            codec_->streamingFrame = true;
+            return decodeZstdStream();
+        }
+        if (frames.size() == threads_ || (!frames.empty() && (unsized || eof))) break;
+        if (eof) return false;  // nothing complete: EOF or a frame still being written
+        eof = !readInput();
+    }
+
+    out_.resize(frames.back().outAt + frames.back().content);
+    std::vector<size_t> results(frames.size());
+    auto run = [&](size_t i) {
+        const Frame& f = frames[i];
+        results[i] = ZSTD_decompressDCtx(codec_->dctx[i], out_.data() + f.outAt, f.content,
+                                         in_.data() + f.pos, f.len);
+    };
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < frames.size(); ++i) {
+        workers.emplace_back(run, i);
+    }
+    run(0);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    for (size_t i = 0; i < frames.size(); ++i) {
+        if (ZSTD_isError(results[i]) || results[i] != frames[i].content) {
+            throw std::runtime_error("Corrupt zstd frame before compressed offset " +
+                                     std::to_string(inOffset_ - (in_.size() - frames[i].pos)));
+        }
+    }
+    inPos_ = frames.back().pos + frames.back().len;
+    return true;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,234 @@
+/**
+ * @file compressed_sink.cpp
+ * @brief Implementation of CompressedSink
+ * @author Nicholas Loo
+ * @date 14/10/26
+ */
+
+#include "compressed_sink.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <unistd.h>
+
+#if LOG_MONITOR_GZIP
+#include <zlib.h>
+#endif
+#if LOG_MONITOR_ZSTD
+#include <zstd.h>
+#endif
+
+/**
+ * @struct CompressedSink::Encoder
+ * @brief Reused compression context, compressor thread only
+ */
+struct CompressedSink::Encoder {
+#if LOG_MONITOR_GZIP
+    z_stream zs{};
+    bool zlibReady = false;
+#endif
+#if LOG_MONITOR_ZSTD
+    ZSTD_CCtx* cctx = nullptr;
+#endif
+
+    ~Encoder() {
+#if LOG_MONITOR_GZIP
+        if (zlibReady) deflateEnd(&zs);
+#endif
+#if LOG_MONITOR_ZSTD
+        ZSTD_freeCCtx(cctx);
+#endif
+    }
+};
+
+bool CompressedSink::supported(OutputWriter::Compression compression) {
+    switch (compression) {
+        case OutputWriter::Compression::Gzip: return LOG_MONITOR_GZIP != 0;
+        case OutputWriter::Compression::Zstd: return LOG_MONITOR_ZSTD != 0;
+        default: return true;
+    }
+}
+
+CompressedSink::CompressedSink(int fd, const std::string& path, const OutputWriter::Options& options)
+    : fd_(fd), path_(path), options_(options), encoder_(std::make_unique<Encoder>()) {
+    if (!supported(options_.compression)) {
+        throw std::runtime_error("Built without " +
+                                 std::string(options_.compression == OutputWriter::Compression::Gzip ? "zlib" : "zstd") +
+                                 ", can't compress " + path);
+    }
+#if LOG_MONITOR_GZIP
+    if (options_.compression == OutputWriter::Compression::Gzip) {
+        // 16 + MAX_WBITS: gzip wrapper, so each block is a gzip member
+        const int level = options_.compressionLevel > 0 ? options_.compressionLevel : 1;
+        if (deflateInit2(&encoder_->zs, level, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            throw std::runtime_error("Failed to initialise zlib for " + path);
+        }
+        encoder_->zlibReady = true;
+    }
+#endif
+#if LOG_MONITOR_ZSTD
+    if (options_.compression == OutputWriter::Compression::Zstd) {
+        encoder_->cctx = ZSTD_createCCtx();
+        ZSTD_CCtx_setParameter(encoder_->cctx, ZSTD_c_compressionLevel,
+                               options_.compressionLevel > 0 ? options_.compressionLevel : 1);
+        ZSTD_CCtx_setParameter(encoder_->cctx, ZSTD_c_contentSizeFlag, 1);
+    }
+#endif
+
+    current_.reserve(options_.frameBytes);
+    for (size_t i = 1; i < BLOCKS; ++i) {
+        free_.emplace_back();
+        free_.back().reserve(options_.frameBytes);
+    }
+    thread_ = std::thread(&CompressedSink::run, this);
+}
+
+CompressedSink::~CompressedSink() {
+    try {
+        if (!current_.empty()) cut();
+    } catch (const std::exception&) {
+        // destructor: the failure was already reported by sync() or append()
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+}
+
+/**
+ * @brief memcpy into the block; whole batches only, so frames end on lines
+ */
+void CompressedSink::append(const iovec* iov, size_t count) {
+    if (current_.empty()) {
+        currentStart_ = std::chrono::steady_clock::now();
+    }
+    for (size_t i = 0; i < count; ++i) {
+        const char* data = static_cast<const char*>(iov[i].iov_base);
+        current_.insert(current_.end(), data, data + iov[i].iov_len);
+        bytesIn_ += iov[i].iov_len;
+    }
+    if (current_.size() >= options_.frameBytes) {
+        cut();
+    } else {
+        tick();
+    }
+}
+
+void CompressedSink::tick() {
+    if (!current_.empty() && std::chrono::steady_clock::now() - currentStart_ >=
+            std::chrono::milliseconds(options_.frameIntervalMs)) {
+        cut();
+    }
+}
+
+/**
+ * @brief Queues current_ and swaps in a free block, waiting for one if needed
+ */
+void CompressedSink::cut() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    rethrowLocked();
+    queued_.push_back(std::move(current_));
+    if (free_.empty()) {
+        stalls_++;
+        cv_.notify_all();
+        cv_.wait(lock, [this] { return !free_.empty() || error_; });
+        rethrowLocked();
+    }
+    current_ = std::move(free_.back());
+    free_.pop_back();
+    lock.unlock();
+    cv_.notify_all();
+}
+
+void CompressedSink::sync() {
+    if (!current_.empty()) {
+        cut();
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return (queued_.empty() && busy_ == 0) || error_; });
+    rethrowLocked();
+}
+
+void CompressedSink::rethrowLocked() {
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+}
+
+/**
+ * @brief Compressor loop: one block in, one frame out, block back to free_
+ */
+void CompressedSink::run() {
+    std::vector<char> out;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        cv_.wait(lock, [this] { return !queued_.empty() || stopping_; });
+        if (queued_.empty()) return;  // stopping, nothing left
+
+        std::vector<char> block = std::move(queued_.front());
+        queued_.pop_front();
+        ++busy_;
+        lock.unlock();
+        try {
+            if (!error_) writeFrame(block, out);
+        } catch (...) {
+            lock.lock();
+            error_ = std::current_exception();
+            lock.unlock();
+        }
+        block.clear();
+        lock.lock();
+        free_.push_back(std::move(block));
+        --busy_;
+        cv_.notify_all();
+    }
+}
+
+void CompressedSink::writeFrame(const std::vector<char>& block, std::vector<char>& out) {
+    if (block.empty()) return;
+    size_t len = 0;
+#if LOG_MONITOR_ZSTD
+    if (options_.compression == OutputWriter::Compression::Zstd) {
+        out.resize(ZSTD_compressBound(block.size()));
+        len = ZSTD_compress2(encoder_->cctx, out.data(), out.size(), block.data(), block.size());
+        if (ZSTD_isError(len)) {
+            throw std::runtime_error("zstd failed for " + path_ + ": " + ZSTD_getErrorName(len));
+        }
+    }
+#endif
+#if LOG_MONITOR_GZIP
+    if (options_.compression == OutputWriter::Compression::Gzip) {
+        z_stream& zs = encoder_->zs;
+        deflateReset(&zs);
+        out.resize(deflateBound(&zs, block.size()));
+        zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(block.data()));
+        zs.avail_in = static_cast<uInt>(block.size());
+        zs.next_out = reinterpret_cast<Bytef*>(out.data());
+        zs.avail_out = static_cast<uInt>(out.size());
+        if (deflate(&zs, Z_FINISH) != Z_STREAM_END) {
+            throw std::runtime_error("zlib failed for " + path_);
+        }
+        len = out.size() - zs.avail_out;
+    }
+#endif
+
+    // one write per frame: with O_APPEND a reader never sees half a frame
+    // unless the disk fills up mid-write
+    const char* p = out.data();
+    size_t left = len;
+    while (left > 0) {
+        ssize_t n = ::write(fd_, p, left);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error("Failed to write output file: " + path_ + ": " + std::strerror(errno));
+        }
+        p += n;
+        left -= static_cast<size_t>(n);
+    }
+    bytesOut_ += len;
+    frames_++;
+}
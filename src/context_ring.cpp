@@ -0,0 +1,100 @@
+/**
+ * @file context_ring.cpp
+ * @brief Implementation of ContextRing
+ * @author Nicholas Loo
+ * @date 14/10/26
+ */
+
+#include "context_ring.h"
+
+#include <cstring>
+
+ContextRing::ContextRing(size_t before, size_t after, size_t maxLineLength, Arena& arena)
+    : slots_(before), after_(after) {
+    for (Slot& slot : slots_) {
+        slot.storage = arena.allocate(maxLineLength);
+    }
+}
+
+void ContextRing::match(std::string_view line, bool stable, OutputWriter& out) {
+    ++lineNumber_;
+    for (size_t i = 0; i < count_; ++i) {
+        const Slot& slot = slots_[(head_ + i) % slots_.size()];
+        if (slot.number + slots_.size() < lineNumber_) continue;  // skipped lines pushed it out of range
+        // a copy is overwritten by the next one, the writer can't keep it
+        emit(slot.line, !slot.copied, slot.number, out);
+    }
+    head_ = 0;
+    count_ = 0;
+    emit(line, stable, lineNumber_, out);
+    afterLeft_ = after_;
+}
+
+void ContextRing::other(std::string_view line, bool stable, OutputWriter& out) {
+    ++lineNumber_;
+    if (afterLeft_ > 0) {
+        --afterLeft_;
+        emit(line, stable, lineNumber_, out);
+        return;
+    }
+    if (!slots_.empty()) {
+        keep(line, stable);
+    }
+}
+
+void ContextRing::skip() {
+    ++lineNumber_;
+    if (afterLeft_ > 0) --afterLeft_;
+}
+
+void ContextRing::endOfBuffer() {
+    for (size_t i = 0; i < count_; ++i) {
+        Slot& slot = slots_[(head_ + i) % slots_.size()];
+        if (!slot.copied) copy(slot, slot.line);
+    }
+}
+
+void ContextRing::reset() {
+    head_ = 0;
+    count_ = 0;
+    afterLeft_ = 0;
+    ++lineNumber_;  // a gap, so the new file's first group gets a separator
+}
+
+size_t ContextRing::arenaBytes(size_t before, size_t maxLineLength) {
+    return before * Arena::footprint(maxLineLength);
+}
+
+void ContextRing::keep(std::string_view line, bool stable) {
+    size_t index;
+    if (count_ == slots_.size()) {
+        index = head_;  // full: the oldest line drops out
+        head_ = (head_ + 1) % slots_.size();
+    } else {
+        index = (head_ + count_) % slots_.size();
+        ++count_;
+    }
+    Slot& slot = slots_[index];
+    slot.number = lineNumber_;
+    if (stable) {
+        slot.line = line;
+        slot.copied = false;
+    } else {
+        copy(slot, line);
+    }
+}
+
+void ContextRing::copy(Slot& slot, std::string_view line) {
+    std::memcpy(slot.storage, line.data(), line.size());
+    slot.line = std::string_view(slot.storage, line.size());
+    slot.copied = true;
+    ++copies_;
+}
+
+void ContextRing::emit(std::string_view line, bool stable, uint64_t number, OutputWriter& out) {
+    if (lastEmitted_ != 0 && number != lastEmitted_ + 1) {
+        out.writeLine("--");
+    }
+    out.writeLine(line, stable);
+    lastEmitted_ = number;
+}
@@ -0,0 +1,282 @@
+/**
+ * @file field_filter.cpp
+ * @brief Implementation of the FieldFilter expression engine
+ * @author Nicholas Loo
+ * @date 14/10/26
+ */
+
+#include "field_filter.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+/// Leading "[-]digits[.digits]" of text; false if it doesn't start with one
+bool leadingNumber(std::string_view text, double& value) {
+    size_t pos = 0;
+    const bool negative = !text.empty() && text[0] == '-';
+    if (negative) pos++;
+
+    double result = 0;
+    size_t digits = 0;
+    for (; pos < text.size() && text[pos] >= '0' && text[pos] <= '9'; ++pos, ++digits) {
+        result = result * 10 + (text[pos] - '0');
+    }
+    if (pos < text.size() && text[pos] == '.') {
+        double scale = 0.1;
+        for (++pos; pos < text.size() && text[pos] >= '0' && text[pos] <= '9'; ++pos, ++digits) {
+            result += (text[pos] - '0') * scale;
+            scale /= 10;
+        }
+    }
+    if (digits == 0) return false;
+    value = negative ? -result : result;
+    return true;
+}
+
+/// Shortest literal, the prefilter's selectivity estimate
+size_t minLength(const std::vector<std::string>& literals) {
+    size_t shortest = std::string::npos;
+    for (const auto& literal : literals) {
+        shortest = std::min(shortest, literal.size());
+    }
+    return shortest;
+}
+
+} // namespace
+
+/**
+ * @class FieldFilter::Parser
+ * @brief Recursive descent over whitespace separated tokens
+ */
+class FieldFilter::Parser {
+public:
+    Parser(const std::string& expression, std::vector<Node>& nodes) : nodes_(nodes) {
+        // parentheses are tokens of their own even when glued to a term
+        std::string token;
+        auto flush = [&]() {
+            if (!token.empty()) tokens_.push_back(token);
+            token.clear();
+        };
+        for (char c : expression) {
+            if (c == ' ' || c == '\t') {
+                flush();
+            } else if (c == '(' || c == ')') {
+                flush();
+                tokens_.emplace_back(1, c);
+            } else {
+                token += c;
+            }
+        }
+        flush();
+    }
+
+    int parse() {
+        if (tokens_.empty()) fail("empty expression");
+        int root = parseOr();
+        if (pos_ != tokens_.size()) fail("unexpected '" + tokens_[pos_] + "'");
+        return root;
+    }
+
+private:
+    int parseOr() {
+        int left = parseAnd();
+        while (accept("OR")) {
+            left = add(Node::Kind::Or, left, parseAnd());
+        }
+        return left;
+    }
+
+    int parseAnd() {
+        int left = parseFactor();
+        while (accept("AND")) {
+            left = add(Node::Kind::And, left, parseFactor());
+        }
+        return left;
+    }
+
+    int parseFactor() {
+        if (pos_ == tokens_.size()) fail("expression ends early");
+        if (accept("NOT")) {
+            return add(Node::Kind::Not, parseFactor(), -1);
+        }
+        if (accept("(")) {
+            int inner = parseOr();
+            if (!accept(")")) fail("missing ')'");
+            return inner;
+        }
+        const std::string& token = tokens_[pos_++];
+        if (token == ")" || token == "AND" || token == "OR") fail("unexpected '" + token + "'");
+        return term(token);
+    }
+
+    /// Key<op>Value or a plain word
+    int term(const std::string& token) {
+        size_t at = token.find_first_of("=<>!");
+        if (at == std::string::npos || (token[at] == '!' && (at + 1 >= token.size() || token[at + 1] != '='))) {
+            Node node;
+            node.kind = Node::Kind::Word;
+            node.text = token;
+            nodes_.push_back(node);
+            return static_cast<int>(nodes_.size() - 1);
+        }
+
+        Node node;
+        node.kind = Node::Kind::Compare;
+        node.key = token.substr(0, at);
+        const bool orEqual = at + 1 < token.size() && token[at + 1] == '=';
+        switch (token[at]) {
+            case '=': node.op = Op::Eq; break;
+            case '!': node.op = Op::Ne; break;
+            case '<': node.op = orEqual ? Op::Le : Op::Lt; break;
+            default:  node.op = orEqual ? Op::Ge : Op::Gt; break;
+        }
+        node.text = token.substr(at + (token[at] == '!' || orEqual ? 2 : 1));
+        if (node.key.empty() || node.text.empty()) fail("incomplete comparison '" + token + "'");
+        if (node.op != Op::Eq && node.op != Op::Ne && !leadingNumber(node.text, node.number)) {
+            fail("not a number in '" + token + "'");
+        }
+        nodes_.push_back(node);
+        return static_cast<int>(nodes_.size() - 1);
+    }
+
+    int add(Node::Kind kind, int left, int right) {
+        Node node;
+        node.kind = kind;
+        node.left = left;
+        node.right = right;
+        nodes_.push_back(node);
+        return static_cast<int>(nodes_.size() - 1);
+    }
+
+    bool accept(const char* token) {
+        if (pos_ < tokens_.size() && tokens_[pos_] == token) {
+            pos_++;
+            return true;
+        }
+        return false;
+    }
+
+    [[noreturn]] static void fail(const std::string& what) {
+        throw std::runtime_error("Invalid filter expression: " + what);
+    }
+
+    std::vector<Node>& nodes_;
+    std::vector<std::string> tokens_;
+    size_t pos_ = 0;
+};
+
+FieldFilter::FieldFilter(const std::string& expression) {
+    root_ = Parser(expression, nodes_).parse();
+    if (!derivePrefilter(root_, prefilter_)) {
+        prefilter_ = {""};  // every line is a candidate
+    }
+    prefilterMatcher_ = std::make_unique<KeywordMatcher>(prefilter_);
+}
+
+FieldFilter::~FieldFilter() = default;
+
+bool FieldFilter::matches(std::string_view line) const {
+    return prefilterMatcher_->matches(line) && eval(root_, line);
+}
+
+bool FieldFilter::evaluate(std::string_view line) const {
+    return eval(root_, line);
+}
+
+/**
+ * @brief First "key=" at the line start or after a space
+ *
+ * std::string_view::find per candidate; field names are short and lines
+ * hold about ten fields, so this beats splitting the whole line.
+ */
+bool FieldFilter::findField(std::string_view line, std::string_view key, std::string_view& value) {
+    size_t pos = 0;
+    while ((pos = line.find(key, pos)) != std::string_view::npos) {
+        const size_t eq = pos + key.size();
+        if ((pos == 0 || line[pos - 1] == ' ') && eq < line.size() && line[eq] == '=') {
+            size_t end = line.find(' ', eq + 1);
+            value = line.substr(eq + 1, end == std::string_view::npos ? std::string_view::npos : end - eq - 1);
+            return true;
+        }
+        pos = eq;
+    }
+    return false;
+}
+
+bool FieldFilter::eval(int index, std::string_view line) const {
+    const Node& node = nodes_[index];
+    switch (node.kind) {
+        case Node::Kind::And:
+            return eval(node.left, line) && eval(node.right, line);
+        case Node::Kind::Or:
+            return eval(node.left, line) || eval(node.right, line);
+        case Node::Kind::Not:
+            return !eval(node.left, line);
+        case Node::Kind::Word:
+            return line.find(node.text) != std::string_view::npos;
+        case Node::Kind::Compare:
+            break;
+    }
+
+    std::string_view value;
+    if (!findField(line, node.key, value)) return false;
+    if (node.op == Op::Eq) return value == node.text;
+    if (node.op == Op::Ne) return value != node.text;
+
+    double number;
+    if (!leadingNumber(value, number)) return false;
+    switch (node.op) {
+        case Op::Lt: return number < node.number;
+        case Op::Le: return number <= node.number;
+        case Op::Gt: return number > node.number;
+        default:     return number >= node.number;
+    }
+}
+
+/**
+ * @brief Substrings implied by node, see prefilterKeywords()
+ *
+ * Key=Value needs "Key=Value" in the line; other comparisons only "Key=".
+ */
+bool FieldFilter::derivePrefilter(int index, std::vector<std::string>& literals) const {
+    const Node& node = nodes_[index];
+    switch (node.kind) {
+        case Node::Kind::Word:
+            literals = {node.text};
+            return true;
+        case Node::Kind::Compare:
+            literals = {node.op == Op::Eq ? node.key + "=" + node.text : node.key + "="};
+            return true;
+        case Node::Kind::Not:
+            return false;
+        case Node::Kind::Or: {
+            std::vector<std::string> right;
+            if (!derivePrefilter(node.left, literals) || !derivePrefilter(node.right, right)) {
+                return false;
+            }
+            for (auto& literal : right) {
+                if (std::find(literals.begin(), literals.end(), literal) == literals.end()) {
+                    literals.push_back(std::move(literal));
+                }
+            }
+            return true;
+        }
+        case Node::Kind::And: {
+            std::vector<std::string> left, right;
+            const bool haveLeft = derivePrefilter(node.left, left);
+            const bool haveRight = derivePrefilter(node.right, right);
+            if (!haveLeft && !haveRight) return false;
+            // either side is necessary, keep the one fewer lines contain
+            bool useLeft = haveLeft;
+            if (haveLeft && haveRight) {
+                size_t l = minLength(left);
+                size_t r = minLength(right);
+                useLeft = l != r ? l > r : left.size() <= right.size();
+            }
+            literals = useLeft ? std::move(left) : std::move(right);
+            return true;
+        }
+    }
+    return false;
+}
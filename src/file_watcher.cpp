@@ -0,0 +1,235 @@
+/**
+ * @file file_watcher.cpp
+ * @brief Implementation of the FileWatcher class
+ * @author Nicholas Loo
+ * @date 14/10/26
+ */
+
+#include "file_watcher.h"
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#elif defined(__APPLE__) || defined(__FreeBSD__)
+#include <sys/event.h>
+#include <sys/time.h>
+#endif
+
+namespace {
+
+/// Remaining time until deadline in ms for poll()/kevent(), -1 = forever
+int remainingMs(int timeoutMs, std::chrono::steady_clock::time_point deadline) {
+    if (timeoutMs < 0) return -1;
+    auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadline - std::chrono::steady_clock::now()).count();
+    return left > 0 ? static_cast<int>(left) : 0;
+}
+
+#if defined(__APPLE__) || defined(__FreeBSD__)
+#ifdef O_EVTONLY
+constexpr int WATCH_OPEN_FLAGS = O_EVTONLY | O_CLOEXEC;
+#else
+constexpr int WATCH_OPEN_FLAGS = O_RDONLY | O_CLOEXEC;
+#endif
+constexpr uintptr_t WAKEUP_IDENT = 1;
+#endif
+
+} // namespace
+
+/**
+ * @brief Sets up the platform backend, leaving valid() false on any failure
+ *
+ * @param path File to watch
+ */
+FileWatcher::FileWatcher(const std::string& path)
+    : path_(path) {
+
+    size_t slash = path_.find_last_of('/');
+    if (slash == std::string::npos) {
+        dir_ = ".";
+        name_ = path_;
+    } else {
+        dir_ = slash == 0 ? "/" : path_.substr(0, slash);
+        name_ = path_.substr(slash + 1);
+    }
+    if (name_.empty()) return;
+
+#if defined(__linux__)
+    eventFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (eventFd_ < 0 || wakeFd_ < 0) return;
+
+    // IN_MODIFY covers appends; the rest cover create / rotate / truncate
+    const uint32_t mask = IN_MODIFY | IN_CREATE | IN_MOVED_TO | IN_MOVED_FROM |
+                          IN_DELETE | IN_ATTRIB | IN_CLOSE_WRITE;
+    if (inotify_add_watch(eventFd_, dir_.c_str(), mask) < 0) return;
+    valid_ = true;
+#elif defined(__APPLE__) || defined(__FreeBSD__)
+    eventFd_ = kqueue();
+    if (eventFd_ < 0) return;
+
+    dirFd_ = ::open(dir_.c_str(), WATCH_OPEN_FLAGS);
+    if (dirFd_ < 0) return;
+
+    struct kevent changes[2];
+    // directory NOTE_WRITE fires when entries are created, renamed or removed
+    EV_SET(&changes[0], static_cast<uintptr_t>(dirFd_), EVFILT_VNODE,
+           EV_ADD | EV_CLEAR, NOTE_WRITE, 0, nullptr);
+    EV_SET(&changes[1], WAKEUP_IDENT, EVFILT_USER, EV_ADD | EV_CLEAR, 0, 0, nullptr);
+    if (kevent(eventFd_, changes, 2, nullptr, 0, nullptr) < 0) return;
+
+    watchFile();
+    valid_ = true;
+#endif
+}
+
+/**
+ * @brief Releases every descriptor that was opened
+ */
+FileWatcher::~FileWatcher() {
+    for (int fd : {fileFd_, dirFd_, wakeFd_, eventFd_}) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+}
+
+/**
+ * @brief Waits for a relevant event
+ *
+ * Events for other files in the same directory are drained and ignored,
+ * so a busy log directory doesn't cause spurious wakeups.
+ *
+ * @param timeoutMs Maximum wait in ms, -1 for none
+ * @return true on file event or wakeup(), false on timeout (or no backend)
+ */
+bool FileWatcher::wait(int timeoutMs) {
+    if (!valid_) return false;
+
+    const auto deadline = std::chrono::steady_clock::now() +
+                          std::chrono::milliseconds(timeoutMs < 0 ? 0 : timeoutMs);
+
+#if defined(__linux__)
+    // aligned so the struct inotify_event casts below are well defined
+    alignas(inotify_event) char events[4096];
+    pollfd fds[2] = {{eventFd_, POLLIN, 0}, {wakeFd_, POLLIN, 0}};
+
+    while (true) {
+        int ready = ::poll(fds, 2, remainingMs(timeoutMs, deadline));
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (ready == 0) return false;
+
+        if (fds[1].revents & POLLIN) {
+            uint64_t value;
+            (void)!::read(wakeFd_, &value, sizeof(value));
+            return true;
+        }
+
+        // drain everything queued, remember whether our file was involved
+        bool relevant = false;
+        ssize_t len;
+        while ((len = ::read(eventFd_, events, sizeof(events))) > 0) {
+            for (char* p = events; p < events + len;) {
+                auto* event = reinterpret_cast<inotify_event*>(p);
+                if ((event->mask & IN_Q_OVERFLOW) ||
+                    (event->len > 0 && name_ == event->name)) {
+                    relevant = true;
+                }
+                p += sizeof(inotify_event) + event->len;
+            }
+        }
+        if (relevant) return true;
+    }
+#elif defined(__APPLE__) || defined(__FreeBSD__)
+    while (true) {
+        struct kevent event;
+        int left = remainingMs(timeoutMs, deadline);
+        timespec ts{left / 1000, (left % 1000) * 1000000L};
+        int ready = kevent(eventFd_, nullptr, 0, &event, 1, left < 0 ? nullptr : &ts);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (ready == 0) return false;
+
+        if (event.filter == EVFILT_USER) {
+            return true;
+        }
+        if (static_cast<int>(event.ident) == dirFd_) {
+            // entry change in the directory: file may have been (re)created
+            watchFile();
+            return true;
+        }
+        if (event.fflags & (NOTE_DELETE | NOTE_RENAME)) {
+            watchFile();
+        }
+        return true;
+    }
+#else
+    (void)deadline;
+    return false;
+#endif
+}
+
+/**
+ * @brief Wakes the waiting thread
+ *
+ * Only a syscall on an already open descriptor, so it is safe from a
+ * signal handler and from destructors racing with wait().
+ */
+void FileWatcher::wakeup() {
+    if (!valid_) return;
+#if defined(__linux__)
+    uint64_t one = 1;
+    (void)!::write(wakeFd_, &one, sizeof(one));
+#elif defined(__APPLE__) || defined(__FreeBSD__)
+    struct kevent trigger;
+    EV_SET(&trigger, WAKEUP_IDENT, EVFILT_USER, 0, NOTE_TRIGGER, 0, nullptr);
+    kevent(eventFd_, &trigger, 1, nullptr, 0, nullptr);
+#endif
+}
+
+/**
+ * @brief Backend name for the startup banner
+ */
+const char* FileWatcher::backendName() const {
+    if (!valid_) return "none";
+#if defined(__linux__)
+    return "inotify";
+#else
+    return "kqueue";
+#endif
+}
+
+/**
+ * @brief Points the per-file vnode watch at the current inode
+ *
+ * kqueue watches descriptors, not names, so after a rotation the old inode
+ * is dropped and the file is reopened. Missing file is fine, the directory
+ * watch reports when it appears.
+ */
+void FileWatcher::watchFile() {
+#if defined(__APPLE__) || defined(__FreeBSD__)
+    if (fileFd_ >= 0) {
+        ::close(fileFd_);  // closing removes its kevents
+        fileFd_ = -1;
+    }
+    fileFd_ = ::open(path_.c_str(), WATCH_OPEN_FLAGS);
+    if (fileFd_ < 0) return;
+
+    struct kevent change;
+    EV_SET(&change, static_cast<uintptr_t>(fileFd_), EVFILT_VNODE, EV_ADD | EV_CLEAR,
+           NOTE_WRITE | NOTE_EXTEND | NOTE_ATTRIB | NOTE_DELETE | NOTE_RENAME, 0, nullptr);
+    kevent(eventFd_, &change, 1, nullptr, 0, nullptr);
+#endif
+}
@@ -15,18 +15,102 @@
  * performance when constructing with large keyword lists.
  * 
  * @param keywords Vector of keywords to match against (moved, not copied)
+ * @param engine Requested engine; Auto picks the automaton above
+ *               AUTOMATON_THRESHOLD keywords and the SIMD scan below it
+ *               (falls back to Linear if the CPU has no vector kernel)
  * 
- * Time complexity: O(1) due to move semantics
+ * Time complexity: O(1) for the linear engine due to move semantics,
+ *                  O(total keyword length) to build the automaton
  * Space complexity: O(n) where n = total size of all keywords
  */
-KeywordMatcher::KeywordMatcher(std::vector<std::string> keywords)
-    : keywords_(std::move(keywords)) {
+KeywordMatcher::KeywordMatcher(std::vector<std::string> keywords, Engine engine)
+    : KeywordMatcher(std::move(keywords), {}, engine) {
+}
+
+/**
+ * @brief Constructs a KeywordMatcher with a group mask per keyword
+ * 
+ * Missing masks (groups shorter than keywords) default to group 0.
+ * 
+ * @param keywords Vector of keywords to match against (moved, not copied)
+ * @param groups Group mask per keyword
+ * @param engine Requested engine, see above; with more than one group
+ *               Auto switches at GROUPED_AUTOMATON_THRESHOLD instead
+ */
+KeywordMatcher::KeywordMatcher(std::vector<std::string> keywords, std::vector<GroupMask> groups,
+                               Engine engine)
+    : KeywordMatcher(std::move(keywords), std::move(groups), Options{engine, false, false}) {
+}
+
+/**
+ * @brief Constructs a KeywordMatcher with a match mode
+ * 
+ * Case folding and word boundaries live in the engines: the needles are
+ * lower cased once here and fed to the case-insensitive kernels, or the
+ * automaton is built folded / with per-state pattern lengths.
+ * 
+ * @param keywords Vector of keywords to match against (moved, not copied)
+ * @param groups Group mask per keyword
+ * @param options Engine (resolved as above), ignoreCase, wholeWord
+ */
+KeywordMatcher::KeywordMatcher(std::vector<std::string> keywords, std::vector<GroupMask> groups,
+                               const Options& options)
+    : keywords_(std::move(keywords)),
+      ignoreCase_(options.ignoreCase),
+      wholeWord_(options.wholeWord),
+      groups_(std::move(groups)),
+      engine_(options.engine) {
+    
+    needles_ = keywords_;
+    if (ignoreCase_) {
+        for (auto& needle : needles_) {
+            for (char& c : needle) {
+                if (c >= 'A' && c <= 'Z') c = static_cast<char>(c | 0x20);
+            }
+        }
+    }
+    
+    groups_.resize(keywords_.size(), 1);
+    for (GroupMask group : groups_) {
+        allGroups_ |= group;
+    }
+    
+    if (engine_ == Engine::Auto) {
+        const bool grouped = (allGroups_ & (allGroups_ - 1)) != 0;
+        if (keywords_.size() > (grouped ? GROUPED_AUTOMATON_THRESHOLD : AUTOMATON_THRESHOLD)) {
+            engine_ = Engine::Automaton;
+        } else {
+            engine_ = simd::bestKernel() != simd::Kernel::Scalar ? Engine::Simd : Engine::Linear;
+        }
+    }
+    
+    // build once here so matches() never allocates or rebuilds
+    if (engine_ == Engine::Automaton) {
+        automaton_.emplace(keywords_, groups_, ignoreCase_, wholeWord_);
+    } else {
+        const simd::Kernel kernel = engine_ == Engine::Linear ? simd::Kernel::Scalar : simd::bestKernel();
+        search_ = ignoreCase_ ? simd::searchFunctionIgnoreCase(kernel) : simd::searchFunction(kernel);
+    }
+}
+
+/**
+ * @brief Constructs a KeywordMatcher around a compile-time matcher
+ * 
+ * @param keywords Keywords staticMatch matches, kept for getKeywords(),
+ *                 Scanner and matchGroups()
+ * @param staticMatch The compiled matches()
+ */
+KeywordMatcher::KeywordMatcher(std::vector<std::string> keywords, StaticMatchFn staticMatch)
+    : KeywordMatcher(std::move(keywords), Engine::Simd) {
+    engine_ = Engine::Static;
+    staticMatch_ = staticMatch;
 }
 
 /**
  * @brief Checks if text contains any of the configured keywords
  * 
- * Performs case-sensitive substring matching. The algorithm iterates through
+ * Performs case-sensitive substring matching. With the automaton engine the
+ * line is scanned exactly once. Otherwise the algorithm iterates through
  * all keywords and uses std::string_view::find() for efficient searching
  * without copying the input text.
  * 
@@ -43,11 +127,137 @@ KeywordMatcher::KeywordMatcher(std::vector<std::string> keywords)
  * @note Thread-safe: const method with no mutable state
  */
 bool KeywordMatcher::matches(std::string_view text) const {
-    // using sting view
-    for (const auto& keyword : keywords_) {
-        if (text.find(keyword) != std::string_view::npos) {
+    if (staticMatch_) {
+        return staticMatch_(text);
+    }
+    if (automaton_) {
+        return automaton_->contains(text);
+    }
+    
+    // using sting view; search_ is std::string_view::find for Engine::Linear
+    // and the vectorized prefilter for Engine::Simd
+    for (size_t i = 0; i < needles_.size(); ++i) {
+        if (find(text, i, 0) != std::string_view::npos) {
             return true;  // early exit on first match
         }
     }
     return false;
 }
+
+/**
+ * @brief Runs the search kernel for one keyword, skipping non-words
+ * 
+ * Without wholeWord this is a single kernel call. With it, hits inside a
+ * longer word are skipped and the search resumes one byte later.
+ * 
+ * @param text Text to search
+ * @param i Keyword index
+ * @param from Offset to search from
+ * @return Start offset of the hit, or npos
+ */
+size_t KeywordMatcher::find(std::string_view text, size_t i, size_t from) const {
+    constexpr size_t npos = std::string_view::npos;
+    const std::string& needle = needles_[i];
+    while (from <= text.size()) {
+        size_t hit = search_(text.data() + from, text.size() - from, needle.data(), needle.size());
+        if (hit == npos) return npos;
+        hit += from;
+        if (!wholeWord_ || needle.empty()) return hit;
+        
+        const auto* bytes = reinterpret_cast<const unsigned char*>(text.data());
+        const size_t end = hit + needle.size();
+        const bool startOk = hit == 0 || !AhoCorasick::isWordByte(bytes[hit]) ||
+                             !AhoCorasick::isWordByte(bytes[hit - 1]);
+        const bool endOk = end == text.size() || !AhoCorasick::isWordByte(bytes[end - 1]) ||
+                           !AhoCorasick::isWordByte(bytes[end]);
+        if (startOk && endOk) return hit;
+        from = hit + 1;
+    }
+    return npos;
+}
+
+/**
+ * @brief Collects the groups of all keywords present in text
+ * 
+ * @param text Text to search
+ * @return Group union, 0 if no keyword occurs
+ * 
+ * Performance:
+ * - Automaton: one pass, stops when every group is found
+ * - Linear/Simd: at most one search per keyword, skipping keywords that
+ *   can't add a group
+ */
+KeywordMatcher::GroupMask KeywordMatcher::matchGroups(std::string_view text) const {
+    if (automaton_) {
+        return automaton_->collect(text, allGroups_);
+    }
+    
+    GroupMask found = 0;
+    for (size_t i = 0; i < keywords_.size(); ++i) {
+        if ((groups_[i] & ~found) == 0) continue;  // nothing new to learn
+        if (find(text, i, 0) != std::string_view::npos) {
+            found |= groups_[i];
+            if (found == allGroups_) break;
+        }
+    }
+    return found;
+}
+
+/**
+ * @brief Prepares a hit scan over text
+ * 
+ * No searching happens here; the per-keyword cache is filled lazily on the
+ * first call to next().
+ * 
+ * @param matcher Matcher to scan with
+ * @param text Text to scan
+ */
+KeywordMatcher::Scanner::Scanner(const KeywordMatcher& matcher, std::string_view text)
+    : matcher_(matcher),
+      text_(text) {
+}
+
+/**
+ * @brief Returns the next hit at or after from
+ * 
+ * Automaton: DFA walk from from, so the earliest-ending match is returned
+ * (its last byte).
+ * 
+ * Linear/Simd: returns the earliest starting keyword occurrence. Cached
+ * positions behind from are refreshed, positions ahead are reused, so a
+ * keyword that never occurs costs one pass over the text in total.
+ * 
+ * @param from Offset to resume from
+ * @return Offset of a byte inside the hit, or npos
+ */
+size_t KeywordMatcher::Scanner::next(size_t from) {
+    constexpr size_t npos = std::string_view::npos;
+    if (from >= text_.size()) {
+        return npos;
+    }
+    
+    if (matcher_.automaton_) {
+        size_t hit = matcher_.automaton_->findEnd(text_.substr(from));
+        return hit == npos ? npos : from + hit;
+    }
+    
+    const size_t count = matcher_.needles_.size();
+    size_t best = npos;
+    if (count > MAX_CACHED) {
+        // too many keywords to cache (explicit linear engine), plain min
+        for (size_t i = 0; i < count; ++i) {
+            best = std::min(best, matcher_.find(text_, i, from));
+        }
+        return best;
+    }
+    
+    for (size_t i = 0; i < count; ++i) {
+        // npos stays npos: that keyword does not occur in the rest of the text
+        if (!primed_ || (nextHit_[i] != npos && nextHit_[i] < from)) {
+            nextHit_[i] = matcher_.find(text_, i, from);
+        }
+        best = std::min(best, nextHit_[i]);
+    }
+    primed_ = true;
+    return best;
+}
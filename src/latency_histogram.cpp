@@ -0,0 +1,66 @@
+/**
+ * @file latency_histogram.cpp
+ * @brief Implementation of LatencyHistogram
+ * @author Nicholas Loo
+ * @date 14/10/26
+ */
+
+#include "latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Bucket index: exact below 64, then 32 per power of two
+ *
+ * For v >= 32 with highest bit b, shift = b - 5 keeps the top 6 bits
+ * (32..63), and the index 32 * shift + (v >> shift) continues seamlessly
+ * from the exact range.
+ */
+size_t LatencyHistogram::bucketOf(uint64_t ns) {
+    if (ns < SUB_BUCKETS) return static_cast<size_t>(ns);
+    const int shift = 63 - __builtin_clzll(ns) - SUB_BUCKET_BITS;
+    return SUB_BUCKETS * static_cast<size_t>(shift) + static_cast<size_t>(ns >> shift);
+}
+
+/// Largest value that lands in bucket (wraps to UINT64_MAX for the last one)
+uint64_t LatencyHistogram::upperEdge(size_t bucket) {
+    if (bucket < 2 * SUB_BUCKETS) return bucket;
+    const size_t shift = bucket / SUB_BUCKETS - 1;
+    const uint64_t mantissa = bucket - SUB_BUCKETS * shift;
+    return ((mantissa + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t ns) {
+    ++counts_[bucketOf(ns)];
+    ++count_;
+    sum_ += ns;
+    min_ = std::min(min_, ns);
+    max_ = std::max(max_, ns);
+}
+
+uint64_t LatencyHistogram::percentile(double q) const {
+    if (count_ == 0) return 0;
+    q = std::clamp(q, 0.0, 100.0);
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q / 100.0 * count_)));
+    uint64_t seen = 0;
+    for (size_t b = 0; b < BUCKETS; ++b) {
+        seen += counts_[b];
+        if (seen >= rank) return std::min(upperEdge(b), max_);
+    }
+    return max_;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t b = 0; b < BUCKETS; ++b) {
+        counts_[b] += other.counts_[b];
+    }
+    count_ += other.count_;
+    sum_ += other.sum_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+}
+
+void LatencyHistogram::reset() {
+    *this = LatencyHistogram();
+}
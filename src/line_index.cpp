@@ -0,0 +1,385 @@
+/**
+ * @file line_index.cpp
+ * @brief Implementation of the sparse line index writer and queries
+ * @author Nicholas Loo
+ * @date 14/10/26
+ */
+
+#include "line_index.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+/// File header: magic + interval
+constexpr char MAGIC[8] = {'L', 'M', 'I', 'N', 'D', 'E', 'X', '1'};
+constexpr size_t HEADER_SIZE = sizeof(MAGIC) + sizeof(uint64_t);
+constexpr size_t ENTRY_SIZE = 3 * sizeof(uint64_t);
+
+/// "[YYYY-MM-DD HH:MM:SS.ffffff]" is 28 bytes
+constexpr size_t PREFIX_BYTES = 28;
+
+/// Read size for resume() counting and queries
+constexpr size_t READ_CHUNK = 1024 * 1024;
+
+/// Days since 1970-01-01 of a proleptic Gregorian date
+int64_t daysFromCivil(int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+/// Reads `count` digits at text[pos], false if any isn't a digit
+bool digits(std::string_view text, size_t pos, size_t count, int64_t& value) {
+    if (pos + count > text.size()) return false;
+    value = 0;
+    for (size_t i = pos; i < pos + count; ++i) {
+        if (text[i] < '0' || text[i] > '9') return false;
+        value = value * 10 + (text[i] - '0');
+    }
+    return true;
+}
+
+/// write() loop, handling partial writes and EINTR
+void writeAll(int fd, const void* data, size_t len, const std::string& path) {
+    const char* p = static_cast<const char*>(data);
+    while (len > 0) {
+        ssize_t n = ::write(fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error("Failed to write index file: " + path);
+        }
+        p += n;
+        len -= static_cast<size_t>(n);
+    }
+}
+
+} // namespace
+
+bool parseTimestamp(std::string_view text, int64_t& micros) {
+    size_t pos = !text.empty() && text[0] == '[' ? 1 : 0;
+    int64_t year, month, day, hour, minute, second;
+    if (!digits(text, pos, 4, year) || text.size() < pos + 19 ||
+        text[pos + 4] != '-' || !digits(text, pos + 5, 2, month) ||
+        text[pos + 7] != '-' || !digits(text, pos + 8, 2, day) ||
+        text[pos + 10] != ' ' || !digits(text, pos + 11, 2, hour) ||
+        text[pos + 13] != ':' || !digits(text, pos + 14, 2, minute) ||
+        text[pos + 16] != ':' || !digits(text, pos + 17, 2, second)) {
+        return false;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60) {
+        return false;
+    }
+
+    // optional fraction, 1..6 digits, scaled to microseconds
+    int64_t fraction = 0;
+    pos += 19;
+    if (pos < text.size() && text[pos] == '.') {
+        size_t n = 0;
+        while (n < 6 && pos + 1 + n < text.size() && text[pos + 1 + n] >= '0' && text[pos + 1 + n] <= '9') {
+            fraction = fraction * 10 + (text[pos + 1 + n] - '0');
+            ++n;
+        }
+        if (n == 0) return false;
+        for (; n < 6; ++n) fraction *= 10;
+    }
+
+    int64_t days = daysFromCivil(year, static_cast<unsigned>(month), static_cast<unsigned>(day));
+    micros = ((days * 86400 + hour * 3600 + minute * 60 + second) * 1000000) + fraction;
+    return true;
+}
+
+/**
+ * @brief Opens read/write without truncating, so resume() can keep entries
+ */
+LineIndexWriter::LineIndexWriter(const std::string& path, uint64_t interval)
+    : path_(path),
+      interval_(std::max<uint64_t>(1, interval)) {
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        throw std::runtime_error("Failed to open index file: " + path);
+    }
+    prefix_.reserve(PREFIX_BYTES);
+}
+
+LineIndexWriter::~LineIndexWriter() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+void LineIndexWriter::reset() {
+    if (::ftruncate(fd_, 0) != 0 || ::lseek(fd_, 0, SEEK_SET) != 0) {
+        throw std::runtime_error("Failed to reset index file: " + path_);
+    }
+    char header[HEADER_SIZE];
+    std::memcpy(header, MAGIC, sizeof(MAGIC));
+    std::memcpy(header + sizeof(MAGIC), &interval_, sizeof(interval_));
+    writeAll(fd_, header, sizeof(header), path_);
+
+    offset_ = 0;
+    line_ = 0;
+    nextEntryAt_ = 0;
+    atLineStart_ = true;
+    pending_ = false;
+    lastTimestamp_ = NO_TIMESTAMP;
+    entries_ = 0;
+}
+
+/**
+ * @brief Keeps entries up to offset and recounts lines from the last one
+ */
+void LineIndexWriter::resume(const std::string& inputFile, uint64_t offset) {
+    std::vector<IndexEntry> kept;
+    try {
+        LineIndex existing(path_);
+        for (const IndexEntry& entry : existing.entries()) {
+            if (entry.offset > offset) break;
+            kept.push_back(entry);
+        }
+    } catch (const std::runtime_error&) {
+        // no usable index: new header, lines counted from the start once
+        reset();
+        if (offset == 0) return;
+    }
+
+    auto input = InputSource::create(InputSource::Backend::Posix);
+    if (!input->open(inputFile)) {
+        reset();
+        return;
+    }
+
+    // line number at offset, counted from the last kept entry
+    uint64_t position = kept.empty() ? 0 : kept.back().offset;
+    uint64_t line = kept.empty() ? 0 : kept.back().line;
+    std::unique_ptr<char[]> buffer(new char[READ_CHUNK]);
+    char last = '\n';
+    while (position < offset) {
+        size_t want = static_cast<size_t>(std::min<uint64_t>(READ_CHUNK, offset - position));
+        ssize_t n = input->read(buffer.get(), want, position);
+        if (n <= 0) {
+            reset();  // input shorter than the checkpoint: start over
+            return;
+        }
+        line += static_cast<uint64_t>(std::count(buffer.get(), buffer.get() + n, '\n'));
+        last = buffer[n - 1];
+        position += static_cast<uint64_t>(n);
+    }
+
+    const off_t size = static_cast<off_t>(HEADER_SIZE + kept.size() * ENTRY_SIZE);
+    if (::ftruncate(fd_, size) != 0 || ::lseek(fd_, size, SEEK_SET) != size) {
+        throw std::runtime_error("Failed to truncate index file: " + path_);
+    }
+
+    offset_ = offset;
+    line_ = line;
+    nextEntryAt_ = kept.empty() ? offset : kept.back().offset + interval_;
+    atLineStart_ = last == '\n';
+    pending_ = false;
+    lastTimestamp_ = kept.empty() ? NO_TIMESTAMP : kept.back().timestamp;
+    entries_ = kept.size();
+}
+
+/**
+ * @brief Counts lines, and finds the line start after each entry boundary
+ *
+ * An entry's prefix may continue into the next buffer, in which case it
+ * stays pending until enough bytes (or its '\n') have arrived.
+ */
+void LineIndexWriter::consume(const char* data, size_t len) {
+    if (len == 0) return;
+
+    size_t pos = 0;
+    size_t counted = 0;  // data[0, counted) is included in line_
+    auto linesBefore = [&](size_t end) {
+        line_ += static_cast<uint64_t>(std::count(data + counted, data + end, '\n'));
+        counted = end;
+        return line_;
+    };
+
+    while (pos < len) {
+        if (pending_) {
+            const void* nl = std::memchr(data + pos, '\n', len - pos);
+            size_t lineEnd = nl ? static_cast<const char*>(nl) - data : len;
+            size_t take = std::min(lineEnd - pos, PREFIX_BYTES - prefix_.size());
+            prefix_.append(data + pos, take);
+            pos += take;
+            if (prefix_.size() < PREFIX_BYTES && !nl) break;  // line continues next buffer
+            finishPending();
+            continue;
+        }
+
+        // common case: no entry boundary in the rest of this buffer
+        if (offset_ + len <= nextEntryAt_) break;
+
+        size_t from = std::max<uint64_t>(pos, nextEntryAt_ > offset_ ? nextEntryAt_ - offset_ : 0);
+        size_t start;
+        if (from == 0 ? atLineStart_ : data[from - 1] == '\n') {
+            start = from;
+        } else {
+            const void* nl = std::memchr(data + from, '\n', len - from);
+            if (!nl) break;
+            start = static_cast<const char*>(nl) - data + 1;
+            if (start == len) break;  // next consume() begins at a line start
+        }
+
+        pendingEntry_.offset = offset_ + start;
+        pendingEntry_.line = linesBefore(start);
+        pending_ = true;
+        prefix_.clear();
+        pos = start;
+    }
+
+    linesBefore(len);
+    offset_ += len;
+    atLineStart_ = data[len - 1] == '\n';
+}
+
+void LineIndexWriter::finishPending() {
+    int64_t timestamp;
+    pendingEntry_.timestamp = parseTimestamp(prefix_, timestamp) ? timestamp : lastTimestamp_;
+    lastTimestamp_ = pendingEntry_.timestamp;
+    append(pendingEntry_);
+    nextEntryAt_ = pendingEntry_.offset + interval_;
+    pending_ = false;
+}
+
+void LineIndexWriter::append(const IndexEntry& entry) {
+    uint64_t words[3] = {entry.offset, entry.line, static_cast<uint64_t>(entry.timestamp)};
+    writeAll(fd_, words, sizeof(words), path_);
+    entries_++;
+}
+
+/**
+ * @brief Reads the whole (small) index; a torn last entry is ignored
+ */
+LineIndex::LineIndex(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open index file: " + path);
+    }
+    std::string data;
+    char chunk[64 * 1024];
+    ssize_t n;
+    while ((n = ::read(fd, chunk, sizeof(chunk))) > 0) {
+        data.append(chunk, static_cast<size_t>(n));
+    }
+    ::close(fd);
+
+    if (data.size() < HEADER_SIZE || std::memcmp(data.data(), MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error("Not an index file: " + path);
+    }
+    const size_t count = (data.size() - HEADER_SIZE) / ENTRY_SIZE;
+    entries_.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t words[3];
+        std::memcpy(words, data.data() + HEADER_SIZE + i * ENTRY_SIZE, sizeof(words));
+        entries_[i].offset = words[0];
+        entries_[i].line = words[1];
+        entries_[i].timestamp = static_cast<int64_t>(words[2]);
+    }
+}
+
+/**
+ * @brief Last entry strictly before `from`, first entry strictly after `to`
+ *
+ * Lines between the begin entry and the next one may still be >= from,
+ * and everything from the end entry on is > to.
+ */
+LineIndex::Range LineIndex::find(int64_t from, int64_t to) const {
+    Range range;
+    auto byTime = [](const IndexEntry& entry, int64_t t) { return entry.timestamp < t; };
+
+    auto first = std::lower_bound(entries_.begin(), entries_.end(), from, byTime);
+    if (first != entries_.begin()) {
+        --first;
+        range.begin = first->offset;
+        range.firstLine = first->line;
+    }
+
+    auto last = std::upper_bound(entries_.begin(), entries_.end(), to,
+                                 [](int64_t t, const IndexEntry& entry) { return t < entry.timestamp; });
+    if (last != entries_.end()) {
+        range.end = last->offset;
+    }
+    return range;
+}
+
+/**
+ * @brief Reads the located range and filters it line by line
+ */
+LineIndex::QueryResult LineIndex::query(InputSource& input, int64_t from, int64_t to,
+                                        const KeywordMatcher* filter, const LineFn& onLine,
+                                        size_t maxLineLength) const {
+    QueryResult result;
+    const Range range = find(from, to);
+    if (range.begin >= range.end) return result;
+
+    std::unique_ptr<char[]> buffer(new char[READ_CHUNK]);
+    std::string partial;          // line split across reads, bounded by maxLineLength
+    bool inRange = false;         // state of the last timestamped line
+    bool done = false;
+    uint64_t position = range.begin;
+
+    // maxLineLength + 1 bytes is enough to truncate like the monitor does
+    auto carry = [&](const char* p, size_t n) {
+        const size_t room = maxLineLength + 1 - std::min(partial.size(), maxLineLength + 1);
+        partial.append(p, std::min(n, room));
+    };
+
+    auto handle = [&](std::string_view line) {
+        result.linesScanned++;
+        int64_t timestamp;
+        if (parseTimestamp(line, timestamp)) {
+            if (timestamp > to) {
+                done = true;  // time-ordered: nothing later can match
+                return;
+            }
+            inRange = timestamp >= from;
+        }
+        if (!inRange || line.empty()) return;
+        if (line.size() > maxLineLength) line = line.substr(0, maxLineLength);
+        if (!filter || filter->matches(line)) {
+            result.linesEmitted++;
+            onLine(line);
+        }
+    };
+
+    while (!done && position < range.end) {
+        size_t want = static_cast<size_t>(std::min<uint64_t>(READ_CHUNK, range.end - position));
+        ssize_t n = input.read(buffer.get(), want, position);
+        if (n <= 0) break;
+        position += static_cast<uint64_t>(n);
+        result.bytesScanned += static_cast<uint64_t>(n);
+
+        const char* p = buffer.get();
+        const char* end = p + n;
+        while (!done && p < end) {
+            const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            if (!nl) {
+                carry(p, end - p);
+                break;
+            }
+            if (partial.empty()) {
+                handle(std::string_view(p, nl - p));
+            } else {
+                carry(p, nl - p);
+                handle(partial);
+                partial.clear();
+            }
+            p = nl + 1;
+        }
+    }
+    if (!done && !partial.empty()) {
+        handle(partial);  // unterminated last line of the range
+    }
+    return result;
+}
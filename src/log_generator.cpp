@@ -18,6 +18,23 @@
 #include <vector>
 #include <iomanip>
 #include <sstream>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <charconv>
+#include <csignal>
+#include <cstring>
+#include <ctime>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+/// Set by SIGINT/SIGTERM so burst writers flush their last batch and exit
+static std::atomic<bool> g_stop{false};
+
+static void stopHandler(int) {
+    g_stop.store(true);
+}
 
 /**
  * @class HFTLogGenerator
@@ -204,31 +221,414 @@ public:
     }
 };
 
+/**
+ * @struct BurstOptions
+ * @brief Settings for the high-rate generator (--burst)
+ */
+struct BurstOptions {
+    uint64_t rate = 0;           ///< Target lines/s over all files, 0 = as fast as possible
+    double matchRatio = 0.1;     ///< Share of lines carrying a status keyword (EXECUTION, REJECT, ...)
+    double longRatio = 0.001;    ///< Share of 15000+ byte lines
+    size_t files = 1;            ///< Parallel writer files, one thread each
+    uint64_t lines = 0;          ///< Lines per file before stopping, 0 = until Ctrl+C
+    double seconds = 0;          ///< Stop after this long, 0 = until Ctrl+C
+};
+
+/**
+ * @class BurstLogGenerator
+ * @brief Same log format as HFTLogGenerator, fast enough to outrun the monitor
+ *
+ * HFTLogGenerator pays for an ostringstream, localtime() and put_time, an
+ * std::endl flush and a sleep on every line, which caps it at a few
+ * hundred thousand lines/s. Here lines are formatted straight into a
+ * preallocated 1MB batch (memcpy for constant text, std::to_chars for
+ * numbers), the "YYYY-MM-DD HH:MM:SS." prefix is only reformatted when the
+ * second changes, and the batch goes out with one write() on an O_APPEND fd.
+ * With a target rate, pacing happens per batch (at most 1ms of lines), not
+ * per line.
+ *
+ * Lines that don't match get a status word none of the keywords occur in
+ * (NEW, ACK, ...), so matchRatio is the match rate of a monitor filtering
+ * on the status keywords.
+ */
+class BurstLogGenerator {
+public:
+    static constexpr size_t BATCH_SIZE = 1024 * 1024;  ///< Bytes per write()
+    static constexpr size_t LONG_FILL = 15000;          ///< Filler bytes of a long line
+    static constexpr size_t MAX_LINE = LONG_FILL + 256;  ///< Room one line may need past BATCH_SIZE
+
+    /**
+     * @brief Opens the file for appending
+     * @param filename Path to output log file
+     * @param options Ratios and limits; rate and lines apply to this file
+     * @param seed RNG seed, different per writer
+     * @throw std::runtime_error if file cannot be opened
+     */
+    BurstLogGenerator(const std::string& filename, const BurstOptions& options, uint64_t seed)
+        : filename_(filename), options_(options), rng_(seed | 1) {
+        fd_ = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            throw std::runtime_error("failed to open log file: " + filename);
+        }
+        batch_.resize(BATCH_SIZE + MAX_LINE);
+        // thresholds on the top 32 bits of a random draw
+        matchThreshold_ = static_cast<uint64_t>(options.matchRatio * 4294967296.0);
+        longThreshold_ = static_cast<uint64_t>(options.longRatio * 4294967296.0);
+    }
+
+    ~BurstLogGenerator() {
+        if (fd_ >= 0) ::close(fd_);
+    }
+
+    BurstLogGenerator(const BurstLogGenerator&) = delete;
+    BurstLogGenerator& operator=(const BurstLogGenerator&) = delete;
+
+    /**
+     * @brief Writes batches until the line/time limit or Ctrl+C
+     * @param deadline Stop time (ignored when options.seconds is 0)
+     */
+    void run(std::chrono::steady_clock::time_point deadline) {
+        // with a target rate a batch holds at most 1ms worth of lines
+        const uint64_t batchLines = options_.rate ? std::max<uint64_t>(1, options_.rate / 1000) : UINT64_MAX;
+        const auto start = std::chrono::steady_clock::now();
+        
+        while (!g_stop.load(std::memory_order_relaxed)) {
+            if (options_.lines && written_ >= options_.lines) break;
+            if (options_.seconds > 0 && std::chrono::steady_clock::now() >= deadline) break;
+            
+            uint64_t count = batchLines;
+            if (options_.lines) count = std::min(count, options_.lines - written_);
+            count = fillBatch(count);
+            writeAll(batch_.data(), static_cast<size_t>(out_ - batch_.data()));
+            written_ += count;
+            lines_.store(written_, std::memory_order_relaxed);
+            
+            if (options_.rate) {
+                // sleep until this many lines are due, so short stalls are caught up
+                auto due = start + std::chrono::microseconds(written_ * 1000000 / options_.rate);
+                std::this_thread::sleep_until(due);
+            }
+        }
+    }
+
+    /// Lines written so far, readable from another thread
+    uint64_t linesWritten() const { return lines_.load(std::memory_order_relaxed); }
+
+    /// Bytes written so far, readable from another thread
+    uint64_t bytesWritten() const { return bytes_.load(std::memory_order_relaxed); }
+
+private:
+    /// xorshift64*: a few cycles per draw, plenty for picking fields
+    uint64_t next() {
+        rng_ ^= rng_ >> 12;
+        rng_ ^= rng_ << 25;
+        rng_ ^= rng_ >> 27;
+        return rng_ * 0x2545F4914F6CDD1DULL;
+    }
+    
+    /// Uniform value in [0, n) from the top 32 bits (multiply-shift, no division)
+    uint32_t pick(uint32_t n) {
+        return static_cast<uint32_t>(((next() >> 32) * n) >> 32);
+    }
+    
+    void append(const char* text, size_t len) {
+        std::memcpy(out_, text, len);
+        out_ += len;
+    }
+    
+    void append(const std::string& text) {
+        append(text.data(), text.size());
+    }
+    
+    void appendNumber(uint64_t value) {
+        out_ = std::to_chars(out_, out_ + 20, value).ptr;
+    }
+    
+    /// Zero padded, fixed width (microseconds, cents)
+    void appendPadded(uint32_t value, int width) {
+        for (int i = width - 1; i >= 0; --i) {
+            out_[i] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        }
+        out_ += width;
+    }
+    
+    /// "[YYYY-MM-DD HH:MM:SS.uuuuuu] ", the date part cached per second
+    void appendTimestamp() {
+        auto micros = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        std::time_t seconds = static_cast<std::time_t>(micros / 1000000);
+        if (seconds != cachedSecond_) {
+            std::tm tm;
+            localtime_r(&seconds, &tm);
+            std::strftime(secondPrefix_, sizeof(secondPrefix_), "[%Y-%m-%d %H:%M:%S.", &tm);
+            cachedSecond_ = seconds;
+        }
+        append(secondPrefix_, 21);
+        appendPadded(static_cast<uint32_t>(micros % 1000000), 6);
+        append("] ", 2);
+    }
+    
+    /// Formats up to count lines into batch_, stops once BATCH_SIZE is reached
+    uint64_t fillBatch(uint64_t count) {
+        out_ = batch_.data();
+        char* const limit = batch_.data() + BATCH_SIZE;
+        uint64_t i = 0;
+        for (; i < count && out_ < limit; ++i) {
+            const bool match = (next() >> 32) < matchThreshold_;
+            const bool longLine = (next() >> 32) < longThreshold_;
+            
+            appendTimestamp();
+            append(match ? KEYWORDS[pick(KEYWORD_COUNT)] : NEUTRAL[pick(NEUTRAL_COUNT)]);
+            if (longLine) {
+                append(" MARKET_DATA_SNAPSHOT ", 22);
+                std::memset(out_, 'X', LONG_FILL);
+                out_ += LONG_FILL;
+            } else {
+                append(" OrderID=", 9);
+                appendNumber(100000 + pick(900000));
+                append(" Symbol=", 8);
+                append(SYMBOLS[pick(SYMBOL_COUNT)]);
+                append(" Side=", 6);
+                append(SIDES[pick(2)]);
+                append(" Type=", 6);
+                append(ORDER_TYPES[pick(ORDER_TYPE_COUNT)]);
+                uint32_t cents = 10000 + pick(40001);
+                append(" Price=", 7);
+                appendNumber(cents / 100);
+                *out_++ = '.';
+                appendPadded(cents % 100, 2);
+                append(" Qty=", 5);
+                appendNumber(100 + pick(9901));
+                append(" Venue=NYSE Latency=", 20);
+                appendNumber(10 + pick(491));
+                append("us", 2);
+            }
+            *out_++ = '\n';
+        }
+        return i;
+    }
+    
+    /// write() loop, handling partial writes and EINTR
+    void writeAll(const char* data, size_t len) {
+        bytes_.fetch_add(len, std::memory_order_relaxed);
+        while (len > 0) {
+            ssize_t n = ::write(fd_, data, len);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                throw std::runtime_error("failed to write log file: " + filename_);
+            }
+            data += n;
+            len -= static_cast<size_t>(n);
+        }
+    }
+    
+    // same vocabulary as HFTLogGenerator
+    static inline const std::string SYMBOLS[] = {
+        "AAPL", "GOOGL", "MSFT", "AMZN", "TSLA", "META", "NVDA", "JPM", "BAC", "GS"};
+    static inline const std::string ORDER_TYPES[] = {"LIMIT", "MARKET", "STOP", "IOC", "FOK", "GTD"};
+    static inline const std::string SIDES[] = {"BUY", "SELL"};
+    static inline const std::string KEYWORDS[] = {
+        "key1", "key2", "EXECUTION", "REJECT", "FILL", "CANCEL", "ERROR", "WARNING"};
+    static inline const std::string NEUTRAL[] = {"NEW", "ACK", "PENDING", "REPLACE"};  // contain no keyword
+    static constexpr uint32_t SYMBOL_COUNT = 10;
+    static constexpr uint32_t ORDER_TYPE_COUNT = 6;
+    static constexpr uint32_t KEYWORD_COUNT = 8;
+    static constexpr uint32_t NEUTRAL_COUNT = 4;
+    
+    std::string filename_;
+    BurstOptions options_;
+    int fd_ = -1;
+    uint64_t rng_;
+    uint64_t matchThreshold_ = 0;
+    uint64_t longThreshold_ = 0;
+    std::vector<char> batch_;
+    char* out_ = nullptr;
+    std::time_t cachedSecond_ = -1;
+    char secondPrefix_[32] = {};
+    uint64_t written_ = 0;
+    std::atomic<uint64_t> lines_{0};
+    std::atomic<uint64_t> bytes_{0};
+};
+
+/**
+ * @brief Runs options.files burst writers in parallel and reports the rate
+ *
+ * One file writes to filename, several to filename.0, filename.1, ... (a
+ * ready-made --sources list for log_monitor). Rate and line limits are
+ * totals and split across the writers. Lines are split exactly: the first
+ * lines % files writers take one more, and a writer left with none isn't
+ * started (its file isn't written).
+ *
+ * @return 0 on success, 1 if a writer failed
+ */
+int runBurst(const std::string& filename, const BurstOptions& options) {
+    BurstOptions perFile = options;
+    perFile.rate = options.rate / options.files;
+    if (options.rate && perFile.rate == 0) perFile.rate = 1;
+    
+    std::vector<std::unique_ptr<BurstLogGenerator>> generators;
+    std::random_device seed;
+    for (size_t i = 0; i < options.files; ++i) {
+        if (options.lines) {
+            perFile.lines = options.lines / options.files + (i < options.lines % options.files ? 1 : 0);
+            if (perFile.lines == 0) continue;  // 0 would mean "until Ctrl+C"
+        }
+        std::string path = options.files == 1 ? filename : filename + "." + std::to_string(i);
+        uint64_t s = (static_cast<uint64_t>(seed()) << 32) | seed();
+        generators.push_back(std::make_unique<BurstLogGenerator>(path, perFile, s));
+        std::cout << "Writing " << path << std::endl;
+    }
+    
+    const auto start = std::chrono::steady_clock::now();
+    const auto deadline = start + std::chrono::microseconds(static_cast<int64_t>(options.seconds * 1e6));
+    std::atomic<size_t> running{generators.size()};
+    std::atomic<bool> failed{false};
+    std::vector<std::thread> writers;
+    for (auto& generator : generators) {
+        writers.emplace_back([&, g = generator.get()]() {
+            try {
+                g->run(deadline);
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << std::endl;
+                failed.store(true);
+            }
+            running.fetch_sub(1);
+        });
+    }
+    
+    auto totals = [&]() {
+        uint64_t lines = 0, bytes = 0;
+        for (const auto& g : generators) {
+            lines += g->linesWritten();
+            bytes += g->bytesWritten();
+        }
+        return std::make_pair(lines, bytes);
+    };
+    
+    // progress once a second: lines/s and MB/s over the last second
+    auto last = start;
+    uint64_t lastLines = 0, lastBytes = 0;
+    while (running.load() > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        auto now = std::chrono::steady_clock::now();
+        if (now - last < std::chrono::seconds(1)) continue;
+        auto [lines, bytes] = totals();
+        double secs = std::chrono::duration<double>(now - last).count();
+        std::cout << "Generated " << lines << " log entries ("
+                  << static_cast<uint64_t>((lines - lastLines) / secs) << " lines/s, "
+                  << std::fixed << std::setprecision(1) << (bytes - lastBytes) / secs / (1024 * 1024)
+                  << " MB/s)" << std::endl;
+        last = now;
+        lastLines = lines;
+        lastBytes = bytes;
+    }
+    for (auto& t : writers) t.join();
+    
+    auto [lines, bytes] = totals();
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Done: " << lines << " lines, " << (bytes / (1024 * 1024)) << " MB in "
+              << std::fixed << std::setprecision(2) << secs << "s ("
+              << static_cast<uint64_t>(lines / secs) << " lines/s)" << std::endl;
+    return failed.load() ? 1 : 0;
+}
+
 /**
  * @brief Main entry point for log_generator program
  * 
  * Usage: ./log_generator <output_file> [interval_microseconds]
+ *        ./log_generator <output_file> --burst [--rate=N] [--match=R] [--long=R]
+ *                        [--files=N] [--lines=N] [--seconds=S]
  * 
  * @param argc Argument count
  * @param argv Argument values
  *             argv[1] = output log file path
  *             argv[2] = interval in microseconds (optional, default: 1000)
  * 
+ * Burst mode options (any of them implies --burst):
+ * - --rate=N     total lines/s over all files, 0 (default) = as fast as possible
+ * - --match=R    share of lines with a status keyword, 0..1 (default 0.1)
+ * - --long=R     share of 15000 byte lines, 0..1 (default 0.001)
+ * - --files=N    parallel writers to FILE.0 .. FILE.N-1 (default 1 = FILE)
+ * - --lines=N    stop after N lines in total (default 0 = until Ctrl+C)
+ * - --seconds=S  stop after S seconds (default 0 = until Ctrl+C)
+ * 
  * @return 0 on success, 1 on error
  */
 int main(int argc, char* argv[]) {
     std::string filename = "a.log";
     int intervalUs = 1000; // 1000 logs per second w 1 ms frq
+    bool burst = false;
+    BurstOptions burstOptions;
     
     // Parse command-line arguments
-    if (argc > 1) filename = argv[1];
-    if (argc > 2) intervalUs = std::stoi(argv[2]);
+    std::vector<std::string> positional;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg.rfind("--", 0) != 0) {
+                positional.push_back(arg);
+                continue;
+            }
+            size_t eq = arg.find('=');
+            std::string name = arg.substr(0, eq);
+            std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+            burst = true;
+            if (name == "--burst") continue;
+            if (value.empty()) {
+                throw std::runtime_error("missing value: " + arg);
+            }
+            if (name == "--rate") {
+                burstOptions.rate = std::stoull(value);
+            } else if (name == "--match") {
+                burstOptions.matchRatio = std::stod(value);
+            } else if (name == "--long") {
+                burstOptions.longRatio = std::stod(value);
+            } else if (name == "--files") {
+                burstOptions.files = std::stoul(value);
+            } else if (name == "--lines") {
+                burstOptions.lines = std::stoull(value);
+            } else if (name == "--seconds") {
+                burstOptions.seconds = std::stod(value);
+            } else {
+                throw std::runtime_error("unknown option: " + arg);
+            }
+        }
+        if (burstOptions.matchRatio < 0 || burstOptions.matchRatio > 1 ||
+            burstOptions.longRatio < 0 || burstOptions.longRatio > 1) {
+            throw std::runtime_error("--match and --long take a ratio between 0 and 1");
+        }
+        if (burstOptions.files == 0) {
+            throw std::runtime_error("--files must be at least 1");
+        }
+        if (positional.size() > 0) filename = positional[0];
+        if (positional.size() > 1) intervalUs = std::stoi(positional[1]);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    
+    if (burst) {
+        std::cout << "=== Log Generator (burst) ===" << std::endl;
+        std::cout << "Rate: " << (burstOptions.rate ? std::to_string(burstOptions.rate) + " lines/second"
+                                                    : std::string("unlimited"))
+                  << ", match " << burstOptions.matchRatio << ", long " << burstOptions.longRatio
+                  << ", " << burstOptions.files << " file(s)" << std::endl << std::endl;
+        std::signal(SIGINT, stopHandler);
+        std::signal(SIGTERM, stopHandler);
+        try {
+            return runBurst(filename, burstOptions);
+        } catch (const std::exception& e) {
+            std::cerr << "Fatal error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
     
     // Print configuration
     std::cout << "=== Log Generator ===" << std::endl;
     std::cout << "Generating trading logs to: " << filename << std::endl;
     std::cout << "Interval: " << intervalUs << " microseconds" << std::endl;
-    std::cout << "Rate: ~" << (1000000 / intervalUs) << " logs/second" << std::endl << std::endl;
+    std::cout << "Rate: ~" << (1000000 / std::max(intervalUs, 1)) << " logs/second" << std::endl << std::endl;
     
     try {
         HFTLogGenerator generator(filename);
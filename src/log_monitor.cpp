@@ -15,57 +15,263 @@
 #include <thread>
 #include <chrono>
 #include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include <sys/stat.h>
+#include "simd_search.h"
+#include "mapped_file.h"
+#include "compressed_sink.h"
+#include "placement.h"
+
+namespace {
+
+/// Arena capacity for config, checked against Config::arenaLimit
+size_t reserveArena(const LogMonitor::Config& config) {
+    const size_t bytes = LogMonitor::arenaBytes(config);
+    if (config.arenaLimit > 0 && bytes > config.arenaLimit) {
+        throw std::runtime_error("Buffers need " + std::to_string(bytes) + " bytes, over arenaLimit " +
+                                 std::to_string(config.arenaLimit));
+    }
+    return bytes;
+}
+
+} // namespace
 
 /**
  * @brief Constructs a LogMonitor with the given configuration
  * 
- * Opens the output file in append mode with binary flag to avoid text
- * translation overhead. Allocates the read buffer and keyword matcher.
+ * Opens the output writer in append mode with the configured flush policy.
+ * Allocates the read buffer and keyword matcher.
  * 
  * @param config Configuration including file paths, keywords, and tuning parameters
- * @throw std::runtime_error if output file cannot be opened
+ * @throw std::runtime_error if output file cannot be opened, maxLineLength
+ *        is 0, WaitMode::Event is requested but unavailable, the buffers
+ *        would exceed Config::arenaLimit, or a configured CPU is unavailable
  * 
- * Memory allocations:
- * - Read buffer: config.bufferSize bytes (default 64KB)
- * - Partial line buffer: reserved to MAX_LINE_LENGTH (5000 bytes)
+ * Memory allocations (all but the matcher in one arena, see arenaBytes()):
+ * - Read buffer: config.bufferSize bytes (default 64KB), page aligned
+ * - Partial line buffer: maxLineLength + 1 (default 5001 bytes)
  * - KeywordMatcher: O(k) where k = total keyword string size
+ * - OutputWriter staging: max(flushBytes, 64KB) per output
+ * - Pipeline blocks: pipelineBlocks * (bufferSize + maxLineLength + 1)
+ * - Context copies: contextBefore * maxLineLength
+ * - Repeat table: repeatSlots * (32 + RepeatSuppressor::SAMPLE_BYTES)
  * 
  * @note Input file is NOT opened here - it's opened when start() is called
  */
 LogMonitor::LogMonitor(const Config& config)
     : config_(config),
-      matcher_(std::make_unique<KeywordMatcher>(config.keywords)),
+      arena_(reserveArena(config), config.hugePages),
+      input_(InputSource::create(config.inputBackend, config.decompressThreads)),
       lastPosition_(0),
       running_(false),
-      buffer_(std::make_unique<char[]>(config.bufferSize)) {
+      rates_(std::chrono::milliseconds(config.rateWindowMs)),
+      buffer_(arena_.allocate(config.bufferSize, 4096)) {
+    
+    if (config_.maxLineLength == 0) {
+        throw std::runtime_error("maxLineLength must be positive");
+    }
+    for (int cpu : config_.pipelineCpus) {
+        if (cpu >= 0 && !cpuAllowed(cpu)) {
+            throw std::runtime_error("CPU " + std::to_string(cpu) + " is not available");
+        }
+    }
+    if (config_.monitorCpu >= 0 && !cpuAllowed(config_.monitorCpu)) {
+        throw std::runtime_error("CPU " + std::to_string(config_.monitorCpu) + " is not available");
+    }
+    // first touch decides the NUMA node: pinned while everything is built,
+    // the caller's thread gets its affinity back when the constructor returns
+    ScopedPin pin(config_.monitorCpu);
+    
+    // +1: holds the truncated form of an over-long line, see carryPartialLine
+    partialLine_ = FixedBuffer(arena_.allocate(config_.maxLineLength + 1), config_.maxLineLength + 1);
+    if (config_.inputBackend == InputBackend::Compressed && !config_.indexFile.empty()) {
+        // the index reader seeks the raw file
+        throw std::runtime_error("A line index needs an uncompressed input");
+    }
+    
+    // open output in append mode: don't overwrite existing data (safe for restarts)
+    OutputWriter::Options writerOptions;
+    writerOptions.policy = config_.flushPolicy;
+    writerOptions.flushBytes = config_.flushBytes;
+    writerOptions.flushIntervalUs = config_.flushIntervalUs;
+    writerOptions.compression = config_.outputCompression;
+    writerOptions.compressionLevel = config_.compressionLevel;
+    writerOptions.frameIntervalMs = config_.frameIntervalMs;
+    writer_ = std::make_unique<OutputWriter>(config_.outputFile, writerOptions, &arena_);
+    outputs_.push_back(writer_.get());
+    
+    // a field filter stands in for the keywords: its prefilter literals find
+    // the candidates, the expression is only evaluated on those
+    std::vector<std::string> primaryKeywords = config_.keywords;
+    if (!config_.filter.empty()) {
+        filter_ = std::make_unique<FieldFilter>(config_.filter);
+        primaryKeywords = filter_->prefilterKeywords();
+    }
+    
+    // routes: one group per distinct output file, outputFile is group 0
+    std::vector<std::string> paths{config_.outputFile};
+    for (const Route& route : config_.routes) {
+        size_t output = std::find(paths.begin(), paths.end(), route.outputFile) - paths.begin();
+        if (output == paths.size()) {
+            if (paths.size() == KeywordMatcher::MAX_GROUPS) {
+                throw std::runtime_error("Too many route outputs, max " +
+                                         std::to_string(KeywordMatcher::MAX_GROUPS));
+            }
+            paths.push_back(route.outputFile);
+            routeWriters_.push_back(std::make_unique<OutputWriter>(route.outputFile, writerOptions, &arena_));
+            outputs_.push_back(routeWriters_.back().get());
+        }
+        routeGroups_.push_back(output);
+    }
+    if (config_.routes.empty() && !filter_ && config_.staticMatch &&
+            !config_.ignoreCase && !config_.wholeWord) {
+        // keywords fixed at compile time, see StaticKeywordMatcher
+        matcher_ = std::make_unique<KeywordMatcher>(primaryKeywords, config_.staticMatch);
+    } else {
+        matcher_ = buildMatcher(std::move(primaryKeywords));
+    }
+    
+    // watch is registered before the first read so no write can slip between
+    // reaching EOF and starting to wait
+    if (config_.waitMode != WaitMode::Poll) {
+        watcher_ = std::make_unique<FileWatcher>(config_.inputFile);
+        if (!watcher_->valid()) {
+            watcher_.reset();
+            if (config_.waitMode == WaitMode::Event) {
+                throw std::runtime_error("File events unavailable for: " + config_.inputFile);
+            }
+        }
+    }
+    
+    if (TRACE_COMPILED && config_.trace) {
+        tracer_ = std::make_unique<StageTracer>();
+    }
+    
+    // before-context is kept as views into buffer_, copied up to
+    // contextBefore lines at a time
+    if (config_.contextBefore > 0 || config_.contextAfter > 0) {
+        if (config_.pipelined) {
+            throw std::runtime_error("Context lines need the monitor thread to see every line, not pipelined");
+        }
+        context_ = std::make_unique<ContextRing>(config_.contextBefore, config_.contextAfter,
+                                                 config_.maxLineLength, arena_);
+    }
+    
+    if (config_.repeatLimit > 0) {
+        if (config_.pipelined) {
+            throw std::runtime_error("Repeat suppression runs on the monitor thread, not pipelined");
+        }
+        repeats_ = std::make_unique<RepeatSuppressor>(config_.repeatLimit, config_.repeatWindowMs,
+                                                      config_.repeatSlots, arena_);
+    }
+    
+    // workers only ever see the shared const matcher
+    if (config_.scanThreads > 1 && !context_) {
+        parallel_ = std::make_unique<ParallelScanner>(*matcher_, config_.scanThreads,
+                                                      config_.maxLineLength, config_.scanChunkSize);
+    }
+    
+    // opened here so the pipeline can be handed it; positioned below
+    if (!config_.indexFile.empty()) {
+        index_ = std::make_unique<LineIndexWriter>(config_.indexFile, config_.indexInterval);
+    }
+    
+    // stages get the shared matcher and exclusive use of the writer
+    if (config_.pipelined) {
+        Pipeline::Options pipelineOptions;
+        pipelineOptions.matcherThreads = config_.matcherThreads;
+        pipelineOptions.blocks = config_.pipelineBlocks;
+        pipelineOptions.readSize = config_.bufferSize;
+        pipelineOptions.maxLineLength = config_.maxLineLength;
+        pipelineOptions.index = index_.get();
+        pipelineOptions.filter = filter_.get();
+        pipelineOptions.arena = &arena_;
+        pipelineOptions.cpus = config_.pipelineCpus;
+        pipeline_ = std::make_unique<Pipeline>(*matcher_, outputs_, pipelineOptions);
+    }
+    
+    // resume point from a previous run, before anything is read or written
+    if (!config_.checkpointFile.empty()) {
+        restoreCheckpoint();
+    }
     
-    // open output file in append + binary mode
-    // append: don't overwrite existing data (safe for restarts)
-    // binary: avoid newline translation overhead
-    outStream_.open(config_.outputFile, std::ios::app | std::ios::binary);
-    if (!outStream_.is_open()) {
-        throw std::runtime_error("Failed to open output file: " + config_.outputFile);
+    // the index must describe exactly the bytes before the first read
+    if (index_) {
+        if (lastPosition_ > 0) {
+            index_->resume(config_.inputFile, lastPosition_);
+        } else {
+            index_->reset();
+        }
+    }
+    
+    checkScanMode();
+}
+
+/**
+ * @brief Builds the runtime matcher: primary keywords in group 0, routes in theirs
+ * 
+ * @param primaryKeywords Keywords (or filter prefilter literals) for outputFile
+ * @return Matcher with ignoreCase / wholeWord from the config
+ */
+std::unique_ptr<KeywordMatcher> LogMonitor::buildMatcher(std::vector<std::string> primaryKeywords) const {
+    KeywordMatcher::Options matchOptions;
+    matchOptions.ignoreCase = config_.ignoreCase;
+    matchOptions.wholeWord = config_.wholeWord;
+    if (config_.routes.empty()) {
+        return std::make_unique<KeywordMatcher>(std::move(primaryKeywords),
+                                                std::vector<KeywordMatcher::GroupMask>{}, matchOptions);
     }
     
-    // reserve space for partial line to avoid repeated reallocations
-    // during string concatenation across buffer boundaries
-    partialLine_.reserve(MAX_LINE_LENGTH);
+    std::vector<std::string> keywords = std::move(primaryKeywords);
+    std::vector<KeywordMatcher::GroupMask> groups(keywords.size(), 1);
+    for (size_t r = 0; r < config_.routes.size(); ++r) {
+        // a keyword shared by groups is searched once, for all of them
+        for (const auto& keyword : config_.routes[r].keywords) {
+            size_t k = std::find(keywords.begin(), keywords.end(), keyword) - keywords.begin();
+            if (k == keywords.size()) {
+                keywords.push_back(keyword);
+                groups.push_back(0);
+            }
+            groups[k] |= KeywordMatcher::GroupMask(1) << routeGroups_[r];
+        }
+    }
+    return std::make_unique<KeywordMatcher>(std::move(keywords), std::move(groups), matchOptions);
+}
+
+/**
+ * @brief Falls back to per-line scans if a keyword contains '\n'
+ * 
+ * Whole-buffer mode assumes a hit never spans lines. Recomputed from
+ * Config::scanMode on every reload, so a set without such a keyword gets
+ * whole-buffer scans back.
+ */
+void LogMonitor::checkScanMode() {
+    scanMode_ = config_.scanMode;
+    if (context_) {
+        scanMode_ = ScanMode::PerLine;  // whole-buffer scans skip the non-matching lines
+    }
+    for (const auto& keyword : matcher_->getKeywords()) {
+        if (keyword.find('\n') != std::string::npos) {
+            scanMode_ = ScanMode::PerLine;
+        }
+    }
 }
 
 /**
  * @brief Destructor - ensures clean shutdown and file closure
  * 
- * Calls stop() to halt monitoring loop, then closes input and output streams.
+ * Calls stop() to halt monitoring loop, then closes input and output files.
  * Destructor guarantees cleanup even if stop() wasn't called explicitly.
+ * Destroying the writer performs the final flush of pending output.
  */
 LogMonitor::~LogMonitor() {
     stop();
-    if (inStream_.is_open()) {
-        inStream_.close();
-    }
-    if (outStream_.is_open()) {
-        outStream_.close();
-    }
+    pipeline_.reset();  // joins stages before the writer goes away
+    input_->close();
+    writer_.reset();
+    routeWriters_.clear();
+    delete pendingMatcher_.load();
 }
 
 /**
@@ -74,34 +280,120 @@ LogMonitor::~LogMonitor() {
  * Processing steps:
  * 1. Skip empty lines (no-op)
  * 2. Increment linesProcessed counter
- * 3. Truncate if line exceeds MAX_LINE_LENGTH
+ * 3. Truncate if line exceeds maxLineLength
  * 4. Check for keyword match
- * 5. If match: write to output file with immediate flush
+ * 5. If match: hand to the output writer, which flushes per Config::flushPolicy
  * 
  * @param line Line to process (string_view for zero-copy when possible)
  * 
  * 
- * @note Flush overhead is acceptable because matched lines are relatively rare
- *       compared to total lines processed (typically <10% match rate)
+ * @note FlushPolicy::PerLine keeps the old one-syscall-per-match behaviour;
+ *       at high match rates use Bytes/Interval/PerBuffer instead
  */
 void LogMonitor::processLine(std::string_view line) {
-    if (line.empty()) return;
+    if (line.empty()) {
+        // not processed or matched, but still a line of context
+        if (context_) context_->other(line, false, *outputs_[0]);
+        return;
+    }
     
     stats_.linesProcessed++;
     
     // truncate if exceeds max length
     std::string_view processedLine = line;
-    if (processedLine.length() > MAX_LINE_LENGTH) {
-        processedLine = processedLine.substr(0, MAX_LINE_LENGTH);
+    if (processedLine.length() > config_.maxLineLength) {
+        processedLine = processedLine.substr(0, config_.maxLineLength);
         stats_.longLinesDiscarded++;
     }
     
-    // check for keyword match
-    if (matcher_->matches(processedLine)) {
-        stats_.linesMatched++;
-        outStream_.write(processedLine.data(), processedLine.length());
-        outStream_.put('\n');
-        outStream_.flush(); // MUST FLUSH YES -stpud bug
+    if (tracing() && tracer_->sampleLine()) {
+        processLineTraced(processedLine);
+        return;
+    }
+    
+    // check for keyword match; routed, the same pass picks the outputs
+    if (outputs_.size() == 1) {
+        if (matcher_->matches(processedLine)) {
+            emitMatch(processedLine, 1);
+        } else if (context_) {
+            emitMatch(processedLine, 0);
+        }
+    } else if (KeywordMatcher::GroupMask groups = matcher_->matchGroups(processedLine)) {
+        emitMatch(processedLine, groups);
+    } else if (context_) {
+        emitMatch(processedLine, 0);
+    }
+}
+
+/**
+ * @brief processLine's match and output, with both timed (sampled lines)
+ */
+void LogMonitor::processLineTraced(std::string_view line) {
+    const uint64_t t0 = StageTracer::now();
+    const KeywordMatcher::GroupMask groups = outputs_.size() == 1
+        ? KeywordMatcher::GroupMask(matcher_->matches(line))
+        : matcher_->matchGroups(line);
+    const uint64_t t1 = StageTracer::now();
+    tracer_->record(StageTracer::Stage::Match, t1 - t0);
+    if (groups) {
+        emitMatch(line, groups);
+        tracer_->record(StageTracer::Stage::Write, StageTracer::now() - t1);
+    } else if (context_) {
+        emitMatch(line, 0);
+    }
+}
+
+/**
+ * @brief Writes a matched line to the output file
+ * 
+ * Shared by the per-line and whole-buffer paths so both produce identical
+ * output and statistics.
+ * 
+ * @param line Matched line, already truncated to maxLineLength
+ * @param groups Outputs the line goes to; group 0 is still subject to
+ *               Config::filter. With context lines every line comes
+ *               through here, 0 for the ones that matched nothing.
+ */
+void LogMonitor::emitMatch(std::string_view line, KeywordMatcher::GroupMask groups) {
+    if (filter_ && (groups & 1) && !filter_->evaluate(line)) {
+        groups &= ~KeywordMatcher::GroupMask(1);  // prefilter candidate only
+    }
+    bool suppressed = false;
+    if (repeats_ && (groups & 1) && !repeats_->admit(line, *outputs_[0])) {
+        groups &= ~KeywordMatcher::GroupMask(1);  // counted into the template's summary
+        suppressed = true;
+        stats_.linesSuppressed++;
+    }
+    // lines in buffer_ stay valid until endOfBuffer(); partialLine_ is reused
+    // by the next carry-over, so that one must be copied
+    const bool stable = line.data() != partialLine_.data();
+    if (context_ && suppressed) {
+        context_->skip();  // not written, but its line number is taken
+    } else if (context_ && !(groups & 1)) {
+        context_->other(line, stable, *outputs_[0]);
+    }
+    if (!groups) return;
+    stats_.linesMatched++;
+    for (size_t i = 0; i < outputs_.size(); ++i) {
+        if (groups >> i & 1) {
+            if (i == 0 && context_) {
+                context_->match(line, stable, *outputs_[0]);
+            } else {
+                outputs_[i]->writeLine(line, stable);
+            }
+        }
+    }
+}
+
+KeywordMatcher::GroupMask LogMonitor::groupsOf(std::string_view line) const {
+    return outputs_.size() == 1 ? 1 : matcher_->matchGroups(line);
+}
+
+void LogMonitor::endOfBuffer() {
+    if (context_) context_->endOfBuffer();
+    if (repeats_) repeats_->tick(std::chrono::steady_clock::now(), *outputs_[0]);
+    for (OutputWriter* output : outputs_) {
+        output->endOfBuffer();
     }
 }
 
@@ -117,147 +409,475 @@ void LogMonitor::processLine(std::string_view line) {
  *
  * State 3: Continuation from previous buffer
  * 
+ * State 4: Rest of an over-long line (discardingLine_), skipped up to its
+ *          '\n' with one memchr; a buffer without one is skipped whole
+ * 
  * @param buffer Pointer to buffer containing data
  * @param bytesRead Number of valid bytes in buffer
  * 
  * Memory safety:
- * - Prevents unbounded growth of partialLine_ via MAX_LINE_LENGTH check
- * - Even a 10GB single line consumes max 5000 bytes memory
+ * - Prevents unbounded growth of partialLine_ via the maxLineLength check
+ * - Even a 10GB single line consumes max maxLineLength + 1 bytes memory
  * 
  * Performance:
- * - Single pass through buffer: O(bytesRead)
+ * - Single memchr pass through buffer: O(bytesRead)
  * - Zero-copy processing when line fits entirely in buffer
  * - String concatenation only when lines span buffers
  */
 void LogMonitor::processBuffer(const char* buffer, size_t bytesRead) {
     stats_.bytesRead += bytesRead;
+    if (index_) {
+        index_->consume(buffer, bytesRead);
+        stats_.indexEntries.set(index_->entryCount());
+    }
     size_t start = 0;
     
-    // scan for newline characters
-    for (size_t i = 0; i < bytesRead; ++i) {
-        if (buffer[i] == '\n') {
-            // complete line found
-            size_t segmentLen = i - start;
-            
-            if (!partialLine_.empty()) {
-                // append to partial line from previous buffer
-                partialLine_.append(buffer + start, segmentLen);
-                processLine(partialLine_);
-                partialLine_.clear();
+    // rest of an over-long line: nothing of it is kept, so find its end
+    // and leave start on the '\n' that completes partialLine_
+    if (discardingLine_) {
+        const void* nl = std::memchr(buffer, '\n', bytesRead);
+        if (!nl) {
+            discardedBytes_ += bytesRead;
+            return;
+        }
+        start = static_cast<const char*>(nl) - buffer;
+        discardedBytes_ += start;
+        discardingLine_ = false;
+    }
+    
+    // only backlog-sized regions are worth fanning out
+    const bool parallel = parallel_ && bytesRead >= 2 * parallel_->chunkSize();
+    
+    if (scanMode_ == ScanMode::WholeBuffer || parallel) {
+        // finish the line carried over from the previous buffer first
+        if (!partialLine_.empty()) {
+            const void* nl = std::memchr(buffer + start, '\n', bytesRead - start);
+            if (!nl) {
+                carryPartialLine(buffer + start, bytesRead - start);
+                return;
+            }
+            size_t lineEnd = static_cast<const char*>(nl) - buffer;
+            completePartialLine(buffer + start, lineEnd - start);
+            start = lineEnd + 1;
+        }
+        
+        // everything up to the last newline is complete lines
+        size_t end = bytesRead;
+        while (end > start && buffer[end - 1] != '\n') {
+            --end;
+        }
+        if (end > start) {
+            if (parallel) {
+                processRegionParallel(buffer + start, end - start);
             } else {
-                // process directly from buffer 
-                processLine(std::string_view(buffer + start, segmentLen));
+                processRegion(buffer + start, end - start);
             }
-            
-            start = i + 1;
         }
+        if (end < bytesRead) {
+            carryPartialLine(buffer + end, bytesRead - end);
+        }
+        return;
+    }
+    
+    // scan for newline characters (memchr is vectorized in libc, and skips
+    // the tail of a long line at the same speed)
+    while (start < bytesRead) {
+        const void* nl = std::memchr(buffer + start, '\n', bytesRead - start);
+        if (!nl) break;
+        // complete line found
+        size_t i = static_cast<const char*>(nl) - buffer;
+        size_t segmentLen = i - start;
+        
+        if (!partialLine_.empty()) {
+            // append to partial line from previous buffer
+            completePartialLine(buffer + start, segmentLen);
+        } else {
+            // process directly from buffer 
+            processLine(std::string_view(buffer + start, segmentLen));
+        }
+        
+        start = i + 1;
     }
     
     // handle remaining partial line (no newline found before buffer end)
     if (start < bytesRead) {
-        size_t remainingLen = bytesRead - start;
+        carryPartialLine(buffer + start, bytesRead - start);
+    }
+}
+
+/**
+ * @brief Cold-start pass over the existing backlog
+ * 
+ * Windows need not end on a line boundary: the tail fragment is carried in
+ * partialLine_ exactly like at a read buffer boundary. endOfBuffer() runs
+ * before each munmap since PerBuffer output references the mapping.
+ * 
+ * Failures (file vanished, mmap refused) just leave the rest of the backlog
+ * to the read loop. Output write errors still propagate to start().
+ */
+void LogMonitor::catchUp() {
+    // compressed: the mapped bytes aren't the text
+    if (config_.mmapWindowSize == 0 || pipeline_ || config_.inputBackend == InputBackend::Compressed) return;
+    
+    std::unique_ptr<MappedFile> file;
+    try {
+        file = std::make_unique<MappedFile>(config_.inputFile);
+    } catch (const std::runtime_error&) {
+        return;
+    }
+    
+    while (running_) {
+        const uint64_t size = file->size();
+        if (size <= lastPosition_ || size - lastPosition_ < config_.mmapCatchUpThreshold) {
+            break;
+        }
         
-        // if partial line + remaining exceeds MAX_LINE_LENGTH, process and discard
-        // this prevents memory exhaustion from malformed input 
-        if (partialLine_.length() + remainingLen >= MAX_LINE_LENGTH) {
-            partialLine_.append(buffer + start, 
-                               MAX_LINE_LENGTH - partialLine_.length());
-            processLine(partialLine_);
-            partialLine_.clear();
-            stats_.longLinesDiscarded++;
-        } else {
-            partialLine_.append(buffer + start, remainingLen);
+        const size_t len = static_cast<size_t>(
+            std::min<uint64_t>(config_.mmapWindowSize, size - lastPosition_));
+        const char* window = file->map(lastPosition_, len);
+        if (!window) break;
+        if (pendingMatcher_.load(std::memory_order_relaxed)) {
+            applyPendingMatcher();
         }
+        
+        const uint64_t t0 = tracing() ? StageTracer::now() : 0;
+        processBuffer(window, len);
+        endOfBuffer();  // flush references before munmap
+        if (tracing()) tracer_->record(StageTracer::Stage::Buffer, StageTracer::now() - t0);
+        lastPosition_ += len;
+        stats_.readOffset.set(lastPosition_);
+        stats_.bytesMapped += len;
     }
 }
 
+/**
+ * @brief Keeps the unterminated tail of a buffer for the next read
+ * 
+ * @param data Fragment start
+ * @param len Fragment length
+ */
+void LogMonitor::carryPartialLine(const char* data, size_t len) {
+    // keep maxLineLength + 1 bytes at most, this prevents memory exhaustion
+    // from malformed input; processLine() truncates and counts at the '\n'
+    const size_t room = config_.maxLineLength + 1 - partialLine_.length();
+    if (len > room) {
+        partialLine_.append(data, room);
+        discardedBytes_ += len - room;
+        discardingLine_ = true;
+    } else {
+        partialLine_.append(data, len);
+    }
+}
+
+/**
+ * @brief Appends the end of the carried line and processes it
+ * 
+ * @param data Bytes up to (not including) the '\n'
+ * @param len Their length
+ */
+void LogMonitor::completePartialLine(const char* data, size_t len) {
+    const size_t room = config_.maxLineLength + 1 - partialLine_.length();
+    partialLine_.append(data, std::min(len, room));
+    processLine(partialLine_);
+    clearPartialLine();
+}
+
+/**
+ * @brief Forgets the carried line, including a discard in progress
+ */
+void LogMonitor::clearPartialLine() {
+    partialLine_.clear();
+    discardingLine_ = false;
+    discardedBytes_ = 0;
+}
+
+/**
+ * @brief Matches a run of complete lines with a single keyword search
+ * 
+ * Algorithm:
+ * 1. Count lines / long lines with the vectorized newline kernel
+ * 2. Ask the Scanner for the next keyword hit
+ * 3. Walk back and forward from the hit to the enclosing '\n's
+ * 4. Truncate, re-check if the hit may have been cut off, emit
+ * 5. Resume the search after that line
+ * 
+ * With a low match rate the common case is two streaming passes (newline
+ * count + keyword search) and no per-line function calls.
+ * 
+ * @param data Start of the first line
+ * @param len Length up to and including the final '\n'
+ */
+void LogMonitor::processRegion(const char* data, size_t len) {
+    simd::LineCounts counts = simd::countLines(data, len, config_.maxLineLength);
+    stats_.linesProcessed += counts.lines;
+    stats_.longLinesDiscarded += counts.longLines;
+    
+    std::string_view text(data, len);
+    KeywordMatcher::Scanner scanner(*matcher_, text);
+    size_t pos = 0;
+    
+    while (pos < len) {
+        size_t hit = scanner.next(pos);
+        if (hit == std::string_view::npos) break;
+        
+        // hit is inside a line that starts at or after pos
+        size_t lineStart = hit;
+        while (lineStart > pos && data[lineStart - 1] != '\n') {
+            --lineStart;
+        }
+        const void* nl = std::memchr(data + hit, '\n', len - hit);
+        size_t lineEnd = static_cast<const char*>(nl) - data;
+        pos = lineEnd + 1;
+        
+        std::string_view line = text.substr(lineStart, lineEnd - lineStart);
+        if (line.empty()) continue;
+        
+        // the hit may sit past the cut, so re-check what will be written
+        if (line.length() > config_.maxLineLength) {
+            line = line.substr(0, config_.maxLineLength);
+            if (!matcher_->matches(line)) continue;
+        }
+        emitMatch(line, groupsOf(line));
+    }
+}
+
+/**
+ * @brief Fans a backlog region out to the ParallelScanner
+ * 
+ * Matches come back in file order on this thread, so output and the
+ * writer stay single-threaded.
+ * 
+ * @param data Start of the first line
+ * @param len Length up to and including the final '\n'
+ */
+void LogMonitor::processRegionParallel(const char* data, size_t len) {
+    ParallelScanner::Result result = parallel_->scan(data, len, [this](std::string_view line) {
+        emitMatch(line, groupsOf(line));
+    });
+    stats_.linesProcessed += result.lines;
+    stats_.longLinesDiscarded += result.longLines;
+}
+
 /**
  * @brief Main monitoring loop - runs until stop() is called
  * 
  * Monitoring algorithm:
- * 1. Open input file (if not already open)
- * 2. Seek to last known position (for resume after file rotation)
- * 3. Read available data in chunks
- * 4. Process each buffer
- * 5. Track file position
- * 6. Handle EOF: clear flag and continue polling
- * 7. Handle errors: close file, reset position, retry
- * 8. Sleep if no data available (avoid busy-wait)
+ * 1. Open input file (if not already open), mmap through a large backlog
+ * 2. Read available data in chunks at lastPosition_ (InputSource backend)
+ * 3. Process each buffer
+ * 4. Advance lastPosition_ by the bytes consumed
+ * 5. Stop reading on a short read / EOF
+ * 6. Handle errors: close file, reset position, retry
+ * 7. Wait for a change event, or sleep in poll mode (avoid busy-wait)
  * 
  * This is a blocking call - typically run in a separate thread.
  * 
  * File rotation handling:
- * - If read fails (file deleted/rotated), close and reopen on next iteration
- * - Position resets to 0, effectively starting from new file
+ * - At EOF, handleRotation() compares the open file with the path: a new
+ *   inode is reopened at 0, a shrunk file is reread from 0
+ * - If read fails, close and reopen on next iteration at position 0
  * 
  * Performance tuning:
- * - pollIntervalMs controls latency vs CPU usage tradeoff
- * - Smaller interval = lower latency, higher CPU
- * - Default 10ms is optimal for HFT (sub-100ms latency requirement)
+ * - WaitMode::Event wakes within microseconds of a write and uses no CPU
+ *   while idle
+ * - In WaitMode::Poll, pollIntervalMs controls latency vs CPU usage; 0
+ *   busy-polls a whole core
  * 
  * @note Blocks until stop() is called from another thread or signal handler
  * @see stop()
  */
 void LogMonitor::start() {
     running_ = true;
+    pinMonitorThread();
+    printStartup();
     
-
-    std::cout << "Starting log monitor..." << std::endl;
-    std::cout << "Input: " << config_.inputFile << std::endl;
-    std::cout << "Output: " << config_.outputFile << std::endl;
-    std::cout << "Keywords: ";
-    for (size_t i = 0; i < config_.keywords.size(); ++i) {
-        std::cout << config_.keywords[i];
-        if (i < config_.keywords.size() - 1) std::cout << ", ";
+    if (pipeline_) {
+        pipeline_->start();  // this thread stays the reader stage
     }
-    std::cout << std::endl << std::endl;
     
     while (running_) {
-        // open file if not open
-        if (!inStream_.is_open()) {
-            inStream_.open(config_.inputFile, std::ios::binary);
-            if (inStream_.is_open()) {
-                inStream_.seekg(lastPosition_);
-            } else {
-                // file doesn't exist yet try one more time
-                std::this_thread::sleep_for(
-                    std::chrono::milliseconds(config_.pollIntervalMs));
+        if (tracing() && traceDumpRequested_.exchange(false)) {
+            std::cerr << tracer_->report() << std::flush;
+        }
+        
+        // open file if not open, reads resume at lastPosition_
+        if (!input_->isOpen()) {
+            if (!input_->open(config_.inputFile)) {
+                // file doesn't exist yet, the directory watch reports its creation
+                waitForData();
                 continue;
             }
+            catchUp();  // big backlog after (re)start: mmap instead of read
         }
         
-        // read available data
-        bool dataRead = false;
-        while (inStream_.good()) {
-            inStream_.read(buffer_.get(), config_.bufferSize);
-            std::streamsize bytesRead = inStream_.gcount();
-            
-            if (bytesRead > 0) {
-                dataRead = true;
-                processBuffer(buffer_.get(), bytesRead);
-                lastPosition_ = inStream_.tellg();
-            }
-            
-            if (inStream_.eof()) {
-                inStream_.clear();  // clear EOF flag to continue polling
-                break;
-            }
-            
-            if (inStream_.fail() && !inStream_.eof()) {
-                // errpr reading file 
-                inStream_.close();
-                lastPosition_ = 0;
-                partialLine_.clear();
-                break;
-            }
+        bool dataRead = readAvailable(true);
+        if (tracing()) tracer_->countLoop(dataRead);
+        
+        // pipelined: the writer thread owns the output until finish()
+        if (!pipeline_ && checkpointDirty_ &&
+            std::chrono::steady_clock::now() - lastCheckpoint_ >=
+                std::chrono::milliseconds(config_.checkpointIntervalMs)) {
+            saveCheckpoint();
         }
         
         //avoid busy wait for sleeping due to no reading of data
         if (!dataRead) {
-            std::this_thread::sleep_for(
-                std::chrono::milliseconds(config_.pollIntervalMs));
+            if (!pipeline_) {
+                // repeats of a flood that stopped get their summary while idle
+                if (repeats_) repeats_->tick(std::chrono::steady_clock::now(), *outputs_[0]);
+                for (OutputWriter* output : outputs_) {
+                    output->tick();  // interval policy: don't sit on output while idle
+                }
+            }
+            const uint64_t idleStart = tracing() ? StageTracer::now() : 0;
+            waitForData();
+            if (tracing()) tracer_->record(StageTracer::Stage::Idle, StageTracer::now() - idleStart);
+        }
+    }
+    
+    finishOutput();
+}
+
+/**
+ * @brief One synchronous pass over the input, for batch runs and benchmarks
+ * 
+ * Same path as start() (catch-up, reads, pipeline, checkpoint) minus the
+ * banner, the waits and rotation checks, so the caller's time is the work.
+ */
+LogMonitor::Statistics LogMonitor::runUntilEof() {
+    running_ = true;  // catch-up windows stop early on stop()
+    pinMonitorThread();
+    if (!input_->isOpen()) {
+        if (!input_->open(config_.inputFile)) {
+            running_ = false;
+            throw std::runtime_error("Failed to open input file: " + config_.inputFile);
+        }
+        catchUp();
+    }
+    if (pipeline_) {
+        pipeline_->start();
+    }
+    readAvailable(false);
+    finishOutput();
+    running_ = false;
+    return getStatistics();
+}
+
+/**
+ * @brief Reads until a short read (caught up with the writer) or EOF
+ * 
+ * At EOF with followRotation a rotated file is switched to and counts as
+ * data, so the caller reads it right away instead of waiting.
+ */
+bool LogMonitor::readAvailable(bool followRotation) {
+    bool dataRead = false;
+    while (true) {
+        if (pendingMatcher_.load(std::memory_order_relaxed)) {
+            applyPendingMatcher();
+        }
+        
+        // pipelined: the read goes into a pool block and on to the matchers
+        const uint64_t readStart = tracing() ? StageTracer::now() : 0;
+        ssize_t bytesRead = pipeline_
+            ? pipeline_->read(*input_, lastPosition_)
+            : input_->read(buffer_, config_.bufferSize, lastPosition_);
+        if (tracing() && bytesRead > 0) {
+            tracer_->record(StageTracer::Stage::Read, StageTracer::now() - readStart);
+            tracer_->recordRead(static_cast<size_t>(bytesRead));
+        }
+        
+        if (bytesRead < 0) {
+            // error reading file
+            input_->close();
+            lastPosition_ = 0;
+            stats_.readOffset.set(0);
+            clearPartialLine();
+            if (pipeline_) pipeline_->discardPartial();
+            if (index_) index_->reset();
+            break;
+        }
+        if (bytesRead == 0) {
+            // at EOF: more data only comes from a rotated file now
+            if (followRotation && handleRotation()) {
+                dataRead = true;  // don't wait, read the new file right away
+            }
+            break;
+        }
+        
+        dataRead = true;
+        checkpointDirty_ = true;
+        if (pipeline_) {
+            stats_.bytesRead += static_cast<uint64_t>(bytesRead);
+            if (index_) stats_.indexEntries.set(index_->entryCount());
+        } else if (tracing()) {
+            const uint64_t t0 = StageTracer::now();
+            processBuffer(buffer_, static_cast<size_t>(bytesRead));
+            const uint64_t t1 = StageTracer::now();
+            endOfBuffer();
+            tracer_->record(StageTracer::Stage::Buffer, t1 - t0);
+            tracer_->record(StageTracer::Stage::Flush, StageTracer::now() - t1);
+        } else {
+            processBuffer(buffer_, static_cast<size_t>(bytesRead));
+            endOfBuffer();  // buffer_ is about to be reused
+        }
+        lastPosition_ += static_cast<uint64_t>(bytesRead);
+        stats_.readOffset.set(lastPosition_);
+        
+        // short read means we've caught up with the writer (tailing only,
+        // a batch run reads on to EOF)
+        if (followRotation && static_cast<size_t>(bytesRead) < config_.bufferSize) {
+            break;
+        }
+    }
+    return dataRead;
+}
+
+/**
+ * @brief Drains the pipeline stages, then final flush and checkpoint on this thread
+ */
+void LogMonitor::finishOutput() {
+    if (pipeline_) {
+        pipeline_->finish();
+    }
+    if (repeats_) {
+        repeats_->finish(*outputs_[0]);
+    }
+    for (OutputWriter* output : outputs_) {
+        output->flush();
+    }
+    saveCheckpoint();
+}
+
+void LogMonitor::printStartup() const {
+    std::cout << "Starting log monitor..." << std::endl;
+    std::cout << "Input: " << config_.inputFile << std::endl;
+    std::cout << "Output: " << config_.outputFile << std::endl;
+    std::cout << "Keywords: ";
+    for (size_t i = 0; i < config_.keywords.size(); ++i) {
+        std::cout << config_.keywords[i];
+        if (i < config_.keywords.size() - 1) std::cout << ", ";
+    }
+    if (matcher_->getEngine() == KeywordMatcher::Engine::Static) {
+        std::cout << " (compiled in)";
+    }
+    if (config_.ignoreCase || config_.wholeWord) {
+        std::cout << " [" << (config_.ignoreCase ? "ignore case" : "")
+                  << (config_.ignoreCase && config_.wholeWord ? ", " : "")
+                  << (config_.wholeWord ? "whole word" : "") << "]";
+    }
+    std::cout << std::endl;
+    if (filter_) {
+        std::cout << "Filter: " << config_.filter << std::endl;
+    }
+    for (const Route& route : config_.routes) {
+        std::cout << "Route: ";
+        for (size_t i = 0; i < route.keywords.size(); ++i) {
+            std::cout << route.keywords[i] << (i + 1 < route.keywords.size() ? ", " : "");
         }
+        std::cout << " -> " << route.outputFile << std::endl;
     }
+    std::cout << "Wait: " << (watcher_ ? watcher_->backendName() : "poll") << std::endl;
+    std::cout << std::endl;
 }
 
 /**
@@ -269,10 +889,275 @@ void LogMonitor::start() {
  * 
  * 
  * @note Thread-safe via std::atomic<bool>
- * @note Safe to call from signal handlers (SIGINT, SIGTERM)
+ * @note Safe to call from signal handlers (SIGINT, SIGTERM); the watcher
+ *       wakeup is a single eventfd/kevent syscall
  */
 void LogMonitor::stop() {
     running_ = false;
+    if (watcher_) {
+        watcher_->wakeup();  // don't wait out EVENT_RECHECK_MS
+    }
+}
+
+/**
+ * @brief Builds the new matcher here and publishes it for the monitor thread
+ * 
+ * The build (automaton for large sets) is the expensive part and stays on
+ * the caller's thread. The exchange hands ownership over: whoever takes a
+ * pointer out of pendingMatcher_ deletes or adopts it.
+ */
+void LogMonitor::reloadKeywords(const std::vector<std::string>& keywords) {
+    if (filter_) {
+        throw std::runtime_error("Keywords can't be reloaded with a filter expression");
+    }
+    if (keywords.empty()) {
+        throw std::runtime_error("Keyword reload needs at least one keyword");
+    }
+    std::unique_ptr<KeywordMatcher> fresh = buildMatcher(keywords);
+    delete pendingMatcher_.exchange(fresh.release(), std::memory_order_acq_rel);  // superseded, never seen
+    if (watcher_) {
+        watcher_->wakeup();  // an idle monitor swaps now, not at the next write
+    }
+}
+
+/**
+ * @brief Adopts the published matcher at a buffer boundary
+ * 
+ * Called by the monitor thread between reads: no line is being matched,
+ * the parallel scanner is between scans, and pipeline stages are drained
+ * and restarted so no matcher thread holds the old one when it is freed.
+ */
+void LogMonitor::applyPendingMatcher() {
+    std::unique_ptr<KeywordMatcher> fresh(pendingMatcher_.exchange(nullptr, std::memory_order_acquire));
+    if (!fresh) return;
+    if (pipeline_) pipeline_->finish();  // the carried partial line is kept
+    matcher_ = std::move(fresh);
+    if (parallel_) parallel_->setMatcher(*matcher_);
+    checkScanMode();
+    if (pipeline_) {
+        pipeline_->setMatcher(*matcher_);
+        pipeline_->start();
+    }
+    stats_.keywordReloads++;
+}
+
+void LogMonitor::requestTraceDump() {
+    if (!tracing()) return;
+    traceDumpRequested_ = true;
+    if (watcher_) {
+        watcher_->wakeup();
+    }
+}
+
+/**
+ * @brief Detects rename/create and truncation rotations at EOF
+ * 
+ * Called only after a read returned 0, so the old descriptor is drained.
+ * A path that is missing right now (renamed, new file not created yet)
+ * counts as no rotation: the old file keeps being tailed until the new
+ * one appears.
+ */
+bool LogMonitor::handleRotation() {
+    InputSource::Rotation rotation = input_->checkRotation(config_.inputFile, lastPosition_);
+    if (rotation == InputSource::Rotation::None) {
+        return false;
+    }
+    
+    // the old file's last line will never get its '\n'
+    if (pipeline_) {
+        pipeline_->endOfFile();
+    } else if (!partialLine_.empty()) {
+        processLine(partialLine_);
+        clearPartialLine();
+        endOfBuffer();
+    }
+    
+    if (rotation == InputSource::Rotation::Replaced) {
+        input_->close();  // reopened (and caught up) by the loop
+    }
+    lastPosition_ = 0;
+    stats_.readOffset.set(0);
+    if (index_) {
+        index_->reset();  // offsets of the old file mean nothing for the new one
+    }
+    if (context_) {
+        context_->reset();  // the old file's lines aren't context for the new one
+    }
+    stats_.rotations++;
+    checkpointDirty_ = true;
+    return true;
+}
+
+/**
+ * @brief Validates the checkpoint against the input as it is now
+ * 
+ * Costs one stat() and a read of Checkpoint::TAIL_BYTES, whatever the
+ * file size; the backlog after the offset is then caught up as usual.
+ */
+void LogMonitor::restoreCheckpoint() {
+    Checkpoint checkpoint;
+    if (!Checkpoint::load(config_.checkpointFile, checkpoint)) {
+        return;
+    }
+    
+    FileId id;
+    // compressed: offsets are decompressed, past the file size; the tail hash decides
+    const bool sizeKnown = config_.inputBackend != InputBackend::Compressed;
+    if (!statFileId(config_.inputFile, id) || id.device != checkpoint.device ||
+        id.inode != checkpoint.inode || (sizeKnown && id.size < checkpoint.inputOffset)) {
+        return;  // rotated or truncated while we were down: start over
+    }
+    
+    char tail[Checkpoint::TAIL_BYTES];
+    auto source = InputSource::create(config_.inputBackend, config_.decompressThreads);
+    if (!source->open(config_.inputFile)) {
+        return;
+    }
+    ssize_t n = source->read(tail, checkpoint.tailLength,
+                             checkpoint.inputOffset - checkpoint.tailLength);
+    if (n != static_cast<ssize_t>(checkpoint.tailLength) ||
+        Checkpoint::hashTail(tail, checkpoint.tailLength) != checkpoint.tailHash) {
+        return;  // rewritten in place
+    }
+    if (checkpoint.routeOffsets.size() != outputs_.size() - 1) {
+        return;  // saved with other route outputs
+    }
+    
+    // matches after the checkpoint are about to be produced again
+    for (size_t i = 0; i < outputs_.size(); ++i) {
+        const uint64_t offset = i == 0 ? checkpoint.outputOffset : checkpoint.routeOffsets[i - 1];
+        if (outputs_[i]->fileSize() > offset) {
+            outputs_[i]->truncate(offset);
+        }
+    }
+    lastPosition_ = checkpoint.inputOffset;
+    stats_.readOffset.set(checkpoint.inputOffset);
+    stats_.resumedOffset.set(checkpoint.inputOffset);
+}
+
+/**
+ * @brief Writes the resume point; failures keep the previous checkpoint
+ */
+void LogMonitor::saveCheckpoint() {
+    lastCheckpoint_ = std::chrono::steady_clock::now();
+    if (config_.checkpointFile.empty() || !input_->isOpen()) {
+        return;
+    }
+    
+    FileId id;
+    if (!input_->fileId(id)) {
+        return;
+    }
+    
+    const uint64_t carried = pipeline_ ? pipeline_->carriedBytes() : partialLine_.size() + discardedBytes_;
+    Checkpoint checkpoint;
+    checkpoint.device = id.device;
+    checkpoint.inode = id.inode;
+    checkpoint.inputOffset = lastPosition_ - carried;
+    checkpoint.tailLength = std::min<uint64_t>(Checkpoint::TAIL_BYTES, checkpoint.inputOffset);
+    
+    char tail[Checkpoint::TAIL_BYTES];
+    if (input_->read(tail, checkpoint.tailLength, checkpoint.inputOffset - checkpoint.tailLength) !=
+        static_cast<ssize_t>(checkpoint.tailLength)) {
+        return;
+    }
+    checkpoint.tailHash = Checkpoint::hashTail(tail, checkpoint.tailLength);
+    
+    for (OutputWriter* output : outputs_) {
+        output->flush();
+    }
+    checkpoint.outputOffset = writer_->fileSize();
+    for (size_t i = 1; i < outputs_.size(); ++i) {
+        checkpoint.routeOffsets.push_back(outputs_[i]->fileSize());
+    }
+    if (checkpoint.save(config_.checkpointFile)) {
+        stats_.checkpointsSaved++;
+        checkpointDirty_ = false;
+    }
+}
+
+/**
+ * @brief Blocks until the input may have new data
+ * 
+ * Spurious returns are harmless: the caller just reads, finds nothing and
+ * waits again.
+ */
+void LogMonitor::waitForData() {
+    if (!watcher_) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(config_.pollIntervalMs));
+        return;
+    }
+    
+    int timeoutMs = EVENT_RECHECK_MS;
+    // pipelined, the writer thread owns the outputs: don't look at them
+    if (!pipeline_ && config_.flushPolicy == FlushPolicy::Interval &&
+            std::any_of(outputs_.begin(), outputs_.end(),
+                        [](const OutputWriter* output) { return output->pendingBytes() > 0; })) {
+        // wake up in time for tick() to flush aged output
+        timeoutMs = static_cast<int>(std::max<uint64_t>(1, config_.flushIntervalUs / 1000));
+    }
+    if (repeats_) {
+        timeoutMs = std::min(timeoutMs, static_cast<int>(std::max<uint64_t>(1, config_.repeatWindowMs)));
+    }
+    if (!pipeline_ && config_.outputCompression != Compression::None) {
+        // and to cut an aged frame so readers of the output see it
+        timeoutMs = std::min(timeoutMs, static_cast<int>(std::max<uint64_t>(1, config_.frameIntervalMs)));
+    }
+    watcher_->wait(timeoutMs);
+}
+
+/**
+ * @brief Input file size minus the read offset, from a stat() on this thread
+ * 
+ * A rotated path whose new file is still shorter than the old offset
+ * reports 0 until the monitor switches over.
+ */
+uint64_t LogMonitor::bytesBehind() const {
+    struct stat st;
+    if (::stat(config_.inputFile.c_str(), &st) != 0) return 0;
+    const uint64_t size = static_cast<uint64_t>(st.st_size);
+    const uint64_t offset = stats_.readOffset.load();
+    return size > offset ? size - offset : 0;
+}
+
+void LogMonitor::pinMonitorThread() const {
+    if (config_.monitorCpu >= 0) {
+        pinCurrentThread(config_.monitorCpu);
+    }
+}
+
+/**
+ * @brief Sum of Arena::footprint() over everything the constructor carves
+ * 
+ * Counts outputs the way the constructor does: one for outputFile plus one
+ * per distinct route path other than it.
+ */
+size_t LogMonitor::arenaBytes(const Config& config) {
+    OutputWriter::Options writerOptions;
+    writerOptions.flushBytes = config.flushBytes;
+    
+    std::vector<std::string> paths{config.outputFile};
+    for (const Route& route : config.routes) {
+        if (std::find(paths.begin(), paths.end(), route.outputFile) == paths.end()) {
+            paths.push_back(route.outputFile);
+        }
+    }
+    
+    size_t bytes = Arena::footprint(config.bufferSize, 4096) +
+                   Arena::footprint(config.maxLineLength + 1) +
+                   paths.size() * Arena::footprint(OutputWriter::stagingSize(writerOptions)) +
+                   ContextRing::arenaBytes(config.contextBefore, config.maxLineLength);
+    if (config.repeatLimit > 0) {
+        bytes += RepeatSuppressor::arenaBytes(config.repeatSlots);
+    }
+    if (config.pipelined) {
+        Pipeline::Options pipelineOptions;
+        pipelineOptions.blocks = config.pipelineBlocks;
+        pipelineOptions.readSize = config.bufferSize;
+        pipelineOptions.maxLineLength = config.maxLineLength;
+        bytes += Pipeline::arenaBytes(pipelineOptions);
+    }
+    return bytes;
 }
 
 /**
@@ -284,8 +1169,51 @@ void LogMonitor::stop() {
  * @return Statistics struct containing current counters
  * 
  * 
- * @note Returns a copy, NOT a reference, to avoid race conditions
+ * @note Returns a copy, NOT a reference; each field is a relaxed atomic
+ *       load, so this never races with or blocks the monitor thread
  */
 LogMonitor::Statistics LogMonitor::getStatistics() const {
-    return stats_;
+    Statistics snapshot;
+    snapshot.linesProcessed = stats_.linesProcessed.load();
+    snapshot.linesMatched = stats_.linesMatched.load();
+    snapshot.bytesRead = stats_.bytesRead.load();
+    snapshot.longLinesDiscarded = stats_.longLinesDiscarded.load();
+    snapshot.bytesMapped = stats_.bytesMapped.load();
+    snapshot.rotations = stats_.rotations.load();
+    snapshot.keywordReloads = stats_.keywordReloads.load();
+    snapshot.linesSuppressed = stats_.linesSuppressed.load();
+    snapshot.resumedOffset = stats_.resumedOffset.load();
+    snapshot.checkpointsSaved = stats_.checkpointsSaved.load();
+    snapshot.indexEntries = stats_.indexEntries.load();
+    snapshot.readOffset = stats_.readOffset.load();
+    for (const OutputWriter* output : outputs_) {
+        snapshot.outputFlushes += output->flushCount();
+        if (const CompressedSink* sink = output->sink()) {
+            snapshot.outputRawBytes += sink->bytesIn();
+            snapshot.outputCompressedBytes += sink->bytesOut();
+        }
+    }
+    if (pipeline_) {
+        Pipeline::Stats p = pipeline_->stats();
+        snapshot.linesProcessed += p.lines;
+        snapshot.linesMatched += p.matched;
+        snapshot.longLinesDiscarded += p.longLines;
+        snapshot.readerStalls = p.readerStalls;
+        snapshot.matcherStalls = p.matcherStalls;
+        snapshot.writerStalls = p.writerStalls;
+        snapshot.matchQueueDepth = p.matchQueueDepth;
+        snapshot.writeQueueDepth = p.writeQueueDepth;
+    }
+    return snapshot;
+}
+
+/**
+ * @brief Polls the counters into the sliding window
+ * 
+ * @return Rates since the oldest sample still inside rateWindowMs
+ */
+LogMonitor::Rates LogMonitor::getRates() const {
+    Statistics snapshot = getStatistics();
+    std::lock_guard<std::mutex> lock(ratesMutex_);
+    return rates_.sample(snapshot.linesProcessed, snapshot.bytesRead, snapshot.linesMatched);
 }
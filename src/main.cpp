@@ -8,14 +8,130 @@
  */
 
 #include "log_monitor.h"
+#include "multi_log_monitor.h"
+#include "metrics_exporter.h"
+#include "static_keyword_matcher.h"
 #include <iostream>
 #include <sstream>
+#include <fstream>
+#include <algorithm>
 #include <csignal>
 #include <memory>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <filesystem>
 
 /// Global monitor instance for signal handler access
 std::unique_ptr<LogMonitor> g_monitor;
 
+/// Multi-file monitor, used instead of g_monitor with --sources
+std::unique_ptr<MultiLogMonitor> g_multiMonitor;
+
+/// File listing the inputs to tail in one process (--sources=FILE)
+std::string g_sourcesFile;
+
+/// Time range "FROM,TO" to answer from the line index instead of tailing (--query)
+std::string g_queryRange;
+
+/// Seconds between live statistics lines on stderr (0 = off, --stats=SEC)
+int g_statsIntervalSec = 0;
+
+/// Prometheus endpoint address (--metrics=[HOST:]PORT), port -1 = off
+std::string g_metricsHost = "127.0.0.1";
+int g_metricsPort = -1;
+
+/// Keyword list reread on change or SIGHUP (--keywords-file=FILE)
+std::string g_keywordsFile;
+std::atomic<bool> g_reloadRequested{false};
+
+/// Keywords of the precompiled sets below
+constexpr char KW_ERROR[] = "ERROR";
+constexpr char KW_REJECT[] = "REJECT";
+constexpr char KW_CANCEL[] = "CANCEL";
+constexpr char KW_FILL[] = "FILL";
+constexpr char KW_EXECUTION[] = "EXECUTION";
+
+/// Order flow alerts
+using AlertMatcher = StaticKeywordMatcher<KW_ERROR, KW_REJECT>;
+using AlertCancelMatcher = StaticKeywordMatcher<KW_ERROR, KW_REJECT, KW_CANCEL>;
+/// Trade activity
+using TradeMatcher = StaticKeywordMatcher<KW_FILL, KW_EXECUTION>;
+
+/**
+ * @brief Compiled-in matcher for exactly this keyword set, if there is one
+ * 
+ * Common deployments pass the same few keywords every time; those sets are
+ * built as StaticKeywordMatcher so matches() is fully unrolled. Order of
+ * the keywords doesn't matter.
+ * 
+ * @param keywords Keywords from the command line
+ * @return matches() of the compiled set, nullptr if none fits
+ */
+KeywordMatcher::StaticMatchFn precompiledMatcher(std::vector<std::string> keywords) {
+    struct Precompiled {
+        std::vector<std::string> keywords;
+        KeywordMatcher::StaticMatchFn match;
+    };
+    static const std::vector<Precompiled> sets = {
+        {AlertMatcher::keywords(), &AlertMatcher::matches},
+        {AlertCancelMatcher::keywords(), &AlertCancelMatcher::matches},
+        {TradeMatcher::keywords(), &TradeMatcher::matches},
+    };
+    
+    std::sort(keywords.begin(), keywords.end());
+    for (const Precompiled& set : sets) {
+        std::vector<std::string> sorted = set.keywords;
+        std::sort(sorted.begin(), sorted.end());
+        if (sorted == keywords) return set.match;
+    }
+    return nullptr;
+}
+
+/**
+ * @brief SIGUSR1: the monitor thread prints the --trace report to stderr
+ */
+void traceSignalHandler(int) {
+    if (g_monitor) {
+        g_monitor->requestTraceDump();
+    }
+}
+
+/**
+ * @brief SIGHUP: the reload thread rereads --keywords-file
+ */
+void reloadSignalHandler(int) {
+    g_reloadRequested = true;
+}
+
+/**
+ * @brief Reads a keyword list: whitespace or comma separated, '#' comments
+ * @param path Keywords file
+ * @return Keywords in file order
+ * @throw std::runtime_error if the file can't be read or has no keywords
+ */
+std::vector<std::string> readKeywordsFile(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Failed to open keywords file: " + path);
+    }
+    std::vector<std::string> keywords;
+    std::string line;
+    while (std::getline(file, line)) {
+        line = line.substr(0, line.find('#'));
+        std::replace(line.begin(), line.end(), ',', ' ');
+        std::istringstream words(line);
+        std::string keyword;
+        while (words >> keyword) {
+            keywords.push_back(keyword);
+        }
+    }
+    if (keywords.empty()) {
+        throw std::runtime_error("No keywords in " + path);
+    }
+    return keywords;
+}
+
 /**
  * @brief Signal handler for graceful shutdown
  * 
@@ -30,6 +146,9 @@ void signalHandler(int signal) {
     if (g_monitor) {
         g_monitor->stop();
     }
+    if (g_multiMonitor) {
+        g_multiMonitor->stop();
+    }
 }
 
 /**
@@ -72,6 +191,419 @@ std::vector<std::string> getKeywordsFromUser() {
     return keywords;
 }
 
+/**
+ * @brief Applies one --name=value command-line option to the config
+ * 
+ * Supported options:
+ * - --flush=line | buffer | bytes[:N] | interval[:US]
+ * - --compress-output=zstd | gzip[:LEVEL]
+ * - --scan=line | buffer
+ * - --wait=auto | event | poll[:MS]
+ * - --input=posix | stream | compressed[:THREADS]
+ * - --mmap=off | WINDOW_MB
+ * - --threads=N
+ * - --huge-pages
+ * - --cpus=MONITOR[,MATCHER...[,WRITER]]
+ * - --pipeline[=MATCHERS]
+ * - --stats=SEC
+ * - --sources=FILE
+ * - --checkpoint=FILE[:MS]
+ * - --index=FILE[:MB]
+ * - --query=FROM,TO
+ * - --route=KEYWORD[,KEYWORD...]:FILE (repeatable)
+ * - --filter=EXPR
+ * - --ignore-case
+ * - --whole-word
+ * - --max-line=BYTES
+ * - --context=N | BEFORE:AFTER
+ * - --suppress-repeats=N[:MS]
+ * - --trace
+ * - --metrics=[HOST:]PORT
+ * - --keywords-file=FILE
+ * 
+ * @param arg Full argument, e.g. "--flush=bytes:65536"
+ * @param config Config to update
+ * @return false if the option is unknown or malformed
+ */
+bool applyOption(const std::string& arg, LogMonitor::Config& config) {
+    size_t eq = arg.find('=');
+    std::string name = arg.substr(2, eq == std::string::npos ? std::string::npos : eq - 2);
+    std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+    
+    // value may carry a ":N" parameter
+    size_t colon = value.find(':');
+    std::string kind = value.substr(0, colon);
+    std::string param = colon == std::string::npos ? "" : value.substr(colon + 1);
+    
+    try {
+        if (name == "flush") {
+            if (kind == "line") {
+                config.flushPolicy = LogMonitor::FlushPolicy::PerLine;
+            } else if (kind == "buffer") {
+                config.flushPolicy = LogMonitor::FlushPolicy::PerBuffer;
+            } else if (kind == "bytes") {
+                config.flushPolicy = LogMonitor::FlushPolicy::Bytes;
+                if (!param.empty()) config.flushBytes = std::stoull(param);
+            } else if (kind == "interval") {
+                config.flushPolicy = LogMonitor::FlushPolicy::Interval;
+                if (!param.empty()) config.flushIntervalUs = std::stoull(param);
+            } else {
+                return false;
+            }
+            return true;
+        }
+        if (name == "compress-output") {
+            if (kind == "zstd") {
+                config.outputCompression = LogMonitor::Compression::Zstd;
+            } else if (kind == "gzip") {
+                config.outputCompression = LogMonitor::Compression::Gzip;
+            } else {
+                return false;
+            }
+            if (!param.empty()) config.compressionLevel = std::stoi(param);
+            return config.compressionLevel >= 0;
+        }
+        if (name == "scan") {
+            if (kind == "line") {
+                config.scanMode = LogMonitor::ScanMode::PerLine;
+            } else if (kind == "buffer") {
+                config.scanMode = LogMonitor::ScanMode::WholeBuffer;
+            } else {
+                return false;
+            }
+            return true;
+        }
+        if (name == "wait") {
+            if (kind == "auto") {
+                config.waitMode = LogMonitor::WaitMode::Auto;
+            } else if (kind == "event") {
+                config.waitMode = LogMonitor::WaitMode::Event;
+            } else if (kind == "poll") {
+                config.waitMode = LogMonitor::WaitMode::Poll;
+                if (!param.empty()) config.pollIntervalMs = std::stoi(param);
+            } else {
+                return false;
+            }
+            return true;
+        }
+        if (name == "input") {
+            if (kind == "posix") {
+                config.inputBackend = LogMonitor::InputBackend::Posix;
+            } else if (kind == "stream") {
+                config.inputBackend = LogMonitor::InputBackend::Stream;
+            } else if (kind == "compressed") {
+                config.inputBackend = LogMonitor::InputBackend::Compressed;
+                if (!param.empty()) config.decompressThreads = std::stoul(param);
+            } else {
+                return false;
+            }
+            return true;
+        }
+        if (name == "checkpoint") {
+            config.checkpointFile = kind;
+            if (!param.empty()) config.checkpointIntervalMs = std::stoi(param);
+            return !kind.empty();
+        }
+        if (name == "index") {
+            config.indexFile = kind;
+            if (!param.empty()) config.indexInterval = std::stoull(param) * 1024 * 1024;
+            return !kind.empty() && config.indexInterval > 0;
+        }
+        if (name == "query") {
+            g_queryRange = value;  // timestamps contain ':', so no param split
+            return value.find(',') != std::string::npos;
+        }
+        if (name == "filter") {
+            config.filter = value;  // may contain ':' and '=', taken whole
+            try {
+                FieldFilter check(value);
+            } catch (const std::runtime_error& e) {
+                std::cerr << e.what() << std::endl;
+                return false;
+            }
+            return true;
+        }
+        if (name == "route") {
+            // keywords before the last ':', so FILE may not contain one
+            size_t split = value.rfind(':');
+            if (split == std::string::npos || split + 1 == value.size()) return false;
+            LogMonitor::Route route;
+            route.outputFile = value.substr(split + 1);
+            std::stringstream keywords(value.substr(0, split));
+            std::string keyword;
+            while (std::getline(keywords, keyword, ',')) {
+                if (!keyword.empty()) route.keywords.push_back(keyword);
+            }
+            config.routes.push_back(route);
+            return !route.keywords.empty();
+        }
+        if (name == "ignore-case") {
+            config.ignoreCase = true;
+            return value.empty();
+        }
+        if (name == "whole-word") {
+            config.wholeWord = true;
+            return value.empty();
+        }
+        if (name == "keywords-file") {
+            g_keywordsFile = value;
+            return !value.empty();
+        }
+        if (name == "metrics") {
+            size_t colon = value.rfind(':');
+            if (colon != std::string::npos) g_metricsHost = value.substr(0, colon);
+            g_metricsPort = std::stoi(colon == std::string::npos ? value : value.substr(colon + 1));
+            return g_metricsPort >= 0 && g_metricsPort <= 65535 && !g_metricsHost.empty();
+        }
+        if (name == "trace") {
+            config.trace = true;
+            return value.empty();
+        }
+        if (name == "context") {
+            config.contextBefore = std::stoull(kind);
+            config.contextAfter = param.empty() ? config.contextBefore : std::stoull(param);
+            return true;
+        }
+        if (name == "suppress-repeats") {
+            config.repeatLimit = std::stoull(kind);
+            if (!param.empty()) config.repeatWindowMs = std::stoull(param);
+            return config.repeatLimit > 0 && config.repeatWindowMs > 0;
+        }
+        if (name == "max-line") {
+            config.maxLineLength = std::stoull(kind);
+            return config.maxLineLength > 0;
+        }
+        if (name == "sources") {
+            g_sourcesFile = value;
+            return !value.empty();
+        }
+        if (name == "stats") {
+            g_statsIntervalSec = std::stoi(kind);
+            return g_statsIntervalSec >= 0;
+        }
+        if (name == "pipeline") {
+            config.pipelined = true;
+            if (!kind.empty()) config.matcherThreads = std::stoul(kind);
+            return config.matcherThreads > 0;
+        }
+        if (name == "huge-pages") {
+            config.hugePages = true;
+            return value.empty();
+        }
+        if (name == "cpus") {
+            // first the monitor thread, the rest go to the pipeline stages
+            std::stringstream cpus(value);
+            std::string cpu;
+            config.pipelineCpus.clear();
+            if (!std::getline(cpus, cpu, ',')) return false;
+            config.monitorCpu = std::stoi(cpu);
+            while (std::getline(cpus, cpu, ',')) {
+                config.pipelineCpus.push_back(std::stoi(cpu));
+            }
+            return config.monitorCpu >= 0;
+        }
+        if (name == "threads") {
+            config.scanThreads = std::stoul(kind);
+            return config.scanThreads > 0;
+        }
+        if (name == "mmap") {
+            config.mmapWindowSize = kind == "off" ? 0 : std::stoull(kind) * 1024 * 1024;
+            return true;
+        }
+    } catch (const std::exception&) {
+        return false;  // bad number in param
+    }
+    return false;
+}
+
+/**
+ * @brief Starts the --metrics endpoint, if one was requested
+ * @param render Builds the /metrics body (see renderMetrics)
+ * @return The running exporter, or null without --metrics
+ * @throw std::runtime_error if the address can't be bound
+ */
+std::unique_ptr<MetricsExporter> startMetrics(MetricsExporter::Render render) {
+    if (g_metricsPort < 0) return nullptr;
+    auto exporter = std::make_unique<MetricsExporter>(
+        g_metricsHost, static_cast<uint16_t>(g_metricsPort), std::move(render));
+    std::cout << "Metrics: http://" << g_metricsHost << ":" << exporter->port() << "/metrics" << std::endl;
+    return exporter;
+}
+
+/**
+ * @brief Options given on the command line that MultiLogMonitor can't honour
+ * 
+ * Compared against the defaults, so e.g. an explicit --scan=line passes.
+ * 
+ * @return Their names, empty if every option applies to --sources
+ */
+std::vector<std::string> unsupportedWithSources(const LogMonitor::Config& config) {
+    const LogMonitor::Config defaults;
+    std::vector<std::string> options;
+    if (!config.filter.empty()) options.push_back("--filter");
+    if (!config.routes.empty()) options.push_back("--route");
+    if (config.contextBefore > 0 || config.contextAfter > 0) options.push_back("--context");
+    if (config.repeatLimit > 0) options.push_back("--suppress-repeats");
+    if (config.pipelined) options.push_back("--pipeline");
+    if (!config.checkpointFile.empty()) options.push_back("--checkpoint");
+    if (!config.indexFile.empty()) options.push_back("--index");
+    if (config.trace) options.push_back("--trace");
+    if (config.scanMode != defaults.scanMode) options.push_back("--scan");
+    if (config.waitMode != defaults.waitMode) options.push_back("--wait");
+    if (config.mmapWindowSize != defaults.mmapWindowSize) options.push_back("--mmap");
+    if (config.monitorCpu >= 0 || !config.pipelineCpus.empty()) options.push_back("--cpus");
+    if (g_statsIntervalSec > 0) options.push_back("--stats");
+    return options;
+}
+
+/**
+ * @brief Tails every file listed in g_sourcesFile from one MultiLogMonitor
+ * 
+ * One source per line: "input.log [output.log]". Sources without an output
+ * share the positional output file. Blank lines and lines starting with
+ * '#' are ignored. Worker pool size comes from --threads.
+ * 
+ * Single-file options without a MultiLogMonitor equivalent are an error
+ * rather than being dropped, see unsupportedWithSources().
+ * 
+ * @param config Parsed single-file config, supplies the shared settings
+ * @return 0 on success, 1 on error
+ */
+int runMultiMonitor(const LogMonitor::Config& config) {
+    const std::vector<std::string> unsupported = unsupportedWithSources(config);
+    if (!unsupported.empty()) {
+        std::cerr << "Error: not supported with --sources:";
+        for (const std::string& option : unsupported) std::cerr << " " << option;
+        std::cerr << std::endl;
+        return 1;
+    }
+    
+    MultiLogMonitor::Config multiConfig;
+    multiConfig.outputFile = config.outputFile;
+    multiConfig.keywords = config.keywords;
+    if (!g_keywordsFile.empty()) {
+        std::cerr << "Note: --keywords-file is read once with --sources, not reloaded" << std::endl;
+    }
+    multiConfig.ignoreCase = config.ignoreCase;
+    multiConfig.wholeWord = config.wholeWord;
+    multiConfig.workerThreads = std::max<size_t>(2, config.scanThreads);
+    multiConfig.bufferSize = config.bufferSize;
+    multiConfig.maxLineLength = config.maxLineLength;
+    multiConfig.pollIntervalMs = config.pollIntervalMs;
+    multiConfig.inputBackend = config.inputBackend;
+    multiConfig.flushPolicy = config.flushPolicy;
+    multiConfig.flushBytes = config.flushBytes;
+    multiConfig.flushIntervalUs = config.flushIntervalUs;
+    multiConfig.outputCompression = config.outputCompression;
+    multiConfig.compressionLevel = config.compressionLevel;
+    multiConfig.hugePages = config.hugePages;
+    
+    std::ifstream list(g_sourcesFile);
+    if (!list.is_open()) {
+        std::cerr << "Error: cannot open source list " << g_sourcesFile << std::endl;
+        return 1;
+    }
+    std::string line;
+    while (std::getline(list, line)) {
+        std::stringstream ss(line);
+        MultiLogMonitor::Source source;
+        if (!(ss >> source.inputFile) || source.inputFile[0] == '#') continue;
+        ss >> source.outputFile;
+        multiConfig.sources.push_back(source);
+    }
+    
+    try {
+        g_multiMonitor = std::make_unique<MultiLogMonitor>(multiConfig);
+        std::cout << "Tailing " << g_multiMonitor->sourceCount() << " sources with "
+                  << multiConfig.workerThreads << " workers" << std::endl;
+        auto metrics = startMetrics([] { return renderMetrics(*g_multiMonitor); });
+        
+        g_multiMonitor->start();
+        metrics.reset();  // stop scraping before the summary
+        
+        auto stats = g_multiMonitor->getStatistics();
+        std::cout << "\n=== Statistics ===" << std::endl;
+        std::cout << "Lines processed: " << stats.linesProcessed << std::endl;
+        std::cout << "Lines matched: " << stats.linesMatched << std::endl;
+        std::cout << "Bytes read: " << stats.bytesRead << std::endl;
+        std::cout << "Long lines discarded: " << stats.longLinesDiscarded << std::endl;
+        std::cout << "Output flushes: " << g_multiMonitor->outputFlushes() << std::endl;
+        std::cout << "Event loop wakeups: " << g_multiMonitor->wakeupCount() << std::endl;
+        for (size_t i = 0; i < g_multiMonitor->sourceCount(); ++i) {
+            auto source = g_multiMonitor->getSourceStatistics(i);
+            std::cout << "  " << multiConfig.sources[i].inputFile << ": "
+                      << source.linesMatched << "/" << source.linesProcessed << " matched" << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Writes the input lines in g_queryRange to the output, via the index
+ * 
+ * Only the chunks the index places around the range are read. Keywords,
+ * when given on the command line, further filter the lines.
+ * 
+ * @param config Parsed config: input, output, indexFile and keywords
+ * @param filterByKeywords Apply config.keywords
+ * @return 0 on success, 1 on error
+ */
+int runQuery(const LogMonitor::Config& config, bool filterByKeywords) {
+    size_t comma = g_queryRange.find(',');
+    int64_t from, to;
+    if (!parseTimestamp(g_queryRange.substr(0, comma), from) ||
+        !parseTimestamp(g_queryRange.substr(comma + 1), to)) {
+        std::cerr << "Error: --query needs \"YYYY-MM-DD HH:MM:SS[.ffffff],YYYY-MM-DD HH:MM:SS[.ffffff]\""
+                  << std::endl;
+        return 1;
+    }
+    if (config.indexFile.empty()) {
+        std::cerr << "Error: --query needs --index=FILE" << std::endl;
+        return 1;
+    }
+    
+    try {
+        LineIndex index(config.indexFile);
+        auto input = InputSource::create(config.inputBackend);
+        if (!input->open(config.inputFile)) {
+            std::cerr << "Error: cannot open " << config.inputFile << std::endl;
+            return 1;
+        }
+        
+        OutputWriter::Options writerOptions;
+        writerOptions.policy = LogMonitor::FlushPolicy::Bytes;
+        writerOptions.flushBytes = config.flushBytes;
+        OutputWriter writer(config.outputFile, writerOptions);
+        
+        std::unique_ptr<KeywordMatcher> filter;
+        if (filterByKeywords) {
+            KeywordMatcher::Options options;
+            options.ignoreCase = config.ignoreCase;
+            options.wholeWord = config.wholeWord;
+            filter = std::make_unique<KeywordMatcher>(config.keywords, std::vector<KeywordMatcher::GroupMask>{},
+                                                      options);
+        }
+        auto result = index.query(*input, from, to, filter.get(),
+                                  [&writer](std::string_view line) { writer.writeLine(line); },
+                                  config.maxLineLength);
+        writer.flush();
+        
+        FileId id;
+        statFileId(config.inputFile, id);
+        std::cout << "Index entries: " << index.entries().size() << std::endl;
+        std::cout << "Bytes scanned: " << result.bytesScanned << " of " << id.size << std::endl;
+        std::cout << "Lines scanned: " << result.linesScanned << std::endl;
+        std::cout << "Lines written: " << result.linesEmitted << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
 /**
  * @brief Main entry point for log_monitor program
  * 
@@ -82,6 +614,11 @@ std::vector<std::string> getKeywordsFromUser() {
  * 2. Command-line: ./log_monitor input.log output.log key1 key2 key3
  *    - Keywords provided as arguments
  * 
+ * Options (--name=value, anywhere on the command line) tune the monitor,
+ * see applyOption(). With --sources=FILE the inputs come from FILE and
+ * argv[1] is ignored (see runMultiMonitor()). With --query the input is
+ * not tailed: the time range is read once via the index (see runQuery()).
+ * 
  * @param argc Argument count
  * @param argv Argument values
  *             argv[1] = input log file path
@@ -95,34 +632,134 @@ int main(int argc, char* argv[]) {
     // setp signal handlers for graceful shutdown
     std::signal(SIGINT, signalHandler);   // Ctrl+C
     std::signal(SIGTERM, signalHandler);  // kill command
+    std::signal(SIGUSR1, traceSignalHandler);  // kill -USR1: dump --trace report
     
     // config monitor with defaults
     LogMonitor::Config config;
     config.inputFile = "a.log";
     config.outputFile = "b.log";
     
-    if (argc > 1) config.inputFile = argv[1];
-    if (argc > 2) config.outputFile = argv[2];
+    // split --options from positional arguments
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--", 0) == 0) {
+            if (!applyOption(arg, config)) {
+                std::cerr << "Unknown or invalid option: " << arg << std::endl;
+                return 1;
+            }
+        } else {
+            positional.push_back(arg);
+        }
+    }
+    
+    if (positional.size() > 0) config.inputFile = positional[0];
+    // rotated, compressed logs: decompress on the fly instead of to disk first
+    auto endsWith = [](const std::string& s, const std::string& suffix) {
+        return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+    if (config.inputBackend == LogMonitor::InputBackend::Posix &&
+            (endsWith(config.inputFile, ".gz") || endsWith(config.inputFile, ".zst"))) {
+        config.inputBackend = LogMonitor::InputBackend::Compressed;
+    }
+    if (positional.size() > 1) config.outputFile = positional[1];
 
     std::cout << "=== Log Monitor ===" << std::endl;
     std::cout << "Input file: " << config.inputFile << std::endl;
     std::cout << "Output file: " << config.outputFile << std::endl << std::endl;
     
-    if (argc > 3) {
-        for (int i = 3; i < argc; ++i) {
-            config.keywords.push_back(argv[i]);
+    if (!g_keywordsFile.empty()) {
+        try {
+            config.keywords = readKeywordsFile(g_keywordsFile);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
         }
+    } else if (positional.size() > 2) {
+        config.keywords.assign(positional.begin() + 2, positional.end());
+    } else if (!g_queryRange.empty()) {
+        // query without keywords: every line in the range
+    } else if (!config.filter.empty() || !config.routes.empty()) {
+        // filter / routes only: no keywords of their own for the positional output
     } else {
         //  mode: prompt user
         config.keywords = getKeywordsFromUser();
     }
     
+    if (!g_queryRange.empty()) {
+        return runQuery(config, positional.size() > 2);
+    }
+    config.staticMatch = precompiledMatcher(config.keywords);
+    if (!g_sourcesFile.empty()) {
+        return runMultiMonitor(config);
+    }
+    
     try {
         // make monitor and store in global for signal handler access
         g_monitor = std::make_unique<LogMonitor>(config);
+        if (config.trace && !LogMonitor::TRACE_COMPILED) {
+            std::cerr << "Warning: built with LOG_MONITOR_TRACE=OFF, --trace ignored" << std::endl;
+        }
+        auto metrics = startMetrics([] { return renderMetrics(*g_monitor); });
+        
+        // live dashboard: poll counters from a side thread, never blocks the monitor
+        std::atomic<bool> monitorDone{false};
+        std::thread dashboard;
+        if (g_statsIntervalSec > 0) {
+            dashboard = std::thread([&monitorDone]() {
+                auto next = std::chrono::steady_clock::now();
+                while (!monitorDone) {
+                    next += std::chrono::seconds(g_statsIntervalSec);
+                    while (!monitorDone && std::chrono::steady_clock::now() < next) {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                    }
+                    if (monitorDone) break;
+                    
+                    auto stats = g_monitor->getStatistics();
+                    auto rates = g_monitor->getRates();
+                    std::cerr << "[stats] lines=" << stats.linesProcessed
+                              << " matched=" << stats.linesMatched
+                              << " lines/s=" << static_cast<uint64_t>(rates.linesPerSec)
+                              << " MB/s=" << rates.bytesPerSec / (1024 * 1024)
+                              << " matches/s=" << static_cast<uint64_t>(rates.matchesPerSec)
+                              << std::endl;
+                }
+            });
+        }
+        
+        // keyword reloads: the new matcher is built here, the monitor only swaps it in
+        std::thread reloader;
+        if (!g_keywordsFile.empty()) {
+            std::signal(SIGHUP, reloadSignalHandler);
+            reloader = std::thread([&monitorDone]() {
+                std::error_code ec;
+                auto seen = std::filesystem::last_write_time(g_keywordsFile, ec);
+                while (!monitorDone) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+                    auto mtime = std::filesystem::last_write_time(g_keywordsFile, ec);
+                    if (!g_reloadRequested.exchange(false) && (ec || mtime == seen)) continue;
+                    seen = mtime;
+                    try {
+                        std::vector<std::string> keywords = readKeywordsFile(g_keywordsFile);
+                        g_monitor->reloadKeywords(keywords);
+                        std::cerr << "Reloaded " << keywords.size() << " keywords from "
+                                  << g_keywordsFile << std::endl;
+                    } catch (const std::exception& e) {
+                        std::cerr << "Keyword reload failed, keeping the old set: " << e.what() << std::endl;
+                    }
+                }
+            });
+        }
         
         // start monitoring (blocks until stopped)
         g_monitor->start();
+        monitorDone = true;
+        if (dashboard.joinable()) {
+            dashboard.join();
+        }
+        if (reloader.joinable()) {
+            reloader.join();
+        }
 
         //print stats
         auto stats = g_monitor->getStatistics();
@@ -131,6 +768,33 @@ int main(int argc, char* argv[]) {
         std::cout << "Lines matched: " << stats.linesMatched << std::endl;
         std::cout << "Bytes read: " << stats.bytesRead << std::endl;
         std::cout << "Long lines discarded: " << stats.longLinesDiscarded << std::endl;
+        std::cout << "Output flushes: " << stats.outputFlushes << std::endl;
+        if (config.outputCompression != LogMonitor::Compression::None) {
+            std::cout << "Output compressed: " << stats.outputRawBytes << " -> "
+                      << stats.outputCompressedBytes << " bytes" << std::endl;
+        }
+        std::cout << "Bytes via mmap catch-up: " << stats.bytesMapped << std::endl;
+        std::cout << "Rotations handled: " << stats.rotations << std::endl;
+        if (!g_keywordsFile.empty()) {
+            std::cout << "Keyword reloads: " << stats.keywordReloads << std::endl;
+        }
+        if (config.repeatLimit > 0) {
+            std::cout << "Repeats suppressed: " << stats.linesSuppressed << std::endl;
+        }
+        if (!config.checkpointFile.empty()) {
+            std::cout << "Resumed at offset: " << stats.resumedOffset
+                      << ", checkpoints saved: " << stats.checkpointsSaved << std::endl;
+        }
+        if (!config.indexFile.empty()) {
+            std::cout << "Index entries: " << stats.indexEntries << std::endl;
+        }
+        if (config.pipelined) {
+            std::cout << "Stalls (reader/matcher/writer): " << stats.readerStalls << "/"
+                      << stats.matcherStalls << "/" << stats.writerStalls << std::endl;
+        }
+        if (const StageTracer* tracer = g_monitor->getTracer()) {
+            std::cout << "\n=== Trace ===" << std::endl << tracer->report();
+        }
         
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
@@ -0,0 +1,68 @@
+/**
+ * @file mapped_file.cpp
+ * @brief Implementation of the MappedFile class
+ * @author Nicholas Loo
+ * @date 14/10/26
+ */
+
+#include "mapped_file.h"
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string& path) {
+    fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0) {
+        throw std::runtime_error("Failed to open input file for mapping: " + path);
+    }
+}
+
+MappedFile::~MappedFile() {
+    unmap();
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+uint64_t MappedFile::size() const {
+    struct stat st;
+    if (::fstat(fd_, &st) != 0) {
+        return 0;
+    }
+    return static_cast<uint64_t>(st.st_size);
+}
+
+/**
+ * @brief Maps a window, aligning the start down to a page
+ *
+ * MADV_SEQUENTIAL makes the kernel read ahead aggressively and free pages
+ * behind the scan, so a 256MB window costs page-cache, not RSS.
+ */
+const char* MappedFile::map(uint64_t offset, size_t len) {
+    unmap();
+
+    static const uint64_t pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    const uint64_t alignedOffset = offset & ~(pageSize - 1);
+    const size_t delta = static_cast<size_t>(offset - alignedOffset);
+
+    void* p = ::mmap(nullptr, len + delta, PROT_READ, MAP_PRIVATE, fd_,
+                     static_cast<off_t>(alignedOffset));
+    if (p == MAP_FAILED) {
+        return nullptr;
+    }
+    ::madvise(p, len + delta, MADV_SEQUENTIAL);  // advisory only
+
+    base_ = p;
+    mappedLen_ = len + delta;
+    return static_cast<const char*>(p) + delta;
+}
+
+void MappedFile::unmap() {
+    if (base_) {
+        ::munmap(base_, mappedLen_);
+        base_ = nullptr;
+        mappedLen_ = 0;
+    }
+}
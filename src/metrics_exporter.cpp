@@ -0,0 +1,213 @@
+/**
+ * @file metrics_exporter.cpp
+ * @brief Implementation of the Prometheus metrics endpoint
+ * @author Nicholas Loo
+ * @date 14/10/26
+ */
+
+#include "metrics_exporter.h"
+#include "log_monitor.h"
+#include "multi_log_monitor.h"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdexcept>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0  // macOS: SO_NOSIGPIPE is set on the client socket instead
+#endif
+
+void MetricsText::family(const std::string& name, const char* type, const char* help) {
+    out_ += "# HELP " + name + " " + help + "\n";
+    out_ += "# TYPE " + name + " " + type + "\n";
+}
+
+void MetricsText::sample(const std::string& name, uint64_t value,
+                         const char* label, const std::string& labelValue) {
+    out_ += name;
+    if (label) {
+        // label values escape backslash, quote and newline
+        out_ += '{';
+        out_ += label;
+        out_ += "=\"";
+        for (char c : labelValue) {
+            if (c == '\\' || c == '"') {
+                out_ += '\\';
+                out_ += c;
+            } else if (c == '\n') {
+                out_ += "\\n";
+            } else {
+                out_ += c;
+            }
+        }
+        out_ += "\"}";
+    }
+    out_ += ' ';
+    out_ += std::to_string(value);
+    out_ += '\n';
+}
+
+void MetricsText::metric(const std::string& name, const char* type, const char* help, uint64_t value) {
+    family(name, type, help);
+    sample(name, value);
+}
+
+std::string renderMetrics(const LogMonitor& monitor) {
+    const LogMonitor::Statistics stats = monitor.getStatistics();
+    MetricsText text;
+    text.metric("log_monitor_lines_processed_total", "counter", "Lines read and matched against", stats.linesProcessed);
+    text.metric("log_monitor_lines_matched_total", "counter", "Lines written to an output", stats.linesMatched);
+    text.metric("log_monitor_bytes_read_total", "counter", "Bytes read from the input", stats.bytesRead);
+    text.metric("log_monitor_bytes_mapped_total", "counter", "Part of bytes read consumed via mmap catch-up", stats.bytesMapped);
+    text.metric("log_monitor_long_lines_total", "counter", "Lines truncated to the maximum line length", stats.longLinesDiscarded);
+    text.metric("log_monitor_output_flushes_total", "counter", "Write batches issued to the outputs", stats.outputFlushes);
+    text.metric("log_monitor_rotations_total", "counter", "Input rotations handled", stats.rotations);
+    text.metric("log_monitor_checkpoints_saved_total", "counter", "Checkpoint files written", stats.checkpointsSaved);
+    text.metric("log_monitor_read_offset_bytes", "gauge", "Input offset read up to", stats.readOffset);
+    text.metric("log_monitor_bytes_behind_writer", "gauge", "Input file size minus the read offset", monitor.bytesBehind());
+    // pipeline series stay 0 when not pipelined, so dashboards see a fixed set
+    text.metric("log_monitor_pipeline_reader_stalls_total", "counter", "Reader waits for a free block", stats.readerStalls);
+    text.metric("log_monitor_pipeline_matcher_stalls_total", "counter", "Matcher waits for input", stats.matcherStalls);
+    text.metric("log_monitor_pipeline_writer_stalls_total", "counter", "Writer waits for matched blocks", stats.writerStalls);
+    text.metric("log_monitor_pipeline_match_queue_blocks", "gauge", "Blocks read but not matched yet", stats.matchQueueDepth);
+    text.metric("log_monitor_pipeline_write_queue_blocks", "gauge", "Blocks matched but not written yet", stats.writeQueueDepth);
+    return text.str();
+}
+
+std::string renderMetrics(const MultiLogMonitor& monitor) {
+    const size_t sources = monitor.sourceCount();
+    std::vector<MultiLogMonitor::Statistics> stats(sources);
+    for (size_t i = 0; i < sources; ++i) {
+        stats[i] = monitor.getSourceStatistics(i);
+    }
+
+    MetricsText text;
+    auto perSource = [&](const char* name, const char* type, const char* help, auto value) {
+        text.family(name, type, help);
+        for (size_t i = 0; i < sources; ++i) {
+            text.sample(name, value(i), "source", monitor.sourcePath(i));
+        }
+    };
+    perSource("log_monitor_lines_processed_total", "counter", "Lines read and matched against",
+              [&](size_t i) { return stats[i].linesProcessed; });
+    perSource("log_monitor_lines_matched_total", "counter", "Lines written to an output",
+              [&](size_t i) { return stats[i].linesMatched; });
+    perSource("log_monitor_bytes_read_total", "counter", "Bytes read from the input",
+              [&](size_t i) { return stats[i].bytesRead; });
+    perSource("log_monitor_long_lines_total", "counter", "Lines truncated to the maximum line length",
+              [&](size_t i) { return stats[i].longLinesDiscarded; });
+    perSource("log_monitor_rotations_total", "counter", "Input rotations handled",
+              [&](size_t i) { return stats[i].rotations; });
+    perSource("log_monitor_read_offset_bytes", "gauge", "Input offset read up to",
+              [&](size_t i) { return stats[i].readOffset; });
+    perSource("log_monitor_bytes_behind_writer", "gauge", "Input file size minus the read offset",
+              [&](size_t i) { return monitor.bytesBehind(i); });
+    text.metric("log_monitor_output_flushes_total", "counter", "Write batches issued to the outputs",
+                monitor.outputFlushes());
+    return text.str();
+}
+
+MetricsExporter::MetricsExporter(const std::string& host, uint16_t port, Render render)
+    : render_(std::move(render)) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (::inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1) {
+        throw std::runtime_error("Invalid metrics address: " + host);
+    }
+
+    listenFd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd_ < 0) {
+        throw std::runtime_error("Failed to create metrics socket");
+    }
+    ::fcntl(listenFd_, F_SETFD, FD_CLOEXEC);
+    int one = 1;
+    ::setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listenFd_, 16) != 0 || ::pipe(wakePipe_) != 0) {
+        const std::string reason = std::strerror(errno);
+        ::close(listenFd_);
+        throw std::runtime_error("Failed to listen on " + host + ":" + std::to_string(port) + ": " + reason);
+    }
+
+    socklen_t len = sizeof(addr);
+    ::getsockname(listenFd_, reinterpret_cast<sockaddr*>(&addr), &len);
+    port_ = ntohs(addr.sin_port);
+    thread_ = std::thread(&MetricsExporter::serve, this);
+}
+
+MetricsExporter::~MetricsExporter() {
+    char byte = 0;
+    (void)!::write(wakePipe_[1], &byte, 1);
+    if (thread_.joinable()) thread_.join();
+    ::close(listenFd_);
+    ::close(wakePipe_[0]);
+    ::close(wakePipe_[1]);
+}
+
+/**
+ * @brief Accept loop; blocks in poll() until a client or the destructor
+ */
+void MetricsExporter::serve() {
+    pollfd fds[2] = {{listenFd_, POLLIN, 0}, {wakePipe_[0], POLLIN, 0}};
+    while (true) {
+        if (::poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        if (fds[1].revents) return;
+        if (fds[0].revents & POLLIN) {
+            int client = ::accept(listenFd_, nullptr, nullptr);
+            if (client < 0) continue;
+            handle(client);
+            ::close(client);
+        }
+    }
+}
+
+/**
+ * @brief Reads one request (up to the blank line, 1s timeout) and answers it
+ */
+void MetricsExporter::handle(int client) {
+    timeval timeout{1, 0};
+    ::setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+#ifdef SO_NOSIGPIPE
+    int one = 1;
+    ::setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+
+    std::string request;
+    char chunk[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192) {
+        ssize_t n = ::recv(client, chunk, sizeof(chunk), 0);
+        if (n <= 0) break;
+        request.append(chunk, static_cast<size_t>(n));
+    }
+
+    const bool metrics = request.rfind("GET /metrics ", 0) == 0 || request.rfind("GET /metrics?", 0) == 0;
+    const std::string body = metrics ? render_() : "not found, try /metrics\n";
+    std::string response = metrics ? "HTTP/1.0 200 OK\r\n" : "HTTP/1.0 404 Not Found\r\n";
+    response += metrics ? "Content-Type: text/plain; version=0.0.4\r\n" : "Content-Type: text/plain\r\n";
+    response += "Content-Length: " + std::to_string(body.size()) + "\r\n";
+    response += "Connection: close\r\n\r\n";
+    response += body;
+
+    const char* p = response.data();
+    size_t left = response.size();
+    while (left > 0) {
+        ssize_t n = ::send(client, p, left, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return;  // client went away
+        p += n;
+        left -= static_cast<size_t>(n);
+    }
+    if (metrics) scrapes_.fetch_add(1, std::memory_order_relaxed);
+}
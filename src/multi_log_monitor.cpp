@@ -0,0 +1,632 @@
+/**
+ * @file multi_log_monitor.cpp
+ * @brief Implementation of the MultiLogMonitor class
+ * @author Nicholas Loo
+ * @date 14/10/26
+ */
+
+#include "multi_log_monitor.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "log_monitor.h"
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#endif
+
+namespace {
+
+/// Splits path into (directory, file name) the way FileWatcher does
+std::pair<std::string, std::string> splitPath(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    if (slash == std::string::npos) {
+        return {".", path};
+    }
+    return {slash == 0 ? "/" : path.substr(0, slash), path.substr(slash + 1)};
+}
+
+/// Arena capacity for config, checked against Config::arenaLimit
+size_t reserveArena(const MultiLogMonitor::Config& config) {
+    const size_t bytes = MultiLogMonitor::arenaBytes(config);
+    if (config.arenaLimit > 0 && bytes > config.arenaLimit) {
+        throw std::runtime_error("Buffers need " + std::to_string(bytes) + " bytes, over arenaLimit " +
+                                 std::to_string(config.arenaLimit));
+    }
+    return bytes;
+}
+
+} // namespace
+
+/**
+ * @brief Resolves per-source defaults and opens each distinct output once
+ *
+ * @param config Sources and defaults
+ * @throw std::runtime_error on an empty source list or unopenable output
+ */
+MultiLogMonitor::MultiLogMonitor(const Config& config)
+    : config_(config),
+      arena_(reserveArena(config), config.hugePages) {
+
+    if (config_.sources.empty()) {
+        throw std::runtime_error("MultiLogMonitor needs at least one source");
+    }
+    config_.workerThreads = std::max<size_t>(1, config_.workerThreads);
+    config_.readsPerTurn = std::max<size_t>(1, config_.readsPerTurn);
+
+    OutputWriter::Options writerOptions;
+    writerOptions.policy = config_.flushPolicy;
+    writerOptions.flushBytes = config_.flushBytes;
+    writerOptions.flushIntervalUs = config_.flushIntervalUs;
+    writerOptions.compression = config_.outputCompression;
+    writerOptions.compressionLevel = config_.compressionLevel;
+    writerOptions.frameIntervalMs = config_.frameIntervalMs;
+
+    if (config_.maxLineLength == 0) {
+        throw std::runtime_error("maxLineLength must be positive");
+    }
+
+    KeywordMatcher::Options matchOptions;
+    matchOptions.ignoreCase = config_.ignoreCase;
+    matchOptions.wholeWord = config_.wholeWord;
+    matchers_.push_back(std::make_unique<KeywordMatcher>(config_.keywords, std::vector<KeywordMatcher::GroupMask>{},
+                                                         matchOptions));
+
+    for (const Source& source : config_.sources) {
+        const std::string& outputPath = source.outputFile.empty() ? config_.outputFile
+                                                                  : source.outputFile;
+        if (outputPath.empty()) {
+            throw std::runtime_error("No output file for source: " + source.inputFile);
+        }
+
+        // sources routed to the same path share one writer (and its lock)
+        Output* output = nullptr;
+        for (auto& existing : outputs_) {
+            if (existing->path == outputPath) {
+                output = existing.get();
+                break;
+            }
+        }
+        if (!output) {
+            outputs_.push_back(std::make_unique<Output>());
+            output = outputs_.back().get();
+            output->path = outputPath;
+            output->writer = std::make_unique<OutputWriter>(outputPath, writerOptions, &arena_);
+        }
+
+        const KeywordMatcher* matcher = matchers_.front().get();
+        if (!source.keywords.empty()) {
+            matchers_.push_back(std::make_unique<KeywordMatcher>(source.keywords,
+                                                                 std::vector<KeywordMatcher::GroupMask>{},
+                                                                 matchOptions));
+            matcher = matchers_.back().get();
+        }
+
+        auto state = std::make_unique<SourceState>();
+        state->inputFile = source.inputFile;
+        state->name = splitPath(source.inputFile).second;
+        state->matcher = matcher;
+        state->output = output;
+        state->input = InputSource::create(config_.inputBackend);
+        state->partialLine = FixedBuffer(arena_.allocate(config_.maxLineLength + 1), config_.maxLineLength + 1);
+        sources_.push_back(std::move(state));
+    }
+
+    // a read's matches: its lines plus one carried line, each truncated + '\n'
+    const size_t matchesCapacity = config_.bufferSize + config_.maxLineLength + 1;
+    workerState_.resize(config_.workerThreads);
+    for (Worker& worker : workerState_) {
+        worker.buffer = arena_.allocate(config_.bufferSize, 4096);
+        worker.matches = FixedBuffer(arena_.allocate(matchesCapacity), matchesCapacity);
+    }
+
+    // one watch per directory, however many sources live in it
+    for (size_t i = 0; i < sources_.size(); ++i) {
+        const std::string dir = splitPath(sources_[i]->inputFile).first;
+        auto it = std::find_if(dirs_.begin(), dirs_.end(),
+                               [&dir](const WatchedDir& d) { return d.path == dir; });
+        if (it == dirs_.end()) {
+            dirs_.push_back({dir, -1, {}});
+            it = dirs_.end() - 1;
+        }
+        it->byName[sources_[i]->name].push_back(i);
+    }
+    
+    // registered before the first read, so no write can slip through unseen
+    events_ = setupEvents();
+}
+
+/**
+ * @brief Joins anything still running; writers flush in their destructors
+ */
+MultiLogMonitor::~MultiLogMonitor() {
+    stop();
+    for (int fd : {inotifyFd_, epollFd_, wakeFd_}) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+}
+
+/**
+ * @brief Event loop on the calling thread, workers in the pool
+ *
+ * Loop:
+ * 1. Schedule every source once (existing content, files present at start)
+ * 2. Wait for inotify events (or sleep in poll mode), schedule the named sources
+ * 3. Reschedule everything every recheckMs
+ * 4. Tick the outputs so FlushPolicy::Interval data doesn't sit while idle
+ *
+ * After stop() the workers finish the source they hold and exit; the
+ * outputs are flushed on this thread.
+ */
+void MultiLogMonitor::start() {
+    running_ = true;
+    const bool events = events_;
+
+    for (Worker& worker : workerState_) {
+        workers_.emplace_back([this, &worker] { workerLoop(worker); });
+    }
+
+    scheduleAll();
+    auto nextRecheck = std::chrono::steady_clock::now() + std::chrono::milliseconds(config_.recheckMs);
+
+    while (running_) {
+        int timeoutMs = events ? (config_.recheckMs > 0 ? config_.recheckMs : -1)
+                               : config_.pollIntervalMs;
+        if (config_.flushPolicy == FlushPolicy::Interval) {
+            // wake up in time for tick() to flush aged output
+            int intervalMs = static_cast<int>(std::max<uint64_t>(1, config_.flushIntervalUs / 1000));
+            timeoutMs = timeoutMs < 0 ? intervalMs : std::min(timeoutMs, intervalMs);
+        }
+        if (config_.outputCompression != Compression::None) {
+            // and to cut aged compressed frames
+            int frameMs = static_cast<int>(std::max<uint64_t>(1, config_.frameIntervalMs));
+            timeoutMs = timeoutMs < 0 ? frameMs : std::min(timeoutMs, frameMs);
+        }
+
+        if (events) {
+            waitForEvents(timeoutMs);
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+            scheduleAll();
+        }
+        wakeups_++;
+
+        if (config_.recheckMs > 0 && std::chrono::steady_clock::now() >= nextRecheck) {
+            scheduleAll();
+            nextRecheck = std::chrono::steady_clock::now() + std::chrono::milliseconds(config_.recheckMs);
+        }
+        tickOutputs();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        ready_.clear();
+        for (auto& source : sources_) {
+            source->state = State::Idle;
+        }
+    }
+    queueCv_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+
+    for (auto& output : outputs_) {
+        output->writer->flush();
+    }
+}
+
+/**
+ * @brief Clears the running flag and pokes the eventfd
+ *
+ * @note Safe from signal handlers (atomic store + one write(2)); workers
+ *       are woken by start() on its way out
+ */
+void MultiLogMonitor::stop() {
+    running_ = false;
+    if (wakeFd_ >= 0) {
+        uint64_t one = 1;
+        (void)!::write(wakeFd_, &one, sizeof(one));
+    }
+}
+
+/**
+ * @brief Creates the inotify instance, one watch per directory, and epoll
+ *
+ * A directory that can't be watched only loses events; the recheck
+ * still covers its sources.
+ *
+ * @return false if the platform (or the kernel) has no inotify
+ */
+bool MultiLogMonitor::setupEvents() {
+#if defined(__linux__)
+    inotifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (inotifyFd_ < 0 || wakeFd_ < 0 || epollFd_ < 0) {
+        return false;
+    }
+
+    // same mask as FileWatcher: appends plus create / rotate / truncate
+    const uint32_t mask = IN_MODIFY | IN_CREATE | IN_MOVED_TO | IN_MOVED_FROM |
+                          IN_DELETE | IN_ATTRIB | IN_CLOSE_WRITE;
+    for (WatchedDir& dir : dirs_) {
+        dir.wd = inotify_add_watch(inotifyFd_, dir.path.c_str(), mask);
+    }
+
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = inotifyFd_;
+    if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, inotifyFd_, &ev) < 0) return false;
+    ev.data.fd = wakeFd_;
+    if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &ev) < 0) return false;
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief One epoll_wait, then drains inotify and schedules named sources
+ *
+ * All sources touched by one batch of events are queued under a single
+ * lock, and a source written to many times is queued once.
+ *
+ * @param timeoutMs Maximum wait, -1 for none
+ */
+void MultiLogMonitor::waitForEvents(int timeoutMs) {
+#if defined(__linux__)
+    epoll_event ready[2];
+    int count = epoll_wait(epollFd_, ready, 2, timeoutMs);
+    if (count <= 0) return;  // timeout or EINTR
+
+    bool overflow = false;
+    std::vector<size_t> touched;
+    for (int i = 0; i < count; ++i) {
+        if (ready[i].data.fd == wakeFd_) {
+            uint64_t value;
+            (void)!::read(wakeFd_, &value, sizeof(value));
+            continue;
+        }
+
+        // aligned so the struct inotify_event casts below are well defined
+        alignas(inotify_event) char events[4096];
+        ssize_t len;
+        while ((len = ::read(inotifyFd_, events, sizeof(events))) > 0) {
+            for (char* p = events; p < events + len;) {
+                auto* event = reinterpret_cast<inotify_event*>(p);
+                p += sizeof(inotify_event) + event->len;
+
+                if (event->mask & IN_Q_OVERFLOW) {
+                    overflow = true;
+                    continue;
+                }
+                if (event->len == 0) continue;
+                // one hash lookup per event, however many files share the directory
+                for (const WatchedDir& dir : dirs_) {
+                    if (dir.wd != event->wd) continue;
+                    auto match = dir.byName.find(event->name);
+                    if (match != dir.byName.end()) {
+                        touched.insert(touched.end(), match->second.begin(), match->second.end());
+                    }
+                }
+            }
+        }
+    }
+
+    if (overflow) {
+        scheduleAll();  // events were lost, look at everything
+        return;
+    }
+    if (touched.empty()) return;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        for (size_t index : touched) {
+            scheduleLocked(index);
+        }
+    }
+    queueCv_.notify_all();
+#else
+    (void)timeoutMs;
+#endif
+}
+
+/**
+ * @brief Queues a source once; one already being read gets re-read after
+ */
+void MultiLogMonitor::scheduleLocked(size_t index) {
+    SourceState& source = *sources_[index];
+    switch (source.state) {
+    case State::Idle:
+        source.state = State::Queued;
+        ready_.push_back(index);
+        break;
+    case State::Active:
+        source.state = State::ActiveDirty;
+        break;
+    case State::Queued:
+    case State::ActiveDirty:
+        break;
+    }
+}
+
+void MultiLogMonitor::scheduleAll() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        for (size_t i = 0; i < sources_.size(); ++i) {
+            scheduleLocked(i);
+        }
+    }
+    queueCv_.notify_all();
+}
+
+/**
+ * @brief Pops sources until stop()
+ *
+ * Ownership handoff goes through queueMutex_, so a source's plain members
+ * and single-writer counters are only touched by one worker at a time.
+ */
+void MultiLogMonitor::workerLoop(Worker& worker) {
+    while (true) {
+        size_t index;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex_);
+            queueCv_.wait(lock, [this] { return !ready_.empty() || !running_; });
+            if (!running_) return;
+            index = ready_.front();
+            ready_.pop_front();
+            sources_[index]->state = State::Active;
+        }
+
+        SourceState& source = *sources_[index];
+        bool more = drain(source, worker);
+
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        if (more || source.state == State::ActiveDirty) {
+            source.state = State::Queued;
+            ready_.push_back(index);  // back of the line: fairness between sources
+        } else {
+            source.state = State::Idle;
+        }
+    }
+}
+
+/**
+ * @brief Read loop of LogMonitor::start for one source, bounded per turn
+ *
+ * A missing file is simply left closed; its creation event schedules it
+ * again. Rotation is checked at EOF; a read error closes the input and
+ * restarts at offset 0, as in the single-file monitor.
+ */
+bool MultiLogMonitor::drain(SourceState& source, Worker& worker) {
+    source.turns++;
+    if (!source.input->isOpen() && !source.input->open(source.inputFile)) {
+        return false;
+    }
+
+    for (size_t reads = 0; reads < config_.readsPerTurn; ++reads) {
+        if (!running_) return false;
+
+        ssize_t bytesRead = source.input->read(worker.buffer, config_.bufferSize, source.offset);
+        if (bytesRead < 0) {
+            source.input->close();
+            source.offset = 0;
+            source.readOffset.set(source.offset);
+            source.partialLine.clear();
+            source.discardingLine = false;  // the reopened file starts on a line
+            return false;
+        }
+        if (bytesRead == 0) {
+            if (!handleRotation(source, worker)) {
+                return false;
+            }
+            // rotated: reopen and read the new file in this turn
+            if (!source.input->isOpen() && !source.input->open(source.inputFile)) {
+                return false;
+            }
+            continue;
+        }
+
+        source.bytesRead += static_cast<uint64_t>(bytesRead);
+        processBuffer(source, worker, worker.buffer, static_cast<size_t>(bytesRead));
+        writeMatches(source, worker);
+        source.offset += static_cast<uint64_t>(bytesRead);
+        source.readOffset.set(source.offset);
+
+        // short read means we've caught up with the writer
+        if (static_cast<size_t>(bytesRead) < config_.bufferSize) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Rename/create or truncation check at EOF of the open file
+ *
+ * The unterminated last line of the old file is matched on its own.
+ */
+bool MultiLogMonitor::handleRotation(SourceState& source, Worker& worker) {
+    InputSource::Rotation rotation = source.input->checkRotation(source.inputFile, source.offset);
+    if (rotation == InputSource::Rotation::None) {
+        return false;
+    }
+
+    if (!source.partialLine.empty()) {
+        processLine(source, worker, source.partialLine);
+        source.partialLine.clear();
+        source.discardingLine = false;
+        writeMatches(source, worker);
+    }
+    if (rotation == InputSource::Rotation::Replaced) {
+        source.input->close();
+    }
+    source.offset = 0;
+    source.readOffset.set(source.offset);
+    source.rotations++;
+    return true;
+}
+
+/**
+ * @brief Per-line split with the carry rules of LogMonitor::processBuffer
+ */
+void MultiLogMonitor::processBuffer(SourceState& source, Worker& worker, const char* data, size_t len) {
+    const size_t maxCarry = config_.maxLineLength + 1;
+    size_t start = 0;
+    if (source.discardingLine) {
+        const void* nl = std::memchr(data, '\n', len);
+        if (!nl) return;  // still inside the over-long line
+        start = static_cast<const char*>(nl) - data;
+        source.discardingLine = false;
+    }
+
+    while (start < len) {
+        const void* nl = std::memchr(data + start, '\n', len - start);
+        if (!nl) break;
+        size_t lineEnd = static_cast<const char*>(nl) - data;
+
+        if (!source.partialLine.empty()) {
+            const size_t room = maxCarry - source.partialLine.length();
+            source.partialLine.append(data + start, std::min(lineEnd - start, room));
+            processLine(source, worker, source.partialLine);
+            source.partialLine.clear();
+        } else {
+            processLine(source, worker, std::string_view(data + start, lineEnd - start));
+        }
+        start = lineEnd + 1;
+    }
+
+    if (start < len) {
+        carryPartialLine(source, data + start, len - start);
+    }
+}
+
+void MultiLogMonitor::carryPartialLine(SourceState& source, const char* data, size_t len) {
+    // maxLineLength + 1 bytes say "too long" and hold the truncated form;
+    // processLine() truncates and counts once the '\n' arrives
+    const size_t room = config_.maxLineLength + 1 - source.partialLine.length();
+    if (len > room) {
+        source.partialLine.append(data, room);
+        source.discardingLine = true;
+    } else {
+        source.partialLine.append(data, len);
+    }
+}
+
+void MultiLogMonitor::processLine(SourceState& source, Worker& worker, std::string_view line) {
+    if (line.empty()) return;
+
+    source.linesProcessed++;
+    if (line.length() > config_.maxLineLength) {
+        line = line.substr(0, config_.maxLineLength);
+        source.longLinesDiscarded++;
+    }
+
+    if (source.matcher->matches(line)) {
+        source.linesMatched++;
+        worker.matches.append(line.data(), line.size());
+        worker.matches.push_back('\n');
+    }
+}
+
+/**
+ * @brief Hands one read's matches to the shared writer in one locked batch
+ *
+ * Lines of one read stay contiguous in a shared output. The staging
+ * buffer outlives endOfBuffer(), so PerBuffer can reference it in place.
+ */
+void MultiLogMonitor::writeMatches(SourceState& source, Worker& worker) {
+    if (worker.matches.empty()) return;
+
+    Output& output = *source.output;
+    {
+        std::lock_guard<std::mutex> lock(output.mutex);
+        const char* p = worker.matches.data();
+        const char* end = p + worker.matches.size();
+        while (p < end) {
+            const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            output.writer->writeLine(std::string_view(p, nl - p), true);
+            p = nl + 1;
+        }
+        output.writer->endOfBuffer();
+    }
+    worker.matches.clear();
+}
+
+void MultiLogMonitor::tickOutputs() {
+    if (config_.flushPolicy != FlushPolicy::Interval && config_.outputCompression == Compression::None) return;
+    for (auto& output : outputs_) {
+        std::lock_guard<std::mutex> lock(output->mutex);
+        output->writer->tick();
+    }
+}
+
+MultiLogMonitor::Statistics MultiLogMonitor::getSourceStatistics(size_t index) const {
+    const SourceState& source = *sources_.at(index);
+    Statistics snapshot;
+    snapshot.linesProcessed = source.linesProcessed.load();
+    snapshot.linesMatched = source.linesMatched.load();
+    snapshot.bytesRead = source.bytesRead.load();
+    snapshot.longLinesDiscarded = source.longLinesDiscarded.load();
+    snapshot.turns = source.turns.load();
+    snapshot.rotations = source.rotations.load();
+    snapshot.readOffset = source.readOffset.load();
+    return snapshot;
+}
+
+uint64_t MultiLogMonitor::bytesBehind(size_t index) const {
+    const SourceState& source = *sources_.at(index);
+    struct stat st;
+    if (::stat(source.inputFile.c_str(), &st) != 0) return 0;
+    const uint64_t size = static_cast<uint64_t>(st.st_size);
+    const uint64_t offset = source.readOffset.load();
+    return size > offset ? size - offset : 0;
+}
+
+MultiLogMonitor::Statistics MultiLogMonitor::getStatistics() const {
+    Statistics total;
+    for (size_t i = 0; i < sources_.size(); ++i) {
+        Statistics s = getSourceStatistics(i);
+        total.linesProcessed += s.linesProcessed;
+        total.linesMatched += s.linesMatched;
+        total.bytesRead += s.bytesRead;
+        total.longLinesDiscarded += s.longLinesDiscarded;
+        total.turns += s.turns;
+        total.rotations += s.rotations;
+    }
+    return total;
+}
+
+size_t MultiLogMonitor::arenaBytes(const Config& config) {
+    OutputWriter::Options writerOptions;
+    writerOptions.flushBytes = config.flushBytes;
+
+    std::vector<std::string> paths;
+    for (const Source& source : config.sources) {
+        const std::string& path = source.outputFile.empty() ? config.outputFile : source.outputFile;
+        if (std::find(paths.begin(), paths.end(), path) == paths.end()) {
+            paths.push_back(path);
+        }
+    }
+    const size_t workers = std::max<size_t>(1, config.workerThreads);
+    return workers * (Arena::footprint(config.bufferSize, 4096) +
+                      Arena::footprint(config.bufferSize + config.maxLineLength + 1)) +
+           config.sources.size() * Arena::footprint(config.maxLineLength + 1) +
+           paths.size() * Arena::footprint(OutputWriter::stagingSize(writerOptions));
+}
+
+uint64_t MultiLogMonitor::outputFlushes() const {
+    uint64_t total = 0;
+    for (const auto& output : outputs_) {
+        total += output->writer->flushCount();
+    }
+    return total;
+}
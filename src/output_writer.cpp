@@ -0,0 +1,302 @@
+/**
+ * @file output_writer.cpp
+ * @brief Implementation of the OutputWriter class
+ * @author Nicholas Loo
+ * @date 14/10/26
+ */
+
+#include "output_writer.h"
+#include "arena.h"
+#include "compressed_sink.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+namespace {
+
+/// Smallest staging buffer, big enough for a batch of MAX_LINE_LENGTH lines
+constexpr size_t MIN_STAGING_SIZE = 64 * 1024;
+
+#ifdef IOV_MAX
+constexpr size_t MAX_IOV = IOV_MAX;
+#else
+constexpr size_t MAX_IOV = 1024;
+#endif
+
+/// Shared newline referenced by zero-copy iovecs
+const char NEWLINE = '\n';
+
+} // namespace
+
+/**
+ * @brief Opens the output file and allocates the staging buffer
+ *
+ * O_APPEND keeps the old "append, never overwrite" semantics of the
+ * std::ofstream version and makes each writev land atomically at EOF.
+ *
+ * @param path Output file path
+ * @param options Flush policy
+ * @param arena Staging memory, null to allocate it here
+ * @throw std::runtime_error if the file cannot be opened
+ */
+OutputWriter::OutputWriter(const std::string& path, const Options& options, Arena* arena)
+    : path_(path),
+      options_(options) {
+
+    fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        throw std::runtime_error("Failed to open output file: " + path);
+    }
+
+    // everything the hot path needs is allocated here, once
+    stagingCapacity_ = stagingSize(options_);
+    try {
+        if (arena) {
+            staging_ = arena->allocate(stagingCapacity_);
+        } else {
+            ownedStaging_ = std::make_unique<char[]>(stagingCapacity_);
+            staging_ = ownedStaging_.get();
+        }
+    } catch (...) {
+        ::close(fd_);
+        throw;
+    }
+    iov_.reserve(MAX_IOV);
+
+    if (options_.compression != Compression::None) {
+        try {
+            sink_ = std::make_unique<CompressedSink>(fd_, path_, options_);
+        } catch (...) {
+            ::close(fd_);
+            throw;
+        }
+    }
+}
+
+/**
+ * @brief Final flush, then close
+ */
+OutputWriter::~OutputWriter() {
+    try {
+        flush();
+    } catch (const std::exception&) {
+        // nothing sensible to do from a destructor
+    }
+    sink_.reset();  // joins the compressor before its fd goes
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+/**
+ * @brief Queues a line according to the flush policy
+ *
+ * - PerLine: written immediately as {line, "\n"} with one writev, no copy
+ * - PerBuffer + stable: referenced in place until endOfBuffer()
+ * - otherwise: copied into the staging buffer
+ *
+ * @param line Line without newline
+ * @param stable Caller keeps line alive until endOfBuffer()
+ */
+void OutputWriter::writeLine(std::string_view line, bool stable) {
+    if (options_.policy == FlushPolicy::PerLine) {
+        iovec iov[2] = {
+            {const_cast<char*>(line.data()), line.size()},
+            {const_cast<char*>(&NEWLINE), 1}
+        };
+        writeAll(iov, 2);
+        flushes_++;
+        return;
+    }
+
+    const bool wasEmpty = pendingBytes_ == 0;
+
+    if (options_.policy == FlushPolicy::PerBuffer && stable) {
+        if (iov_.size() + 2 > MAX_IOV) {
+            writePending();
+        }
+        if (line.data()[line.size()] == '\n') {
+            pushIov(line.data(), line.size() + 1);  // newline already in place
+        } else {
+            pushIov(line.data(), line.size());
+            pushIov(&NEWLINE, 1);
+        }
+    } else {
+        const size_t needed = line.size() + 1;
+        if (needed > stagingCapacity_ - stagingUsed_ || iov_.size() + 2 > MAX_IOV) {
+            writePending();
+        }
+        if (needed > stagingCapacity_) {
+            // larger than the whole staging buffer, write it through
+            iovec iov[2] = {
+                {const_cast<char*>(line.data()), line.size()},
+                {const_cast<char*>(&NEWLINE), 1}
+            };
+            writeAll(iov, 2);
+            flushes_++;
+            return;
+        }
+        stage(line.data(), line.size());
+        stage(&NEWLINE, 1);
+    }
+
+    switch (options_.policy) {
+        case FlushPolicy::Bytes:
+            if (pendingBytes_ >= options_.flushBytes) {
+                writePending();
+            }
+            break;
+        case FlushPolicy::Interval: {
+            auto now = std::chrono::steady_clock::now();
+            if (wasEmpty) {
+                oldestPending_ = now;
+            } else if (now - oldestPending_ >= std::chrono::microseconds(options_.flushIntervalUs)) {
+                writePending();
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Input buffer boundary; PerBuffer batches are written here
+ *
+ * Must be called before the memory behind stable lines is reused.
+ */
+void OutputWriter::endOfBuffer() {
+    if (options_.policy == FlushPolicy::PerBuffer) {
+        writePending();
+    }
+}
+
+/**
+ * @brief Flushes Interval-policy data that has aged out while idle
+ */
+void OutputWriter::tick() {
+    if (options_.policy == FlushPolicy::Interval && pendingBytes_ > 0 &&
+        std::chrono::steady_clock::now() - oldestPending_ >=
+            std::chrono::microseconds(options_.flushIntervalUs)) {
+        writePending();
+    }
+    if (sink_) {
+        sink_->tick();
+    }
+}
+
+/**
+ * @brief Writes everything pending; compressed, waits for the sink too
+ */
+void OutputWriter::flush() {
+    writePending();
+    if (sink_) {
+        sink_->sync();
+    }
+}
+
+/**
+ * @brief Writes every pending iovec and resets the batch
+ */
+void OutputWriter::writePending() {
+    if (iov_.empty()) {
+        return;
+    }
+    writeAll(iov_.data(), iov_.size());
+    iov_.clear();
+    stagingUsed_ = 0;
+    pendingBytes_ = 0;
+    flushes_++;
+}
+
+size_t OutputWriter::stagingSize(const Options& options) {
+    return std::max(options.flushBytes, MIN_STAGING_SIZE);
+}
+
+uint64_t OutputWriter::fileSize() const {
+    struct stat st;
+    if (::fstat(fd_, &st) != 0) {
+        throw std::runtime_error("Failed to stat output file: " + path_);
+    }
+    return static_cast<uint64_t>(st.st_size);
+}
+
+void OutputWriter::truncate(uint64_t size) {
+    if (sink_) {
+        sink_->sync();  // queued frames would land after the cut
+    }
+    iov_.clear();
+    stagingUsed_ = 0;
+    pendingBytes_ = 0;
+    if (::ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+        throw std::runtime_error("Failed to truncate output file: " + path_);
+    }
+}
+
+/**
+ * @brief Copies bytes into staging and describes them with an iovec
+ */
+void OutputWriter::stage(const char* data, size_t len) {
+    char* dst = staging_ + stagingUsed_;
+    std::memcpy(dst, data, len);
+    stagingUsed_ += len;
+    pushIov(dst, len);
+}
+
+/**
+ * @brief Adds an iovec, extending the last one when the memory is adjacent
+ *
+ * Consecutive staged lines collapse into a single iovec.
+ */
+void OutputWriter::pushIov(const char* data, size_t len) {
+    pendingBytes_ += len;
+    if (!iov_.empty()) {
+        iovec& last = iov_.back();
+        if (static_cast<const char*>(last.iov_base) + last.iov_len == data) {
+            last.iov_len += len;
+            return;
+        }
+    }
+    iov_.push_back({const_cast<char*>(data), len});
+}
+
+/**
+ * @brief writev() until everything is written
+ *
+ * Handles short writes by advancing through the iovec array in place and
+ * retries on EINTR. Compressed output is copied into the sink instead.
+ *
+ * @param iov iovec array (modified)
+ * @param count Number of entries
+ * @throw std::runtime_error on any other write error
+ */
+void OutputWriter::writeAll(iovec* iov, size_t count) {
+    if (sink_) {
+        sink_->append(iov, count);
+        return;
+    }
+    while (count > 0) {
+        ssize_t written = ::writev(fd_, iov, static_cast<int>(std::min(count, MAX_IOV)));
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error("Failed to write output file: " + path_ + ": " +
+                                     std::strerror(errno));
+        }
+
+        size_t remaining = static_cast<size_t>(written);
+        while (count > 0 && remaining >= iov->iov_len) {
+            remaining -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+        if (count > 0 && remaining > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + remaining;
+            iov->iov_len -= remaining;
+        }
+    }
+}
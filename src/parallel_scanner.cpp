@@ -0,0 +1,179 @@
+/**
+ * @file parallel_scanner.cpp
+ * @brief Implementation of the ParallelScanner class
+ * @author Nicholas Loo
+ * @date 14/10/26
+ */
+
+#include "parallel_scanner.h"
+#include <algorithm>
+#include <cstring>
+
+ParallelScanner::ParallelScanner(const KeywordMatcher& matcher, size_t threads,
+                                 size_t maxLineLength, size_t chunkSize)
+    : matcher_(&matcher),
+      maxLineLength_(maxLineLength),
+      chunkSize_(std::max<size_t>(chunkSize, 1)) {
+    for (size_t i = 1; i < threads; ++i) {
+        workers_.emplace_back(&ParallelScanner::workerLoop, this);
+    }
+}
+
+ParallelScanner::~ParallelScanner() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    workCv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Splits, filters in parallel, emits in order
+ *
+ * Algorithm:
+ * 1. Cut the region every chunkSize bytes, moving each cut forward to just
+ *    after the next '\n' so every chunk holds whole lines
+ * 2. Publish the job and wake the workers
+ * 3. For chunk 0, 1, 2...: help with unclaimed chunks until it is done,
+ *    then emit its matches (the reorder step)
+ * 4. Wait for workers to leave the job so chunks_ can be reused
+ *
+ * @param data Region of complete lines
+ * @param len Region length
+ * @param onMatch Match callback, runs on this thread only
+ */
+ParallelScanner::Result ParallelScanner::scan(const char* data, size_t len, const MatchFn& onMatch) {
+    Result result;
+    if (len == 0) return result;
+
+    // newline-aligned chunk boundaries
+    size_t count = 0;
+    for (size_t start = 0; start < len;) {
+        size_t end = std::min(start + chunkSize_, len);
+        if (end < len) {
+            const void* nl = std::memchr(data + end - 1, '\n', len - end + 1);
+            end = nl ? static_cast<const char*>(nl) - data + 1 : len;
+        }
+        if (count == chunks_.size()) {
+            chunks_.emplace_back();
+        }
+        Chunk& chunk = chunks_[count++];
+        chunk.data = data + start;
+        chunk.len = end - start;
+        chunk.matches.clear();
+        chunk.lines = 0;
+        chunk.longLines = 0;
+        chunk.done = false;
+        start = end;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        chunkCount_ = count;
+        nextChunk_.store(0);
+        jobId_++;
+    }
+    workCv_.notify_all();
+
+    for (size_t i = 0; i < count; ++i) {
+        // chunk i may not even be claimed yet, so help before blocking
+        while (true) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (chunks_[i].done) break;
+            }
+            if (!runChunks()) {
+                std::unique_lock<std::mutex> lock(mutex_);
+                doneCv_.wait(lock, [&] { return chunks_[i].done; });
+                break;
+            }
+        }
+
+        const Chunk& chunk = chunks_[i];
+        result.lines += chunk.lines;
+        result.longLines += chunk.longLines;
+        result.matched += chunk.matches.size();
+        for (std::string_view line : chunk.matches) {
+            onMatch(line);
+        }
+    }
+
+    // no worker may still be touching chunks_ when the next scan rewrites it
+    std::unique_lock<std::mutex> lock(mutex_);
+    doneCv_.wait(lock, [&] { return activeWorkers_ == 0; });
+    chunkCount_ = 0;
+    return result;
+}
+
+void ParallelScanner::workerLoop() {
+    uint64_t seenJob = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        workCv_.wait(lock, [&] { return stopping_ || jobId_ != seenJob; });
+        if (stopping_) return;
+        seenJob = jobId_;
+        activeWorkers_++;
+
+        lock.unlock();
+        runChunks();
+        lock.lock();
+
+        activeWorkers_--;
+        doneCv_.notify_all();
+    }
+}
+
+/**
+ * @brief Claims chunks off the shared cursor until the job is drained
+ * @return true if at least one chunk was processed
+ */
+bool ParallelScanner::runChunks() {
+    bool any = false;
+    size_t count;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        count = chunkCount_;
+    }
+    // a worker waking late, between jobs, must not move the cursor
+    if (count == 0) return false;
+    
+    size_t index;
+    while ((index = nextChunk_.fetch_add(1)) < count) {
+        scanChunk(chunks_[index]);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            chunks_[index].done = true;
+        }
+        doneCv_.notify_all();
+        any = true;
+    }
+    return any;
+}
+
+/**
+ * @brief Same per-line rules as LogMonitor::processLine, on one chunk
+ */
+void ParallelScanner::scanChunk(Chunk& chunk) const {
+    const char* p = chunk.data;
+    const char* end = chunk.data + chunk.len;
+
+    while (p < end) {
+        const void* nl = std::memchr(p, '\n', end - p);
+        const char* lineEnd = nl ? static_cast<const char*>(nl) : end;
+        std::string_view line(p, lineEnd - p);
+        p = lineEnd + 1;
+
+        if (line.empty()) continue;
+        chunk.lines++;
+        if (line.size() > maxLineLength_) {
+            line = line.substr(0, maxLineLength_);
+            chunk.longLines++;
+        }
+        if (matcher_->matches(line)) {
+            chunk.matches.push_back(line);
+        }
+    }
+}
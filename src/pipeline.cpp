@@ -0,0 +1,369 @@
+/**
+ * @file pipeline.cpp
+ * @brief Implementation of the Pipeline class
+ * @author Nicholas Loo
+ * @date 14/10/26
+ */
+
+#include "pipeline.h"
+#include "placement.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+/// Last '\n' in [data, data + n), or nullptr
+const char* findLastNewline(const char* data, size_t n) {
+    for (size_t i = n; i > 0; --i) {
+        if (data[i - 1] == '\n') return data + i - 1;
+    }
+    return nullptr;
+}
+
+} // namespace
+
+/**
+ * @brief Allocates the pool and rings, all blocks start on the free ring
+ *
+ * Every ring can hold the whole pool, so pushes never fail and only
+ * "ring empty" ever makes a stage wait.
+ */
+Pipeline::Pipeline(const KeywordMatcher& matcher, OutputWriter& writer, const Options& options)
+    : Pipeline(matcher, std::vector<OutputWriter*>{&writer}, options) {
+}
+
+Pipeline::Pipeline(const KeywordMatcher& matcher, std::vector<OutputWriter*> writers,
+                   const Options& options)
+    : matcher_(&matcher),
+      writers_(std::move(writers)),
+      options_([&options] {
+          Options o = options;
+          o.matcherThreads = std::max<size_t>(o.matcherThreads, 1);
+          o.blocks = std::max<size_t>(o.blocks, 2);
+          return o;
+      }()),
+      pool_(options_.blocks),
+      freeRing_(options_.blocks) {
+
+    const size_t blockCapacity = options_.readSize + options_.maxLineLength + 1;
+    for (Block& block : pool_) {
+        if (options_.arena) {
+            block.data = options_.arena->allocate(blockCapacity);
+        } else {
+            block.owned = std::make_unique<char[]>(blockCapacity);
+            block.data = block.owned.get();
+        }
+        freeRing_.tryPush(&block);
+    }
+    for (size_t i = 0; i < options_.matcherThreads; ++i) {
+        matchRings_.push_back(std::make_unique<SpscRing<Block*>>(options_.blocks));
+        writeRings_.push_back(std::make_unique<SpscRing<Block*>>(options_.blocks));
+    }
+}
+
+size_t Pipeline::arenaBytes(const Options& options) {
+    const size_t blocks = std::max<size_t>(options.blocks, 2);
+    return blocks * Arena::footprint(options.readSize + options.maxLineLength + 1);
+}
+
+Pipeline::~Pipeline() {
+    finish();
+}
+
+void Pipeline::start() {
+    if (writerThread_.joinable()) return;
+    readerDone_ = false;
+    matchersDone_ = 0;
+    // pinned before the first touch, so ring and block traffic stays on the node
+    auto pin = [this](size_t slot) {
+        if (slot < options_.cpus.size() && options_.cpus[slot] >= 0) {
+            pinCurrentThread(options_.cpus[slot]);
+        }
+    };
+    for (size_t i = 0; i < options_.matcherThreads; ++i) {
+        matchers_.emplace_back([this, pin, i] {
+            pin(i);
+            matcherLoop(i);
+        });
+    }
+    writerThread_ = std::thread([this, pin] {
+        pin(options_.matcherThreads);
+        writerLoop();
+    });
+}
+
+void Pipeline::finish() {
+    if (!writerThread_.joinable()) return;
+    readerDone_.store(true, std::memory_order_release);
+    for (auto& thread : matchers_) {
+        thread.join();
+    }
+    matchers_.clear();
+    writerThread_.join();
+}
+
+/**
+ * @brief Reads into the current block and dispatches its complete lines
+ *
+ * Algorithm:
+ * 1. read() after the carried bytes of the current block (and index them)
+ * 2. If an over-long line is being dropped, skip up to its '\n'
+ * 3. No '\n' in the block: keep carrying (bounded to maxLineLength + 1)
+ * 4. Otherwise move the tail after the last '\n' into a fresh block and
+ *    push this one to the next matcher
+ */
+ssize_t Pipeline::read(InputSource& input, uint64_t offset) {
+    if (!current_) {
+        current_ = acquireFree();
+    }
+
+    char* data = current_->data;
+    ssize_t n = input.read(data + used_, options_.readSize, offset);
+    if (n <= 0) return n;
+    if (options_.index) {
+        options_.index->consume(data + used_, static_cast<size_t>(n));  // before any byte is dropped
+    }
+
+    char* fresh = data + used_;
+    size_t freshLen = static_cast<size_t>(n);
+
+    if (discarding_) {
+        const void* nl = std::memchr(fresh, '\n', freshLen);
+        if (!nl) {
+            dropped_ += freshLen;
+            return n;  // all of it belongs to the dropped line
+        }
+        size_t skip = static_cast<const char*>(nl) - fresh;
+        dropped_ += skip;
+        std::memmove(fresh, nl, freshLen - skip);
+        freshLen -= skip;
+        discarding_ = false;
+    }
+
+    const size_t total = used_ + freshLen;
+    const size_t maxCarry = options_.maxLineLength + 1;
+    const char* last = findLastNewline(fresh, freshLen);
+
+    if (!last) {
+        // still inside one line; maxLineLength + 1 bytes is enough to know
+        // it is too long and what its truncated form is
+        if (total > maxCarry) {
+            dropped_ += total - maxCarry;
+            used_ = maxCarry;
+            discarding_ = true;
+        } else {
+            used_ = total;
+        }
+        return n;
+    }
+
+    const size_t complete = static_cast<size_t>(last - data) + 1;
+    const size_t tail = total - complete;
+
+    Block* next = acquireFree();
+    const size_t keep = std::min(tail, maxCarry);
+    std::memcpy(next->data, data + complete, keep);
+    discarding_ = tail > maxCarry;
+    dropped_ = tail - keep;
+
+    current_->len = complete;
+    matchRings_[nextMatcher_]->tryPush(current_);
+    nextMatcher_ = (nextMatcher_ + 1) % matchRings_.size();
+
+    current_ = next;
+    used_ = keep;
+    return n;
+}
+
+void Pipeline::discardPartial() {
+    used_ = 0;
+    discarding_ = false;
+    dropped_ = 0;
+}
+
+/**
+ * @brief Terminates the carry in place and sends it to the next matcher
+ *
+ * Blocks hold readSize + maxLineLength + 1 bytes and the carry is at most
+ * maxLineLength + 1, so there is always room for the '\n'.
+ */
+void Pipeline::endOfFile() {
+    if (current_ && used_ > 0) {
+        current_->data[used_] = '\n';
+        current_->len = used_ + 1;
+        matchRings_[nextMatcher_]->tryPush(current_);
+        nextMatcher_ = (nextMatcher_ + 1) % matchRings_.size();
+        current_ = nullptr;  // next read() takes a fresh block
+    }
+    discardPartial();
+}
+
+Pipeline::Stats Pipeline::stats() const {
+    Stats s;
+    s.lines = lines_.load();
+    s.longLines = longLines_.load();
+    s.matched = matched_.load();
+    s.readerStalls = readerStalls_.load();
+    s.matcherStalls = matcherStalls_.load(std::memory_order_relaxed);
+    s.writerStalls = writerStalls_.load();
+    for (size_t i = 0; i < matchRings_.size(); ++i) {
+        s.matchQueueDepth += matchRings_[i]->size();
+        s.writeQueueDepth += writeRings_[i]->size();
+    }
+    return s;
+}
+
+Pipeline::Block* Pipeline::acquireFree() {
+    Block* block;
+    if (freeRing_.tryPop(block)) return block;
+
+    readerStalls_++;
+    RingBackoff backoff;
+    while (!freeRing_.tryPop(block)) {
+        backoff.pause();
+    }
+    return block;
+}
+
+/**
+ * @brief Matcher stage: filter blocks until the reader is done and the ring is drained
+ */
+void Pipeline::matcherLoop(size_t index) {
+    SpscRing<Block*>& in = *matchRings_[index];
+    SpscRing<Block*>& out = *writeRings_[index];
+    RingBackoff backoff;
+    bool waiting = false;
+    Block* block;
+
+    while (true) {
+        if (in.tryPop(block)) {
+            matchBlock(*block);
+            out.tryPush(block);
+            backoff.reset();
+            waiting = false;
+            continue;
+        }
+        // re-check after seeing done: the last push may have raced the flag
+        if (readerDone_.load(std::memory_order_acquire)) {
+            if (!in.tryPop(block)) break;
+            matchBlock(*block);
+            out.tryPush(block);
+            continue;
+        }
+        if (!waiting) {
+            matcherStalls_.fetch_add(1, std::memory_order_relaxed);
+            waiting = true;
+        }
+        backoff.pause();
+    }
+    matchersDone_.fetch_add(1, std::memory_order_release);
+}
+
+/**
+ * @brief Writer stage: write blocks in dispatch order, recycle them
+ */
+void Pipeline::writerLoop() {
+    const size_t rings = writeRings_.size();
+    size_t next = 0;
+    RingBackoff backoff;
+    bool waiting = false;
+    Block* block;
+
+    while (true) {
+        if (writeRings_[next]->tryPop(block)) {
+            const char* p = block->data;
+            const char* end = p + block->outLen;
+            const bool routed = writers_.size() > 1;
+            size_t line = 0;
+            while (p < end) {
+                const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+                // stable: the block isn't recycled until after endOfBuffer()
+                std::string_view text(p, nl - p);
+                KeywordMatcher::GroupMask groups = routed ? block->groups[line++] : 1;
+                for (size_t i = 0; i < writers_.size(); ++i) {
+                    if (groups >> i & 1) writers_[i]->writeLine(text, true);
+                }
+                p = nl + 1;
+            }
+            for (OutputWriter* writer : writers_) {
+                writer->endOfBuffer();
+            }
+
+            lines_ += block->lines;
+            longLines_ += block->longLines;
+            matched_ += block->matched;
+            freeRing_.tryPush(block);
+
+            next = (next + 1) % rings;
+            backoff.reset();
+            waiting = false;
+            continue;
+        }
+        // the block for `next` can only still come if its matcher is running
+        if (matchersDone_.load(std::memory_order_acquire) == rings &&
+            writeRings_[next]->size() == 0) {
+            break;
+        }
+        if (!waiting) {
+            writerStalls_++;
+            waiting = true;
+        }
+        for (OutputWriter* writer : writers_) {
+            writer->tick();  // interval policy while idle
+        }
+        backoff.pause();
+    }
+}
+
+/**
+ * @brief processLine() rules over a block, matches compacted to the front
+ *
+ * A matched line is moved to outLen and followed by '\n'. The destination
+ * never passes the source, and the '\n' lands inside the current line
+ * (or on its own '\n'), so unread lines are never overwritten. Routed,
+ * the groups from the same matcher pass are kept in block.groups.
+ */
+void Pipeline::matchBlock(Block& block) const {
+    char* data = block.data;
+    const char* p = data;
+    const char* end = data + block.len;
+    size_t out = 0;
+    block.lines = 0;
+    block.longLines = 0;
+    block.matched = 0;
+    block.groups.clear();  // keeps its capacity across reuse
+    const bool routed = writers_.size() > 1;
+
+    while (p < end) {
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        std::string_view line(p, nl - p);
+        const char* lineStart = p;
+        p = nl + 1;
+
+        if (line.empty()) continue;
+        block.lines++;
+        if (line.size() > options_.maxLineLength) {
+            line = line.substr(0, options_.maxLineLength);
+            block.longLines++;
+        }
+        const FieldFilter* filter = options_.filter;
+        if (routed) {
+            KeywordMatcher::GroupMask groups = matcher_->matchGroups(line);
+            if (filter && (groups & 1) && !filter->evaluate(line)) {
+                groups &= ~KeywordMatcher::GroupMask(1);
+            }
+            if (!groups) continue;
+            block.groups.push_back(groups);
+        } else if (!matcher_->matches(line) || (filter && !filter->evaluate(line))) {
+            continue;
+        }
+
+        if (data + out != lineStart) {
+            std::memmove(data + out, lineStart, line.size());
+        }
+        out += line.size();
+        data[out++] = '\n';
+        block.matched++;
+    }
+    block.outLen = out;
+}
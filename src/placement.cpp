@@ -0,0 +1,84 @@
+/**
+ * @file placement.cpp
+ * @brief Linux sched_setaffinity / getcpu wrappers
+ * @author Nicholas Loo
+ * @date 14/10/26
+ */
+
+#include "placement.h"
+
+#if defined(__linux__)
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+#if defined(__linux__)
+namespace {
+
+/// Affinity at startup: once a thread is pinned its own mask is one CPU,
+/// and threads it starts inherit that, so later checks can't ask the kernel
+const cpu_set_t g_startupMask = [] {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    sched_getaffinity(0, sizeof(set), &set);
+    return set;
+}();
+
+} // namespace
+#endif
+
+bool cpuAllowed(int cpu) {
+#if defined(__linux__)
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+    return CPU_ISSET(cpu, &g_startupMask);
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+bool pinCurrentThread(int cpu) {
+#if defined(__linux__)
+    if (!cpuAllowed(cpu)) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;  // 0 = calling thread
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+int currentNumaNode() {
+#if defined(__linux__) && defined(SYS_getcpu)
+    // raw syscall: the glibc getcpu() wrapper is newer than 22.04's baseline
+    unsigned cpu = 0, node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) return -1;
+    return static_cast<int>(node);
+#else
+    return -1;
+#endif
+}
+
+ScopedPin::ScopedPin(int cpu) {
+#if defined(__linux__)
+    if (cpu < 0) return;
+    CPU_ZERO(&mask_);
+    saved_ = sched_getaffinity(0, sizeof(mask_), &mask_) == 0;
+    if (saved_ && !pinCurrentThread(cpu)) {
+        saved_ = false;  // nothing changed, nothing to restore
+    }
+#else
+    (void)cpu;
+#endif
+}
+
+ScopedPin::~ScopedPin() {
+#if defined(__linux__)
+    if (saved_) {
+        sched_setaffinity(0, sizeof(mask_), &mask_);
+    }
+#endif
+}
@@ -0,0 +1,39 @@
+/**
+ * @file rate_tracker.cpp
+ * @brief Implementation of the RateTracker class
+ * @author Nicholas Loo
+ * @date 14/10/26
+ */
+
+#include "rate_tracker.h"
+
+RateTracker::RateTracker(Clock::duration window)
+    : window_(window) {}
+
+/**
+ * @brief Appends a sample, trims to the window, computes rates
+ *
+ * One sample just outside the window is kept so the covered time stays
+ * close to the full window between polls.
+ */
+RateTracker::Rates RateTracker::sample(uint64_t lines, uint64_t bytes, uint64_t matches,
+                                       Clock::time_point now) {
+    samples_.push_back({now, lines, bytes, matches});
+    while (samples_.size() > 2 && now - samples_[1].time >= window_) {
+        samples_.pop_front();
+    }
+
+    Rates rates;
+    const Sample& oldest = samples_.front();
+    const Sample& newest = samples_.back();
+    double seconds = std::chrono::duration<double>(newest.time - oldest.time).count();
+    if (seconds <= 0) {
+        return rates;
+    }
+
+    rates.windowSec = seconds;
+    rates.linesPerSec = static_cast<double>(newest.lines - oldest.lines) / seconds;
+    rates.bytesPerSec = static_cast<double>(newest.bytes - oldest.bytes) / seconds;
+    rates.matchesPerSec = static_cast<double>(newest.matches - oldest.matches) / seconds;
+    return rates;
+}
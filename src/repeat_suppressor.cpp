@@ -0,0 +1,135 @@
+/**
+ * @file repeat_suppressor.cpp
+ * @brief Implementation of RepeatSuppressor
+ * @author Nicholas Loo
+ * @date 14/10/26
+ */
+
+#include "repeat_suppressor.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+namespace {
+
+constexpr std::string_view SUMMARY_PREFIX = "repeated ";
+constexpr std::string_view SUMMARY_INFIX = " times: ";
+constexpr size_t SUMMARY_BYTES = 64 + RepeatSuppressor::SAMPLE_BYTES;
+
+} // namespace
+
+RepeatSuppressor::RepeatSuppressor(size_t limit, uint64_t windowMs, size_t slots, Arena& arena)
+    : mask_(tableSize(slots) - 1),
+      limit_(std::max<size_t>(limit, 1)),
+      windowMs_(std::max<uint64_t>(windowMs, 1)),
+      start_(Clock::now()) {
+    const size_t size = tableSize(slots);
+    slots_ = reinterpret_cast<Slot*>(arena.allocate(size * sizeof(Slot)));
+    std::memset(static_cast<void*>(slots_), 0, size * sizeof(Slot));  // arena memory isn't zeroed
+    samples_ = arena.allocate(size * SAMPLE_BYTES);
+    summary_ = arena.allocate(SUMMARY_BYTES);
+}
+
+bool RepeatSuppressor::admit(std::string_view line, OutputWriter& out) {
+    const uint64_t hash = templateHash(line);
+    Slot* reusable = nullptr;
+    Slot* slot = nullptr;
+    for (size_t probe = 0; probe < MAX_PROBES; ++probe) {
+        Slot& candidate = slots_[(hash + probe) & mask_];
+        if (candidate.hash == hash) {
+            slot = &candidate;
+            break;
+        }
+        if (!reusable && (candidate.hash == 0 || expired(candidate))) {
+            reusable = &candidate;
+        }
+        if (candidate.hash == 0) break;  // end of the chain, hash isn't further on
+    }
+    if (!slot) {
+        if (!reusable) return true;  // table congested here: don't track, just write
+        if (reusable->count > limit_) summarise(*reusable, out);
+        slot = reusable;
+        slot->hash = hash;
+        slot->count = 0;
+    }
+
+    if (expired(*slot)) {
+        if (slot->count > limit_) summarise(*slot, out);
+        slot->windowStart = now_;
+        slot->count = 0;
+    }
+    if (++slot->count <= limit_) {
+        return true;
+    }
+    if (slot->count == limit_ + 1) {
+        slot->sampleLength = static_cast<uint32_t>(std::min(line.size(), SAMPLE_BYTES));
+        std::memcpy(samples_ + (slot - slots_) * SAMPLE_BYTES, line.data(), slot->sampleLength);
+    }
+    ++suppressed_;
+    return false;
+}
+
+void RepeatSuppressor::tick(Clock::time_point now, OutputWriter& out) {
+    now_ = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(now - start_).count());
+    if (now_ - lastSweep_ < windowMs_) return;
+    lastSweep_ = now_;
+    for (size_t i = 0; i <= mask_; ++i) {
+        Slot& slot = slots_[i];
+        if (slot.count > limit_ && expired(slot)) summarise(slot, out);
+    }
+}
+
+void RepeatSuppressor::finish(OutputWriter& out) {
+    for (size_t i = 0; i <= mask_; ++i) {
+        Slot& slot = slots_[i];
+        if (slot.count > limit_) summarise(slot, out);
+    }
+}
+
+/**
+ * @brief FNV-1a over the line, a digit run hashed as one '#'
+ *
+ * Timestamps, ids, prices and quantities all collapse, "Price=123.45" is
+ * "Price=#.#" whatever the price.
+ */
+uint64_t RepeatSuppressor::templateHash(std::string_view line) {
+    uint64_t hash = 14695981039346656037ull;
+    bool inDigits = false;
+    for (char c : line) {
+        const bool digit = c >= '0' && c <= '9';
+        if (digit && inDigits) continue;
+        inDigits = digit;
+        hash ^= static_cast<unsigned char>(digit ? '#' : c);
+        hash *= 1099511628211ull;
+    }
+    return hash == 0 ? 1 : hash;  // 0 marks a free slot
+}
+
+size_t RepeatSuppressor::arenaBytes(size_t slots) {
+    const size_t size = tableSize(slots);
+    return Arena::footprint(size * sizeof(Slot)) + Arena::footprint(size * SAMPLE_BYTES) +
+           Arena::footprint(SUMMARY_BYTES);
+}
+
+size_t RepeatSuppressor::tableSize(size_t slots) {
+    size_t size = 1;
+    while (size < slots) size <<= 1;
+    return size;
+}
+
+/**
+ * @brief Writes "repeated K times: <sample>" and closes the slot's window
+ */
+void RepeatSuppressor::summarise(Slot& slot, OutputWriter& out) {
+    char* p = summary_;
+    std::memcpy(p, SUMMARY_PREFIX.data(), SUMMARY_PREFIX.size());
+    p += SUMMARY_PREFIX.size();
+    p = std::to_chars(p, summary_ + SUMMARY_BYTES, slot.count - limit_).ptr;
+    std::memcpy(p, SUMMARY_INFIX.data(), SUMMARY_INFIX.size());
+    p += SUMMARY_INFIX.size();
+    std::memcpy(p, samples_ + (&slot - slots_) * SAMPLE_BYTES, slot.sampleLength);
+    p += slot.sampleLength;
+    out.writeLine(std::string_view(summary_, p - summary_));  // copied: summary_ is reused
+    slot.count = 0;
+}
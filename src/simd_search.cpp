@@ -0,0 +1,449 @@
+/**
+ * @file simd_search.cpp
+ * @brief SSE2 / AVX2 / NEON substring search kernels and CPU dispatch
+ * @author Nicholas Loo
+ * @date 14/10/26
+ */
+
+#include "simd_search.h"
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SIMD_SEARCH_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define SIMD_SEARCH_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace simd {
+
+namespace {
+
+constexpr size_t npos = std::string_view::npos;
+
+/**
+ * @brief ASCII lower case, other bytes unchanged
+ */
+inline char foldByte(char c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c | 0x20) : c;
+}
+
+/**
+ * @brief OR mask that folds byte c in a vector compare: 0x20 for letters
+ *
+ * For a lower case letter c, (x | 0x20) == c only holds for x = c and its
+ * upper case, so the folded first / last byte test stays exact.
+ */
+inline char foldBit(char c) {
+    return c >= 'a' && c <= 'z' ? 0x20 : 0;
+}
+
+/**
+ * @brief Compares k bytes, ASCII case-insensitive; b is already lower case
+ */
+inline bool equalsFolded(const char* a, const char* b, size_t k) {
+    for (size_t i = 0; i < k; ++i) {
+        if (foldByte(a[i]) != b[i]) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Portable path, also used for haystack tails shorter than a vector
+ */
+size_t scalarFind(const char* haystack, size_t n, const char* needle, size_t k) {
+    return std::string_view(haystack, n).find(std::string_view(needle, k));
+}
+
+/**
+ * @brief Case-insensitive portable path; needle is lower case
+ */
+size_t scalarFindFolded(const char* haystack, size_t n, const char* needle, size_t k) {
+    if (k == 0) return 0;
+    if (k > n) return npos;
+    for (size_t i = 0; i + k <= n; ++i) {
+        if (foldByte(haystack[i]) == needle[0] && equalsFolded(haystack + i + 1, needle + 1, k - 1)) {
+            return i;
+        }
+    }
+    return npos;
+}
+
+/**
+ * @brief Scalar path matching the kernel's case handling
+ */
+template <bool Fold>
+inline size_t scalarFor(const char* haystack, size_t n, const char* needle, size_t k) {
+    return Fold ? scalarFindFolded(haystack, n, needle, k) : scalarFind(haystack, n, needle, k);
+}
+
+/**
+ * @brief Verifies candidate bits of a match mask
+ *
+ * First and last bytes are already known to match, so only the k-2 bytes in
+ * between are compared (folded when Fold).
+ *
+ * @param bitsPerByte 1 for movemask based masks, 4 for the NEON nibble mask
+ */
+template <bool Fold, typename Mask>
+inline size_t verifyCandidates(Mask mask, unsigned bitsPerByte, const char* block,
+                               const char* needle, size_t k) {
+    while (mask) {
+        unsigned bit = static_cast<unsigned>(__builtin_ctzll(mask)) / bitsPerByte;
+        if (k <= 2 || (Fold ? equalsFolded(block + bit + 1, needle + 1, k - 2)
+                            : std::memcmp(block + bit + 1, needle + 1, k - 2) == 0)) {
+            return bit;
+        }
+        // clear every bit belonging to this byte
+        if (bitsPerByte == 1) {
+            mask &= mask - 1;
+        } else {
+            mask &= ~(static_cast<Mask>(0xF) << (bit * 4));
+        }
+    }
+    return npos;
+}
+
+/**
+ * @brief Running state of a line count across vector blocks
+ */
+struct LineCounter {
+    LineCounts counts;
+    size_t lineStart = 0;  ///< Offset of the first byte of the current line
+    size_t maxLineLength;
+
+    explicit LineCounter(size_t maxLen) : maxLineLength(maxLen) {}
+
+    /// Accounts for the line ending at the newline at offset pos
+    inline void newline(size_t pos) {
+        size_t len = pos - lineStart;
+        counts.lines += len != 0;
+        counts.longLines += len > maxLineLength;
+        lineStart = pos + 1;
+    }
+
+    /// Walks the set bits of a newline mask for the block at base
+    template <typename Mask>
+    inline void consume(Mask mask, unsigned bitsPerByte, size_t base) {
+        while (mask) {
+            unsigned bit = static_cast<unsigned>(__builtin_ctzll(mask)) / bitsPerByte;
+            newline(base + bit);
+            if (bitsPerByte == 1) {
+                mask &= mask - 1;
+            } else {
+                mask &= ~(static_cast<Mask>(0xF) << (bit * 4));
+            }
+        }
+    }
+};
+
+LineCounts scalarCountLines(const char* data, size_t n, size_t maxLineLength) {
+    LineCounter counter(maxLineLength);
+    const char* p = data;
+    const char* end = data + n;
+    while (p < end) {
+        const void* nl = std::memchr(p, '\n', static_cast<size_t>(end - p));
+        if (!nl) break;
+        const char* at = static_cast<const char*>(nl);
+        counter.newline(static_cast<size_t>(at - data));
+        p = at + 1;
+    }
+    return counter.counts;
+}
+
+#if defined(SIMD_SEARCH_X86)
+
+LineCounts sse2CountLines(const char* data, size_t n, size_t maxLineLength) {
+    LineCounter counter(maxLineLength);
+    const __m128i nl = _mm_set1_epi8('\n');
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, nl)));
+        counter.consume(mask, 1, i);
+    }
+    for (; i < n; ++i) {
+        if (data[i] == '\n') counter.newline(i);
+    }
+    return counter.counts;
+}
+
+__attribute__((target("avx2")))
+LineCounts avx2CountLines(const char* data, size_t n, size_t maxLineLength) {
+    LineCounter counter(maxLineLength);
+    const __m256i nl = _mm256_set1_epi8('\n');
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, nl)));
+        counter.consume(mask, 1, i);
+    }
+    for (; i < n; ++i) {
+        if (data[i] == '\n') counter.newline(i);
+    }
+    return counter.counts;
+}
+
+/**
+ * @brief Candidate mask for the 16 start positions at p
+ *
+ * Fold: the block bytes are ORed with the needle's fold bits first.
+ */
+template <bool Fold>
+inline uint32_t sse2Candidates(const char* p, size_t k, __m128i first, __m128i last,
+                               __m128i foldFirst, __m128i foldLast) {
+    __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + k - 1));
+    if (Fold) {
+        blockFirst = _mm_or_si128(blockFirst, foldFirst);
+        blockLast = _mm_or_si128(blockLast, foldLast);
+    }
+    return static_cast<uint32_t>(_mm_movemask_epi8(
+        _mm_and_si128(_mm_cmpeq_epi8(first, blockFirst), _mm_cmpeq_epi8(last, blockLast))));
+}
+
+template <bool Fold>
+size_t sse2Find(const char* haystack, size_t n, const char* needle, size_t k) {
+    // end = number of valid start positions; both loads of a block must fit
+    if (k < 2 || n < k - 1 + 16) return scalarFor<Fold>(haystack, n, needle, k);
+    const size_t end = n - (k - 1);
+
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[k - 1]);
+    const __m128i foldFirst = _mm_set1_epi8(Fold ? foldBit(needle[0]) : 0);
+    const __m128i foldLast = _mm_set1_epi8(Fold ? foldBit(needle[k - 1]) : 0);
+
+    size_t i = 0;
+    for (; i + 16 <= end; i += 16) {
+        uint32_t mask = sse2Candidates<Fold>(haystack + i, k, first, last, foldFirst, foldLast);
+        if (mask) {
+            size_t hit = verifyCandidates<Fold>(mask, 1, haystack + i, needle, k);
+            if (hit != npos) return i + hit;
+        }
+    }
+
+    // tail: one overlapping block ending exactly at end, already checked
+    // positions masked off, so there is no scalar loop
+    if (i < end) {
+        const size_t tail = end - 16;
+        uint32_t mask = sse2Candidates<Fold>(haystack + tail, k, first, last, foldFirst, foldLast) & (~0u << (i - tail));
+        if (mask) {
+            size_t hit = verifyCandidates<Fold>(mask, 1, haystack + tail, needle, k);
+            if (hit != npos) return tail + hit;
+        }
+    }
+    return npos;
+}
+
+template <bool Fold>
+__attribute__((target("avx2")))
+inline uint32_t avx2Candidates(const char* p, size_t k, __m256i first, __m256i last,
+                               __m256i foldFirst, __m256i foldLast) {
+    __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    __m256i blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + k - 1));
+    if (Fold) {
+        blockFirst = _mm256_or_si256(blockFirst, foldFirst);
+        blockLast = _mm256_or_si256(blockLast, foldLast);
+    }
+    return static_cast<uint32_t>(_mm256_movemask_epi8(
+        _mm256_and_si256(_mm256_cmpeq_epi8(first, blockFirst), _mm256_cmpeq_epi8(last, blockLast))));
+}
+
+template <bool Fold>
+__attribute__((target("avx2")))
+size_t avx2Find(const char* haystack, size_t n, const char* needle, size_t k) {
+    if (k < 2 || n < k - 1 + 32) return sse2Find<Fold>(haystack, n, needle, k);
+    const size_t end = n - (k - 1);
+
+    const __m256i first = _mm256_set1_epi8(needle[0]);
+    const __m256i last = _mm256_set1_epi8(needle[k - 1]);
+    const __m256i foldFirst = _mm256_set1_epi8(Fold ? foldBit(needle[0]) : 0);
+    const __m256i foldLast = _mm256_set1_epi8(Fold ? foldBit(needle[k - 1]) : 0);
+
+    size_t i = 0;
+    // 2x unrolled: one branch per 64 bytes on lines with no candidates
+    for (; i + 64 <= end; i += 64) {
+        uint32_t lo = avx2Candidates<Fold>(haystack + i, k, first, last, foldFirst, foldLast);
+        uint32_t hi = avx2Candidates<Fold>(haystack + i + 32, k, first, last, foldFirst, foldLast);
+        if (lo | hi) {
+            uint64_t mask = (static_cast<uint64_t>(hi) << 32) | lo;
+            size_t hit = verifyCandidates<Fold>(mask, 1, haystack + i, needle, k);
+            if (hit != npos) return i + hit;
+        }
+    }
+    for (; i + 32 <= end; i += 32) {
+        uint32_t mask = avx2Candidates<Fold>(haystack + i, k, first, last, foldFirst, foldLast);
+        if (mask) {
+            size_t hit = verifyCandidates<Fold>(mask, 1, haystack + i, needle, k);
+            if (hit != npos) return i + hit;
+        }
+    }
+    if (i < end) {
+        const size_t tail = end - 32;
+        uint32_t mask = avx2Candidates<Fold>(haystack + tail, k, first, last, foldFirst, foldLast) & (~0u << (i - tail));
+        if (mask) {
+            size_t hit = verifyCandidates<Fold>(mask, 1, haystack + tail, needle, k);
+            if (hit != npos) return tail + hit;
+        }
+    }
+    return npos;
+}
+
+#endif // SIMD_SEARCH_X86
+
+#if defined(SIMD_SEARCH_NEON)
+
+template <bool Fold>
+inline uint64_t neonCandidates(const char* p, size_t k, uint8x16_t first, uint8x16_t last,
+                               uint8x16_t foldFirst, uint8x16_t foldLast) {
+    uint8x16_t blockFirst = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+    uint8x16_t blockLast = vld1q_u8(reinterpret_cast<const uint8_t*>(p + k - 1));
+    if (Fold) {
+        blockFirst = vorrq_u8(blockFirst, foldFirst);
+        blockLast = vorrq_u8(blockLast, foldLast);
+    }
+    const uint8x16_t eq = vandq_u8(vceqq_u8(first, blockFirst), vceqq_u8(last, blockLast));
+    // no movemask on NEON: narrow to 4 bits per byte in a 64-bit lane
+    return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+}
+
+LineCounts neonCountLines(const char* data, size_t n, size_t maxLineLength) {
+    LineCounter counter(maxLineLength);
+    const uint8x16_t nl = vdupq_n_u8('\n');
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const uint8x16_t eq = vceqq_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(data + i)), nl);
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+        counter.consume(mask, 4, i);
+    }
+    for (; i < n; ++i) {
+        if (data[i] == '\n') counter.newline(i);
+    }
+    return counter.counts;
+}
+
+template <bool Fold>
+size_t neonFind(const char* haystack, size_t n, const char* needle, size_t k) {
+    if (k < 2 || n < k - 1 + 16) return scalarFor<Fold>(haystack, n, needle, k);
+    const size_t end = n - (k - 1);
+
+    const uint8x16_t first = vdupq_n_u8(static_cast<uint8_t>(needle[0]));
+    const uint8x16_t last = vdupq_n_u8(static_cast<uint8_t>(needle[k - 1]));
+    const uint8x16_t foldFirst = vdupq_n_u8(static_cast<uint8_t>(Fold ? foldBit(needle[0]) : 0));
+    const uint8x16_t foldLast = vdupq_n_u8(static_cast<uint8_t>(Fold ? foldBit(needle[k - 1]) : 0));
+
+    size_t i = 0;
+    for (; i + 16 <= end; i += 16) {
+        uint64_t mask = neonCandidates<Fold>(haystack + i, k, first, last, foldFirst, foldLast);
+        if (mask) {
+            size_t hit = verifyCandidates<Fold>(mask, 4, haystack + i, needle, k);
+            if (hit != npos) return i + hit;
+        }
+    }
+    if (i < end) {
+        const size_t tail = end - 16;
+        uint64_t mask = neonCandidates<Fold>(haystack + tail, k, first, last, foldFirst, foldLast) & (~0ull << ((i - tail) * 4));
+        if (mask) {
+            size_t hit = verifyCandidates<Fold>(mask, 4, haystack + tail, needle, k);
+            if (hit != npos) return tail + hit;
+        }
+    }
+    return npos;
+}
+
+#endif // SIMD_SEARCH_NEON
+
+} // namespace
+
+bool isSupported(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::Scalar:
+            return true;
+#if defined(SIMD_SEARCH_X86)
+        case Kernel::SSE2:
+            return __builtin_cpu_supports("sse2");
+        case Kernel::AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+#if defined(SIMD_SEARCH_NEON)
+        case Kernel::NEON:
+            return true;  // mandatory on AArch64
+#endif
+        default:
+            return false;
+    }
+}
+
+Kernel bestKernel() {
+    static const Kernel best = [] {
+        for (Kernel k : {Kernel::AVX2, Kernel::NEON, Kernel::SSE2}) {
+            if (isSupported(k)) return k;
+        }
+        return Kernel::Scalar;
+    }();
+    return best;
+}
+
+SearchFn searchFunction(Kernel kernel) {
+    switch (kernel) {
+#if defined(SIMD_SEARCH_X86)
+        case Kernel::SSE2:
+            return sse2Find<false>;
+        case Kernel::AVX2:
+            return avx2Find<false>;
+#endif
+#if defined(SIMD_SEARCH_NEON)
+        case Kernel::NEON:
+            return neonFind<false>;
+#endif
+        default:
+            return scalarFind;
+    }
+}
+
+SearchFn searchFunctionIgnoreCase(Kernel kernel) {
+    switch (kernel) {
+#if defined(SIMD_SEARCH_X86)
+        case Kernel::SSE2:
+            return sse2Find<true>;
+        case Kernel::AVX2:
+            return avx2Find<true>;
+#endif
+#if defined(SIMD_SEARCH_NEON)
+        case Kernel::NEON:
+            return neonFind<true>;
+#endif
+        default:
+            return scalarFindFolded;
+    }
+}
+
+LineCountFn lineCountFunction(Kernel kernel) {
+    switch (kernel) {
+#if defined(SIMD_SEARCH_X86)
+        case Kernel::SSE2:
+            return sse2CountLines;
+        case Kernel::AVX2:
+            return avx2CountLines;
+#endif
+#if defined(SIMD_SEARCH_NEON)
+        case Kernel::NEON:
+            return neonCountLines;
+#endif
+        default:
+            return scalarCountLines;
+    }
+}
+
+const char* kernelName(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::SSE2: return "sse2";
+        case Kernel::AVX2: return "avx2";
+        case Kernel::NEON: return "neon";
+        default:           return "scalar";
+    }
+}
+
+} // namespace simd
@@ -0,0 +1,76 @@
+/**
+ * @file stage_tracer.cpp
+ * @brief Implementation of StageTracer
+ * @author Nicholas Loo
+ * @date 14/10/26
+ */
+
+#include "stage_tracer.h"
+
+#include <cstdio>
+
+StageTracer::StageTracer()
+    : startTicks_(now()), startTime_(std::chrono::steady_clock::now()) {}
+
+double StageTracer::ticksPerNs() const {
+#if defined(__x86_64__) || defined(__i386__)
+    const double ns = std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - startTime_).count();
+    return ns > 0 ? static_cast<double>(now() - startTicks_) / ns : 1.0;
+#else
+    return 1.0;
+#endif
+}
+
+const char* StageTracer::stageName(Stage stage) {
+    switch (stage) {
+        case Stage::Read: return "read";
+        case Stage::Buffer: return "buffer";
+        case Stage::Match: return "  match";
+        case Stage::Write: return "  write";
+        case Stage::Flush: return "flush";
+        case Stage::Idle: return "idle";
+        default: return "?";
+    }
+}
+
+/**
+ * @brief One row per stage; match/write are part of buffer and indented
+ *
+ * Sampled stages are scaled by SAMPLE_EVERY for the total. Share is of
+ * the wall time since the tracer was created.
+ */
+std::string StageTracer::report() const {
+    const double perNs = ticksPerNs();
+    const double elapsedMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - startTime_).count();
+
+    std::string out;
+    char row[160];
+    std::snprintf(row, sizeof(row), "%-8s %12s %10s %10s %10s %10s %6s\n",
+                  "stage", "count", "p50 ns", "p99 ns", "max ns", "total ms", "share");
+    out += row;
+    for (size_t i = 0; i < STAGES; ++i) {
+        const Stage stage = static_cast<Stage>(i);
+        const LatencyHistogram& h = stages_[i];
+        const bool sampled = stage == Stage::Match || stage == Stage::Write;
+        const double totalMs = h.mean() * h.count() * (sampled ? SAMPLE_EVERY : 1) / perNs / 1e6;
+        std::snprintf(row, sizeof(row), "%-8s %12llu %10.0f %10.0f %10.0f %10.1f %5.1f%%",
+                      stageName(stage), static_cast<unsigned long long>(h.count()),
+                      h.percentile(50) / perNs, h.percentile(99) / perNs, h.max() / perNs,
+                      totalMs, elapsedMs > 0 ? 100.0 * totalMs / elapsedMs : 0.0);
+        out += row;
+        if (sampled) {
+            std::snprintf(row, sizeof(row), " (1 in %u lines)", SAMPLE_EVERY);
+            out += row;
+        }
+        out += '\n';
+    }
+    std::snprintf(row, sizeof(row), "reads: p50 %llu B, p99 %llu B; loops: %llu busy, %llu idle\n",
+                  static_cast<unsigned long long>(readSizes_.percentile(50)),
+                  static_cast<unsigned long long>(readSizes_.percentile(99)),
+                  static_cast<unsigned long long>(busyLoops_),
+                  static_cast<unsigned long long>(idleLoops_));
+    out += row;
+    return out;
+}
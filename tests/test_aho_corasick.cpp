@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include "aho_corasick.h"
+#include <random>
+
+TEST(AhoCorasickTest, FindsAnyPattern) {
+    AhoCorasick ac({"REJECT", "FILL", "ERROR"});
+    EXPECT_TRUE(ac.contains("[ts] FILL OrderID=1"));
+    EXPECT_TRUE(ac.contains("prefix ERROR"));
+    EXPECT_TRUE(ac.contains("REJECT"));
+    EXPECT_FALSE(ac.contains("EXECUTION OrderID=1 Symbol=AAPL"));
+    EXPECT_FALSE(ac.contains(""));
+}
+
+TEST(AhoCorasickTest, FollowsFailureLinks) {
+    // "abcd" fails after "abc", must fall back into "bce" without rescanning
+    AhoCorasick ac({"abcd", "bce"});
+    EXPECT_TRUE(ac.contains("xabcex"));
+    EXPECT_FALSE(ac.contains("abcabc"));
+
+    // pattern that is a suffix of another pattern's prefix
+    AhoCorasick nested({"she", "he", "hers"});
+    EXPECT_TRUE(nested.contains("ushe"));
+    EXPECT_TRUE(nested.contains("xhx he"));
+    EXPECT_FALSE(nested.contains("shx"));
+}
+
+TEST(AhoCorasickTest, CompactsAlphabet) {
+    AhoCorasick ac({"AB", "BA"});
+    // 2 distinct bytes + the "other" class
+    EXPECT_EQ(ac.classCount(), 3u);
+    EXPECT_EQ(ac.stateCount(), 5u);
+}
+
+TEST(AhoCorasickTest, EmptyPatternSetAndEmptyPattern) {
+    AhoCorasick none({});
+    EXPECT_FALSE(none.contains("anything"));
+
+    // mirrors std::string_view::find("") which always succeeds
+    AhoCorasick empty({""});
+    EXPECT_TRUE(empty.contains("anything"));
+}
+
+TEST(AhoCorasickTest, CollectsMasksOfAllPatternsFound) {
+    AhoCorasick ac({"she", "he", "hers", "FILL"}, {1, 2, 4, 8});
+    // "he" ends inside "she"; both are reported from one walk
+    EXPECT_EQ(ac.collect("ushers", 15), 1u | 2u | 4u);
+    EXPECT_EQ(ac.collect("a FILL then he", 15), 8u | 2u);
+    EXPECT_EQ(ac.collect("nothing", 15), 0u);
+
+    // stops as soon as every bit is in: "hers" isn't reached
+    EXPECT_EQ(ac.collect("FILL she hers", 1 | 2 | 8), 1u | 2u | 8u);
+
+    // without masks every pattern is bit 0
+    AhoCorasick plain({"REJECT", "FILL"});
+    EXPECT_EQ(plain.collect("FILL", 1), 1u);
+    EXPECT_EQ(AhoCorasick({"", "x"}, {2, 4}).collect("abc", 6), 2u);
+}
+
+TEST(AhoCorasickTest, IgnoreCaseFoldsTheClassMap) {
+    AhoCorasick ac({"Error", "REJECT"}, {1, 2}, true);
+    EXPECT_TRUE(ac.contains("an ERROR here"));
+    EXPECT_TRUE(ac.contains("order rejected"));
+    EXPECT_FALSE(ac.contains("err0r"));
+    EXPECT_EQ(ac.findEnd("xx error"), 7u);
+    EXPECT_EQ(ac.collect("Reject then eRRor", 3), 3u);
+
+    // folding adds no classes for the upper case letters
+    EXPECT_EQ(ac.classCount(), AhoCorasick({"error", "reject"}).classCount());
+}
+
+TEST(AhoCorasickTest, WholeWordChecksBoundariesOnHits) {
+    AhoCorasick ac({"key", "ERROR", "Symbol="}, {1, 2, 4}, false, true);
+    EXPECT_TRUE(ac.contains("key"));
+    EXPECT_TRUE(ac.contains("the key, again"));
+    EXPECT_FALSE(ac.contains("monkey keys key_1 key2"));
+    EXPECT_TRUE(ac.contains("(ERROR)"));
+    EXPECT_FALSE(ac.contains("ERRORS"));
+
+    // a punctuation edge needs no boundary on its side ("=N" is fine)
+    EXPECT_TRUE(ac.contains("[Symbol=NVDA"));
+    EXPECT_FALSE(ac.contains("xSymbol=NVDA"));
+    EXPECT_FALSE(ac.contains("xSymbolic"));
+
+    // a word suffix of a longer hit is still found: "key" in "a-key" after "monkey"
+    EXPECT_EQ(ac.findEnd("monkey a-key"), 11u);
+    EXPECT_EQ(ac.collect("monkey ERROR Symbol=X", 7), 6u);
+
+    // both together
+    AhoCorasick both({"error"}, {}, true, true);
+    EXPECT_TRUE(both.contains("[Error]"));
+    EXPECT_FALSE(both.contains("Errors"));
+}
+
+TEST(AhoCorasickTest, AgreesWithLinearSearch) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> ch('a', 'd');
+    std::uniform_int_distribution<int> len(1, 4);
+
+    for (int round = 0; round < 200; ++round) {
+        std::vector<std::string> patterns(5);
+        for (auto& p : patterns) {
+            int n = len(rng);
+            for (int i = 0; i < n; ++i) p += static_cast<char>(ch(rng));
+        }
+        AhoCorasick ac(patterns);
+
+        std::string text;
+        for (int i = 0; i < 30; ++i) text += static_cast<char>(ch(rng));
+
+        bool expected = false;
+        for (const auto& p : patterns) {
+            expected |= text.find(p) != std::string::npos;
+        }
+        EXPECT_EQ(ac.contains(text), expected) << text;
+    }
+}
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include "checkpoint.h"
+#include <fstream>
+#include <chrono>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+class CheckpointTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto now = std::chrono::system_clock::now().time_since_epoch().count();
+        path_ = "test_checkpoint_" + std::to_string(now) + "_" + std::to_string(rand()) + ".ckpt";
+    }
+
+    void TearDown() override {
+        fs::remove(path_);
+        fs::remove(path_ + ".tmp");
+    }
+
+    std::string path_;
+};
+
+TEST_F(CheckpointTest, SaveLoadRoundTrip) {
+    Checkpoint saved;
+    saved.device = 2049;
+    saved.inode = 1234567;
+    saved.inputOffset = 500ULL * 1024 * 1024 * 1024;  // 500GB
+    saved.tailLength = Checkpoint::TAIL_BYTES;
+    saved.tailHash = Checkpoint::hashTail("line\n", 5);
+    saved.outputOffset = 987654321;
+    ASSERT_TRUE(saved.save(path_));
+    EXPECT_FALSE(fs::exists(path_ + ".tmp"));
+
+    Checkpoint loaded;
+    ASSERT_TRUE(Checkpoint::load(path_, loaded));
+    EXPECT_EQ(loaded.device, saved.device);
+    EXPECT_EQ(loaded.inode, saved.inode);
+    EXPECT_EQ(loaded.inputOffset, saved.inputOffset);
+    EXPECT_EQ(loaded.tailLength, saved.tailLength);
+    EXPECT_EQ(loaded.tailHash, saved.tailHash);
+    EXPECT_EQ(loaded.outputOffset, saved.outputOffset);
+    EXPECT_TRUE(loaded.routeOffsets.empty());
+
+    saved.routeOffsets = {10, 0, 42};
+    ASSERT_TRUE(saved.save(path_));
+    ASSERT_TRUE(Checkpoint::load(path_, loaded));
+    EXPECT_EQ(loaded.routeOffsets, saved.routeOffsets);
+}
+
+TEST_F(CheckpointTest, RejectsMissingOrMalformed) {
+    Checkpoint loaded;
+    EXPECT_FALSE(Checkpoint::load(path_, loaded));
+
+    std::ofstream(path_) << "something else\ninput_offset=5\n";
+    EXPECT_FALSE(Checkpoint::load(path_, loaded));
+
+    // header ok but fields missing
+    std::ofstream(path_) << "log_monitor checkpoint v1\ninput_offset=5\n";
+    EXPECT_FALSE(Checkpoint::load(path_, loaded));
+}
+
+TEST_F(CheckpointTest, TailHashDistinguishesContent) {
+    EXPECT_EQ(Checkpoint::hashTail("abc", 3), Checkpoint::hashTail("abc", 3));
+    EXPECT_NE(Checkpoint::hashTail("abc", 3), Checkpoint::hashTail("abd", 3));
+    EXPECT_NE(Checkpoint::hashTail("abc", 3), Checkpoint::hashTail("abc", 2));
+}
@@ -0,0 +1,244 @@
+#include <gtest/gtest.h>
+#include "compressed_input.h"
+#include "log_monitor.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#if LOG_MONITOR_GZIP
+#include <zlib.h>
+#endif
+#if LOG_MONITOR_ZSTD
+#include <zstd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+/// Lines "line N EXECUTION" every 3rd line, "line N other" otherwise; noise
+/// adds a pseudo-random field so the compressed file spans several input chunks
+std::string makeLog(int lines, bool noise = false) {
+    std::ostringstream out;
+    uint64_t x = 88172645463325252ull;
+    for (int i = 0; i < lines; ++i) {
+        out << "line " << i << (i % 3 == 0 ? " EXECUTION" : " other");
+        if (noise) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            out << " id=" << std::hex << x << std::dec;
+        }
+        out << "\n";
+    }
+    return out.str();
+}
+
+/// Reads from offset until the source runs dry
+std::string readAll(InputSource& source, size_t chunk, uint64_t offset = 0) {
+    std::string out;
+    std::string buffer(chunk, '\0');
+    ssize_t n;
+    while ((n = source.read(&buffer[0], chunk, offset + out.size())) > 0) {
+        out.append(buffer, 0, static_cast<size_t>(n));
+    }
+    EXPECT_EQ(n, 0);
+    return out;
+}
+
+void writeFile(const std::string& path, const std::string& data, std::ios::openmode mode = std::ios::trunc) {
+    std::ofstream(path, std::ios::binary | mode) << data;
+}
+
+#if LOG_MONITOR_GZIP
+/// One gzip member holding data
+std::string gzipMember(const std::string& data) {
+    z_stream zs{};
+    deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+    std::string out(deflateBound(&zs, data.size()), '\0');
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    zs.avail_in = static_cast<uInt>(data.size());
+    zs.next_out = reinterpret_cast<Bytef*>(&out[0]);
+    zs.avail_out = static_cast<uInt>(out.size());
+    deflate(&zs, Z_FINISH);
+    out.resize(zs.total_out);
+    deflateEnd(&zs);
+    return out;
+}
+#endif
+
+#if LOG_MONITOR_ZSTD
+/// data split into frames of frameSize bytes, content size in each header
+std::string zstdFrames(const std::string& data, size_t frameSize) {
+    std::string out;
+    for (size_t pos = 0; pos < data.size(); pos += frameSize) {
+        const size_t len = std::min(frameSize, data.size() - pos);
+        std::string frame(ZSTD_compressBound(len), '\0');
+        frame.resize(ZSTD_compress(&frame[0], frame.size(), data.data() + pos, len, 1));
+        out += frame;
+    }
+    return out;
+}
+
+/// Skippable frame (pzstd puts one before each frame), 8 byte payload
+std::string zstdSkippable() {
+    return std::string("\x50\x2a\x4d\x18\x08\x00\x00\x00", 8) + std::string(8, 'x');
+}
+
+/// One streamed frame: no content size in the header
+std::string zstdUnsized(const std::string& data) {
+    ZSTD_CStream* cs = ZSTD_createCStream();
+    ZSTD_initCStream(cs, 1);
+    std::string out(ZSTD_compressBound(data.size()) + 64, '\0');
+    ZSTD_inBuffer in{data.data(), data.size(), 0};
+    ZSTD_outBuffer o{&out[0], out.size(), 0};
+    ZSTD_compressStream(cs, &o, &in);
+    ZSTD_endStream(cs, &o);
+    out.resize(o.pos);
+    ZSTD_freeCStream(cs);
+    return out;
+}
+#endif
+
+} // namespace
+
+class CompressedInputTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        fs::remove_all(dir_);
+        fs::create_directories(dir_);
+    }
+    void TearDown() override {
+        fs::remove_all(dir_);
+    }
+    std::string path(const std::string& name) const { return (dir_ / name).string(); }
+
+    fs::path dir_ = "compressed_input_test";
+};
+
+TEST_F(CompressedInputTest, DetectsFormatFromMagic) {
+    using Format = CompressedInputSource::Format;
+    EXPECT_EQ(CompressedInputSource::detect("\x1f\x8b\x08\x00", 4), Format::Gzip);
+    EXPECT_EQ(CompressedInputSource::detect("\x28\xb5\x2f\xfd", 4), Format::Zstd);
+    EXPECT_EQ(CompressedInputSource::detect("line", 4), Format::Plain);
+    EXPECT_EQ(CompressedInputSource::detect("\x53\x2a\x4d\x18", 4), Format::Zstd);  // skippable
+    EXPECT_EQ(CompressedInputSource::detect("\x28\xb5", 2), Format::Plain);
+    EXPECT_TRUE(CompressedInputSource::supported(Format::Plain));
+}
+
+TEST_F(CompressedInputTest, PlainFileReadsAsPosix) {
+    writeFile(path("plain.log"), "0123456789");
+    CompressedInputSource source;
+    ASSERT_TRUE(source.open(path("plain.log")));
+    EXPECT_EQ(source.format(), CompressedInputSource::Format::Plain);
+    char buffer[4];
+    EXPECT_EQ(source.read(buffer, 4, 6), 4);
+    EXPECT_EQ(std::string(buffer, 4), "6789");
+    EXPECT_EQ(source.checkRotation(path("plain.log"), 11), InputSource::Rotation::Truncated);
+}
+
+#if LOG_MONITOR_GZIP
+TEST_F(CompressedInputTest, GzipReadsAtDecompressedOffsets) {
+    const std::string log = makeLog(100000);  // ~2MB, several input chunks
+    writeFile(path("a.log.gz"), gzipMember(log.substr(0, 700000)) + gzipMember(log.substr(700000)));
+
+    CompressedInputSource source;
+    ASSERT_TRUE(source.open(path("a.log.gz")));
+    EXPECT_EQ(source.format(), CompressedInputSource::Format::Gzip);
+    EXPECT_EQ(readAll(source, 64 * 1024), log);  // both members, back to back
+
+    // backwards restarts, forwards skips
+    std::string buffer(100, '\0');
+    ASSERT_EQ(source.read(&buffer[0], 100, 10), 100);
+    EXPECT_EQ(buffer, log.substr(10, 100));
+    ASSERT_EQ(source.read(&buffer[0], 100, 1500000), 100);
+    EXPECT_EQ(buffer, log.substr(1500000, 100));
+
+    // decompressed offset is past the file size: still not truncated
+    EXPECT_EQ(source.checkRotation(path("a.log.gz"), log.size()), InputSource::Rotation::None);
+}
+
+TEST_F(CompressedInputTest, GzipStillBeingWrittenIsTailed) {
+    const std::string log = makeLog(5000);
+    const std::string gz = gzipMember(log);
+    const size_t cut = gz.size() / 2;
+    writeFile(path("b.log.gz"), gz.substr(0, cut));
+
+    CompressedInputSource source;
+    ASSERT_TRUE(source.open(path("b.log.gz")));
+    std::string head = readAll(source, 4096);
+    EXPECT_LT(head.size(), log.size());
+    EXPECT_EQ(head, log.substr(0, head.size()));
+
+    writeFile(path("b.log.gz"), gz.substr(cut), std::ios::app);
+    EXPECT_EQ(head + readAll(source, 4096, head.size()), log);
+}
+
+TEST_F(CompressedInputTest, CorruptGzipThrows) {
+    std::string gz = gzipMember(makeLog(5000));
+    for (size_t i = 20; i < 200; ++i) gz[i] = static_cast<char>(0xff);
+    writeFile(path("bad.log.gz"), gz);
+    CompressedInputSource source;
+    ASSERT_TRUE(source.open(path("bad.log.gz")));
+    char buffer[4096];
+    EXPECT_THROW(source.read(buffer, sizeof(buffer), 0), std::runtime_error);
+}
+
+TEST_F(CompressedInputTest, MonitorFiltersGzipLikePlain) {
+    const std::string log = makeLog(30000);
+    writeFile(path("plain.log"), log);
+    writeFile(path("c.log.gz"), gzipMember(log));
+
+    auto run = [&](const std::string& input, LogMonitor::InputBackend backend, const std::string& output) {
+        LogMonitor::Config config;
+        config.inputFile = input;
+        config.outputFile = output;
+        config.keywords = {"EXECUTION"};
+        config.inputBackend = backend;
+        config.mmapCatchUpThreshold = 1;  // skipped for compressed input
+        LogMonitor monitor(config);
+        auto stats = monitor.runUntilEof();
+        EXPECT_EQ(stats.bytesRead, log.size());
+        EXPECT_EQ(stats.linesMatched, 10000u);
+        std::ifstream ifs(output);
+        return std::string((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    };
+    EXPECT_EQ(run(path("c.log.gz"), LogMonitor::InputBackend::Compressed, path("gz.out")),
+              run(path("plain.log"), LogMonitor::InputBackend::Posix, path("plain.out")));
+}
+#endif
+
+#if LOG_MONITOR_ZSTD
+TEST_F(CompressedInputTest, ZstdFramesDecodeTheSameOnAnyThreadCount) {
+    const std::string log = makeLog(200000, true);  // ~7MB, ~3MB compressed
+    // sized frames, then an unsized streamed one the workers can't take, then more frames
+    writeFile(path("d.log.zst"), zstdSkippable() + zstdFrames(log.substr(0, 2000000), 300000) +
+                                 zstdUnsized(log.substr(2000000, 1000000)) +
+                                 zstdFrames(log.substr(3000000), 250000));
+    ASSERT_GT(fs::file_size(path("d.log.zst")), 2 * CompressedInputSource::INPUT_CHUNK);
+    for (size_t threads : {1u, 2u, 4u}) {
+        CompressedInputSource source(threads);
+        ASSERT_TRUE(source.open(path("d.log.zst")));
+        EXPECT_EQ(source.format(), CompressedInputSource::Format::Zstd);
+        EXPECT_EQ(readAll(source, 64 * 1024), log) << threads << " threads";
+
+        std::string buffer(100, '\0');
+        ASSERT_EQ(source.read(&buffer[0], 100, 2999950), 100);
+        EXPECT_EQ(buffer, log.substr(2999950, 100)) << threads << " threads";
+    }
+}
+
+TEST_F(CompressedInputTest, ZstdFrameStillBeingWrittenIsTailed) {
+    const std::string log = makeLog(20000);
+    const std::string zst = zstdFrames(log, 100000);
+    const size_t cut = zst.size() * 2 / 3;
+    writeFile(path("e.log.zst"), zst.substr(0, cut));
+
+    CompressedInputSource source(2);
+    ASSERT_TRUE(source.open(path("e.log.zst")));
+    std::string head = readAll(source, 4096);
+    EXPECT_EQ(head, log.substr(0, head.size()));
+    writeFile(path("e.log.zst"), zst.substr(cut), std::ios::app);
+    EXPECT_EQ(head + readAll(source, 4096, head.size()), log);
+}
+#endif
@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include "compressed_sink.h"
+#include "compressed_input.h"
+#include "log_monitor.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::string makeLines(int from, int to) {
+    std::ostringstream out;
+    for (int i = from; i < to; ++i) {
+        out << "2024-10-15 12:34:56 EXECUTION OrderID=" << i << " Venue=NYSE\n";
+    }
+    return out.str();
+}
+
+/// Whole decompressed contents of path
+std::string decompress(const std::string& path) {
+    CompressedInputSource source(2);
+    EXPECT_TRUE(source.open(path));
+    std::string out;
+    std::string buffer(64 * 1024, '\0');
+    ssize_t n;
+    while ((n = source.read(&buffer[0], buffer.size(), out.size())) > 0) {
+        out.append(buffer, 0, static_cast<size_t>(n));
+    }
+    EXPECT_EQ(n, 0);
+    return out;
+}
+
+void writeLines(OutputWriter& writer, const std::string& lines) {
+    std::istringstream in(lines);
+    std::string line;
+    while (std::getline(in, line)) {
+        writer.writeLine(line);
+    }
+}
+
+/// Formats this build can write, so every test runs on whatever is compiled in
+std::vector<OutputWriter::Compression> formats() {
+    std::vector<OutputWriter::Compression> out;
+    for (auto c : {OutputWriter::Compression::Gzip, OutputWriter::Compression::Zstd}) {
+        if (CompressedSink::supported(c)) out.push_back(c);
+    }
+    return out;
+}
+
+} // namespace
+
+class CompressedSinkTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        fs::remove_all(dir_);
+        fs::create_directories(dir_);
+        if (formats().empty()) {
+            GTEST_SKIP() << "built without zlib and zstd";
+        }
+    }
+    void TearDown() override {
+        fs::remove_all(dir_);
+    }
+    std::string path(const std::string& name) const { return (dir_ / name).string(); }
+
+    fs::path dir_ = "compressed_sink_test";
+};
+
+TEST_F(CompressedSinkTest, FramesRoundTripThroughCompressedInput) {
+    const std::string lines = makeLines(0, 50000);
+    for (auto compression : formats()) {
+        const std::string out = path("out" + std::to_string(static_cast<int>(compression)));
+        OutputWriter::Options options;
+        options.policy = OutputWriter::FlushPolicy::Bytes;
+        options.compression = compression;
+        options.frameBytes = 64 * 1024;  // ~40 frames, so the pool wraps
+        {
+            OutputWriter writer(out, options);
+            writeLines(writer, lines);
+            writer.flush();
+            EXPECT_GT(writer.sink()->frames(), 20u);
+            EXPECT_EQ(writer.sink()->bytesIn(), lines.size());
+            EXPECT_EQ(writer.sink()->bytesOut(), writer.fileSize());
+            EXPECT_LT(writer.fileSize() * 4, lines.size());
+        }
+        EXPECT_EQ(decompress(out), lines);
+    }
+}
+
+TEST_F(CompressedSinkTest, AgedFrameIsReadableWhileLive) {
+    const std::string lines = makeLines(0, 100);
+    for (auto compression : formats()) {
+        const std::string out = path("live" + std::to_string(static_cast<int>(compression)));
+        OutputWriter::Options options;
+        options.policy = OutputWriter::FlushPolicy::PerLine;
+        options.compression = compression;
+        options.frameIntervalMs = 20;
+        OutputWriter writer(out, options);
+        writeLines(writer, lines);
+        EXPECT_EQ(fs::file_size(out), 0u);  // still in the block
+
+        // no more lines: tick() cuts the frame once it is old enough
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (fs::file_size(out) == 0 && std::chrono::steady_clock::now() < deadline) {
+            writer.tick();
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        EXPECT_EQ(decompress(out), lines);
+    }
+}
+
+TEST_F(CompressedSinkTest, TruncateDropsFramesAfterTheCut) {
+    for (auto compression : formats()) {
+        const std::string out = path("cut" + std::to_string(static_cast<int>(compression)));
+        OutputWriter::Options options;
+        options.policy = OutputWriter::FlushPolicy::PerBuffer;
+        options.compression = compression;
+        options.frameBytes = 4096;
+        OutputWriter writer(out, options);
+        writeLines(writer, makeLines(0, 1000));
+        writer.flush();
+        const uint64_t checkpoint = writer.fileSize();
+
+        writeLines(writer, makeLines(1000, 2000));
+        writer.endOfBuffer();  // queued, maybe not written yet
+        writer.truncate(checkpoint);
+        writeLines(writer, makeLines(5000, 5100));
+        writer.flush();
+        EXPECT_EQ(decompress(out), makeLines(0, 1000) + makeLines(5000, 5100));
+    }
+}
+
+TEST_F(CompressedSinkTest, MonitorOutputDecompressesToPlainOutput) {
+    const std::string input = makeLines(0, 30000) + "other line\n";
+    std::ofstream(path("in.log")) << input;
+
+    auto run = [&](OutputWriter::Compression compression, const std::string& output) {
+        LogMonitor::Config config;
+        config.inputFile = path("in.log");
+        config.outputFile = output;
+        config.keywords = {"OrderID=2"};
+        config.flushPolicy = LogMonitor::FlushPolicy::PerBuffer;
+        config.outputCompression = compression;
+        LogMonitor monitor(config);
+        auto stats = monitor.runUntilEof();
+        if (compression != OutputWriter::Compression::None) {
+            EXPECT_GT(stats.outputRawBytes, 0u);
+            EXPECT_LT(stats.outputCompressedBytes * 4, stats.outputRawBytes);
+        }
+        return stats.linesMatched;
+    };
+    const uint64_t matched = run(OutputWriter::Compression::None, path("plain.out"));
+    std::ifstream plain(path("plain.out"));
+    const std::string expected((std::istreambuf_iterator<char>(plain)), std::istreambuf_iterator<char>());
+    for (auto compression : formats()) {
+        const std::string out = path("monitor" + std::to_string(static_cast<int>(compression)));
+        EXPECT_EQ(run(compression, out), matched);
+        EXPECT_EQ(decompress(out), expected);
+    }
+}
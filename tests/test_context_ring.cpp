@@ -0,0 +1,213 @@
+#include <gtest/gtest.h>
+#include "context_ring.h"
+#include "log_monitor.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::string readFile(const std::string& path) {
+    std::ifstream in(path);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+// what grep -B before -A after prints, straight from the definition
+std::string expectedContext(const std::vector<std::string>& lines, const std::string& keyword,
+                            size_t before, size_t after) {
+    std::vector<bool> wanted(lines.size(), false);
+    for (size_t i = 0; i < lines.size(); ++i) {
+        if (lines[i].find(keyword) == std::string::npos) continue;
+        size_t from = i >= before ? i - before : 0;
+        for (size_t j = from; j <= i + after && j < lines.size(); ++j) wanted[j] = true;
+    }
+    std::string out;
+    bool any = false;
+    for (size_t i = 0; i < lines.size(); ++i) {
+        if (!wanted[i]) continue;
+        if (any && !wanted[i - 1]) out += "--\n";
+        out += lines[i] + "\n";
+        any = true;
+    }
+    return out;
+}
+
+} // namespace
+
+class ContextRingTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        fs::remove_all(dir_);
+        fs::create_directories(dir_);
+    }
+    void TearDown() override {
+        fs::remove_all(dir_);
+    }
+    std::string path(const std::string& name) const { return (dir_ / name).string(); }
+
+    fs::path dir_ = "context_ring_test";
+};
+
+TEST_F(ContextRingTest, WritesEachLineOnceWithSeparators) {
+    Arena arena(ContextRing::arenaBytes(2, 16));
+    ContextRing ring(2, 1, 16, arena);
+    {
+        OutputWriter::Options options;
+        options.policy = OutputWriter::FlushPolicy::PerBuffer;
+        OutputWriter out(path("out.log"), options);
+        // "a b c M d e f g M M h" with the views in one buffer
+        const std::string buffer = "a\nb\nc\nM\nd\ne\nf\ng\nM\nM\nh\n";
+        for (size_t i = 0; i < buffer.size(); i += 2) {
+            std::string_view line(buffer.data() + i, 1);
+            if (line == "M") {
+                ring.match(line, true, out);
+            } else {
+                ring.other(line, true, out);
+            }
+        }
+        EXPECT_EQ(ring.copies(), 0u);  // everything still in the buffer
+        ring.endOfBuffer();
+        out.endOfBuffer();
+    }
+    EXPECT_EQ(readFile(path("out.log")), "b\nc\nM\nd\n--\nf\ng\nM\nM\nh\n");
+}
+
+TEST_F(ContextRingTest, CopiesOnlyLinesThatOutliveTheirBuffer) {
+    Arena arena(ContextRing::arenaBytes(3, 16));
+    ContextRing ring(3, 0, 16, arena);
+    {
+        OutputWriter out(path("out.log"), OutputWriter::Options());
+        std::string first = "one\ntwo\n";
+        ring.other(std::string_view(first.data(), 3), true, out);
+        ring.other(std::string_view(first.data() + 4, 3), true, out);
+        ring.endOfBuffer();  // both still kept: copied before first is reused
+        EXPECT_EQ(ring.copies(), 2u);
+        first.assign("xxxxxxxx");
+
+        ring.other("three", false, out);  // not stable: copied right away
+        EXPECT_EQ(ring.copies(), 3u);
+        ring.match("MATCH", false, out);
+        ring.endOfBuffer();
+        EXPECT_EQ(ring.copies(), 3u);  // nothing kept any more
+    }
+    EXPECT_EQ(readFile(path("out.log")), "one\ntwo\nthree\nMATCH\n");
+}
+
+TEST_F(ContextRingTest, MonitorContextMatchesGrepAcrossRefills) {
+    std::vector<std::string> lines;
+    std::ostringstream log;
+    for (int i = 0; i < 3000; ++i) {
+        std::string line = "2024-10-15 12:34:56 " + std::string(i % 7 == 0 || i % 97 < 3 ? "EXECUTION" : "NEW") +
+                           " OrderID=" + std::to_string(i) + std::string(i % 13, 'p');
+        lines.push_back(line);
+        log << line << "\n";
+    }
+    std::ofstream(path("in.log")) << log.str();
+
+    for (auto policy : {LogMonitor::FlushPolicy::PerLine, LogMonitor::FlushPolicy::PerBuffer}) {
+        for (size_t window : {size_t(0), size_t(4096)}) {
+            for (auto [before, after] : {std::pair<size_t, size_t>{2, 1}, {0, 3}, {5, 0}, {10, 10}}) {
+                fs::remove(path("out.log"));
+                LogMonitor::Config config;
+                config.inputFile = path("in.log");
+                config.outputFile = path("out.log");
+                config.keywords = {"EXECUTION"};
+                config.bufferSize = 100;  // lines carried and kept across most refills
+                config.mmapWindowSize = window;  // 4096: catch-up windows unmapped under the ring
+                config.mmapCatchUpThreshold = 0;
+                config.scanMode = LogMonitor::ScanMode::WholeBuffer;  // falls back to per line
+                config.scanThreads = 4;                                // likewise
+                config.flushPolicy = policy;
+                config.waitMode = LogMonitor::WaitMode::Poll;
+                config.contextBefore = before;
+                config.contextAfter = after;
+                {
+                    LogMonitor monitor(config);
+                    auto stats = monitor.runUntilEof();
+                    EXPECT_EQ(stats.linesProcessed, lines.size());
+                }
+                EXPECT_EQ(readFile(path("out.log")), expectedContext(lines, "EXECUTION", before, after))
+                    << "policy " << static_cast<int>(policy) << " window " << window
+                    << " -B" << before << " -A" << after;
+            }
+        }
+    }
+
+    LogMonitor::Config config;
+    config.inputFile = path("in.log");
+    config.outputFile = path("out.log");
+    config.keywords = {"EXECUTION"};
+    config.contextBefore = 1;
+    EXPECT_GT(LogMonitor::arenaBytes(config), [&] {
+        LogMonitor::Config plain = config;
+        plain.contextBefore = 0;
+        return LogMonitor::arenaBytes(plain);
+    }());
+    config.pipelined = true;
+    EXPECT_THROW(LogMonitor monitor(config), std::runtime_error);
+}
+
+TEST_F(ContextRingTest, BlankLinesAreContextButNeverMatch) {
+    const std::vector<std::string> lines = {"a", "b", "", "ERROR 1", "", "c", "d", "e", "f", "", "ERROR 2", "x"};
+    std::string log;
+    for (const std::string& line : lines) log += line + "\n";
+    std::ofstream(path("in.log")) << log;
+
+    for (auto [before, after] : {std::pair<size_t, size_t>{0, 1}, {2, 1}, {1, 0}, {3, 3}}) {
+        fs::remove(path("out.log"));
+        LogMonitor::Config config;
+        config.inputFile = path("in.log");
+        config.outputFile = path("out.log");
+        config.keywords = {"ERROR"};
+        config.waitMode = LogMonitor::WaitMode::Poll;
+        config.contextBefore = before;
+        config.contextAfter = after;
+        {
+            LogMonitor monitor(config);
+            auto stats = monitor.runUntilEof();
+            EXPECT_EQ(stats.linesProcessed, 9u);  // blank lines aren't counted
+            EXPECT_EQ(stats.linesMatched, 2u);
+        }
+        EXPECT_EQ(readFile(path("out.log")), expectedContext(lines, "ERROR", before, after))
+            << "-B" << before << " -A" << after;
+    }
+}
+
+TEST_F(ContextRingTest, SkippedLinesKeepDistances) {
+    Arena arena(ContextRing::arenaBytes(2, 16));
+    ContextRing ring(2, 1, 16, arena);
+    {
+        OutputWriter out(path("out.log"), OutputWriter::Options());
+        ring.match("M1", false, out);
+        ring.skip();                   // takes M1's after-context slot
+        ring.other("a", false, out);   // 3 lines before M2: out of range
+        ring.other("b", false, out);
+        ring.skip();
+        ring.match("M2", false, out);  // b is 2 before, a 3
+    }
+    // the skipped line between b and M2 still splits them
+    EXPECT_EQ(readFile(path("out.log")), "M1\n--\nb\n--\nM2\n");
+}
+
+TEST_F(ContextRingTest, SuppressedRepeatsKeepSeparators) {
+    std::ofstream(path("in.log")) << "REJECT 1\nnext\nREJECT 2\nERROR x\nlast\n";
+    LogMonitor::Config config;
+    config.inputFile = path("in.log");
+    config.outputFile = path("out.log");
+    config.keywords = {"REJECT", "ERROR"};
+    config.waitMode = LogMonitor::WaitMode::Poll;
+    config.contextAfter = 1;
+    config.repeatLimit = 1;
+    config.repeatWindowMs = 60000;
+    {
+        LogMonitor monitor(config);
+        EXPECT_EQ(monitor.runUntilEof().linesSuppressed, 1u);
+    }
+    // REJECT 2 is a hidden line between next and ERROR x
+    EXPECT_EQ(readFile(path("out.log")), "REJECT 1\nnext\n--\nERROR x\nlast\nrepeated 1 times: REJECT 2\n");
+}
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include "field_filter.h"
+
+namespace {
+
+const char* const NVDA_SLOW =
+    "[2026-10-14 09:30:00.000001] EXECUTION OrderID=100001 Symbol=NVDA Side=BUY Type=LIMIT "
+    "Price=450.25 Qty=100 Venue=NYSE Latency=350us";
+const char* const NVDA_FAST =
+    "[2026-10-14 09:30:00.000002] FILL OrderID=100002 Symbol=NVDA Side=SELL Type=MARKET "
+    "Price=449.5 Qty=2500 Venue=NYSE Latency=20us";
+const char* const META =
+    "[2026-10-14 09:30:00.000003] FILL OrderID=100003 Symbol=META Side=BUY Type=LIMIT "
+    "Price=300 Qty=10 Venue=NYSE Latency=301us";
+const char* const SNAPSHOT = "[2026-10-14 09:30:00.000004] key1 MARKET_DATA_SNAPSHOT Symbol=METAX";
+
+} // namespace
+
+TEST(FieldFilterTest, FindsFieldsAtTokenBoundaries) {
+    std::string_view value;
+    ASSERT_TRUE(FieldFilter::findField(NVDA_SLOW, "Symbol", value));
+    EXPECT_EQ(value, "NVDA");
+    ASSERT_TRUE(FieldFilter::findField(NVDA_SLOW, "Latency", value));
+    EXPECT_EQ(value, "350us");
+    EXPECT_TRUE(FieldFilter::findField("Qty=5", "Qty", value));
+    EXPECT_EQ(value, "5");
+
+    // "ID=" inside "OrderID=" is not a field, neither is a missing '='
+    EXPECT_FALSE(FieldFilter::findField(NVDA_SLOW, "ID", value));
+    EXPECT_FALSE(FieldFilter::findField("Symbol NVDA", "Symbol", value));
+}
+
+TEST(FieldFilterTest, ComparesTextAndNumbers) {
+    FieldFilter filter("Symbol=NVDA AND Latency>300");
+    EXPECT_TRUE(filter.matches(NVDA_SLOW));
+    EXPECT_FALSE(filter.matches(NVDA_FAST));
+    EXPECT_FALSE(filter.matches(META));
+
+    // exact field text: no "META" substring false positive
+    FieldFilter meta("Symbol=META");
+    EXPECT_TRUE(meta.matches(META));
+    EXPECT_FALSE(meta.matches(SNAPSHOT));
+
+    EXPECT_TRUE(FieldFilter("Price<=300").matches(META));
+    EXPECT_FALSE(FieldFilter("Price<300").matches(META));
+    EXPECT_TRUE(FieldFilter("Price>=449.5 AND Price<450").matches(NVDA_FAST));
+    EXPECT_TRUE(FieldFilter("Qty>1000").matches(NVDA_FAST));
+    EXPECT_TRUE(FieldFilter("Latency<25us").matches(NVDA_FAST));
+    EXPECT_TRUE(FieldFilter("Side!=BUY").matches(NVDA_FAST));
+
+    // missing field: every comparison is false, != included
+    EXPECT_FALSE(FieldFilter("Account!=X").matches(NVDA_FAST));
+    EXPECT_FALSE(FieldFilter("Account<5").matches(NVDA_FAST));
+}
+
+TEST(FieldFilterTest, BooleanOperatorsAndWords) {
+    FieldFilter filter("(Symbol=META OR Symbol=NVDA) AND NOT Side=SELL AND FILL");
+    EXPECT_TRUE(filter.matches(META));
+    EXPECT_FALSE(filter.matches(NVDA_SLOW));  // not a FILL
+    EXPECT_FALSE(filter.matches(NVDA_FAST));  // SELL
+
+    // AND binds tighter than OR
+    FieldFilter precedence("Symbol=META OR Symbol=NVDA AND Latency>300");
+    EXPECT_TRUE(precedence.matches(META));
+    EXPECT_TRUE(precedence.matches(NVDA_SLOW));
+    EXPECT_FALSE(precedence.matches(NVDA_FAST));
+
+    EXPECT_TRUE(FieldFilter("NOT EXECUTION").matches(NVDA_FAST));
+    EXPECT_TRUE(FieldFilter("MARKET_DATA_SNAPSHOT").matches(SNAPSHOT));
+}
+
+TEST(FieldFilterTest, DerivesSelectivePrefilter) {
+    using Keywords = std::vector<std::string>;
+    EXPECT_EQ(FieldFilter("Symbol=NVDA AND Latency>300").prefilterKeywords(), Keywords{"Symbol=NVDA"});
+    EXPECT_EQ(FieldFilter("Latency>300").prefilterKeywords(), Keywords{"Latency="});
+    EXPECT_EQ(FieldFilter("Symbol=META OR Symbol=NVDA").prefilterKeywords(),
+              (Keywords{"Symbol=META", "Symbol=NVDA"}));
+    EXPECT_EQ(FieldFilter("NOT Side=BUY AND REJECT").prefilterKeywords(), Keywords{"REJECT"});
+
+    // nothing necessary can be said: every line is a candidate
+    EXPECT_EQ(FieldFilter("NOT Side=BUY").prefilterKeywords(), Keywords{""});
+    EXPECT_EQ(FieldFilter("FILL OR NOT Side=BUY").prefilterKeywords(), Keywords{""});
+
+    // evaluate() skips the prefilter but gives the same answer on candidates
+    FieldFilter filter("Symbol=NVDA AND Latency>300");
+    EXPECT_TRUE(filter.evaluate(NVDA_SLOW));
+    EXPECT_FALSE(filter.evaluate(META));
+}
+
+TEST(FieldFilterTest, RejectsMalformedExpressions) {
+    for (const char* bad : {"", "Symbol=", "=NVDA", "Latency>fast", "(Symbol=NVDA", "Symbol=NVDA)",
+                            "Symbol=NVDA AND", "OR FILL", "FILL FILL"}) {
+        EXPECT_THROW(FieldFilter filter(bad), std::runtime_error) << bad;
+    }
+}
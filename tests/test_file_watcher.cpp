@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include "file_watcher.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+class FileWatcherTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto now = std::chrono::system_clock::now().time_since_epoch().count();
+        dir_ = fs::temp_directory_path() / ("test_watcher_" + std::to_string(now) + "_" + std::to_string(rand()));
+        fs::create_directories(dir_);
+        path_ = (dir_ / "input.log").string();
+    }
+
+    void TearDown() override {
+        fs::remove_all(dir_);
+    }
+
+    void append(const std::string& path, const std::string& data) {
+        std::ofstream ofs(path, std::ios::app);
+        ofs << data;
+    }
+
+    fs::path dir_;
+    std::string path_;
+};
+
+TEST_F(FileWatcherTest, TimesOutWhenIdle) {
+    append(path_, "existing\n");
+    FileWatcher watcher(path_);
+    if (!watcher.valid()) GTEST_SKIP() << "no event backend";
+
+    EXPECT_FALSE(watcher.wait(20));
+}
+
+TEST_F(FileWatcherTest, WakesOnAppend) {
+    append(path_, "existing\n");
+    FileWatcher watcher(path_);
+    if (!watcher.valid()) GTEST_SKIP() << "no event backend";
+
+    // written before wait(): the event must still be delivered
+    append(path_, "new line\n");
+    EXPECT_TRUE(watcher.wait(5000));
+}
+
+TEST_F(FileWatcherTest, WakesOnCreate) {
+    FileWatcher watcher(path_);
+    if (!watcher.valid()) GTEST_SKIP() << "no event backend";
+
+    std::thread writer([this] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        append(path_, "created\n");
+    });
+    EXPECT_TRUE(watcher.wait(5000));
+    writer.join();
+}
+
+TEST_F(FileWatcherTest, IgnoresOtherFilesInDirectory) {
+    append(path_, "existing\n");
+    FileWatcher watcher(path_);
+    if (!watcher.valid()) GTEST_SKIP() << "no event backend";
+
+    append((dir_ / "other.log").string(), "unrelated\n");
+    EXPECT_FALSE(watcher.wait(50));
+}
+
+TEST_F(FileWatcherTest, WakeupInterruptsWait) {
+    FileWatcher watcher(path_);
+    if (!watcher.valid()) GTEST_SKIP() << "no event backend";
+
+    std::thread waker([&watcher] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        watcher.wakeup();
+    });
+    auto begin = std::chrono::steady_clock::now();
+    EXPECT_TRUE(watcher.wait(-1));
+    EXPECT_LT(std::chrono::steady_clock::now() - begin, std::chrono::seconds(5));
+    waker.join();
+}
+
+TEST_F(FileWatcherTest, MissingDirectoryIsInvalid) {
+    FileWatcher watcher((dir_ / "missing" / "input.log").string());
+    EXPECT_FALSE(watcher.valid());
+    EXPECT_FALSE(watcher.wait(0));
+    EXPECT_STREQ(watcher.backendName(), "none");
+}
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include "input_source.h"
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+class InputSourceTest : public ::testing::TestWithParam<InputSource::Backend> {
+protected:
+    void SetUp() override {
+        auto now = std::chrono::system_clock::now().time_since_epoch().count();
+        path_ = "test_input_source_" + std::to_string(now) + "_" + std::to_string(rand()) + ".log";
+        fs::remove(path_);
+    }
+
+    void TearDown() override {
+        fs::remove(path_);
+    }
+
+    void append(const std::string& data) {
+        std::ofstream ofs(path_, std::ios::app | std::ios::binary);
+        ofs << data;
+    }
+
+    std::string read(InputSource& source, size_t len, uint64_t offset) {
+        std::string out(len, '\0');
+        ssize_t n = source.read(&out[0], len, offset);
+        EXPECT_GE(n, 0);
+        out.resize(n < 0 ? 0 : static_cast<size_t>(n));
+        return out;
+    }
+
+    std::string path_;
+};
+
+TEST_P(InputSourceTest, MissingFileFailsToOpen) {
+    auto source = InputSource::create(GetParam());
+    EXPECT_FALSE(source->open(path_));
+    EXPECT_FALSE(source->isOpen());
+}
+
+TEST_P(InputSourceTest, ReadsAtOffset) {
+    append("0123456789");
+    auto source = InputSource::create(GetParam());
+    ASSERT_TRUE(source->open(path_));
+
+    EXPECT_EQ(read(*source, 4, 0), "0123");
+    EXPECT_EQ(read(*source, 4, 4), "4567");
+    EXPECT_EQ(read(*source, 3, 2), "234");  // backwards seek
+    EXPECT_EQ(read(*source, 100, 8), "89");  // short read at EOF
+    EXPECT_EQ(read(*source, 100, 10), "");
+}
+
+TEST_P(InputSourceTest, SeesDataAppendedAfterEof) {
+    append("first\n");
+    auto source = InputSource::create(GetParam());
+    ASSERT_TRUE(source->open(path_));
+
+    EXPECT_EQ(read(*source, 100, 0), "first\n");
+    EXPECT_EQ(read(*source, 100, 6), "");
+    append("second\n");
+    EXPECT_EQ(read(*source, 100, 6), "second\n");
+}
+
+TEST_P(InputSourceTest, ReopenAfterClose) {
+    append("abc");
+    auto source = InputSource::create(GetParam());
+    ASSERT_TRUE(source->open(path_));
+    source->close();
+    EXPECT_FALSE(source->isOpen());
+
+    ASSERT_TRUE(source->open(path_));
+    EXPECT_EQ(read(*source, 100, 1), "bc");
+}
+
+TEST_P(InputSourceTest, DetectsRotation) {
+    using Rotation = InputSource::Rotation;
+    append("0123456789");
+    auto source = InputSource::create(GetParam());
+    ASSERT_TRUE(source->open(path_));
+    EXPECT_EQ(source->checkRotation(path_, 10), Rotation::None);
+
+    // mid-rotation: path gone, keep reading the old file
+    std::string rotated = path_ + ".1";
+    fs::rename(path_, rotated);
+    EXPECT_EQ(source->checkRotation(path_, 10), Rotation::None);
+
+    append("new");
+    EXPECT_EQ(source->checkRotation(path_, 10), Rotation::Replaced);
+    EXPECT_EQ(read(*source, 100, 0), "0123456789");  // old fd still readable
+    fs::remove(rotated);
+
+    source->close();
+    ASSERT_TRUE(source->open(path_));
+    EXPECT_EQ(source->checkRotation(path_, 3), Rotation::None);
+    EXPECT_EQ(source->checkRotation(path_, 4), Rotation::Truncated);
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends, InputSourceTest,
+                         ::testing::Values(InputSource::Backend::Stream,
+                                           InputSource::Backend::Posix));
+
+TEST(AlignedBufferTest, IsPageAligned) {
+    for (size_t size : {1u, 4096u, 5000u, 64u * 1024u}) {
+        AlignedBuffer buffer = makeAlignedBuffer(size);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(buffer.get()) % 4096, 0u);
+        buffer[size - 1] = 'x';  // usable up to size
+    }
+}
@@ -59,3 +59,114 @@ TEST_F(KeywordMatcherTest, EmptyKeywordList) {
     EXPECT_FALSE(emptyMatcher.matches("Any text here"));
     EXPECT_FALSE(emptyMatcher.matches("key1"));
 }
+
+TEST_F(KeywordMatcherTest, AutoSelectsEngineByKeywordCount) {
+    EXPECT_NE(matcher_->getEngine(), KeywordMatcher::Engine::Automaton);
+
+    std::vector<std::string> many;
+    for (int i = 0; i < 50; ++i) many.push_back("SYM" + std::to_string(i));
+    KeywordMatcher large(many);
+    EXPECT_EQ(large.getEngine(), KeywordMatcher::Engine::Automaton);
+    EXPECT_TRUE(large.matches("Symbol=SYM42 Side=BUY"));
+    EXPECT_FALSE(large.matches("Symbol=AAPL Side=BUY"));
+}
+
+TEST_F(KeywordMatcherTest, AllEnginesMatchLikeLinear) {
+    KeywordMatcher linear(keywords_, KeywordMatcher::Engine::Linear);
+    KeywordMatcher simdScan(keywords_, KeywordMatcher::Engine::Simd);
+    KeywordMatcher automaton(keywords_, KeywordMatcher::Engine::Automaton);
+    EXPECT_EQ(automaton.getEngine(), KeywordMatcher::Engine::Automaton);
+
+    std::string longLine = std::string(100, 'E') + "EXECUTIONX" + std::string(100, 'N');
+    for (std::string line : {"This line contains key1 somewhere", "ERROR in key1 processing",
+                             "Found KEY1 here", "key", "", "EXECUTIO", "xxEXECUTIONxx",
+                             longLine.c_str()}) {
+        EXPECT_EQ(simdScan.matches(line), linear.matches(line)) << line;
+        EXPECT_EQ(automaton.matches(line), linear.matches(line)) << line;
+    }
+}
+
+TEST_F(KeywordMatcherTest, ScannerVisitsEveryHit) {
+    std::string text = "a key2\nnothing\nERROR x key1\nkey2\n";
+    for (auto engine : {KeywordMatcher::Engine::Linear, KeywordMatcher::Engine::Simd,
+                        KeywordMatcher::Engine::Automaton}) {
+        KeywordMatcher matcher(keywords_, engine);
+        KeywordMatcher::Scanner scanner(matcher, text);
+        
+        // resume after each hit's line the way processRegion does
+        std::vector<size_t> lines;
+        size_t pos = 0;
+        for (size_t hit; (hit = scanner.next(pos)) != std::string::npos;) {
+            size_t lineEnd = text.find('\n', hit);
+            lines.push_back(std::count(text.begin(), text.begin() + hit, '\n'));
+            pos = lineEnd + 1;
+        }
+        EXPECT_EQ(lines, (std::vector<size_t>{0, 2, 3}));
+    }
+}
+
+TEST_F(KeywordMatcherTest, MatchGroupsReportsEveryGroupInOnePass) {
+    // 0: alerts, 1: fills, keyword "FILL" also feeds 2: audit
+    std::vector<std::string> keywords = {"REJECT", "ERROR", "FILL", "EXECUTION", "AUDIT"};
+    std::vector<KeywordMatcher::GroupMask> groups = {1, 1, 2 | 4, 2, 4};
+    for (auto engine : {KeywordMatcher::Engine::Linear, KeywordMatcher::Engine::Simd,
+                        KeywordMatcher::Engine::Automaton}) {
+        KeywordMatcher matcher(keywords, groups, engine);
+        EXPECT_EQ(matcher.allGroups(), 7u);
+        EXPECT_EQ(matcher.matchGroups("ERROR order 1"), 1u);
+        EXPECT_EQ(matcher.matchGroups("FILL qty=10"), 6u);
+        EXPECT_EQ(matcher.matchGroups("EXECUTION REJECT"), 3u);
+        EXPECT_EQ(matcher.matchGroups("REJECT after FILL"), 7u);
+        EXPECT_EQ(matcher.matchGroups("heartbeat"), 0u);
+        EXPECT_EQ(matcher.matches("EXECUTION"), true);
+    }
+
+    // whole-line walks favour the per-keyword scan for longer
+    std::vector<std::string> eight(8, "SYM");
+    EXPECT_NE(KeywordMatcher(eight, std::vector<KeywordMatcher::GroupMask>(8, 3)).getEngine(),
+              KeywordMatcher::Engine::Automaton);
+    EXPECT_EQ(KeywordMatcher(eight, std::vector<KeywordMatcher::GroupMask>(8, 1)).getEngine(),
+              KeywordMatcher::Engine::Automaton);
+
+    // no groups given: every keyword is group 0
+    KeywordMatcher plain(keywords_);
+    EXPECT_EQ(plain.matchGroups("ERROR in key1"), 1u);
+    EXPECT_EQ(plain.matchGroups("nothing"), 0u);
+}
+
+TEST_F(KeywordMatcherTest, IgnoreCaseAndWholeWordInEveryEngine) {
+    for (auto engine : {KeywordMatcher::Engine::Linear, KeywordMatcher::Engine::Simd,
+                        KeywordMatcher::Engine::Automaton}) {
+        KeywordMatcher::Options options;
+        options.engine = engine;
+        options.ignoreCase = true;
+        KeywordMatcher folded({"ERROR", "key"}, {}, options);
+        EXPECT_TRUE(folded.matches("an Error occurred"));
+        EXPECT_TRUE(folded.matches("error"));
+        EXPECT_TRUE(folded.matches("MONKEY"));
+        EXPECT_FALSE(folded.matches("err or"));
+        EXPECT_EQ(folded.getKeywords()[0], "ERROR");  // lower cased copy is internal
+
+        options.ignoreCase = false;
+        options.wholeWord = true;
+        KeywordMatcher words({"ERROR", "key"}, {1, 2}, options);
+        EXPECT_FALSE(words.matches("monkey ERRORS key1"));
+        EXPECT_TRUE(words.matches("monkey key"));
+        EXPECT_TRUE(words.matches("key=1"));
+        EXPECT_EQ(words.matchGroups("ERROR: bad key"), 3u);
+        EXPECT_EQ(words.matchGroups("monkey ERROR"), 1u);
+
+        // scanner skips the non-word hits too
+        std::string text = "monkey\nERRORS\nthe key\n";
+        KeywordMatcher::Scanner scanner(words, text);
+        size_t hit = scanner.next(0);
+        ASSERT_NE(hit, std::string::npos);
+        EXPECT_EQ(std::count(text.begin(), text.begin() + hit, '\n'), 2);
+
+        options.ignoreCase = true;
+        KeywordMatcher both({"ERROR"}, {}, options);
+        EXPECT_TRUE(both.matches("[error]"));
+        EXPECT_FALSE(both.matches("errors"));
+        EXPECT_EQ(both.getOptions().engine, engine);
+    }
+}
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include "latency_histogram.h"
+
+TEST(LatencyHistogramTest, EmptyReportsZero) {
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.count(), 0u);
+    EXPECT_EQ(histogram.percentile(50), 0u);
+    EXPECT_EQ(histogram.min(), 0u);
+    EXPECT_EQ(histogram.max(), 0u);
+}
+
+TEST(LatencyHistogramTest, SmallValuesAreExact) {
+    LatencyHistogram histogram;
+    for (uint64_t ns = 1; ns <= 60; ++ns) {
+        histogram.record(ns);
+    }
+    EXPECT_EQ(histogram.percentile(50), 30u);
+    EXPECT_EQ(histogram.percentile(100), 60u);
+    EXPECT_EQ(histogram.min(), 1u);
+    EXPECT_DOUBLE_EQ(histogram.mean(), 30.5);
+}
+
+TEST(LatencyHistogramTest, PercentilesWithinBucketError) {
+    // 1..100000 ns uniform: pN is N% of the range, bucket edges add at most ~3%
+    LatencyHistogram histogram;
+    for (uint64_t ns = 1; ns <= 100000; ++ns) {
+        histogram.record(ns);
+    }
+    for (double q : {50.0, 90.0, 99.0, 99.9}) {
+        double expected = q / 100.0 * 100000;
+        double got = static_cast<double>(histogram.percentile(q));
+        EXPECT_GE(got, expected) << "p" << q;  // upper edge: never underreports
+        EXPECT_LE(got, expected * 1.035) << "p" << q;
+    }
+    EXPECT_EQ(histogram.percentile(100), 100000u);  // clamped to the exact max
+}
+
+TEST(LatencyHistogramTest, TailSamplesShowUpInP999) {
+    // 999 fast samples and one slow outlier per thousand
+    LatencyHistogram histogram;
+    for (int i = 0; i < 100000; ++i) {
+        histogram.record(i % 1000 == 0 ? 5000000 : 2000);
+    }
+    EXPECT_LE(histogram.percentile(99), 2100u);
+    EXPECT_GE(histogram.percentile(99.95), 5000000u);
+    EXPECT_EQ(histogram.max(), 5000000u);
+}
+
+TEST(LatencyHistogramTest, HugeValuesAndMerge) {
+    LatencyHistogram a, b;
+    a.record(UINT64_MAX);
+    b.record(10);
+    b.record(1000);
+    a.merge(b);
+    EXPECT_EQ(a.count(), 3u);
+    EXPECT_EQ(a.min(), 10u);
+    EXPECT_EQ(a.max(), UINT64_MAX);
+    EXPECT_EQ(a.percentile(100), UINT64_MAX);
+
+    a.reset();
+    EXPECT_EQ(a.count(), 0u);
+    EXPECT_EQ(a.percentile(99), 0u);
+}
+
+TEST(LatencyHistogramTest, BucketsContinueAcrossPowersOfTwo) {
+    LatencyHistogram histogram;
+    for (uint64_t ns : {63ull, 64ull, 65ull, 127ull, 128ull}) {
+        histogram.record(ns);
+    }
+    EXPECT_EQ(histogram.percentile(20), 63u);
+    EXPECT_EQ(histogram.percentile(40), 65u);  // 64 and 65 share a 2-wide bucket
+    EXPECT_EQ(histogram.percentile(100), 128u);
+}
@@ -0,0 +1,226 @@
+#include <gtest/gtest.h>
+#include "line_index.h"
+#include <fstream>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+class LineIndexTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto now = std::chrono::system_clock::now().time_since_epoch().count();
+        std::string base = "test_line_index_" + std::to_string(now) + "_" + std::to_string(rand());
+        logPath_ = base + ".log";
+        indexPath_ = base + ".idx";
+    }
+
+    void TearDown() override {
+        fs::remove(logPath_);
+        fs::remove(indexPath_);
+    }
+
+    /// "[2026-10-14 HH:MM:SS.uuuuuu] ..." one second apart; every 7th line
+    /// is followed by an untimestamped continuation line
+    std::string makeLog(int lines) {
+        std::string log;
+        char stamp[64];
+        for (int i = 0; i < lines; ++i) {
+            std::snprintf(stamp, sizeof(stamp), "[2026-10-14 %02d:%02d:%02d.%06d] ",
+                          9 + i / 3600, (i / 60) % 60, i % 60, i * 7 % 1000000);
+            log += stamp;
+            log += i % 2 ? "ORDER BUY id=" : "ORDER SELL id=";
+            log += std::to_string(i) + "\n";
+            if (i % 7 == 0) {
+                log += "    at continuation of " + std::to_string(i) + "\n";
+            }
+        }
+        std::ofstream(logPath_, std::ios::binary) << log;
+        return log;
+    }
+
+    /// Feeds the writer in chunks of the given size
+    void feed(LineIndexWriter& writer, const std::string& data, size_t chunk) {
+        for (size_t pos = 0; pos < data.size(); pos += chunk) {
+            writer.consume(data.data() + pos, std::min(chunk, data.size() - pos));
+        }
+    }
+
+    static int64_t at(const char* text) {
+        int64_t micros = 0;
+        EXPECT_TRUE(parseTimestamp(text, micros)) << text;
+        return micros;
+    }
+
+    std::string logPath_;
+    std::string indexPath_;
+};
+
+TEST_F(LineIndexTest, ParsesTimestamps) {
+    EXPECT_EQ(at("1970-01-01 00:00:00"), 0);
+    EXPECT_EQ(at("1970-01-02 00:00:01.5"), (86400LL + 1) * 1000000 + 500000);
+    EXPECT_EQ(at("[2026-10-14 09:30:00.000123] ORDER"), at("2026-10-14 09:30:00.000123"));
+    EXPECT_LT(at("2026-02-28 23:59:59.999999"), at("2026-03-01 00:00:00"));
+
+    int64_t micros;
+    EXPECT_FALSE(parseTimestamp("", micros));
+    EXPECT_FALSE(parseTimestamp("    at continuation", micros));
+    EXPECT_FALSE(parseTimestamp("2026-10-14 09:30", micros));
+    EXPECT_FALSE(parseTimestamp("2026-13-14 09:30:00", micros));
+    EXPECT_FALSE(parseTimestamp("2026-10-14 09:30:00.", micros));
+}
+
+TEST_F(LineIndexTest, EntriesAtLineStartsWhateverTheChunking) {
+    std::string log = makeLog(2000);
+    std::vector<IndexEntry> reference;
+
+    for (size_t chunk : {log.size(), size_t(4096), size_t(61), size_t(1)}) {
+        {
+            LineIndexWriter writer(indexPath_, 1000);
+            writer.reset();
+            feed(writer, log, chunk);
+        }
+        LineIndex index(indexPath_);
+        ASSERT_GT(index.entries().size(), log.size() / 1000 / 2) << chunk;
+
+        uint64_t previous = 0;
+        for (const IndexEntry& entry : index.entries()) {
+            ASSERT_LT(entry.offset, log.size());
+            EXPECT_TRUE(entry.offset == 0 || log[entry.offset - 1] == '\n');
+            EXPECT_TRUE(entry.offset == 0 || entry.offset >= previous + 1000);
+            EXPECT_EQ(entry.line, static_cast<uint64_t>(
+                std::count(log.begin(), log.begin() + entry.offset, '\n')));
+            int64_t ts;
+            if (parseTimestamp(std::string_view(log).substr(entry.offset), ts)) {
+                EXPECT_EQ(entry.timestamp, ts);
+            }
+            previous = entry.offset;
+        }
+
+        if (reference.empty()) {
+            reference = index.entries();
+        } else {
+            ASSERT_EQ(index.entries().size(), reference.size()) << chunk;
+            for (size_t i = 0; i < reference.size(); ++i) {
+                EXPECT_EQ(index.entries()[i].offset, reference[i].offset);
+                EXPECT_EQ(index.entries()[i].timestamp, reference[i].timestamp);
+            }
+        }
+    }
+}
+
+TEST_F(LineIndexTest, QueryMatchesFullScanAndReadsLess) {
+    std::string log = makeLog(20000);
+    {
+        LineIndexWriter writer(indexPath_, 4096);
+        writer.reset();
+        feed(writer, log, 64 * 1024);
+    }
+    LineIndex index(indexPath_);
+    auto input = InputSource::create(InputSource::Backend::Posix);
+    ASSERT_TRUE(input->open(logPath_));
+
+    const std::pair<const char*, const char*> ranges[] = {
+        {"2026-10-14 10:00:00", "2026-10-14 10:01:00"},
+        {"2026-10-14 09:00:00", "2026-10-14 09:00:00.000000"},
+        {"2026-10-14 16:00:00", "2026-10-14 17:00:00"},   // past the end
+        {"2026-10-13 00:00:00", "2026-10-14 09:00:30"},   // before the start
+    };
+    for (const auto& range : ranges) {
+        const int64_t from = at(range.first);
+        const int64_t to = at(range.second);
+
+        // brute force: continuation lines follow their timestamped line
+        std::string expected;
+        bool inRange = false;
+        size_t pos = 0;
+        while (pos < log.size()) {
+            size_t nl = log.find('\n', pos);
+            std::string_view line(log.data() + pos, nl - pos);
+            int64_t ts;
+            if (parseTimestamp(line, ts)) inRange = ts >= from && ts <= to;
+            if (inRange && line.find("BUY") != std::string_view::npos) {
+                expected.append(line.data(), line.size()).push_back('\n');
+            }
+            pos = nl + 1;
+        }
+
+        std::string got;
+        KeywordMatcher filter({"BUY"});
+        auto result = index.query(*input, from, to, &filter, [&got](std::string_view line) {
+            got.append(line.data(), line.size()).push_back('\n');
+        });
+        EXPECT_EQ(got, expected) << range.first;
+        EXPECT_LT(result.bytesScanned, log.size() / 10) << range.first;
+    }
+}
+
+TEST_F(LineIndexTest, UntimestampedLinesBelongToPreviousLine) {
+    std::ofstream(logPath_, std::ios::binary)
+        << "[2026-10-14 09:00:00] a\n  trace a\n[2026-10-14 09:00:01] b\n  trace b\n"
+        << "[2026-10-14 09:00:02] c\n";
+    {
+        LineIndexWriter writer(indexPath_, 1);
+        writer.reset();
+        std::ifstream in(logPath_, std::ios::binary);
+        std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        feed(writer, data, 5);
+    }
+    LineIndex index(indexPath_);
+    ASSERT_EQ(index.entries().size(), 5u);
+    EXPECT_EQ(index.entries()[1].timestamp, index.entries()[0].timestamp);
+
+    auto input = InputSource::create(InputSource::Backend::Posix);
+    ASSERT_TRUE(input->open(logPath_));
+    std::vector<std::string> lines;
+    index.query(*input, at("2026-10-14 09:00:01"), at("2026-10-14 09:00:01"), nullptr,
+                [&lines](std::string_view line) { lines.emplace_back(line); });
+    ASSERT_EQ(lines.size(), 2u);
+    EXPECT_EQ(lines[0], "[2026-10-14 09:00:01] b");
+    EXPECT_EQ(lines[1], "  trace b");
+}
+
+TEST_F(LineIndexTest, ResumeContinuesWhereTheIndexStopped) {
+    std::string log = makeLog(3000);
+    {
+        LineIndexWriter writer(indexPath_, 2000);
+        writer.reset();
+        feed(writer, log, 777);
+    }
+    std::vector<IndexEntry> whole = LineIndex(indexPath_).entries();
+
+    // index written up to some line start, then resumed there
+    size_t half = log.find('\n', log.size() / 2) + 1;
+    {
+        LineIndexWriter writer(indexPath_, 2000);
+        writer.reset();
+        feed(writer, log.substr(0, half + 5000), 777);  // ran past the resume point
+    }
+    {
+        LineIndexWriter writer(indexPath_, 2000);
+        writer.resume(logPath_, half);
+        feed(writer, log.substr(half), 777);
+    }
+    std::vector<IndexEntry> resumed = LineIndex(indexPath_).entries();
+    ASSERT_EQ(resumed.size(), whole.size());
+    for (size_t i = 0; i < whole.size(); ++i) {
+        EXPECT_EQ(resumed[i].offset, whole[i].offset);
+        EXPECT_EQ(resumed[i].line, whole[i].line);
+        EXPECT_EQ(resumed[i].timestamp, whole[i].timestamp);
+    }
+}
+
+TEST_F(LineIndexTest, RejectsMissingOrForeignFile) {
+    EXPECT_THROW(LineIndex index(indexPath_), std::runtime_error);
+    std::ofstream(indexPath_) << "not an index at all";
+    EXPECT_THROW(LineIndex index(indexPath_), std::runtime_error);
+
+    // resume() on a foreign file starts a fresh index
+    std::string log = makeLog(10);
+    LineIndexWriter writer(indexPath_, 100);
+    writer.resume(logPath_, 0);
+    feed(writer, log, 64);
+    EXPECT_GT(writer.entryCount(), 0u);
+    EXPECT_NO_THROW(LineIndex index(indexPath_));
+}
@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace fs = std::filesystem;
+
+// log_generator is its own program: run it and look at what it wrote
+class LogGeneratorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        fs::remove_all(dir_);
+        fs::create_directories(dir_);
+    }
+    void TearDown() override {
+        fs::remove_all(dir_);
+    }
+
+    int generate(const std::string& options) {
+        const std::string command = std::string(LOG_GENERATOR_PATH) + " " + (dir_ / "burst.log").string() +
+                                    " " + options + " > " + (dir_ / "stdout.txt").string();
+        return std::system(command.c_str());
+    }
+
+    /// Lines in burst.log.<i>, -1 if it wasn't written
+    long lines(size_t i) const {
+        std::ifstream in(dir_ / ("burst.log." + std::to_string(i)));
+        if (!in) return -1;
+        long count = 0;
+        for (std::string line; std::getline(in, line);) ++count;
+        return count;
+    }
+
+    fs::path dir_ = "log_generator_test";
+};
+
+TEST_F(LogGeneratorTest, LineLimitIsSplitExactlyAcrossFiles) {
+    ASSERT_EQ(generate("--lines=10 --files=3"), 0);
+    EXPECT_EQ(lines(0), 4);
+    EXPECT_EQ(lines(1), 3);
+    EXPECT_EQ(lines(2), 3);
+
+    fs::remove_all(dir_);
+    fs::create_directories(dir_);
+    ASSERT_EQ(generate("--lines=2 --files=4"), 0);
+    EXPECT_EQ(lines(0), 1);
+    EXPECT_EQ(lines(1), 1);
+    EXPECT_EQ(lines(2), -1);  // no share, no writer
+    EXPECT_EQ(lines(3), -1);
+}
@@ -1,9 +1,12 @@
 #include <gtest/gtest.h>
 #include "log_monitor.h"
+#include "static_keyword_matcher.h"
 #include <fstream>
 #include <thread>
 #include <chrono>
 #include <filesystem>
+#include <algorithm>
+#include <cstdio>
 
 namespace fs = std::filesystem;
 
@@ -135,6 +138,37 @@ TEST_F(LogMonitorTest, TruncatesLongLines) {
     EXPECT_EQ(stats.linesMatched, 1);
 }
 
+TEST_F(LogMonitorTest, LongLineAcrossBuffersIsCountedOnceAndSkipped) {
+    // a keyword in the discarded part must not surface as a line of its own
+    const std::string head = "key1 " + std::string(95, 'H');
+    writeToInputFile(head + std::string(20000, 'X') + " key2 tail\nkey2 next\n");
+    
+    for (int mode = 0; mode < 3; ++mode) {
+        SCOPED_TRACE(mode == 0 ? "per-line" : mode == 1 ? "whole-buffer" : "pipelined");
+        fs::remove(testOutputFile_);
+        
+        LogMonitor::Config config;
+        config.inputFile = testInputFile_;
+        config.outputFile = testOutputFile_;
+        config.keywords = {"key1", "key2"};
+        config.bufferSize = 4096;
+        config.maxLineLength = 100;
+        config.scanMode = mode == 1 ? LogMonitor::ScanMode::WholeBuffer : LogMonitor::ScanMode::PerLine;
+        config.pipelined = mode == 2;
+        
+        LogMonitor monitor(config);
+        std::thread monitorThread([&monitor]() { monitor.start(); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        monitor.stop();
+        monitorThread.join();
+        
+        EXPECT_EQ(readOutputFile(), head + "\nkey2 next\n");
+        auto stats = monitor.getStatistics();
+        EXPECT_EQ(stats.linesProcessed, 2u);
+        EXPECT_EQ(stats.longLinesDiscarded, 1u);
+    }
+}
+
 TEST_F(LogMonitorTest, HandlesRealTimeUpdates) {
     {
         std::ofstream ofs(testInputFile_);
@@ -176,3 +210,892 @@ TEST_F(LogMonitorTest, HandlesRealTimeUpdates) {
     EXPECT_GE(stats.linesProcessed, 2);
     EXPECT_GE(stats.linesMatched, 2);
 }
+
+TEST_F(LogMonitorTest, WholeBufferModeMatchesPerLine) {
+    {
+        std::ofstream ofs(testInputFile_);
+        for (int i = 0; i < 2000; ++i) {
+            ofs << "[ts] " << (i % 7 == 0 ? "key1" : "INFO") << " OrderID=" << i << "\n";
+            if (i % 250 == 0) ofs << "\n";                                   // empty lines
+            if (i % 500 == 0) ofs << "key1 " << std::string(6000, 'X') << "\n";  // long match
+            if (i % 501 == 0) ofs << std::string(6000, 'Y') << " key1\n";        // hit past the cut
+        }
+    }
+    
+    auto run = [&](LogMonitor::ScanMode mode, const std::string& output) {
+        fs::remove(output);
+        LogMonitor::Config config;
+        config.inputFile = testInputFile_;
+        config.outputFile = output;
+        config.keywords = {"key1"};
+        config.pollIntervalMs = 10;
+        config.bufferSize = 4096;  // force plenty of buffer boundaries
+        config.scanMode = mode;
+        
+        LogMonitor monitor(config);
+        std::thread monitorThread([&monitor]() { monitor.start(); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        monitor.stop();
+        monitorThread.join();
+        return monitor.getStatistics();
+    };
+    
+    auto perLine = run(LogMonitor::ScanMode::PerLine, testOutputFile_);
+    std::string perLineOutput = readOutputFile();
+    
+    std::string wholeOutputFile = testOutputFile_ + ".whole";
+    auto whole = run(LogMonitor::ScanMode::WholeBuffer, wholeOutputFile);
+    std::ifstream ifs(wholeOutputFile);
+    std::string wholeOutput((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    fs::remove(wholeOutputFile);
+    
+    EXPECT_FALSE(perLineOutput.empty());
+    EXPECT_EQ(wholeOutput, perLineOutput);
+    EXPECT_EQ(whole.linesProcessed, perLine.linesProcessed);
+    EXPECT_EQ(whole.linesMatched, perLine.linesMatched);
+    EXPECT_EQ(whole.longLinesDiscarded, perLine.longLinesDiscarded);
+    EXPECT_EQ(whole.bytesRead, perLine.bytesRead);
+}
+
+TEST_F(LogMonitorTest, PerBufferFlushPolicyBatchesOutput) {
+    {
+        std::ofstream ofs(testInputFile_);
+        for (int i = 0; i < 1000; ++i) {
+            ofs << "key1 OrderID=" << i << "\n";
+        }
+    }
+    
+    LogMonitor::Config config;
+    config.inputFile = testInputFile_;
+    config.outputFile = testOutputFile_;
+    config.keywords = {"key1"};
+    config.pollIntervalMs = 10;
+    config.flushPolicy = LogMonitor::FlushPolicy::PerBuffer;
+    
+    LogMonitor monitor(config);
+    std::thread monitorThread([&monitor]() { monitor.start(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    monitor.stop();
+    monitorThread.join();
+    
+    std::string output = readOutputFile();
+    EXPECT_EQ(std::count(output.begin(), output.end(), '\n'), 1000);
+    
+    // whole file fits in one 64KB read, so one batch instead of 1000 writes
+    auto stats = monitor.getStatistics();
+    EXPECT_EQ(stats.linesMatched, 1000u);
+    EXPECT_EQ(stats.outputFlushes, 1u);
+}
+
+TEST_F(LogMonitorTest, EventWaitModeTailsAndStopsPromptly) {
+    writeToInputFile("");
+    
+    LogMonitor::Config config;
+    config.inputFile = testInputFile_;
+    config.outputFile = testOutputFile_;
+    config.keywords = {"key1"};
+    config.waitMode = LogMonitor::WaitMode::Auto;
+    
+    LogMonitor monitor(config);
+    if (monitor.getWaitMode() != LogMonitor::WaitMode::Event) {
+        GTEST_SKIP() << "no event backend";
+    }
+    
+    std::thread monitorThread([&monitor]() { monitor.start(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    writeToInputFile("line with key1\n");
+    writeToInputFile("line without keyword\n");
+    
+    // stop() must wake the watcher rather than wait out EVENT_RECHECK_MS
+    auto begin = std::chrono::steady_clock::now();
+    monitor.stop();
+    monitorThread.join();
+    EXPECT_LT(std::chrono::steady_clock::now() - begin,
+              std::chrono::milliseconds(LogMonitor::EVENT_RECHECK_MS / 2));
+    
+    EXPECT_EQ(readOutputFile(), "line with key1\n");
+}
+
+TEST_F(LogMonitorTest, PollWaitModeDisablesWatcher) {
+    LogMonitor::Config config;
+    config.inputFile = testInputFile_;
+    config.outputFile = testOutputFile_;
+    config.keywords = {"key1"};
+    config.waitMode = LogMonitor::WaitMode::Poll;
+    
+    LogMonitor monitor(config);
+    EXPECT_EQ(monitor.getWaitMode(), LogMonitor::WaitMode::Poll);
+}
+
+TEST_F(LogMonitorTest, InputBackendsProduceSameOutput) {
+    {
+        std::ofstream ofs(testInputFile_);
+        for (int i = 0; i < 500; ++i) {
+            ofs << (i % 3 == 0 ? "key1" : "none") << " OrderID=" << i << "\n";
+        }
+    }
+    
+    auto run = [this](LogMonitor::InputBackend backend, const std::string& output) {
+        LogMonitor::Config config;
+        config.inputFile = testInputFile_;
+        config.outputFile = output;
+        config.keywords = {"key1"};
+        config.bufferSize = 100;  // many short chunks, lines split across reads
+        config.inputBackend = backend;
+        
+        LogMonitor monitor(config);
+        std::thread monitorThread([&monitor]() { monitor.start(); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        monitor.stop();
+        monitorThread.join();
+        return monitor.getStatistics();
+    };
+    
+    auto posix = run(LogMonitor::InputBackend::Posix, testOutputFile_);
+    std::string posixOutput = readOutputFile();
+    
+    std::string streamOutputFile = testOutputFile_ + ".stream";
+    auto stream = run(LogMonitor::InputBackend::Stream, streamOutputFile);
+    std::ifstream ifs(streamOutputFile);
+    std::string streamOutput((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    fs::remove(streamOutputFile);
+    
+    EXPECT_EQ(posix.linesProcessed, 500u);
+    EXPECT_EQ(posix.linesMatched, 167u);
+    EXPECT_EQ(streamOutput, posixOutput);
+    EXPECT_EQ(stream.linesProcessed, posix.linesProcessed);
+    EXPECT_EQ(stream.bytesRead, posix.bytesRead);
+}
+
+TEST_F(LogMonitorTest, MmapCatchUpThenTails) {
+    std::string expected;
+    {
+        std::ofstream ofs(testInputFile_);
+        for (int i = 0; i < 2000; ++i) {
+            std::string line = std::string(i % 2 ? "key1" : "none") + " OrderID=" + std::to_string(i) + "\n";
+            ofs << line;
+            if (i % 2) expected += line;
+        }
+    }
+    const uint64_t backlog = fs::file_size(testInputFile_);
+    
+    LogMonitor::Config config;
+    config.inputFile = testInputFile_;
+    config.outputFile = testOutputFile_;
+    config.keywords = {"key1"};
+    config.mmapWindowSize = 1000;  // windows end mid-line and off page boundaries
+    config.mmapCatchUpThreshold = 1;
+    config.flushPolicy = LogMonitor::FlushPolicy::PerBuffer;
+    
+    LogMonitor monitor(config);
+    std::thread monitorThread([&monitor]() { monitor.start(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    writeToInputFile("key1 tailed after catch-up\n");
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    monitor.stop();
+    monitorThread.join();
+    
+    expected += "key1 tailed after catch-up\n";
+    EXPECT_EQ(readOutputFile(), expected);
+    
+    auto stats = monitor.getStatistics();
+    EXPECT_EQ(stats.bytesMapped, backlog);
+    EXPECT_EQ(stats.linesProcessed, 2001u);
+    EXPECT_EQ(stats.bytesRead, backlog + 27);
+}
+
+TEST_F(LogMonitorTest, ParallelCatchUpMatchesSerial) {
+    {
+        std::ofstream ofs(testInputFile_);
+        for (int i = 0; i < 5000; ++i) {
+            ofs << (i % 7 == 0 ? "key1" : "none") << " OrderID=" << i << "\n";
+            if (i % 1000 == 0) ofs << std::string(6000, 'L') << " key1 past the cut\n";
+        }
+    }
+    
+    auto run = [this](size_t threads, const std::string& output) {
+        LogMonitor::Config config;
+        config.inputFile = testInputFile_;
+        config.outputFile = output;
+        config.keywords = {"key1"};
+        config.mmapWindowSize = 32 * 1024;
+        config.mmapCatchUpThreshold = 1;
+        config.scanThreads = threads;
+        config.scanChunkSize = 1024;
+        
+        LogMonitor monitor(config);
+        std::thread monitorThread([&monitor]() { monitor.start(); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        monitor.stop();
+        monitorThread.join();
+        return monitor.getStatistics();
+    };
+    
+    auto serial = run(1, testOutputFile_);
+    std::string serialOutput = readOutputFile();
+    
+    std::string parallelOutputFile = testOutputFile_ + ".parallel";
+    auto parallel = run(4, parallelOutputFile);
+    std::ifstream ifs(parallelOutputFile);
+    std::string parallelOutput((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    fs::remove(parallelOutputFile);
+    
+    EXPECT_EQ(serial.linesProcessed, 5005u);
+    EXPECT_EQ(serial.longLinesDiscarded, 5u);
+    EXPECT_EQ(parallelOutput, serialOutput);
+    EXPECT_EQ(parallel.linesProcessed, serial.linesProcessed);
+    EXPECT_EQ(parallel.linesMatched, serial.linesMatched);
+    EXPECT_EQ(parallel.longLinesDiscarded, serial.longLinesDiscarded);
+}
+
+TEST_F(LogMonitorTest, PipelinedModeMatchesSerial) {
+    {
+        std::ofstream ofs(testInputFile_);
+        for (int i = 0; i < 20000; ++i) {
+            ofs << (i % 5 == 0 ? "key1" : "none") << " OrderID=" << i << "\n";
+        }
+    }
+    
+    auto run = [this](bool pipelined, const std::string& output) {
+        LogMonitor::Config config;
+        config.inputFile = testInputFile_;
+        config.outputFile = output;
+        config.keywords = {"key1"};
+        config.bufferSize = 4096;
+        config.pipelined = pipelined;
+        config.matcherThreads = 2;
+        config.pipelineBlocks = 4;
+        config.flushPolicy = LogMonitor::FlushPolicy::PerBuffer;
+        
+        LogMonitor monitor(config);
+        std::thread monitorThread([&monitor]() { monitor.start(); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        monitor.stop();
+        monitorThread.join();
+        return monitor.getStatistics();
+    };
+    
+    auto serial = run(false, testOutputFile_);
+    std::string serialOutput = readOutputFile();
+    
+    std::string pipelinedOutputFile = testOutputFile_ + ".pipelined";
+    auto pipelined = run(true, pipelinedOutputFile);
+    std::ifstream ifs(pipelinedOutputFile);
+    std::string pipelinedOutput((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    fs::remove(pipelinedOutputFile);
+    
+    EXPECT_EQ(serial.linesMatched, 4000u);
+    EXPECT_EQ(pipelinedOutput, serialOutput);
+    EXPECT_EQ(pipelined.linesProcessed, serial.linesProcessed);
+    EXPECT_EQ(pipelined.linesMatched, serial.linesMatched);
+    EXPECT_EQ(pipelined.bytesRead, serial.bytesRead);
+    EXPECT_EQ(pipelined.matchQueueDepth, 0u);
+    EXPECT_EQ(pipelined.writeQueueDepth, 0u);
+}
+
+TEST_F(LogMonitorTest, StatisticsAndRatesPollableWhileRunning) {
+    writeToInputFile("");
+    
+    LogMonitor::Config config;
+    config.inputFile = testInputFile_;
+    config.outputFile = testOutputFile_;
+    config.keywords = {"key1"};
+    
+    LogMonitor monitor(config);
+    std::thread monitorThread([&monitor]() { monitor.start(); });
+    
+    // dashboard-style poller racing the monitor thread
+    std::atomic<bool> done{false};
+    uint64_t polls = 0;
+    std::thread poller([&] {
+        while (!done) {
+            auto stats = monitor.getStatistics();
+            EXPECT_LE(stats.linesMatched, stats.linesProcessed + 1000);
+            monitor.getRates();
+            polls++;
+        }
+    });
+    
+    monitor.getRates();
+    for (int i = 0; i < 10; ++i) {
+        std::string batch;
+        for (int j = 0; j < 100; ++j) batch += "key1 line " + std::to_string(j) + "\n";
+        writeToInputFile(batch);
+    }
+    auto rates = monitor.getRates();
+    
+    done = true;
+    poller.join();
+    monitor.stop();
+    monitorThread.join();
+    
+    EXPECT_GT(polls, 0u);
+    EXPECT_EQ(monitor.getStatistics().linesMatched, 1000u);
+    EXPECT_GT(rates.linesPerSec, 0);
+    EXPECT_GT(rates.windowSec, 0);
+}
+
+TEST_F(LogMonitorTest, RenameRotationReadsNewFileFromStart) {
+    for (int mode = 0; mode < 3; ++mode) {
+        fs::remove(testInputFile_);
+        fs::remove(testOutputFile_);
+        
+        // old file ends in an unterminated line
+        writeToInputFile("key1 old 1\nkey1 old 2\nkey1 old tail");
+        
+        LogMonitor::Config config;
+        config.inputFile = testInputFile_;
+        config.outputFile = testOutputFile_;
+        config.keywords = {"key1"};
+        config.inputBackend = mode == 1 ? LogMonitor::InputBackend::Stream
+                                        : LogMonitor::InputBackend::Posix;
+        config.pipelined = mode == 2;
+        
+        LogMonitor monitor(config);
+        std::thread monitorThread([&monitor]() { monitor.start(); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        
+        // logrotate "create": rename away, new file at the same path; the new
+        // head is longer than the old offset so a stale offset would skip it
+        std::string rotated = testInputFile_ + ".1";
+        fs::rename(testInputFile_, rotated);
+        writeToInputFile("key1 new 1 with a head longer than the whole old file\nkey1 new 2\n");
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        
+        monitor.stop();
+        monitorThread.join();
+        fs::remove(rotated);
+        
+        EXPECT_EQ(readOutputFile(),
+                  "key1 old 1\nkey1 old 2\nkey1 old tail\n"
+                  "key1 new 1 with a head longer than the whole old file\nkey1 new 2\n")
+            << "mode " << mode;
+        EXPECT_EQ(monitor.getStatistics().rotations, 1u) << "mode " << mode;
+    }
+}
+
+TEST_F(LogMonitorTest, CopyTruncateRotationRereadsFromStart) {
+    writeToInputFile("key1 before 1\nkey1 before 2\nkey1 before 3\n");
+    
+    LogMonitor::Config config;
+    config.inputFile = testInputFile_;
+    config.outputFile = testOutputFile_;
+    config.keywords = {"key1"};
+    
+    LogMonitor monitor(config);
+    std::thread monitorThread([&monitor]() { monitor.start(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    
+    // copytruncate keeps the inode, the file just shrinks
+    std::ofstream(testInputFile_, std::ios::trunc).close();
+    writeToInputFile("key1 after\n");
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    
+    monitor.stop();
+    monitorThread.join();
+    
+    EXPECT_EQ(readOutputFile(), "key1 before 1\nkey1 before 2\nkey1 before 3\nkey1 after\n");
+    EXPECT_EQ(monitor.getStatistics().rotations, 1u);
+}
+
+TEST_F(LogMonitorTest, CheckpointResumesWithoutDuplicates) {
+    for (bool pipelined : {false, true}) {
+        SCOPED_TRACE(pipelined ? "pipelined" : "serial");
+        fs::remove(testInputFile_);
+        fs::remove(testOutputFile_);
+        std::string checkpointFile = testInputFile_ + ".ckpt";
+        writeToInputFile("key1 first\nnone\nkey1 partial");
+    
+        LogMonitor::Config config;
+        config.pipelined = pipelined;
+        config.inputFile = testInputFile_;
+        config.outputFile = testOutputFile_;
+        config.keywords = {"key1"};
+        config.checkpointFile = checkpointFile;
+        config.flushPolicy = LogMonitor::FlushPolicy::Bytes;
+    
+        auto run = [&config](int runMs) {
+            LogMonitor monitor(config);
+            std::thread monitorThread([&monitor]() { monitor.start(); });
+            std::this_thread::sleep_for(std::chrono::milliseconds(runMs));
+            monitor.stop();
+            monitorThread.join();
+            return monitor.getStatistics();
+        };
+    
+        auto first = run(150);
+        EXPECT_EQ(first.resumedOffset, 0u);
+        EXPECT_GE(first.checkpointsSaved, 1u);
+    
+        // the partial line is completed while the monitor is down
+        writeToInputFile(" line\nkey1 second\n");
+    
+        // simulate a crash after the final checkpoint: output got ahead of it
+        {
+            std::ofstream ofs(testOutputFile_, std::ios::app);
+            ofs << "key1 partial line\n";
+        }
+    
+        auto second = run(150);
+        EXPECT_EQ(second.resumedOffset, std::string("key1 first\nnone\n").size());
+        EXPECT_EQ(second.linesProcessed, 2u);  // nothing before the checkpoint rescanned
+        EXPECT_EQ(readOutputFile(), "key1 first\nkey1 partial line\nkey1 second\n");
+    
+        fs::remove(checkpointFile);
+    }
+}
+
+TEST_F(LogMonitorTest, StaleCheckpointStartsOver) {
+    std::string checkpointFile = testInputFile_ + ".ckpt";
+    writeToInputFile("key1 old file\n");
+    
+    LogMonitor::Config config;
+    config.inputFile = testInputFile_;
+    config.outputFile = testOutputFile_;
+    config.keywords = {"key1"};
+    config.checkpointFile = checkpointFile;
+    {
+        LogMonitor monitor(config);
+        std::thread monitorThread([&monitor]() { monitor.start(); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        monitor.stop();
+        monitorThread.join();
+    }
+    
+    // rotated while down: new inode, so the checkpoint no longer applies
+    fs::remove(testInputFile_);
+    writeToInputFile("key1 new file, longer than the old one\n");
+    
+    LogMonitor monitor(config);
+    std::thread monitorThread([&monitor]() { monitor.start(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    monitor.stop();
+    monitorThread.join();
+    
+    EXPECT_EQ(monitor.getStatistics().resumedOffset, 0u);
+    EXPECT_EQ(readOutputFile(), "key1 old file\nkey1 new file, longer than the old one\n");
+    
+    fs::remove(checkpointFile);
+}
+
+TEST_F(LogMonitorTest, IndexBuiltWhileReadingAnswersTimeQueries) {
+    std::string log;
+    char stamp[64];
+    for (int i = 0; i < 5000; ++i) {
+        std::snprintf(stamp, sizeof(stamp), "[2026-10-14 09:%02d:%02d.000000] ", i / 60 % 60, i % 60);
+        log += stamp + std::string(i % 3 ? "key1 fill " : "quote ") + std::to_string(i) + "\n";
+    }
+    writeToInputFile(log);
+    std::string indexFile = testInputFile_ + ".idx";
+    
+    std::vector<IndexEntry> serialEntries;
+    for (bool pipelined : {false, true}) {
+        SCOPED_TRACE(pipelined ? "pipelined" : "serial");
+        LogMonitor::Config config;
+        config.pipelined = pipelined;
+        config.inputFile = testInputFile_;
+        config.outputFile = testOutputFile_;
+        config.keywords = {"key1"};
+        config.bufferSize = 4096;
+        config.indexFile = indexFile;
+        config.indexInterval = 8192;
+        {
+            LogMonitor monitor(config);
+            std::thread monitorThread([&monitor]() { monitor.start(); });
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            monitor.stop();
+            monitorThread.join();
+            EXPECT_GT(monitor.getStatistics().indexEntries, log.size() / 8192 / 2);
+        }
+        
+        LineIndex index(indexFile);
+        for (const IndexEntry& entry : index.entries()) {
+            ASSERT_TRUE(entry.offset == 0 || log[entry.offset - 1] == '\n');
+            EXPECT_EQ(entry.line, static_cast<uint64_t>(
+                std::count(log.begin(), log.begin() + entry.offset, '\n')));
+        }
+        if (!pipelined) {
+            serialEntries = index.entries();
+        } else {
+            EXPECT_EQ(index.entries().size(), serialEntries.size());
+        }
+        
+        // 09:30:00 .. 09:30:02 is lines 1800..1802
+        int64_t from, to;
+        ASSERT_TRUE(parseTimestamp("2026-10-14 09:30:00", from));
+        ASSERT_TRUE(parseTimestamp("2026-10-14 09:30:02", to));
+        auto input = InputSource::create(InputSource::Backend::Posix);
+        ASSERT_TRUE(input->open(testInputFile_));
+        std::vector<std::string> lines;
+        auto result = index.query(*input, from, to, nullptr,
+                                  [&lines](std::string_view line) { lines.emplace_back(line); });
+        ASSERT_EQ(lines.size(), 3u);
+        EXPECT_EQ(lines[0], "[2026-10-14 09:30:00.000000] quote 1800");
+        EXPECT_EQ(lines[2], "[2026-10-14 09:30:02.000000] key1 fill 1802");
+        EXPECT_LE(result.bytesScanned, 2 * config.indexInterval);
+        fs::remove(testOutputFile_);
+    }
+    fs::remove(indexFile);
+}
+
+TEST_F(LogMonitorTest, RoutesFanOutMatchesByKeywordGroup) {
+    std::string alerts = testOutputFile_ + ".alerts";
+    std::string fills = testOutputFile_ + ".fills";
+    writeToInputFile("ORDER REJECT id=1\nheartbeat\nFILL id=2\nERROR on FILL id=3\nkey1 plain\n");
+    
+    for (int mode = 0; mode < 3; ++mode) {
+        SCOPED_TRACE(mode == 0 ? "per-line" : mode == 1 ? "whole-buffer" : "pipelined");
+        fs::remove(testOutputFile_);
+        fs::remove(alerts);
+        fs::remove(fills);
+        
+        LogMonitor::Config config;
+        config.inputFile = testInputFile_;
+        config.outputFile = testOutputFile_;
+        config.keywords = {"key1"};
+        config.routes = {{{"REJECT", "ERROR"}, alerts},
+                         {{"FILL"}, fills},
+                         {{"id=2"}, testOutputFile_}};  // same file as keywords: same group
+        config.scanMode = mode == 1 ? LogMonitor::ScanMode::WholeBuffer : LogMonitor::ScanMode::PerLine;
+        config.pipelined = mode == 2;
+        
+        LogMonitor monitor(config);
+        std::thread monitorThread([&monitor]() { monitor.start(); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        monitor.stop();
+        monitorThread.join();
+        
+        auto read = [](const std::string& path) {
+            std::ifstream ifs(path);
+            return std::string((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+        };
+        EXPECT_EQ(read(alerts), "ORDER REJECT id=1\nERROR on FILL id=3\n");
+        EXPECT_EQ(read(fills), "FILL id=2\nERROR on FILL id=3\n");
+        EXPECT_EQ(read(testOutputFile_), "FILL id=2\nkey1 plain\n");
+        EXPECT_EQ(monitor.getStatistics().linesMatched, 4u);  // lines, not copies
+    }
+    fs::remove(alerts);
+    fs::remove(fills);
+}
+
+TEST_F(LogMonitorTest, CheckpointCoversRouteOutputs) {
+    std::string alerts = testOutputFile_ + ".alerts";
+    std::string checkpointFile = testInputFile_ + ".ckpt";
+    writeToInputFile("key1 a\nERROR b\n");
+    
+    LogMonitor::Config config;
+    config.inputFile = testInputFile_;
+    config.outputFile = testOutputFile_;
+    config.keywords = {"key1"};
+    config.routes = {{{"ERROR"}, alerts}};
+    config.checkpointFile = checkpointFile;
+    auto run = [&config]() {
+        LogMonitor monitor(config);
+        std::thread monitorThread([&monitor]() { monitor.start(); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(150));
+        monitor.stop();
+        monitorThread.join();
+        return monitor.getStatistics();
+    };
+    run();
+    
+    // crash after the checkpoint: the route output got ahead
+    std::ofstream(alerts, std::ios::app) << "ERROR c\n";
+    writeToInputFile("ERROR c\n");
+    
+    auto second = run();
+    EXPECT_EQ(second.resumedOffset, std::string("key1 a\nERROR b\n").size());
+    std::ifstream ifs(alerts);
+    EXPECT_EQ(std::string((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>()),
+              "ERROR b\nERROR c\n");
+    EXPECT_EQ(readOutputFile(), "key1 a\n");
+    
+    fs::remove(alerts);
+    fs::remove(checkpointFile);
+}
+
+TEST_F(LogMonitorTest, FieldFilterSelectsOnFieldValues) {
+    std::string alerts = testOutputFile_ + ".alerts";
+    writeToInputFile("FILL Symbol=NVDA Latency=350us\n"
+                     "FILL Symbol=NVDA Latency=20us\n"
+                     "REJECT Symbol=META Latency=400us\n"
+                     "key1 MARKET_DATA_SNAPSHOT Symbol=METAX Latency=900us\n");
+    
+    for (int mode = 0; mode < 4; ++mode) {
+        SCOPED_TRACE(mode == 0 ? "per-line" : mode == 1 ? "whole-buffer" : mode == 2 ? "pipelined" : "routed");
+        fs::remove(testOutputFile_);
+        fs::remove(alerts);
+        
+        LogMonitor::Config config;
+        config.inputFile = testInputFile_;
+        config.outputFile = testOutputFile_;
+        config.filter = "(Symbol=NVDA OR Symbol=META) AND Latency>300";
+        config.scanMode = mode == 1 ? LogMonitor::ScanMode::WholeBuffer : LogMonitor::ScanMode::PerLine;
+        config.pipelined = mode >= 2;
+        if (mode == 3) {
+            config.routes = {{{"REJECT"}, alerts}};  // plain keywords, not filtered
+        }
+        
+        LogMonitor monitor(config);
+        std::thread monitorThread([&monitor]() { monitor.start(); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        monitor.stop();
+        monitorThread.join();
+        
+        EXPECT_EQ(readOutputFile(), "FILL Symbol=NVDA Latency=350us\nREJECT Symbol=META Latency=400us\n");
+        if (mode == 3) {
+            std::ifstream ifs(alerts);
+            EXPECT_EQ(std::string((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>()),
+                      "REJECT Symbol=META Latency=400us\n");
+        }
+    }
+    fs::remove(alerts);
+}
+
+namespace {
+constexpr char STATIC_REJECT[] = "REJECT";
+constexpr char STATIC_FILL[] = "FILL";
+} // namespace
+
+TEST_F(LogMonitorTest, StaticMatcherDropsIn) {
+    using Matcher = StaticKeywordMatcher<STATIC_REJECT, STATIC_FILL>;
+    writeToInputFile("EXECUTION OrderID=1\nFILL OrderID=2\nCANCEL OrderID=3\nREJECT OrderID=4\n");
+    
+    for (int mode = 0; mode < 3; ++mode) {
+        SCOPED_TRACE(mode == 0 ? "per-line" : mode == 1 ? "whole-buffer" : "pipelined");
+        fs::remove(testOutputFile_);
+        
+        LogMonitor::Config config;
+        config.inputFile = testInputFile_;
+        config.outputFile = testOutputFile_;
+        config.keywords = Matcher::keywords();
+        config.staticMatch = &Matcher::matches;
+        config.scanMode = mode == 1 ? LogMonitor::ScanMode::WholeBuffer : LogMonitor::ScanMode::PerLine;
+        config.pipelined = mode == 2;
+        
+        LogMonitor monitor(config);
+        std::thread monitorThread([&monitor]() { monitor.start(); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        monitor.stop();
+        monitorThread.join();
+        
+        EXPECT_EQ(readOutputFile(), "FILL OrderID=2\nREJECT OrderID=4\n");
+    }
+}
+
+TEST_F(LogMonitorTest, IgnoreCaseAndWholeWordModes) {
+    writeToInputFile("Error in feed\nmonkey business\nERRORS: 3\nthe key, at last\nerror KEY\n");
+    
+    for (int mode = 0; mode < 3; ++mode) {
+        SCOPED_TRACE(mode == 0 ? "per-line" : mode == 1 ? "whole-buffer" : "pipelined");
+        fs::remove(testOutputFile_);
+        
+        LogMonitor::Config config;
+        config.inputFile = testInputFile_;
+        config.outputFile = testOutputFile_;
+        config.keywords = {"error", "key"};
+        config.ignoreCase = true;
+        config.wholeWord = true;
+        config.scanMode = mode == 1 ? LogMonitor::ScanMode::WholeBuffer : LogMonitor::ScanMode::PerLine;
+        config.pipelined = mode == 2;
+        
+        LogMonitor monitor(config);
+        std::thread monitorThread([&monitor]() { monitor.start(); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        monitor.stop();
+        monitorThread.join();
+        
+        EXPECT_EQ(readOutputFile(), "Error in feed\nthe key, at last\nerror KEY\n");
+    }
+}
+
+TEST_F(LogMonitorTest, RunUntilEofProcessesTheFileSynchronously) {
+    // no thread, no sleeps: the output is complete when runUntilEof returns
+    for (int mode = 0; mode < 3; ++mode) {  // read(), mmap catch-up, pipelined
+        fs::remove(testInputFile_);
+        fs::remove(testOutputFile_);
+        std::string expected;
+        {
+            std::ofstream ofs(testInputFile_);
+            for (int i = 0; i < 20000; ++i) {
+                std::string line = (i % 4 == 0 ? "key1 line " : "other line ") + std::to_string(i) + "\n";
+                ofs << line;
+                if (i % 4 == 0) expected += line;
+            }
+            ofs << "key1 unterminated";
+        }
+        
+        LogMonitor::Config config;
+        config.inputFile = testInputFile_;
+        config.outputFile = testOutputFile_;
+        config.keywords = {"key1"};
+        config.bufferSize = 4096;
+        config.mmapCatchUpThreshold = mode == 1 ? 1 : UINT64_MAX;
+        config.pipelined = mode == 2;
+        LogMonitor monitor(config);
+        
+        auto stats = monitor.runUntilEof();
+        EXPECT_EQ(stats.linesProcessed, 20000u) << "mode " << mode;
+        EXPECT_EQ(stats.linesMatched, 5000u) << "mode " << mode;
+        EXPECT_EQ(stats.bytesMapped > 0, mode == 1) << "mode " << mode;
+        std::ifstream ifs(testOutputFile_);
+        std::string output((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+        EXPECT_EQ(output, expected) << "mode " << mode;
+        
+        // the unterminated line stays carried: a second run picks up its end
+        {
+            std::ofstream ofs(testInputFile_, std::ios::app);
+            ofs << " now done\n";
+        }
+        stats = monitor.runUntilEof();
+        EXPECT_EQ(stats.linesMatched, 5001u) << "mode " << mode;
+    }
+}
+
+TEST_F(LogMonitorTest, TraceRecordsStagesOnlyWhenEnabled) {
+    {
+        std::ofstream ofs(testInputFile_);
+        for (int i = 0; i < 10000; ++i) {
+            ofs << (i % 2 ? "key1 line " : "other line ") << i << "\n";
+        }
+    }
+    LogMonitor::Config config;
+    config.inputFile = testInputFile_;
+    config.outputFile = testOutputFile_;
+    config.keywords = {"key1"};
+    config.bufferSize = 4096;
+    config.mmapWindowSize = 0;
+    {
+        LogMonitor monitor(config);
+        monitor.runUntilEof();
+        EXPECT_EQ(monitor.getTracer(), nullptr);
+    }
+    if (!LogMonitor::TRACE_COMPILED) GTEST_SKIP() << "built with LOG_MONITOR_TRACE=OFF";
+    
+    fs::remove(testOutputFile_);
+    config.trace = true;
+    LogMonitor monitor(config);
+    auto stats = monitor.runUntilEof();
+    EXPECT_EQ(stats.linesMatched, 5000u);  // sampled lines take the same decisions
+    const StageTracer* tracer = monitor.getTracer();
+    ASSERT_NE(tracer, nullptr);
+    
+    using Stage = StageTracer::Stage;
+    uint64_t reads = tracer->stage(Stage::Read).count();
+    EXPECT_GT(reads, 1u);
+    EXPECT_EQ(tracer->readSizes().count(), reads);
+    EXPECT_EQ(tracer->stage(Stage::Buffer).count(), reads);
+    EXPECT_EQ(tracer->stage(Stage::Flush).count(), reads);
+    EXPECT_EQ(tracer->stage(Stage::Match).count(), 10000u / StageTracer::SAMPLE_EVERY);
+    EXPECT_GT(tracer->stage(Stage::Write).count(), 0u);
+    EXPECT_LE(tracer->readSizes().max(), 4096u);
+    
+    std::string report = tracer->report();
+    EXPECT_NE(report.find("read"), std::string::npos);
+    EXPECT_NE(report.find("match"), std::string::npos);
+}
+
+TEST_F(LogMonitorTest, ReloadKeywordsSwapsInBeforeTheNextRead) {
+    for (int mode = 0; mode < 3; ++mode) {  // read(), parallel scanner, pipelined
+        fs::remove(testInputFile_);
+        fs::remove(testOutputFile_);
+        auto append = [this](int from, int to) {
+            std::ofstream ofs(testInputFile_, std::ios::app);
+            for (int i = from; i < to; ++i) {
+                ofs << (i % 2 ? "ALPHA " : "BETA ") << i << "\n";
+            }
+        };
+        append(0, 1000);
+        
+        LogMonitor::Config config;
+        config.inputFile = testInputFile_;
+        config.outputFile = testOutputFile_;
+        config.keywords = {"ALPHA"};
+        config.mmapWindowSize = 0;
+        config.scanThreads = mode == 1 ? 2 : 1;
+        config.scanChunkSize = 1024;
+        config.pipelined = mode == 2;
+        LogMonitor monitor(config);
+        EXPECT_EQ(monitor.runUntilEof().linesMatched, 500u) << "mode " << mode;
+        
+        // lines already read keep the old keywords, the rest get the new ones
+        monitor.reloadKeywords({"BETA", "GAMMA"});
+        append(1000, 2000);
+        auto stats = monitor.runUntilEof();
+        EXPECT_EQ(stats.linesMatched, 1000u) << "mode " << mode;
+        EXPECT_EQ(stats.keywordReloads, 1u) << "mode " << mode;
+        
+        std::ifstream ifs(testOutputFile_);
+        std::string line;
+        int n = 0;
+        while (std::getline(ifs, line)) {
+            const bool early = n < 500;
+            EXPECT_EQ(line.rfind(early ? "ALPHA " : "BETA ", 0), 0u) << "mode " << mode << ": " << line;
+            ++n;
+        }
+        EXPECT_EQ(n, 1000) << "mode " << mode;
+    }
+}
+
+TEST_F(LogMonitorTest, ReloadKeywordsKeepsRoutesAndRejectsFilters) {
+    const std::string routeOutput = "test_reload_route.log";
+    fs::remove(routeOutput);
+    {
+        std::ofstream ofs(testInputFile_);
+        ofs << "ALPHA 1\nBETA 2\nROUTED 3\n";
+    }
+    LogMonitor::Config config;
+    config.inputFile = testInputFile_;
+    config.outputFile = testOutputFile_;
+    config.keywords = {"ALPHA"};
+    config.routes.push_back({{"ROUTED"}, routeOutput});
+    LogMonitor monitor(config);
+    EXPECT_THROW(monitor.reloadKeywords({}), std::runtime_error);
+    
+    monitor.reloadKeywords({"BETA"});
+    monitor.runUntilEof();
+    std::ifstream out(testOutputFile_);
+    std::string text((std::istreambuf_iterator<char>(out)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(text, "BETA 2\n");
+    std::ifstream routed(routeOutput);
+    std::string routedText((std::istreambuf_iterator<char>(routed)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(routedText, "ROUTED 3\n");
+    fs::remove(routeOutput);
+    
+    LogMonitor::Config filtered = config;
+    filtered.routes.clear();
+    filtered.filter = "Symbol=NVDA";
+    LogMonitor filterMonitor(filtered);
+    EXPECT_THROW(filterMonitor.reloadKeywords({"BETA"}), std::runtime_error);
+}
+
+TEST_F(LogMonitorTest, ReloadKeywordsRecomputesScanMode) {
+    auto append = [this](const std::string& text) {
+        std::ofstream(testInputFile_, std::ios::app) << text;
+    };
+    append("ALPHA 1\n");
+    LogMonitor::Config config;
+    config.inputFile = testInputFile_;
+    config.outputFile = testOutputFile_;
+    config.keywords = {"ALPHA"};
+    config.scanMode = LogMonitor::ScanMode::WholeBuffer;
+    LogMonitor monitor(config);
+    EXPECT_EQ(monitor.getScanMode(), LogMonitor::ScanMode::WholeBuffer);
+    monitor.runUntilEof();
+    
+    // a keyword spanning lines needs per-line scans...
+    monitor.reloadKeywords({"ALPHA\nBETA"});
+    append("ALPHA 2\nBETA 3\n");
+    monitor.runUntilEof();
+    EXPECT_EQ(monitor.getScanMode(), LogMonitor::ScanMode::PerLine);
+    
+    // ...but only while it is loaded
+    monitor.reloadKeywords({"BETA"});
+    append("ALPHA 4\nBETA 5\n");
+    EXPECT_EQ(monitor.runUntilEof().linesMatched, 2u);
+    EXPECT_EQ(monitor.getScanMode(), LogMonitor::ScanMode::WholeBuffer);
+    
+    std::ifstream out(testOutputFile_);
+    std::string text((std::istreambuf_iterator<char>(out)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(text, "ALPHA 1\nBETA 5\n");
+}
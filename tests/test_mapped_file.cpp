@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+#include "mapped_file.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+class MappedFileTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto now = std::chrono::system_clock::now().time_since_epoch().count();
+        path_ = "test_mapped_" + std::to_string(now) + "_" + std::to_string(rand()) + ".log";
+        std::ofstream ofs(path_, std::ios::binary);
+        for (int i = 0; i < 20000; ++i) {
+            content_.push_back(static_cast<char>('a' + i % 26));
+        }
+        ofs << content_;
+    }
+
+    void TearDown() override {
+        fs::remove(path_);
+    }
+
+    std::string path_;
+    std::string content_;
+};
+
+TEST_F(MappedFileTest, ReportsSize) {
+    MappedFile file(path_);
+    EXPECT_EQ(file.size(), content_.size());
+}
+
+TEST_F(MappedFileTest, MapsUnalignedWindows) {
+    MappedFile file(path_);
+    for (uint64_t offset : {0u, 1u, 4095u, 4096u, 12345u}) {
+        size_t len = std::min<size_t>(5000, content_.size() - offset);
+        const char* data = file.map(offset, len);
+        ASSERT_NE(data, nullptr);
+        EXPECT_EQ(std::string(data, len), content_.substr(offset, len)) << "offset " << offset;
+    }
+    file.unmap();
+    file.unmap();  // idempotent
+}
+
+TEST_F(MappedFileTest, MissingFileThrows) {
+    EXPECT_THROW(MappedFile("/nonexistent/dir/file.log"), std::runtime_error);
+}
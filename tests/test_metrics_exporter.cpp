@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include "metrics_exporter.h"
+#include "log_monitor.h"
+#include "multi_log_monitor.h"
+#include <arpa/inet.h>
+#include <filesystem>
+#include <fstream>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+/// One HTTP/1.0 request to 127.0.0.1:port, returns the whole response
+std::string httpGet(uint16_t port, const std::string& path) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    ::inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return "";
+    }
+    std::string request = "GET " + path + " HTTP/1.0\r\nHost: localhost\r\n\r\n";
+    (void)!::send(fd, request.data(), request.size(), 0);
+    std::string response;
+    char chunk[4096];
+    ssize_t n;
+    while ((n = ::recv(fd, chunk, sizeof(chunk), 0)) > 0) {
+        response.append(chunk, static_cast<size_t>(n));
+    }
+    ::close(fd);
+    return response;
+}
+
+} // namespace
+
+TEST(MetricsExporterTest, TextFormatAndLabelEscaping) {
+    MetricsText text;
+    text.metric("x_total", "counter", "Things", 42);
+    text.family("y_bytes", "gauge", "Per source");
+    text.sample("y_bytes", 7, "source", "a\"b\\c\nd");
+    EXPECT_EQ(text.str(),
+              "# HELP x_total Things\n"
+              "# TYPE x_total counter\n"
+              "x_total 42\n"
+              "# HELP y_bytes Per source\n"
+              "# TYPE y_bytes gauge\n"
+              "y_bytes{source=\"a\\\"b\\\\c\\nd\"} 7\n");
+}
+
+TEST(MetricsExporterTest, ServesMetricsAnd404) {
+    MetricsExporter exporter("127.0.0.1", 0, [] { return std::string("up 1\n"); });
+    ASSERT_NE(exporter.port(), 0);
+
+    std::string ok = httpGet(exporter.port(), "/metrics");
+    EXPECT_EQ(ok.rfind("HTTP/1.0 200 OK\r\n", 0), 0u) << ok;
+    EXPECT_NE(ok.find("Content-Type: text/plain; version=0.0.4"), std::string::npos);
+    EXPECT_NE(ok.find("Content-Length: 5\r\n"), std::string::npos);
+    EXPECT_EQ(ok.substr(ok.size() - 5), "up 1\n");
+
+    std::string missing = httpGet(exporter.port(), "/");
+    EXPECT_EQ(missing.rfind("HTTP/1.0 404", 0), 0u) << missing;
+    EXPECT_EQ(exporter.scrapes(), 1u);
+}
+
+TEST(MetricsExporterTest, RejectsBadAddress) {
+    EXPECT_THROW(MetricsExporter("not-an-ip", 0, [] { return std::string(); }), std::runtime_error);
+}
+
+TEST(MetricsExporterTest, BytesBehindWriterTracksUnreadInput) {
+    const std::string input = "metrics_in.log";
+    const std::string output = "metrics_out.log";
+    fs::remove(input);
+    fs::remove(output);
+    {
+        std::ofstream ofs(input);
+        for (int i = 0; i < 100; ++i) ofs << "EXECUTION line " << i << "\n";
+    }
+    LogMonitor::Config config;
+    config.inputFile = input;
+    config.outputFile = output;
+    config.keywords = {"EXECUTION"};
+    LogMonitor monitor(config);
+    monitor.runUntilEof();
+
+    const uint64_t size = fs::file_size(input);
+    EXPECT_EQ(monitor.getStatistics().readOffset, size);
+    EXPECT_EQ(monitor.bytesBehind(), 0u);
+    {
+        std::ofstream ofs(input, std::ios::app);
+        ofs << std::string(99, 'x') << "\n";  // written, not read yet
+    }
+    EXPECT_EQ(monitor.bytesBehind(), 100u);
+
+    std::string body = renderMetrics(monitor);
+    EXPECT_NE(body.find("log_monitor_lines_matched_total 100\n"), std::string::npos) << body;
+    EXPECT_NE(body.find("log_monitor_read_offset_bytes " + std::to_string(size) + "\n"), std::string::npos);
+    EXPECT_NE(body.find("log_monitor_bytes_behind_writer 100\n"), std::string::npos);
+    EXPECT_NE(body.find("# TYPE log_monitor_bytes_behind_writer gauge\n"), std::string::npos);
+
+    fs::remove(input);
+    fs::remove(output);
+}
+
+TEST(MetricsExporterTest, MultiMonitorLabelsEverySource) {
+    fs::path dir = "metrics_multi";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    MultiLogMonitor::Config config;
+    config.outputFile = (dir / "out.log").string();
+    config.keywords = {"EXECUTION"};
+    for (int i = 0; i < 2; ++i) {
+        std::string path = (dir / ("s" + std::to_string(i) + ".log")).string();
+        std::ofstream(path) << "EXECUTION x\n";
+        config.sources.push_back({path, "", {}});
+    }
+    MultiLogMonitor monitor(config);
+
+    std::string body = renderMetrics(monitor);
+    // nothing read yet: each source is its full size behind
+    EXPECT_NE(body.find("log_monitor_bytes_behind_writer{source=\"" + config.sources[0].inputFile + "\"} 12\n"),
+              std::string::npos) << body;
+    EXPECT_NE(body.find("log_monitor_lines_processed_total{source=\"" + config.sources[1].inputFile + "\"} 0\n"),
+              std::string::npos);
+    EXPECT_EQ(body.find("# TYPE log_monitor_bytes_behind_writer gauge"),
+              body.rfind("# TYPE log_monitor_bytes_behind_writer gauge"));  // one family header
+
+    fs::remove_all(dir);
+}
@@ -0,0 +1,282 @@
+#include <gtest/gtest.h>
+#include "multi_log_monitor.h"
+#include <fstream>
+#include <thread>
+#include <chrono>
+#include <filesystem>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+// pread() of the whole test binary goes through here, so a test can make
+// the next read of a source fail
+namespace {
+std::atomic<int> g_failReads{0};
+}
+
+extern "C" ssize_t pread(int fd, void* buffer, size_t len, off_t offset) {
+    if (g_failReads.load() > 0 && g_failReads.fetch_sub(1) > 0) {
+        errno = EIO;
+        return -1;
+    }
+    return static_cast<ssize_t>(syscall(SYS_pread64, fd, buffer, len, offset));
+}
+
+class MultiLogMonitorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto now = std::chrono::system_clock::now().time_since_epoch().count();
+        dir_ = fs::temp_directory_path() /
+               ("multi_" + std::to_string(now) + "_" + std::to_string(rand()));
+        fs::create_directories(dir_);
+    }
+
+    void TearDown() override {
+        fs::remove_all(dir_);
+    }
+
+    std::string path(const std::string& name) const {
+        return (dir_ / name).string();
+    }
+
+    void append(const std::string& file, const std::string& content) {
+        std::ofstream ofs(file, std::ios::app);
+        ofs << content;
+    }
+
+    std::string read(const std::string& file) {
+        std::ifstream ifs(file);
+        return std::string((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    }
+
+    /// Polls until the file has `lines` lines or ~2s pass
+    std::string waitForLines(const std::string& file, size_t lines) {
+        std::string content;
+        for (int i = 0; i < 200; ++i) {
+            content = read(file);
+            if (static_cast<size_t>(std::count(content.begin(), content.end(), '\n')) >= lines) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return content;
+    }
+
+    fs::path dir_;
+};
+
+TEST_F(MultiLogMonitorTest, ManySourcesIntoSharedOutput) {
+    MultiLogMonitor::Config config;
+    config.outputFile = path("out.log");
+    config.keywords = {"key1"};
+    config.workerThreads = 3;
+    for (int i = 0; i < 50; ++i) {
+        std::string input = path("in_" + std::to_string(i) + ".log");
+        append(input, "key1 backlog " + std::to_string(i) + "\nskip\n");
+        config.sources.push_back({input, "", {}});
+    }
+
+    MultiLogMonitor monitor(config);
+    std::thread monitorThread([&monitor] { monitor.start(); });
+
+    waitForLines(config.outputFile, 50);
+    for (int i = 0; i < 50; ++i) {
+        append(config.sources[i].inputFile, "key1 live " + std::to_string(i) + "\nskip\n");
+    }
+    std::string output = waitForLines(config.outputFile, 100);
+
+    monitor.stop();
+    monitorThread.join();
+
+    for (int i = 0; i < 50; ++i) {
+        EXPECT_NE(output.find("key1 backlog " + std::to_string(i) + "\n"), std::string::npos);
+        EXPECT_NE(output.find("key1 live " + std::to_string(i) + "\n"), std::string::npos);
+    }
+    EXPECT_EQ(output.find("skip"), std::string::npos);
+
+    MultiLogMonitor::Statistics total = monitor.getStatistics();
+    EXPECT_EQ(total.linesProcessed, 200u);
+    EXPECT_EQ(total.linesMatched, 100u);
+}
+
+TEST_F(MultiLogMonitorTest, PerSourceOutputsKeywordsAndStatistics) {
+    MultiLogMonitor::Config config;
+    config.keywords = {"ERROR"};
+    config.sources.push_back({path("a.log"), path("a_out.log"), {}});
+    config.sources.push_back({path("b.log"), path("b_out.log"), {"WARN"}});
+
+    MultiLogMonitor monitor(config);
+    std::thread monitorThread([&monitor] { monitor.start(); });
+
+    // files created after start are picked up via the directory watch
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    append(path("a.log"), "ERROR a1\nWARN a2\n");
+    append(path("b.log"), "ERROR b1\nWARN b2\nWARN b3\n");
+
+    std::string a = waitForLines(path("a_out.log"), 1);
+    std::string b = waitForLines(path("b_out.log"), 2);
+
+    monitor.stop();
+    monitorThread.join();
+
+    EXPECT_EQ(a, "ERROR a1\n");
+    EXPECT_EQ(b, "WARN b2\nWARN b3\n");
+
+    EXPECT_EQ(monitor.getSourceStatistics(0).linesProcessed, 2u);
+    EXPECT_EQ(monitor.getSourceStatistics(0).linesMatched, 1u);
+    EXPECT_EQ(monitor.getSourceStatistics(1).linesProcessed, 3u);
+    EXPECT_EQ(monitor.getSourceStatistics(1).linesMatched, 2u);
+    EXPECT_EQ(monitor.getSourceStatistics(1).bytesRead, 25u);
+}
+
+TEST_F(MultiLogMonitorTest, PartialLinesKeptPerSource) {
+    MultiLogMonitor::Config config;
+    config.outputFile = path("out.log");
+    config.keywords = {"key1"};
+    config.sources.push_back({path("a.log"), "", {}});
+    config.sources.push_back({path("b.log"), "", {}});
+    append(path("a.log"), "");
+    append(path("b.log"), "");
+
+    MultiLogMonitor monitor(config);
+    std::thread monitorThread([&monitor] { monitor.start(); });
+
+    // interleaved halves must not get stitched across sources
+    append(path("a.log"), "first ");
+    append(path("b.log"), "other ");
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    append(path("a.log"), "half key1\n");
+    append(path("b.log"), "half nothing\n");
+    std::string output = waitForLines(config.outputFile, 1);
+
+    monitor.stop();
+    monitorThread.join();
+
+    EXPECT_EQ(output, "first half key1\n");
+}
+
+TEST_F(MultiLogMonitorTest, LongLinesTruncatedAndTheirRestSkipped) {
+    MultiLogMonitor::Config config;
+    config.outputFile = path("out.log");
+    config.keywords = {"key1"};
+    config.bufferSize = 4096;
+    config.maxLineLength = 50;
+    config.sources.push_back({path("a.log"), "", {}});
+    const std::string head = "key1 " + std::string(45, 'H');
+    append(path("a.log"), head + std::string(20000, 'X') + " key1 tail\nkey1 next\n");
+
+    MultiLogMonitor monitor(config);
+    std::thread monitorThread([&monitor] { monitor.start(); });
+    std::string output = waitForLines(config.outputFile, 2);
+    monitor.stop();
+    monitorThread.join();
+
+    EXPECT_EQ(output, head + "\nkey1 next\n");
+    EXPECT_EQ(monitor.getStatistics().longLinesDiscarded, 1u);
+    EXPECT_EQ(monitor.getStatistics().linesProcessed, 2u);
+}
+
+TEST_F(MultiLogMonitorTest, IdleSourcesCauseNoWakeups) {
+#if !defined(__linux__)
+    GTEST_SKIP() << "poll fallback wakes every pollIntervalMs";
+#endif
+    MultiLogMonitor::Config config;
+    config.outputFile = path("out.log");
+    config.keywords = {"key1"};
+    config.recheckMs = 0;
+    for (int i = 0; i < 100; ++i) {
+        std::string input = path("in_" + std::to_string(i) + ".log");
+        append(input, "");
+        config.sources.push_back({input, "", {}});
+    }
+
+    MultiLogMonitor monitor(config);
+    std::thread monitorThread([&monitor] { monitor.start(); });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    uint64_t idleWakeups = monitor.wakeupCount();
+    uint64_t idleTurns = monitor.getStatistics().turns;
+
+    append(config.sources[7].inputFile, "key1\n");
+    waitForLines(config.outputFile, 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    monitor.stop();
+    monitorThread.join();
+
+    EXPECT_EQ(idleWakeups, 0u);
+    EXPECT_EQ(idleTurns, 100u);  // the initial pass only
+    EXPECT_EQ(monitor.getSourceStatistics(7).linesMatched, 1u);
+    EXPECT_EQ(monitor.getSourceStatistics(8).turns, 1u);
+}
+
+TEST_F(MultiLogMonitorTest, RejectsSourceWithoutOutput) {
+    MultiLogMonitor::Config config;
+    config.sources.push_back({path("a.log"), "", {}});
+    EXPECT_THROW(MultiLogMonitor monitor(config), std::runtime_error);
+
+    MultiLogMonitor::Config empty;
+    empty.outputFile = path("out.log");
+    EXPECT_THROW(MultiLogMonitor monitor(empty), std::runtime_error);
+}
+
+TEST_F(MultiLogMonitorTest, RotationHandledPerSource) {
+    MultiLogMonitor::Config config;
+    config.outputFile = path("out.log");
+    config.keywords = {"key1"};
+    config.sources.push_back({path("a.log"), "", {}});
+    config.sources.push_back({path("b.log"), path("b_out.log"), {}});
+    append(path("a.log"), "key1 a old\n");
+    append(path("b.log"), "key1 b old\n");
+
+    MultiLogMonitor monitor(config);
+    std::thread monitorThread([&monitor] { monitor.start(); });
+    waitForLines(config.outputFile, 1);
+
+    fs::rename(path("a.log"), path("a.log.1"));
+    append(path("a.log"), "key1 a new, longer than the old file\n");
+    std::string output = waitForLines(config.outputFile, 2);
+    append(path("b.log"), "key1 b more\n");
+    std::string b = waitForLines(path("b_out.log"), 2);
+
+    monitor.stop();
+    monitorThread.join();
+
+    EXPECT_EQ(output, "key1 a old\nkey1 a new, longer than the old file\n");
+    EXPECT_EQ(b, "key1 b old\nkey1 b more\n");
+    EXPECT_EQ(monitor.getSourceStatistics(0).rotations, 1u);
+    EXPECT_EQ(monitor.getSourceStatistics(1).rotations, 0u);
+}
+
+TEST_F(MultiLogMonitorTest, ReadErrorMidDiscardRestartsOnALine) {
+    MultiLogMonitor::Config config;
+    config.outputFile = path("out.log");
+    config.keywords = {"key1"};
+    config.bufferSize = 4096;
+    config.maxLineLength = 50;
+    config.sources.push_back({path("a.log"), "", {}});
+    append(path("a.log"), std::string(9000, 'X'));  // over-long, still being discarded
+
+    MultiLogMonitor monitor(config);
+    std::thread monitorThread([&monitor] { monitor.start(); });
+    for (int i = 0; i < 200 && monitor.getSourceStatistics(0).bytesRead < 9000; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    // rewritten in place, and the read that would see it fails: the
+    // source is closed and read again from 0 on the next event
+    g_failReads = 1;
+    std::ofstream(path("a.log"), std::ios::trunc) << "key1 first\n";
+    for (int i = 0; i < 200 && g_failReads.load() > 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    append(path("a.log"), "key1 second\n");
+    std::string output = waitForLines(config.outputFile, 2);
+    monitor.stop();
+    monitorThread.join();
+    g_failReads = 0;
+
+    EXPECT_EQ(output, "key1 first\nkey1 second\n");
+}
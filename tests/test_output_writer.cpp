@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include "output_writer.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+class OutputWriterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto now = std::chrono::system_clock::now().time_since_epoch().count();
+        path_ = "test_out_writer_" + std::to_string(now) + "_" + std::to_string(rand()) + ".log";
+        fs::remove(path_);
+    }
+
+    void TearDown() override {
+        fs::remove(path_);
+    }
+
+    std::string readFile() {
+        std::ifstream ifs(path_);
+        return std::string((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    }
+
+    OutputWriter::Options options(OutputWriter::FlushPolicy policy) {
+        OutputWriter::Options opts;
+        opts.policy = policy;
+        return opts;
+    }
+
+    std::string path_;
+};
+
+TEST_F(OutputWriterTest, PerLineFlushesEveryLine) {
+    OutputWriter writer(path_, options(OutputWriter::FlushPolicy::PerLine));
+    writer.writeLine("first");
+    writer.writeLine("second");
+    EXPECT_EQ(writer.flushCount(), 2u);
+    EXPECT_EQ(readFile(), "first\nsecond\n");
+}
+
+TEST_F(OutputWriterTest, BytesPolicyBatches) {
+    auto opts = options(OutputWriter::FlushPolicy::Bytes);
+    opts.flushBytes = 100;
+    OutputWriter writer(path_, opts);
+
+    std::string line(9, 'x');  // 10 bytes with newline
+    for (int i = 0; i < 25; ++i) writer.writeLine(line);
+    EXPECT_EQ(writer.flushCount(), 2u);
+    EXPECT_EQ(writer.pendingBytes(), 50u);
+    EXPECT_EQ(readFile().size(), 200u);
+
+    writer.flush();
+    EXPECT_EQ(readFile().size(), 250u);
+}
+
+TEST_F(OutputWriterTest, PerBufferWritesOnBufferEnd) {
+    OutputWriter writer(path_, options(OutputWriter::FlushPolicy::PerBuffer));
+    std::string buffer = "aaa\nbbb\n";
+    writer.writeLine(std::string_view(buffer).substr(0, 3), true);   // zero-copy
+    std::string carried = "ccc";
+    writer.writeLine(carried, false);                                // copied
+    carried = "zzz";  // caller reuses its memory before the flush
+    writer.writeLine(std::string_view(buffer).substr(4, 3), true);
+    EXPECT_EQ(readFile(), "");
+
+    writer.endOfBuffer();
+    EXPECT_EQ(writer.flushCount(), 1u);
+    EXPECT_EQ(readFile(), "aaa\nccc\nbbb\n");
+}
+
+TEST_F(OutputWriterTest, PerBufferBatchExceedsIovLimit) {
+    OutputWriter writer(path_, options(OutputWriter::FlushPolicy::PerBuffer));
+    // every other line matches, so references can't merge across lines
+    std::string buffer;
+    for (int i = 0; i < 5000; ++i) buffer += (i % 2 ? "skip\n" : "keep\n");
+    for (size_t pos = 0; pos < buffer.size(); pos += 10) {
+        writer.writeLine(std::string_view(buffer).substr(pos, 4), true);
+    }
+    writer.endOfBuffer();
+
+    std::string expected;
+    for (int i = 0; i < 2500; ++i) expected += "keep\n";
+    EXPECT_EQ(readFile(), expected);
+}
+
+TEST_F(OutputWriterTest, IntervalPolicyFlushesOnTick) {
+    auto opts = options(OutputWriter::FlushPolicy::Interval);
+    opts.flushIntervalUs = 1000;
+    OutputWriter writer(path_, opts);
+
+    writer.writeLine("pending");
+    writer.tick();
+    EXPECT_EQ(writer.flushCount(), 0u);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    writer.tick();
+    EXPECT_EQ(writer.flushCount(), 1u);
+    EXPECT_EQ(readFile(), "pending\n");
+}
+
+TEST_F(OutputWriterTest, DestructorFlushesAndAppends) {
+    {
+        std::ofstream ofs(path_);
+        ofs << "existing\n";
+    }
+    {
+        OutputWriter writer(path_, options(OutputWriter::FlushPolicy::Bytes));
+        writer.writeLine("new");
+    }
+    EXPECT_EQ(readFile(), "existing\nnew\n");
+}
+
+TEST_F(OutputWriterTest, ThrowsWhenPathIsInvalid) {
+    EXPECT_THROW(OutputWriter("/nonexistent_dir/out.log", options(OutputWriter::FlushPolicy::PerLine)),
+                 std::runtime_error);
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include "parallel_scanner.h"
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr size_t MAX_LEN = 50;
+
+// reference: same rules as LogMonitor::processLine, single-threaded
+std::vector<std::string> serialMatches(const KeywordMatcher& matcher, const std::string& text,
+                                       ParallelScanner::Result& counts) {
+    std::vector<std::string> out;
+    size_t start = 0;
+    while (start < text.size()) {
+        size_t nl = text.find('\n', start);
+        std::string_view line(text.data() + start, nl - start);
+        start = nl + 1;
+        if (line.empty()) continue;
+        counts.lines++;
+        if (line.size() > MAX_LEN) {
+            line = line.substr(0, MAX_LEN);
+            counts.longLines++;
+        }
+        if (matcher.matches(line)) {
+            out.emplace_back(line);
+            counts.matched++;
+        }
+    }
+    return out;
+}
+
+std::string randomLines(size_t count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::string text;
+    const char* words[] = {"ERROR", "INFO", "fill", "REJECT", "x", ""};
+    for (size_t i = 0; i < count; ++i) {
+        size_t len = rng() % 100;  // some empty, some over MAX_LEN
+        std::string line;
+        while (line.size() < len) {
+            line += words[rng() % 6];
+            line += ' ';
+        }
+        text += line.substr(0, len) + "#" + std::to_string(i) + "\n";
+        if (rng() % 10 == 0) text += "\n";
+    }
+    return text;
+}
+
+} // namespace
+
+TEST(ParallelScannerTest, MatchesSerialInOrder) {
+    KeywordMatcher matcher({"ERROR", "REJECT"});
+    std::string text = randomLines(5000, 1);
+
+    ParallelScanner::Result expectedCounts;
+    auto expected = serialMatches(matcher, text, expectedCounts);
+    ASSERT_GT(expected.size(), 100u);
+
+    for (size_t threads : {1u, 2u, 4u, 7u}) {
+        for (size_t chunk : {1u, 64u, 1000u, 1u << 20}) {
+            ParallelScanner scanner(matcher, threads, MAX_LEN, chunk);
+            std::vector<std::string> got;
+            auto counts = scanner.scan(text.data(), text.size(),
+                                       [&got](std::string_view line) { got.emplace_back(line); });
+            EXPECT_EQ(got, expected) << "threads=" << threads << " chunk=" << chunk;
+            EXPECT_EQ(counts.lines, expectedCounts.lines);
+            EXPECT_EQ(counts.longLines, expectedCounts.longLines);
+            EXPECT_EQ(counts.matched, expectedCounts.matched);
+        }
+    }
+}
+
+TEST(ParallelScannerTest, ReusableAcrossScans) {
+    KeywordMatcher matcher({"fill"});
+    ParallelScanner scanner(matcher, 4, MAX_LEN, 128);
+    EXPECT_EQ(scanner.threadCount(), 4u);
+
+    for (unsigned seed = 0; seed < 20; ++seed) {
+        std::string text = randomLines(200 + seed * 50, seed);
+        ParallelScanner::Result expectedCounts;
+        auto expected = serialMatches(matcher, text, expectedCounts);
+
+        std::vector<std::string> got;
+        auto counts = scanner.scan(text.data(), text.size(),
+                                   [&got](std::string_view line) { got.emplace_back(line); });
+        EXPECT_EQ(got, expected) << "seed=" << seed;
+        EXPECT_EQ(counts.lines, expectedCounts.lines);
+    }
+}
+
+TEST(ParallelScannerTest, EmptyRegion) {
+    KeywordMatcher matcher({"x"});
+    ParallelScanner scanner(matcher, 3, MAX_LEN);
+    auto counts = scanner.scan("", 0, [](std::string_view) { FAIL(); });
+    EXPECT_EQ(counts.lines, 0u);
+}
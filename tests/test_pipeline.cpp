@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+#include "pipeline.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr size_t MAX_LEN = 40;
+
+// serves a string, at most `step` bytes per read
+class StringInput : public InputSource {
+public:
+    StringInput(std::string text, size_t step) : text_(std::move(text)), step_(step) {}
+    bool open(const std::string&) override { return true; }
+    bool isOpen() const override { return true; }
+    void close() override {}
+    bool fileId(FileId&) const override { return false; }
+    ssize_t read(char* buffer, size_t len, uint64_t offset) override {
+        if (offset >= text_.size()) return 0;
+        size_t n = std::min({len, step_, text_.size() - static_cast<size_t>(offset)});
+        std::memcpy(buffer, text_.data() + offset, n);
+        return static_cast<ssize_t>(n);
+    }
+
+private:
+    std::string text_;
+    size_t step_;
+};
+
+// whole-line reference: single count and truncation per long line
+std::string expectedOutput(const KeywordMatcher& matcher, const std::string& text,
+                           uint64_t& lines, uint64_t& longLines) {
+    std::string out;
+    size_t start = 0;
+    while (true) {
+        size_t nl = text.find('\n', start);
+        if (nl == std::string::npos) break;  // unterminated tail stays pending
+        std::string_view line(text.data() + start, nl - start);
+        start = nl + 1;
+        if (line.empty()) continue;
+        lines++;
+        if (line.size() > MAX_LEN) {
+            line = line.substr(0, MAX_LEN);
+            longLines++;
+        }
+        if (matcher.matches(line)) {
+            out.append(line.data(), line.size());
+            out += '\n';
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+class PipelineTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto now = std::chrono::system_clock::now().time_since_epoch().count();
+        path_ = "test_pipeline_" + std::to_string(now) + "_" + std::to_string(rand()) + ".log";
+        fs::remove(path_);
+    }
+
+    void TearDown() override {
+        fs::remove(path_);
+    }
+
+    std::string readFile() {
+        std::ifstream ifs(path_);
+        return std::string((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    }
+
+    std::string path_;
+};
+
+TEST_F(PipelineTest, MatchesSerialOutputInOrder) {
+    std::mt19937 rng(7);
+    std::string text;
+    for (int i = 0; i < 3000; ++i) {
+        size_t len = rng() % 300;  // many lines longer than MAX_LEN and the read size
+        std::string line = (rng() % 4 == 0 ? "key " : "") + std::to_string(i);
+        line.resize(std::max(line.size(), len), 'x');
+        if (rng() % 50 == 0) line += " key";  // only visible past the cut
+        text += line + "\n";
+    }
+    text += "key unterminated";
+
+    KeywordMatcher matcher({"key"});
+    uint64_t lines = 0, longLines = 0;
+    std::string expected = expectedOutput(matcher, text, lines, longLines);
+
+    for (size_t matchers : {1u, 3u}) {
+        for (size_t step : {7u, 64u, 4096u}) {
+            fs::remove(path_);
+            OutputWriter::Options writerOptions;
+            writerOptions.policy = OutputWriter::FlushPolicy::PerBuffer;
+            OutputWriter writer(path_, writerOptions);
+
+            Pipeline::Options options;
+            options.matcherThreads = matchers;
+            options.blocks = 4;
+            options.readSize = 64;
+            options.maxLineLength = MAX_LEN;
+            Pipeline pipeline(matcher, writer, options);
+            pipeline.start();
+
+            StringInput input(text, step);
+            uint64_t offset = 0;
+            ssize_t n;
+            while ((n = pipeline.read(input, offset)) > 0) {
+                offset += static_cast<uint64_t>(n);
+            }
+            pipeline.finish();
+            writer.flush();
+
+            EXPECT_EQ(offset, text.size());
+            EXPECT_EQ(readFile(), expected) << "matchers=" << matchers << " step=" << step;
+            auto stats = pipeline.stats();
+            EXPECT_EQ(stats.lines, lines);
+            EXPECT_EQ(stats.longLines, longLines);
+            EXPECT_EQ(stats.matchQueueDepth, 0u);
+            EXPECT_EQ(stats.writeQueueDepth, 0u);
+        }
+    }
+}
+
+TEST_F(PipelineTest, DiscardPartialDropsCarriedLine) {
+    KeywordMatcher matcher({"key"});
+    OutputWriter writer(path_, OutputWriter::Options{});
+    Pipeline pipeline(matcher, writer, Pipeline::Options{});
+    pipeline.start();
+
+    StringInput first("key partial", 100);
+    ASSERT_GT(pipeline.read(first, 0), 0);
+    pipeline.discardPartial();
+
+    StringInput second(" rest\nkey fresh\n", 100);
+    ASSERT_GT(pipeline.read(second, 0), 0);
+    pipeline.finish();
+    writer.flush();
+
+    EXPECT_EQ(readFile(), "key fresh\n");  // " rest" was never a key line
+}
+
+TEST(SpscRingTest, FifoAcrossThreads) {
+    SpscRing<uint64_t> ring(5);
+    EXPECT_EQ(ring.capacity(), 8u);
+    constexpr uint64_t count = 200000;
+
+    std::thread producer([&ring] {
+        for (uint64_t i = 0; i < count; ++i) {
+            while (!ring.tryPush(i)) std::this_thread::yield();
+        }
+    });
+
+    uint64_t expected = 0, value;
+    while (expected < count) {
+        if (ring.tryPop(value)) {
+            ASSERT_EQ(value, expected);
+            expected++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    EXPECT_EQ(ring.size(), 0u);
+}
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include "placement.h"
+#include "log_monitor.h"
+#include <cstdio>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace {
+
+int firstAllowedCpu() {
+    for (int cpu = 0; cpu < 1024; ++cpu) {
+        if (cpuAllowed(cpu)) return cpu;
+    }
+    return -1;
+}
+
+} // namespace
+
+#if defined(__linux__)
+class PlacementTest : public ::testing::Test {
+protected:
+    // tests run on one thread: put its affinity back for the next test
+    void SetUp() override {
+        sched_getaffinity(0, sizeof(saved_), &saved_);
+    }
+    void TearDown() override {
+        sched_setaffinity(0, sizeof(saved_), &saved_);
+    }
+
+    cpu_set_t saved_;
+};
+
+TEST_F(PlacementTest, PinsToAnAllowedCpuOnly) {
+    EXPECT_FALSE(cpuAllowed(-1));
+    EXPECT_FALSE(pinCurrentThread(-1));
+    EXPECT_FALSE(pinCurrentThread(CPU_SETSIZE));
+
+    const int cpu = firstAllowedCpu();
+    ASSERT_GE(cpu, 0);
+    ASSERT_TRUE(pinCurrentThread(cpu));
+    EXPECT_EQ(sched_getcpu(), cpu);
+    EXPECT_TRUE(cpuAllowed(cpu));  // still judged on the startup mask
+    EXPECT_GE(currentNumaNode(), 0);
+}
+
+TEST_F(PlacementTest, ScopedPinRestoresAffinity) {
+    const int cpu = firstAllowedCpu();
+    ASSERT_GE(cpu, 0);
+    {
+        ScopedPin pin(cpu);
+        cpu_set_t inside;
+        sched_getaffinity(0, sizeof(inside), &inside);
+        EXPECT_EQ(CPU_COUNT(&inside), 1);
+        EXPECT_TRUE(CPU_ISSET(cpu, &inside));
+    }
+    cpu_set_t after;
+    sched_getaffinity(0, sizeof(after), &after);
+    EXPECT_TRUE(CPU_EQUAL(&after, &saved_));
+}
+
+TEST_F(PlacementTest, MonitorConfigPinsAndRejectsUnknownCpus) {
+    LogMonitor::Config config;
+    config.inputFile = "placement_test.log";
+    config.outputFile = "placement_test.out";
+    config.keywords = {"ERROR"};
+    config.pipelined = true;
+    config.pipelineCpus = {CPU_SETSIZE};
+    EXPECT_THROW(LogMonitor monitor(config), std::runtime_error);
+
+    config.pipelineCpus = {firstAllowedCpu(), -1};  // writer unpinned
+    config.monitorCpu = firstAllowedCpu();
+    config.hugePages = true;
+    {
+        LogMonitor monitor(config);
+        cpu_set_t after;
+        sched_getaffinity(0, sizeof(after), &after);
+        EXPECT_TRUE(CPU_EQUAL(&after, &saved_));  // the constructing thread is left as it was
+    }
+    std::remove("placement_test.out");
+}
+#endif
@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+#include "rate_tracker.h"
+#include "stat_counter.h"
+#include <thread>
+
+using namespace std::chrono;
+
+TEST(RateTrackerTest, ZeroUntilTwoSamples) {
+    RateTracker tracker(seconds(10));
+    auto rates = tracker.sample(100, 1000, 10, RateTracker::Clock::time_point(seconds(1)));
+    EXPECT_EQ(rates.linesPerSec, 0);
+    EXPECT_EQ(rates.windowSec, 0);
+}
+
+TEST(RateTrackerTest, RatesOverWindow) {
+    RateTracker tracker(seconds(10));
+    RateTracker::Clock::time_point t0(seconds(100));
+    tracker.sample(0, 0, 0, t0);
+    auto rates = tracker.sample(1000, 64000, 50, t0 + seconds(2));
+    EXPECT_DOUBLE_EQ(rates.windowSec, 2.0);
+    EXPECT_DOUBLE_EQ(rates.linesPerSec, 500.0);
+    EXPECT_DOUBLE_EQ(rates.bytesPerSec, 32000.0);
+    EXPECT_DOUBLE_EQ(rates.matchesPerSec, 25.0);
+}
+
+TEST(RateTrackerTest, OldSamplesSlideOut) {
+    RateTracker tracker(seconds(3));
+    RateTracker::Clock::time_point t0(seconds(100));
+    // fast burst first, then steady 10 lines/s
+    tracker.sample(0, 0, 0, t0);
+    tracker.sample(100000, 0, 0, t0 + seconds(1));
+    uint64_t lines = 100000;
+    RateTracker::Rates rates;
+    for (int i = 2; i <= 10; ++i) {
+        lines += 10;
+        rates = tracker.sample(lines, 0, 0, t0 + seconds(i));
+    }
+    EXPECT_DOUBLE_EQ(rates.linesPerSec, 10.0);
+    EXPECT_LE(rates.windowSec, 4.0);
+}
+
+TEST(StatCounterTest, SingleWriterVisibleToReaders) {
+    StatCounter counter;
+    constexpr uint64_t count = 100000;
+
+    std::thread writer([&counter] {
+        for (uint64_t i = 0; i < count; ++i) counter++;
+    });
+    uint64_t last = 0;
+    while (last < count) {
+        uint64_t now = counter.load();
+        ASSERT_GE(now, last);  // monotonic from the reader's side
+        last = now;
+    }
+    writer.join();
+
+    counter += 5;
+    EXPECT_EQ(counter.load(), count + 5);
+    EXPECT_EQ(alignof(StatCounter), 64u);
+}
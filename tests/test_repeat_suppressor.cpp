@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include "repeat_suppressor.h"
+#include "log_monitor.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::string readFile(const std::string& path) {
+    std::ifstream in(path);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+std::string reject(int i) {
+    return "2024-10-15 12:34:" + std::to_string(10 + i % 50) + "." + std::to_string(i * 37 % 1000000) +
+           " REJECT OrderID=" + std::to_string(100000 + i) + " Price=" + std::to_string(100 + i % 7) + ".25";
+}
+
+} // namespace
+
+class RepeatSuppressorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        fs::remove_all(dir_);
+        fs::create_directories(dir_);
+    }
+    void TearDown() override {
+        fs::remove_all(dir_);
+    }
+    std::string path(const std::string& name) const { return (dir_ / name).string(); }
+
+    fs::path dir_ = "repeat_suppressor_test";
+};
+
+TEST_F(RepeatSuppressorTest, TemplateMasksDigitRuns) {
+    EXPECT_EQ(RepeatSuppressor::templateHash(reject(1)), RepeatSuppressor::templateHash(reject(12345)));
+    EXPECT_EQ(RepeatSuppressor::templateHash("Price=1.5"), RepeatSuppressor::templateHash("Price=123.45"));
+    EXPECT_NE(RepeatSuppressor::templateHash("Price=1.5"), RepeatSuppressor::templateHash("Price=15"));
+    EXPECT_NE(RepeatSuppressor::templateHash("REJECT Symbol=AAPL"), RepeatSuppressor::templateHash("REJECT Symbol=MSFT"));
+}
+
+TEST_F(RepeatSuppressorTest, WritesFirstLinesThenOneSummaryPerWindow) {
+    Arena arena(RepeatSuppressor::arenaBytes(8));
+    RepeatSuppressor repeats(2, 1000, 8, arena);
+    const auto start = RepeatSuppressor::Clock::now();
+    {
+        OutputWriter out(path("out.log"), OutputWriter::Options());
+        auto feed = [&](const std::string& line) {
+            if (repeats.admit(line, out)) out.writeLine(line);
+        };
+        for (int i = 0; i < 5; ++i) feed(reject(i));
+        feed("ERROR disk full");
+        repeats.tick(start + std::chrono::milliseconds(10), out);  // window still open
+        EXPECT_EQ(repeats.suppressed(), 3u);
+
+        repeats.tick(start + std::chrono::milliseconds(1500), out);  // ended: summary
+        feed(reject(5));  // new window
+        repeats.finish(out);  // one line only, nothing to sum up
+    }
+    EXPECT_EQ(readFile(path("out.log")),
+              reject(0) + "\n" + reject(1) + "\n" + "ERROR disk full\n" +
+              "repeated 3 times: " + reject(2) + "\n" + reject(5) + "\n");
+}
+
+TEST_F(RepeatSuppressorTest, FullTableWritesUntrackedLines) {
+    Arena arena(RepeatSuppressor::arenaBytes(1));
+    RepeatSuppressor repeats(1, 60000, 1, arena);
+    OutputWriter out(path("out.log"), OutputWriter::Options());
+    EXPECT_TRUE(repeats.admit("A", out));
+    EXPECT_FALSE(repeats.admit("A", out));
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_TRUE(repeats.admit("B", out));  // no slot left for B
+    }
+    EXPECT_EQ(repeats.suppressed(), 1u);
+}
+
+TEST_F(RepeatSuppressorTest, MonitorRateLimitsOutputFileOnly) {
+    {
+        std::ofstream log(path("in.log"));
+        for (int i = 0; i < 1000; ++i) {
+            log << reject(i) << "\n";
+            if (i % 100 == 0) log << "2024-10-15 12:34:56 ERROR Venue=NYSE\n";
+        }
+    }
+    LogMonitor::Config config;
+    config.inputFile = path("in.log");
+    config.outputFile = path("out.log");
+    config.keywords = {"REJECT", "ERROR"};
+    config.routes = {{{"REJECT"}, path("rejects.log")}};
+    config.bufferSize = 4096;
+    config.waitMode = LogMonitor::WaitMode::Poll;
+    config.repeatLimit = 3;
+    config.repeatWindowMs = 60000;  // the whole run is one window
+    std::string expected = reject(0) + "\n" + "2024-10-15 12:34:56 ERROR Venue=NYSE\n" + reject(1) + "\n" +
+                           reject(2) + "\n" + "2024-10-15 12:34:56 ERROR Venue=NYSE\n" +
+                           "2024-10-15 12:34:56 ERROR Venue=NYSE\n";
+    {
+        LogMonitor monitor(config);
+        auto stats = monitor.runUntilEof();
+        EXPECT_EQ(stats.linesSuppressed, 997u + 7u);
+        EXPECT_EQ(stats.linesMatched, 1010u - 7u);  // suppressed REJECTs still went to the route
+    }
+    const std::string out = readFile(path("out.log"));
+    ASSERT_EQ(out.substr(0, expected.size()), expected);
+    EXPECT_NE(out.find("repeated 997 times: " + reject(3) + "\n"), std::string::npos);
+    EXPECT_NE(out.find("repeated 7 times: 2024-10-15 12:34:56 ERROR Venue=NYSE\n"), std::string::npos);
+
+    // the route isn't limited
+    std::ifstream rejects(path("rejects.log"));
+    size_t lines = 0;
+    for (std::string line; std::getline(rejects, line);) ++lines;
+    EXPECT_EQ(lines, 1000u);
+
+    config.pipelined = true;
+    EXPECT_THROW(LogMonitor monitor(config), std::runtime_error);
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include "simd_search.h"
+#include <random>
+
+namespace {
+
+std::vector<simd::Kernel> supportedKernels() {
+    std::vector<simd::Kernel> kernels;
+    for (auto k : {simd::Kernel::Scalar, simd::Kernel::SSE2, simd::Kernel::AVX2, simd::Kernel::NEON}) {
+        if (simd::isSupported(k)) kernels.push_back(k);
+    }
+    return kernels;
+}
+
+} // namespace
+
+TEST(SimdSearchTest, BestKernelIsSupported) {
+    EXPECT_TRUE(simd::isSupported(simd::bestKernel()));
+    EXPECT_STRNE(simd::kernelName(simd::bestKernel()), "");
+}
+
+TEST(SimdSearchTest, FindsAtVectorBoundaries) {
+    for (auto kernel : supportedKernels()) {
+        auto fn = simd::searchFunction(kernel);
+        // place the needle at every offset around 16/32 byte block edges,
+        // including where the last byte sits in the scalar tail
+        for (size_t len = 0; len < 80; ++len) {
+            for (size_t pos = 0; pos + 5 <= len; ++pos) {
+                std::string hay(len, 'E');
+                hay.replace(pos, 5, "ERROR");
+                EXPECT_EQ(fn(hay.data(), hay.size(), "ERROR", 5), hay.find("ERROR"))
+                    << simd::kernelName(kernel) << " len=" << len << " pos=" << pos;
+            }
+            std::string miss(len, 'R');
+            EXPECT_EQ(fn(miss.data(), miss.size(), "ERROR", 5), std::string::npos);
+        }
+    }
+}
+
+TEST(SimdSearchTest, ShortNeedles) {
+    for (auto kernel : supportedKernels()) {
+        auto fn = simd::searchFunction(kernel);
+        std::string hay = std::string(40, 'a') + "xy" + std::string(40, 'a');
+        EXPECT_EQ(fn(hay.data(), hay.size(), "", 0), 0u);
+        EXPECT_EQ(fn(hay.data(), hay.size(), "x", 1), 40u);
+        EXPECT_EQ(fn(hay.data(), hay.size(), "xy", 2), 40u);
+        EXPECT_EQ(fn(hay.data(), 3, "aaaa", 4), std::string::npos);
+    }
+}
+
+TEST(SimdSearchTest, AgreesWithScalarOnRandomText) {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> ch('a', 'c');
+    for (auto kernel : supportedKernels()) {
+        auto fn = simd::searchFunction(kernel);
+        for (int round = 0; round < 500; ++round) {
+            std::string hay(rng() % 100, ' ');
+            for (auto& c : hay) c = static_cast<char>(ch(rng));
+            std::string needle(1 + rng() % 4, ' ');
+            for (auto& c : needle) c = static_cast<char>(ch(rng));
+            EXPECT_EQ(fn(hay.data(), hay.size(), needle.data(), needle.size()), hay.find(needle))
+                << simd::kernelName(kernel) << " " << hay << " / " << needle;
+        }
+    }
+}
+
+TEST(SimdSearchTest, IgnoreCaseFoldsInsideTheKernel) {
+    std::mt19937 rng(11);
+    // letters in both cases plus the bytes that differ from a letter by 0x20 only
+    const std::string alphabet = "aAbBcC@`[{";
+    auto fold = [](std::string text) {
+        for (auto& c : text) {
+            if (c >= 'A' && c <= 'Z') c = static_cast<char>(c | 0x20);
+        }
+        return text;
+    };
+    for (auto kernel : supportedKernels()) {
+        auto fn = simd::searchFunctionIgnoreCase(kernel);
+        std::string hay = std::string(40, '.') + "eRrOr" + std::string(40, '.');
+        EXPECT_EQ(fn(hay.data(), hay.size(), "error", 5), 40u) << simd::kernelName(kernel);
+        EXPECT_EQ(fn(hay.data(), hay.size(), "", 0), 0u);
+
+        for (int round = 0; round < 500; ++round) {
+            std::string text(rng() % 100, ' ');
+            for (auto& c : text) c = alphabet[rng() % alphabet.size()];
+            std::string needle(1 + rng() % 4, ' ');
+            for (auto& c : needle) c = alphabet[rng() % alphabet.size()];
+            needle = fold(needle);
+            EXPECT_EQ(fn(text.data(), text.size(), needle.data(), needle.size()), fold(text).find(needle))
+                << simd::kernelName(kernel) << " " << text << " / " << needle;
+        }
+    }
+}
+
+TEST(SimdSearchTest, CountLinesMatchesPerLineRules) {
+    std::string text;
+    for (int i = 0; i < 100; ++i) {
+        text += "line " + std::to_string(i) + "\n";
+        if (i % 10 == 0) text += "\n";                            // empty: not counted
+        if (i % 30 == 0) text += std::string(70, 'L') + "\n";     // over the limit below
+    }
+    text += "unterminated tail";
+
+    for (auto kernel : supportedKernels()) {
+        auto counts = simd::lineCountFunction(kernel)(text.data(), text.size(), 64);
+        EXPECT_EQ(counts.lines, 104u) << simd::kernelName(kernel);
+        EXPECT_EQ(counts.longLines, 4u) << simd::kernelName(kernel);
+    }
+}
@@ -0,0 +1,43 @@
+#include <gtest/gtest.h>
+#include "stage_tracer.h"
+#include <thread>
+
+TEST(StageTracerTest, SamplesOneLineInSampleEvery) {
+    StageTracer tracer;
+    int sampled = 0;
+    for (uint32_t i = 0; i < StageTracer::SAMPLE_EVERY * 10; ++i) {
+        sampled += tracer.sampleLine();
+    }
+    EXPECT_EQ(sampled, 10);
+}
+
+TEST(StageTracerTest, TicksAdvanceAndConvertToNs) {
+    StageTracer tracer;
+    uint64_t t0 = StageTracer::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    uint64_t ticks = StageTracer::now() - t0;
+    double ns = ticks / tracer.ticksPerNs();
+    EXPECT_GT(ns, 15e6);
+    EXPECT_LT(ns, 500e6);
+}
+
+TEST(StageTracerTest, ReportListsEveryStage) {
+    StageTracer tracer;
+    tracer.record(StageTracer::Stage::Read, 1000);
+    tracer.record(StageTracer::Stage::Read, 3000);
+    tracer.recordRead(65536);
+    tracer.countLoop(true);
+    tracer.countLoop(false);
+    tracer.countLoop(false);
+    EXPECT_EQ(tracer.stage(StageTracer::Stage::Read).count(), 2u);
+    EXPECT_EQ(tracer.stage(StageTracer::Stage::Idle).count(), 0u);
+    EXPECT_EQ(tracer.busyLoops(), 1u);
+    EXPECT_EQ(tracer.idleLoops(), 2u);
+    
+    std::string report = tracer.report();
+    for (const char* name : {"read", "buffer", "match", "write", "flush", "idle"}) {
+        EXPECT_NE(report.find(name), std::string::npos) << name;
+    }
+    EXPECT_NE(report.find("p50 65536 B"), std::string::npos);
+    EXPECT_NE(report.find("1 busy, 2 idle"), std::string::npos);
+}
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include "static_keyword_matcher.h"
+#include "keyword_matcher.h"
+#include <random>
+
+namespace {
+
+constexpr char REJECT[] = "REJECT";
+constexpr char ERROR[] = "ERROR";
+constexpr char FILL[] = "FILL";
+constexpr char X[] = "x";
+constexpr char AB[] = "ab";
+
+using OrderMatcher = StaticKeywordMatcher<REJECT, ERROR, FILL>;
+using ShortMatcher = StaticKeywordMatcher<X, AB>;
+
+} // namespace
+
+TEST(StaticKeywordMatcherTest, CompileTimeProperties) {
+    static_assert(OrderMatcher::COUNT == 3);
+    static_assert(OrderMatcher::MAX_LENGTH == 6);
+    static_assert(ShortMatcher::MAX_LENGTH == 2);
+    EXPECT_EQ(OrderMatcher::keywords(), (std::vector<std::string>{"REJECT", "ERROR", "FILL"}));
+}
+
+TEST(StaticKeywordMatcherTest, MatchesLikeKeywordMatcher) {
+    EXPECT_TRUE(OrderMatcher::matches("[2026-10-14 09:30:00.000001] REJECT OrderID=7"));
+    EXPECT_FALSE(OrderMatcher::matches("[2026-10-14 09:30:00.000001] EXECUTION OrderID=7 Symbol=FIL"));
+    EXPECT_FALSE(OrderMatcher::matches(""));
+    EXPECT_FALSE(OrderMatcher::matches("error reject fill"));
+
+    // every keyword at every offset of lines around the 16 / 32 byte block
+    // and tail boundaries, on a background full of first / last bytes
+    KeywordMatcher reference(OrderMatcher::keywords(), KeywordMatcher::Engine::Linear);
+    KeywordMatcher shortReference(ShortMatcher::keywords(), KeywordMatcher::Engine::Linear);
+    std::mt19937 rng(7);
+    const std::string alphabet = "RETFILJCOab ";
+    for (size_t length = 0; length < 100; ++length) {
+        for (int trial = 0; trial < 20; ++trial) {
+            std::string line(length, ' ');
+            for (char& c : line) c = alphabet[rng() % alphabet.size()];
+            if (length > 0 && trial % 2 == 0) {
+                const std::string& keyword = reference.getKeywords()[trial % 3];
+                size_t at = rng() % length;
+                line.replace(at, std::min(keyword.size(), length - at), keyword, 0, length - at);
+            }
+            EXPECT_EQ(OrderMatcher::matches(line), reference.matches(line)) << line;
+            EXPECT_EQ(ShortMatcher::matches(line), shortReference.matches(line)) << line;
+        }
+    }
+}
+
+TEST(StaticKeywordMatcherTest, WrapsIntoKeywordMatcher) {
+    KeywordMatcher matcher(OrderMatcher::keywords(), &OrderMatcher::matches);
+    EXPECT_EQ(matcher.getEngine(), KeywordMatcher::Engine::Static);
+    EXPECT_TRUE(matcher.matches("order FILL"));
+    EXPECT_FALSE(matcher.matches("order EXECUTION"));
+
+    // whole-buffer scanning and groups use the runtime keywords
+    std::string text = "a\nb ERROR\nc\nd FILL\n";
+    KeywordMatcher::Scanner scanner(matcher, text);
+    size_t hit = scanner.next(0);
+    EXPECT_EQ(hit, text.find("ERROR"));
+    EXPECT_EQ(scanner.next(text.find('\n', hit)), text.find("FILL"));
+    EXPECT_EQ(matcher.matchGroups("REJECT"), 1u);
+    EXPECT_EQ(matcher.matchGroups("INFO"), 0u);
+}